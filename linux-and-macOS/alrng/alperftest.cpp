@@ -13,9 +13,9 @@
 
 /**
  *    @file alperftest.cpp
- *    @date 1/9/2024
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 1.4
+ *    @version 1.19
  *
  *    @brief A utility used for measuring performance of the AlphaRNG device in different transmission modes.
  */
@@ -24,10 +24,52 @@
 #include <iostream>
 #include <iomanip>
 #include <AlphaRngApi.h>
+#ifdef __linux__
+#include <SharedEntropyRing.h>
+#include <PskChannel.h>
+#include <EntropyServerClient.h>
+#include <AlphaRngApiCWrapper.h>
+#include <RandomRangeSequence.h>
+#include <RandomRangePermutation.h>
+#include <atomic>
+#include <memory>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <sys/random.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <cstring>
+#include <algorithm>
+#include <openssl/rand.h>
+#include <openssl/evp.h>
+#include <openssl/provider.h>
+#endif
 
 using namespace std;
 using namespace alpharng;
 
+#ifdef __linux__
+/**
+ * A TCP connection to the entropy server, requests and replies are carried in PskChannel frames
+ */
+struct TcpConnection {
+	int fd = -1;
+	unique_ptr<PskChannel> channel;
+	vector<unsigned char> rx;
+	size_t rx_level = 0;
+	vector<unsigned char> payload;
+	size_t payload_offset = 0;
+};
+#endif
+
 /**
 * Local functions used
 */
@@ -37,13 +79,94 @@ static bool run_device_perf_tests(int device_num, MacType macType, KeySize keySi
 static bool run_device_perf_test(int device_num, const RngConfig &cfg);
 static void reset_statistics(DeviceStatistics *ds);
 static void generate_statistics(DeviceStatistics &ds, int64_t num_bytes);
+static bool run_encoding_benchmark();
+static double measure_encoding_speed(const TextEncoder &encoder, const unsigned char *in, int in_length, char *out);
+static bool run_batch_benchmark(int device_num);
+#ifdef __linux__
+static bool run_ring_benchmark();
+static bool measure_ring_readers(const string &ring_name, int num_readers);
+static void run_ring_reader(const string &ring_name, int start_fd, int result_fd);
+static bool run_server_benchmark(const string &socket_path);
+static int connect_server(const string &socket_path);
+static bool send_bytes(int fd, const void *in, size_t size);
+static bool receive_bytes(int fd, void *out, size_t size);
+static bool send_server_request(int fd, uint32_t cmd, uint32_t size, unsigned char *out);
+static bool measure_sequential_requests(int fd, int num_requests);
+static bool measure_pipelined_requests(int fd, int num_requests, int batch_size);
+static bool measure_small_request_latency(const string &socket_path, int num_bulk_clients, bool is_prioritized);
+static bool measure_burst_latency(const string &socket_path, int num_clients);
+static bool measure_client_library(const string &socket_path, size_t read_ahead_bytes, size_t request_size, int num_threads);
+static bool run_copy_benchmark();
+static bool measure_delivery(int method, int num_readers);
+static bool run_getrandom_benchmark();
+static bool measure_random_calls(int method, size_t request_size, int num_threads);
+static bool run_openssl_benchmark(const string &config_file_name);
+static bool measure_rand_bytes(OSSL_LIB_CTX *libctx, const string &label, size_t request_size, int num_threads);
+static bool measure_reseeds(OSSL_LIB_CTX *libctx, const string &label);
+static bool run_tcp_benchmark(const string &endpoint, const string &psk_file_name);
+static bool connect_tcp_server(const sockaddr_in &addr, const unsigned char *psk, TcpConnection *connection);
+static bool send_tcp_bytes(TcpConnection *connection, const void *in, uint32_t size);
+static bool receive_tcp_bytes(TcpConnection *connection, void *out, size_t size);
+static bool measure_tcp_requests(TcpConnection *connection, int num_requests, uint32_t request_size);
+static bool measure_tcp_pipelined_requests(TcpConnection *connection, int num_requests, int batch_size);
+static bool measure_tcp_connections(const sockaddr_in &addr, const unsigned char *psk, int num_connections);
+static bool run_thread_cache_benchmark(int device_num);
+static bool measure_c_entropy_calls(alrng_context *ctxt, bool is_cached, int request_size, int num_threads);
+static bool run_sequence_benchmark(uint64_t max_size);
+static bool generate_sequence_by_rounds(int32_t *dest, uint32_t size, uint64_t *entropy_bytes);
+static bool stream_permutation(uint64_t size, double *secs);
+#endif
 
 /**
  * Application entry point.
  *
+ * @param[in] argc number of arguments provided in command line
+ * @param[in] argv '-enc' to measure the text encoders, '-ring' to measure the shared memory ring
+ *                 '-batch [DEVICE]' to compare batches of key sized reads with one vectored read,
+ *                 '-server [SOCKET]' to measure a running entropy server instead of the devices,
+ *                 '-copy' to compare ways of delivering buffered bytes to sockets,
+ *                 '-getrandom' to compare getrandom() and /dev/urandom calls with the system calls,
+ *                 '-openssl CONFIG' to measure RAND_bytes() with the AlphaRNG provider loaded by an OpenSSL configuration file
+ *                 '-tcp ADDRESS:PORT PSKFILE' to measure the TCP clients of a running entropy server
+ *                 '-tcache [DEVICE]' to compare small alrng_get_entropy() calls with and without thread caches
+ *                 or '-seq [MAX_SIZE]' to compare the random range sequence algorithms without a device
+ *
  * @return 0 when executed successfully
  */
-int main() {
+int main(const int argc, const char **argv) {
+
+	if (argc == 2 && string(argv[1]) == "-enc") {
+		return run_encoding_benchmark() ? 0 : -1;
+	}
+	if ((argc == 2 || argc == 3) && string(argv[1]) == "-batch") {
+		return run_batch_benchmark(argc == 3 ? atoi(argv[2]) : 0) ? 0 : -1;
+	}
+#ifdef __linux__
+	if (argc == 2 && string(argv[1]) == "-ring") {
+		return run_ring_benchmark() ? 0 : -1;
+	}
+	if ((argc == 2 || argc == 3) && string(argv[1]) == "-server") {
+		return run_server_benchmark(argc == 3 ? argv[2] : "/run/alpharng.sock") ? 0 : -1;
+	}
+	if (argc == 2 && string(argv[1]) == "-copy") {
+		return run_copy_benchmark() ? 0 : -1;
+	}
+	if (argc == 2 && string(argv[1]) == "-getrandom") {
+		return run_getrandom_benchmark() ? 0 : -1;
+	}
+	if (argc == 3 && string(argv[1]) == "-openssl") {
+		return run_openssl_benchmark(argv[2]) ? 0 : -1;
+	}
+	if (argc == 4 && string(argv[1]) == "-tcp") {
+		return run_tcp_benchmark(argv[2], argv[3]) ? 0 : -1;
+	}
+	if ((argc == 2 || argc == 3) && string(argv[1]) == "-tcache") {
+		return run_thread_cache_benchmark(argc == 3 ? atoi(argv[2]) : 0) ? 0 : -1;
+	}
+	if ((argc == 2 || argc == 3) && string(argv[1]) == "-seq") {
+		return run_sequence_benchmark(argc == 3 ? strtoull(argv[2], nullptr, 10) : 1000000000ULL) ? 0 : -1;
+	}
+#endif
 
 	AlphaRngApi rng_count;
 
@@ -292,8 +415,8 @@ static bool run_device_perf_test(int device_num, const RngConfig &cfg) {
  *
  */
 static void reset_statistics(DeviceStatistics *ds) {
-	memset(ds, 0x0, sizeof(DeviceStatistics));
-	time(&ds->begin_time);
+	*ds = DeviceStatistics();
+	ds->begin_time = chrono::steady_clock::now();
 }
 
 /**
@@ -305,12 +428,1464 @@ static void reset_statistics(DeviceStatistics *ds) {
  *
  */
 static void generate_statistics(DeviceStatistics &ds, int64_t num_bytes) {
-	time(&ds.end_time);
-	ds.total_time = ds.end_time - ds.begin_time;
-	if (ds.total_time == 0) {
-		ds.total_time = 1;
+	ds.end_time = chrono::steady_clock::now();
+	ds.total_time_secs = chrono::duration<double>(ds.end_time - ds.begin_time).count();
+	if (ds.total_time_secs <= 0) {
+		ds.total_time_secs = 1e-6;
+	}
+	ds.download_speed_kbsec = (int) ((double)num_bytes / 1024.0 / ds.total_time_secs);
+}
+
+/**
+ * Compare retrieving batches of 32 byte keys with one get_entropy() call per key
+ * and with one get_entropy_v() call per batch.
+ *
+ * @param[in] device_num device number
+ *
+ * @return true for successful operation
+ */
+static bool run_batch_benchmark(int device_num) {
+	const int key_size = 32;
+	const int batch_sizes[] = {1, 10, 100, 500, 1000};
+	const int max_batch_size = 1000;
+	AlphaRngApi rng;
+	if (!rng.connect(device_num)) {
+		cerr << "Could not reach device: " << rng.get_last_error() << endl;
+		return false;
+	}
+	unsigned char *keys = new (nothrow) unsigned char[max_batch_size * key_size];
+	struct iovec *iov = new (nothrow) struct iovec[max_batch_size];
+	if (keys == nullptr || iov == nullptr) {
+		cerr << "Could not prepare the batch benchmark" << endl;
+		delete [] keys;
+		delete [] iov;
+		return false;
+	}
+	for (int i = 0; i < max_batch_size; i++) {
+		iov[i].iov_base = keys + i * key_size;
+		iov[i].iov_len = key_size;
+	}
+
+	cout << "-------------------------------------------------------------------------------" << endl;
+	cout << "------ TectroLabs - alperftest - batched key reads performance test -----------" << endl;
+	cout << "Key size: " << key_size << " bytes" << endl;
+	cout << "-------------------------------------------------------------------------------" << endl;
+	bool status = true;
+	for (int batch_size : batch_sizes) {
+		const int batch_count = max(1, 2000 / batch_size);
+		chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+		for (int b = 0; status && b < batch_count; b++) {
+			for (int i = 0; status && i < batch_size; i++) {
+				status = rng.get_entropy(keys + i * key_size, key_size);
+			}
+		}
+		double single_secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		begin = chrono::steady_clock::now();
+		for (int b = 0; status && b < batch_count; b++) {
+			status = rng.get_entropy_v(iov, batch_size);
+		}
+		double vectored_secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		if (!status) {
+			cerr << "Error when retrieving entropy bytes: " << rng.get_last_error() << endl;
+			break;
+		}
+		cout << "keys per batch: " << std::setw(4) << batch_size << " ...... single: " << std::fixed << std::setprecision(3)
+				<< std::setw(8) << single_secs * 1000 / batch_count << " ms/batch, vectored: " << std::setw(8)
+				<< vectored_secs * 1000 / batch_count << " ms/batch, " << std::setprecision(1) << std::setw(6)
+				<< single_secs / max(vectored_secs, 1e-9) << "x" << endl;
+	}
+	delete [] keys;
+	delete [] iov;
+	return status;
+}
+
+/**
+ * Measure the speed of the text encoders, scalar and vectorized, without a device.
+ *
+ * @return true for successful operation
+ */
+static bool run_encoding_benchmark() {
+	const int in_length = 100000;
+	unsigned char *in = new (nothrow) unsigned char[in_length];
+	char *out = new (nothrow) char[in_length * 2];
+	if (in == nullptr || out == nullptr || !RAND_bytes(in, in_length)) {
+		cerr << "Could not prepare the encoding benchmark" << endl;
+		delete [] in;
+		delete [] out;
+		return false;
+	}
+
+	cout << "-------------------------------------------------------------------------------" << endl;
+	cout << "------ TectroLabs - alperftest - text encoding performance test ---------------" << endl;
+	cout << "-------------------------------------------------------------------------------" << endl;
+	const OutputEncoding encodings[] = {OutputEncoding::hex, OutputEncoding::base64, OutputEncoding::base64url, OutputEncoding::base32};
+	const char *names[] = {"hex      ", "base64   ", "base64url", "base32   "};
+	for (int i = 0; i < 4; i++) {
+		TextEncoder scalar_encoder(encodings[i], false);
+		TextEncoder simd_encoder(encodings[i]);
+		cout << names[i] << " ...... scalar: " << std::fixed << std::setprecision(2) << std::setw(6)
+				<< measure_encoding_speed(scalar_encoder, in, in_length, out) << " GB/sec";
+		cout << ", " << std::setw(6) << simd_encoder.get_implementation_name() << ": " << std::setw(6)
+				<< measure_encoding_speed(simd_encoder, in, in_length, out) << " GB/sec" << endl;
+	}
+	delete [] in;
+	delete [] out;
+	return true;
+}
+
+/**
+ * @return encoding speed in GB (10^9 input bytes) per second
+ */
+static double measure_encoding_speed(const TextEncoder &encoder, const unsigned char *in, int in_length, char *out) {
+	const int iterations = 20000;
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		encoder.encode(in, in_length, out, false);
+	}
+	double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	return (double)in_length * iterations / secs / 1e9;
+}
+
+#ifdef __linux__
+
+/**
+ * Measure the latency of small reads from the shared memory ring, without a device,
+ * for 1 to 64 reader processes. A producer thread keeps publishing test bytes.
+ *
+ * @return true for successful operation
+ */
+static bool run_ring_benchmark() {
+	const string ring_name = "/alperftest-ring-" + to_string(getpid());
+	cout << "-------------------------------------------------------------------------------" << endl;
+	cout << "------ TectroLabs - alperftest - shared memory ring performance test ----------" << endl;
+	cout << "-------------------------------------------------------------------------------" << endl;
+	cout << "Ring capacity: " << SharedEntropyRing::c_default_capacity_bytes / 1048576 << " MB, read size: 32 bytes, CPUs: "
+			<< thread::hardware_concurrency() << endl;
+	const int reader_counts[] = {1, 2, 4, 8, 16, 32, 64};
+	for (int num_readers : reader_counts) {
+		if (!measure_ring_readers(ring_name, num_readers)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @param[in] ring_name name of the ring to create for the measurement
+ * @param[in] num_readers amount of reader processes
+ *
+ * @return true for successful operation
+ */
+static bool measure_ring_readers(const string &ring_name, int num_readers) {
+	SharedEntropyRing ring;
+	int start_pipe[2];
+	int result_pipe[2];
+	if (!ring.create(ring_name, SharedEntropyRing::c_default_capacity_bytes) || pipe(start_pipe) < 0 || pipe(result_pipe) < 0) {
+		cerr << "Could not prepare the ring benchmark. " << ring.get_last_error() << endl;
+		return false;
+	}
+
+	// Readers are forked before the producer thread starts
+	for (int i = 0; i < num_readers; i++) {
+		pid_t pid = fork();
+		if (pid == 0) {
+			close(start_pipe[1]);
+			close(result_pipe[0]);
+			run_ring_reader(ring_name, start_pipe[0], result_pipe[1]);
+		}
+		if (pid < 0) {
+			cerr << "Could not start reader process" << endl;
+			return false;
+		}
+	}
+	close(start_pipe[0]);
+	close(result_pipe[1]);
+
+	atomic<bool> is_stopping {false};
+	thread producer([&ring, &is_stopping] {
+		unsigned char chunk[16000];
+		RAND_bytes(chunk, sizeof(chunk));
+		while (!is_stopping.load()) {
+			if (ring.wait_for_space(sizeof(chunk), 100)) {
+				ring.publish(chunk, sizeof(chunk));
+			}
+		}
+	});
+
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	close(start_pipe[1]);
+	double total_secs = 0;
+	uint64_t total_reads = 0;
+	int finished = 0;
+	double result[2];
+	while (::read(result_pipe[0], result, sizeof(result)) == sizeof(result)) {
+		total_secs += result[0];
+		total_reads += (uint64_t)result[1];
+		finished++;
+	}
+	double wall_secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	while (wait(nullptr) > 0) {
+	}
+	is_stopping.store(true);
+	producer.join();
+	close(result_pipe[0]);
+
+	if (finished != num_readers || total_reads == 0) {
+		cerr << "Only " << finished << " of " << num_readers << " readers completed" << endl;
+		return false;
+	}
+	cout << std::setw(2) << num_readers << " reader(s) ...... mean read latency: " << std::fixed << std::setprecision(1)
+			<< std::setw(8) << total_secs / total_reads * 1e9 << " ns, aggregate: " << std::setw(7)
+			<< total_reads * 32.0 / wall_secs / 1048576 << " MB/sec" << endl;
+	return true;
+}
+
+/**
+ * Reader process: wait for the start signal, time the reads and report the result
+ */
+static void run_ring_reader(const string &ring_name, int start_fd, int result_fd) {
+	const int num_reads = 200000;
+	unsigned char buffer[32];
+	double result[2] = {0, 0};
+	SharedEntropyRing ring;
+	char c;
+	if (ring.attach(ring_name) && ::read(start_fd, &c, 1) == 0) {
+		chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+		int i = 0;
+		while (i < num_reads && ring.read(buffer, sizeof(buffer))) {
+			i++;
+		}
+		result[0] = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+		result[1] = i;
+	}
+	ring.detach();
+	if (write(result_fd, result, sizeof(result)) != sizeof(result)) {
+		_exit(1);
+	}
+	_exit(0);
+}
+
+/**
+ * Compare many small entropy requests sent to a running entropy server one per round trip
+ * with the same requests pipelined in batches using protocol version 2.
+ *
+ * @param[in] socket_path Unix domain socket of the entropy server
+ *
+ * @return true for successful operation
+ */
+static bool run_server_benchmark(const string &socket_path) {
+	const int num_requests = 100000;
+	cout << "-------------------------------------------------------------------------------" << endl;
+	cout << "-------- TectroLabs - alperftest - entropy server performance test ------------" << endl;
+	cout << "-------------------------------------------------------------------------------" << endl;
+
+	int fd = connect_server(socket_path);
+	if (fd < 0) {
+		return false;
+	}
+	unsigned char major_version;
+	unsigned char minor_version;
+	if (!send_server_request(fd, 7, 1, &major_version) || !send_server_request(fd, 6, 1, &minor_version)) {
+		cerr << "Could not retrieve the server version" << endl;
+		close(fd);
+		return false;
+	}
+	cout << "Server " << socket_path << " version: " << (int)major_version << "." << (int)minor_version
+			<< ", " << num_requests << " requests of 32 bytes per test" << endl;
+	bool status = measure_sequential_requests(fd, num_requests);
+	close(fd);
+	if (!status) {
+		return false;
+	}
+	if (major_version != 1 || minor_version < 6) {
+		cout << "The server does not support pipelined requests" << endl;
+		return true;
+	}
+
+	const int batch_sizes[] = {1, 8, 32, 128};
+	for (int batch_size : batch_sizes) {
+		fd = connect_server(socket_path);
+		unsigned char protocol_version = 0;
+		status = fd >= 0 && send_server_request(fd, 13, 1, &protocol_version) && protocol_version == 2
+				&& measure_pipelined_requests(fd, num_requests, batch_size);
+		if (fd >= 0) {
+			close(fd);
+		}
+		if (!status) {
+			cerr << "Pipelined requests failed" << endl;
+			return false;
+		}
+	}
+
+	cout << "Latency of 32 byte requests from one client while others pull 100000 byte replies:" << endl;
+	if (!measure_small_request_latency(socket_path, 0, false)
+			|| !measure_small_request_latency(socket_path, 4, false)
+			|| !measure_small_request_latency(socket_path, 4, true)) {
+		return false;
+	}
+
+	cout << "Latency of 4096 byte requests from clients sending bursts of 25 requests every 250 ms:" << endl;
+	if (!measure_burst_latency(socket_path, 1)
+			|| !measure_burst_latency(socket_path, 4)
+			|| !measure_burst_latency(socket_path, 16)) {
+		return false;
+	}
+
+	cout << "Small entropy requests through one shared EntropyServerClient, without and with read-ahead:" << endl;
+	const size_t read_ahead_sizes[] = {0, EntropyServerClient::c_default_read_ahead_bytes};
+	for (size_t read_ahead_bytes : read_ahead_sizes) {
+		for (size_t request_size : {4, 64}) {
+			for (int num_threads : {1, 4, 16}) {
+				if (!measure_client_library(socket_path, read_ahead_bytes, request_size, num_threads)) {
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * @param[in] socket_path Unix domain socket of the entropy server
+ *
+ * @return connected socket or -1 when failed
+ */
+static int connect_server(const string &socket_path) {
+	sockaddr_un addr {};
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0 || connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+		cerr << "Could not connect to " << socket_path << ", error code: " << errno << endl;
+		if (fd >= 0) {
+			close(fd);
+		}
+		return -1;
+	}
+	return fd;
+}
+
+static bool send_bytes(int fd, const void *in, size_t size) {
+	const char *p = (const char*)in;
+	while (size > 0) {
+		ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+		if (n <= 0) {
+			return false;
+		}
+		p += n;
+		size -= n;
+	}
+	return true;
+}
+
+static bool receive_bytes(int fd, void *out, size_t size) {
+	char *p = (char*)out;
+	while (size > 0) {
+		ssize_t n = recv(fd, p, size, 0);
+		if (n <= 0) {
+			return false;
+		}
+		p += n;
+		size -= n;
+	}
+	return true;
+}
+
+/**
+ * Send one protocol version 1 request and wait for the reply
+ *
+ * @param[in] fd connected socket
+ * @param[in] cmd command id
+ * @param[in] size amount of bytes requested
+ * @param[out] out location for the reply
+ *
+ * @return true for successful operation
+ */
+static bool send_server_request(int fd, uint32_t cmd, uint32_t size, unsigned char *out) {
+	uint32_t request[2] = {cmd, size};
+	return send_bytes(fd, request, sizeof(request)) && receive_bytes(fd, out, size);
+}
+
+/**
+ * @param[in] fd connected socket using protocol version 1
+ * @param[in] num_requests amount of entropy requests
+ *
+ * @return true for successful operation
+ */
+static bool measure_sequential_requests(int fd, int num_requests) {
+	unsigned char buffer[32];
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	for (int i = 0; i < num_requests; i++) {
+		if (!send_server_request(fd, 0, sizeof(buffer), buffer)) {
+			cerr << "Entropy request failed" << endl;
+			return false;
+		}
+	}
+	double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	cout << "One request per round trip ......... " << std::fixed << std::setprecision(0) << std::setw(9)
+			<< num_requests / secs << " requests/sec, mean latency: " << std::setprecision(1) << std::setw(7)
+			<< secs / num_requests * 1e6 << " us" << endl;
+	return true;
+}
+
+/**
+ * Send the requests in batches and keep up to two batches outstanding, replies are read as they arrive
+ *
+ * @param[in] fd connected socket using protocol version 2
+ * @param[in] num_requests amount of entropy requests
+ * @param[in] batch_size amount of requests sent in one message
+ *
+ * @return true for successful operation
+ */
+static bool measure_pipelined_requests(int fd, int num_requests, int batch_size) {
+	const uint32_t request_size = 32;
+	const size_t reply_size = 3 * sizeof(uint32_t) + request_size;
+	vector<uint32_t> batch(3 * batch_size);
+	vector<unsigned char> replies(2 * (batch_size + 1) * reply_size);
+	size_t level = 0;
+	int sent = 0;
+	int received = 0;
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	while (received < num_requests) {
+		while (sent < num_requests && sent - received <= batch_size) {
+			int count = min(batch_size, num_requests - sent);
+			for (int i = 0; i < count; i++) {
+				batch[3 * i] = (uint32_t)(sent + i);
+				batch[3 * i + 1] = 0;
+				batch[3 * i + 2] = request_size;
+			}
+			if (!send_bytes(fd, batch.data(), count * 3 * sizeof(uint32_t))) {
+				return false;
+			}
+			sent += count;
+		}
+		ssize_t n = recv(fd, replies.data() + level, replies.size() - level, 0);
+		if (n <= 0) {
+			return false;
+		}
+		level += n;
+		size_t offset = 0;
+		for (; level - offset >= reply_size; offset += reply_size) {
+			uint32_t header[3];
+			memcpy(header, replies.data() + offset, sizeof(header));
+			if (header[1] != 0 || header[2] != request_size) {
+				return false;
+			}
+			received++;
+		}
+		level -= offset;
+		memmove(replies.data(), replies.data() + offset, level);
+	}
+	double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	cout << "Pipelined, " << std::setw(3) << batch_size << " request(s) per batch .. " << std::fixed
+			<< std::setprecision(0) << std::setw(9) << num_requests / secs << " requests/sec" << endl;
+	return true;
+}
+
+/**
+ * Measure the latency of small entropy requests sent once per millisecond while bulk clients saturate the device
+ *
+ * @param[in] socket_path Unix domain socket of the entropy server
+ * @param[in] num_bulk_clients amount of clients continuously requesting large amounts of bytes
+ * @param[in] is_prioritized true to put the bulk clients into the bulk and the small client into the high priority class
+ *
+ * @return true for successful operation
+ */
+static bool measure_small_request_latency(const string &socket_path, int num_bulk_clients, bool is_prioritized) {
+	const int num_requests = 2000;
+	atomic<bool> is_stopping {false};
+	vector<thread> bulk_clients;
+	for (int i = 0; i < num_bulk_clients; i++) {
+		bulk_clients.push_back(thread([&socket_path, &is_stopping, is_prioritized] {
+			vector<unsigned char> buffer(100000);
+			int fd = connect_server(socket_path);
+			if (fd < 0 || (is_prioritized && !send_server_request(fd, 16, 1, buffer.data()))) {
+				is_stopping.store(true);
+			}
+			while (!is_stopping.load() && send_server_request(fd, 0, (uint32_t)buffer.size(), buffer.data())) {
+			}
+			if (fd >= 0) {
+				close(fd);
+			}
+		}));
+	}
+
+	vector<double> latencies;
+	unsigned char buffer[32];
+	int fd = connect_server(socket_path);
+	bool status = fd >= 0 && (!is_prioritized || send_server_request(fd, 14, 1, buffer));
+	// Let the bulk clients fill the server queues first
+	this_thread::sleep_for(chrono::milliseconds(200));
+	for (int i = 0; status && i < num_requests; i++) {
+		chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+		status = send_server_request(fd, 0, sizeof(buffer), buffer);
+		latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count());
+		this_thread::sleep_for(chrono::milliseconds(1));
+	}
+	if (fd >= 0) {
+		close(fd);
+	}
+	is_stopping.store(true);
+	for (thread &bulk_client : bulk_clients) {
+		bulk_client.join();
+	}
+	if (!status) {
+		cerr << "Small requests failed" << endl;
+		return false;
+	}
+
+	sort(latencies.begin(), latencies.end());
+	cout << std::setw(2) << num_bulk_clients << " bulk client(s)" << (is_prioritized ? ", prioritized" : "            ")
+			<< " ...... p50: " << std::fixed << std::setprecision(1) << std::setw(8) << latencies[num_requests / 2]
+			<< " us, p99: " << std::setw(8) << latencies[num_requests * 99 / 100] << " us" << endl;
+	return true;
+}
+
+/**
+ * Measure the latency of entropy requests arriving in bursts from all clients at once, with idle periods
+ * in between. Requests are served from the server cache as long as a burst does not drain it.
+ *
+ * @param[in] socket_path Unix domain socket of the entropy server
+ * @param[in] num_clients amount of clients sending bursts at the same time
+ *
+ * @return true for successful operation
+ */
+static bool measure_burst_latency(const string &socket_path, int num_clients) {
+	const int num_bursts = 12;
+	const int burst_size = 25;
+	atomic<bool> is_failed {false};
+	vector<vector<double>> client_latencies(num_clients);
+	vector<thread> clients;
+	const chrono::steady_clock::time_point start = chrono::steady_clock::now() + chrono::milliseconds(100);
+	for (int i = 0; i < num_clients; i++) {
+		clients.push_back(thread([&socket_path, &is_failed, &start, &client_latencies, i] {
+			vector<double> &latencies = client_latencies[i];
+			unsigned char buffer[4096];
+			int fd = connect_server(socket_path);
+			if (fd < 0) {
+				is_failed.store(true);
+				return;
+			}
+			for (int burst = 0; burst < num_bursts && !is_failed.load(); burst++) {
+				this_thread::sleep_until(start + chrono::milliseconds(250) * burst);
+				for (int r = 0; r < burst_size; r++) {
+					chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+					if (!send_server_request(fd, 0, sizeof(buffer), buffer)) {
+						is_failed.store(true);
+						break;
+					}
+					latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count());
+				}
+			}
+			close(fd);
+		}));
+	}
+	for (thread &client : clients) {
+		client.join();
+	}
+	if (is_failed.load()) {
+		cerr << "Burst requests failed" << endl;
+		return false;
+	}
+
+	vector<double> latencies;
+	for (const vector<double> &client : client_latencies) {
+		latencies.insert(latencies.end(), client.begin(), client.end());
+	}
+	sort(latencies.begin(), latencies.end());
+	const size_t count = latencies.size();
+	cout << std::setw(2) << num_clients << " client(s), " << std::setw(7) << num_clients * burst_size * 4096 / 1024
+			<< " KB per burst ...... p50: " << std::fixed << std::setprecision(1) << std::setw(8) << latencies[count / 2]
+			<< " us, p99: " << std::setw(8) << latencies[count * 99 / 100] << " us, max: " << std::setw(8)
+			<< latencies.back() << " us" << endl;
+	return true;
+}
+
+/**
+ * Measure the TCP clients of an entropy server: encrypted request round trips, pipelined requests,
+ * bulk throughput and many concurrent connections
+ *
+ * @param[in] endpoint ADDRESS:PORT of the entropy server
+ * @param[in] psk_file_name file with the pre-shared key of the server
+ *
+ * @return true for successful operation
+ */
+static bool run_tcp_benchmark(const string &endpoint, const string &psk_file_name) {
+	cout << "-------------------------------------------------------------------------------" << endl;
+	cout << "-------- TectroLabs - alperftest - entropy server TCP performance test --------" << endl;
+	cout << "-------------------------------------------------------------------------------" << endl;
+
+	unsigned char psk[PskChannel::c_psk_size_bytes];
+	string error;
+	if (!PskChannel::read_psk_file(psk_file_name, psk, &error)) {
+		cerr << error << endl;
+		return false;
+	}
+	const size_t separator = endpoint.rfind(':');
+	sockaddr_in addr {};
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons((uint16_t)atoi(endpoint.substr(separator + 1).c_str()));
+	if (separator == string::npos || inet_pton(AF_INET, endpoint.substr(0, separator).c_str(), &addr.sin_addr) != 1) {
+		cerr << "Invalid endpoint " << endpoint << ", expected IPv4 ADDRESS:PORT" << endl;
+		return false;
+	}
+
+	TcpConnection connection;
+	if (!connect_tcp_server(addr, psk, &connection)) {
+		return false;
+	}
+	cout << "Server " << endpoint << ", requests of 32 bytes unless stated otherwise" << endl;
+	bool status = measure_tcp_requests(&connection, 20000, 32) && measure_tcp_requests(&connection, 200, 100000);
+	close(connection.fd);
+	if (!status) {
+		cerr << "Entropy request failed" << endl;
+		return false;
 	}
-	ds.download_speed_kbsec = (int) (num_bytes / (int64_t) 1024 / ds.total_time);
+
+	const int batch_sizes[] = {8, 32, 128};
+	for (int batch_size : batch_sizes) {
+		TcpConnection pipelined;
+		unsigned char protocol_version = 0;
+		uint32_t request[2] = {13, 1};
+		status = connect_tcp_server(addr, psk, &pipelined) && send_tcp_bytes(&pipelined, request, sizeof(request))
+				&& receive_tcp_bytes(&pipelined, &protocol_version, 1) && protocol_version == 2
+				&& measure_tcp_pipelined_requests(&pipelined, 100000, batch_size);
+		if (pipelined.fd >= 0) {
+			close(pipelined.fd);
+		}
+		if (!status) {
+			cerr << "Pipelined requests failed" << endl;
+			return false;
+		}
+	}
+
+	// Each connection uses a descriptor
+	rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+	return measure_tcp_connections(addr, psk, 100) && measure_tcp_connections(addr, psk, 1000)
+			&& measure_tcp_connections(addr, psk, 3000);
+}
+
+/**
+ * Connect to the server and exchange the hellos
+ *
+ * @param[in] addr server address
+ * @param[in] psk pre-shared key
+ * @param[out] connection established connection
+ *
+ * @return true for successful operation
+ */
+static bool connect_tcp_server(const sockaddr_in &addr, const unsigned char *psk, TcpConnection *connection) {
+	connection->fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (connection->fd < 0 || connect(connection->fd, (const sockaddr*)&addr, sizeof(addr)) < 0) {
+		cerr << "Could not connect to the server, error code: " << errno << endl;
+		return false;
+	}
+	int no_delay = 1;
+	setsockopt(connection->fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+	connection->channel.reset(new PskChannel(psk, false));
+	connection->rx.resize(2 * (PskChannel::c_max_payload_bytes + PskChannel::c_frame_overhead_bytes));
+	unsigned char hello[PskChannel::c_hello_size_bytes];
+	if (!connection->channel->create_hello(hello) || !send_bytes(connection->fd, hello, sizeof(hello))
+			|| !receive_bytes(connection->fd, hello, sizeof(hello)) || !connection->channel->accept_hello(hello)) {
+		cerr << "Could not establish the channel: " << connection->channel->get_last_error() << endl;
+		return false;
+	}
+	return true;
 }
 
+/**
+ * @param[in] connection established connection
+ * @param[in] in request bytes
+ * @param[in] size amount of request bytes, one frame carries up to 4096 bytes of requests
+ *
+ * @return true for successful operation
+ */
+static bool send_tcp_bytes(TcpConnection *connection, const void *in, uint32_t size) {
+	unsigned char frame[4096 + PskChannel::c_frame_overhead_bytes];
+	return size <= 4096 && connection->channel->seal((const unsigned char*)in, size, frame)
+			&& send_bytes(connection->fd, frame, size + PskChannel::c_frame_overhead_bytes);
+}
+
+/**
+ * Receive reply bytes, decrypting the frames as they arrive
+ *
+ * @param[in] connection established connection
+ * @param[out] out location for the reply bytes
+ * @param[in] size amount of reply bytes
+ *
+ * @return true for successful operation
+ */
+static bool receive_tcp_bytes(TcpConnection *connection, void *out, size_t size) {
+	unsigned char *p = (unsigned char*)out;
+	while (size > 0) {
+		if (connection->payload_offset < connection->payload.size()) {
+			const size_t count = min(size, connection->payload.size() - connection->payload_offset);
+			memcpy(p, connection->payload.data() + connection->payload_offset, count);
+			connection->payload_offset += count;
+			p += count;
+			size -= count;
+			continue;
+		}
+		if (connection->rx_level >= (size_t)PskChannel::c_header_size_bytes) {
+			const uint32_t payload_size = PskChannel::get_payload_size(connection->rx.data());
+			if (payload_size == 0) {
+				return false;
+			}
+			const size_t frame_size = payload_size + PskChannel::c_frame_overhead_bytes;
+			if (connection->rx_level >= frame_size) {
+				connection->payload.resize(payload_size);
+				connection->payload_offset = 0;
+				if (!connection->channel->open(connection->rx.data(), connection->payload.data())) {
+					return false;
+				}
+				connection->rx_level -= frame_size;
+				memmove(connection->rx.data(), connection->rx.data() + frame_size, connection->rx_level);
+				continue;
+			}
+		}
+		ssize_t n = recv(connection->fd, connection->rx.data() + connection->rx_level,
+				connection->rx.size() - connection->rx_level, 0);
+		if (n <= 0) {
+			return false;
+		}
+		connection->rx_level += n;
+	}
+	return true;
+}
+
+/**
+ * @param[in] connection established connection using protocol version 1
+ * @param[in] num_requests amount of entropy requests
+ * @param[in] request_size amount of bytes per request
+ *
+ * @return true for successful operation
+ */
+static bool measure_tcp_requests(TcpConnection *connection, int num_requests, uint32_t request_size) {
+	vector<unsigned char> buffer(request_size);
+	uint32_t request[2] = {0, request_size};
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	for (int i = 0; i < num_requests; i++) {
+		if (!send_tcp_bytes(connection, request, sizeof(request)) || !receive_tcp_bytes(connection, buffer.data(), request_size)) {
+			return false;
+		}
+	}
+	double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	cout << "One request of " << std::setw(6) << request_size << " bytes per round trip " << std::fixed
+			<< std::setprecision(0) << std::setw(9) << num_requests / secs << " requests/sec, " << std::setprecision(2)
+			<< std::setw(8) << num_requests * (double)request_size / secs / 1048576 << " MB/sec" << endl;
+	return true;
+}
+
+/**
+ * Send the requests in batches and keep up to two batches outstanding
+ *
+ * @param[in] connection established connection using protocol version 2
+ * @param[in] num_requests amount of entropy requests
+ * @param[in] batch_size amount of requests sent in one frame
+ *
+ * @return true for successful operation
+ */
+static bool measure_tcp_pipelined_requests(TcpConnection *connection, int num_requests, int batch_size) {
+	const uint32_t request_size = 32;
+	vector<uint32_t> batch(3 * batch_size);
+	unsigned char reply[3 * sizeof(uint32_t) + request_size];
+	int sent = 0;
+	int received = 0;
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	while (received < num_requests) {
+		while (sent < num_requests && sent - received <= batch_size) {
+			int count = min(batch_size, num_requests - sent);
+			for (int i = 0; i < count; i++) {
+				batch[3 * i] = (uint32_t)(sent + i);
+				batch[3 * i + 1] = 0;
+				batch[3 * i + 2] = request_size;
+			}
+			if (!send_tcp_bytes(connection, batch.data(), count * 3 * sizeof(uint32_t))) {
+				return false;
+			}
+			sent += count;
+		}
+		if (!receive_tcp_bytes(connection, reply, sizeof(reply))) {
+			return false;
+		}
+		uint32_t header[3];
+		memcpy(header, reply, sizeof(header));
+		if (header[1] != 0 || header[2] != request_size) {
+			return false;
+		}
+		received++;
+	}
+	double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	cout << "Pipelined, " << std::setw(3) << batch_size << " request(s) per frame ...... " << std::fixed
+			<< std::setprecision(0) << std::setw(9) << num_requests / secs << " requests/sec" << endl;
+	return true;
+}
+
+/**
+ * Open many connections at once, then send one request on each of them and collect the replies
+ *
+ * @param[in] addr server address
+ * @param[in] psk pre-shared key
+ * @param[in] num_connections amount of concurrent connections
+ *
+ * @return true for successful operation
+ */
+static bool measure_tcp_connections(const sockaddr_in &addr, const unsigned char *psk, int num_connections) {
+	vector<TcpConnection> connections(num_connections);
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	int connected = 0;
+	while (connected < num_connections && connect_tcp_server(addr, psk, &connections[connected])) {
+		connected++;
+	}
+	chrono::steady_clock::time_point connected_time = chrono::steady_clock::now();
+	uint32_t request[2] = {0, 32};
+	unsigned char buffer[32];
+	bool status = connected == num_connections;
+	for (int i = 0; status && i < connected; i++) {
+		status = send_tcp_bytes(&connections[i], request, sizeof(request));
+	}
+	for (int i = 0; status && i < connected; i++) {
+		status = receive_tcp_bytes(&connections[i], buffer, sizeof(buffer));
+	}
+	double request_secs = chrono::duration<double>(chrono::steady_clock::now() - connected_time).count();
+	double connect_secs = chrono::duration<double>(connected_time - begin).count();
+	for (TcpConnection &connection : connections) {
+		if (connection.fd >= 0) {
+			close(connection.fd);
+		}
+	}
+	if (!status) {
+		cerr << "Served " << connected << " of " << num_connections << " concurrent connections, check the -i option of the server" << endl;
+		return false;
+	}
+	cout << std::setw(5) << num_connections << " concurrent connections ....... " << std::fixed << std::setprecision(0)
+			<< std::setw(9) << num_connections / connect_secs << " handshakes/sec, one request each in "
+			<< std::setprecision(1) << request_secs * 1e3 << " ms" << endl;
+	return true;
+}
+
+/**
+ * Measure entropy requests of many threads sharing one EntropyServerClient
+ *
+ * @param[in] socket_path Unix domain socket of the entropy server
+ * @param[in] read_ahead_bytes size of the client read-ahead buffer
+ * @param[in] request_size amount of bytes per request
+ * @param[in] num_threads amount of threads using the client
+ *
+ * @return true for successful operation
+ */
+static bool measure_client_library(const string &socket_path, size_t read_ahead_bytes, size_t request_size, int num_threads) {
+	const int num_requests = read_ahead_bytes > 0 ? 200000 : 20000;
+	EntropyServerClient client(socket_path, read_ahead_bytes);
+	if (!client.connect()) {
+		cerr << client.get_last_error();
+		return false;
+	}
+	atomic<bool> is_ok(true);
+	vector<thread> threads;
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	for (int i = 0; i < num_threads; i++) {
+		threads.push_back(thread([&client, &is_ok, request_size, num_requests, num_threads]() {
+			unsigned char buffer[64];
+			for (int r = 0; r < num_requests / num_threads && is_ok; r++) {
+				if (!client.get_entropy(buffer, request_size)) {
+					is_ok = false;
+				}
+			}
+		}));
+	}
+	for (thread &t : threads) {
+		t.join();
+	}
+	double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	if (!is_ok) {
+		cerr << "Entropy request failed: " << client.get_last_error();
+		return false;
+	}
+	cout << "Read-ahead " << std::setw(5) << read_ahead_bytes << " bytes, " << std::setw(2) << request_size << " bytes, "
+			<< std::setw(2) << num_threads << " thread(s) ..... " << std::fixed << std::setprecision(0) << std::setw(9)
+			<< num_requests / secs << " requests/sec, mean latency: " << std::setprecision(2) << std::setw(7)
+			<< secs * num_threads / num_requests * 1e6 << " us" << endl;
+	return true;
+}
+
+/**
+ * Compare small alrng_get_entropy() calls of 1 to 32 threads sharing one C API context,
+ * serialized by a caller lock and served by thread caches.
+ *
+ * @param[in] device_num device number
+ *
+ * @return true for successful operation
+ */
+static bool run_thread_cache_benchmark(int device_num) {
+	alrng_context *ctxt = alrng_create_default_ctxt();
+	if (ctxt == nullptr) {
+		cerr << "Could not create a context" << endl;
+		return false;
+	}
+	if (alrng_connect(ctxt, device_num) != 0) {
+		char msg[256];
+		alrng_get_last_error(ctxt, msg, sizeof(msg));
+		cerr << "Could not reach device: " << msg << endl;
+		alrng_destroy_ctxt(ctxt);
+		return false;
+	}
+	cout << "-------------------------------------------------------------------------------" << endl;
+	cout << "------ TectroLabs - alperftest - C API thread cache performance test ----------" << endl;
+	cout << "-------------------------------------------------------------------------------" << endl;
+	cout << "Thread cache size: " << ALRNG_DEFAULT_THREAD_CACHE_BYTES << " bytes, CPUs: " << thread::hardware_concurrency() << endl;
+	bool status = true;
+	for (bool is_cached : {false, true}) {
+		if (alrng_set_thread_cache(ctxt, is_cached ? ALRNG_DEFAULT_THREAD_CACHE_BYTES : 0) != 0) {
+			status = false;
+			break;
+		}
+		for (int request_size : {4, 16, 64}) {
+			for (int num_threads : {1, 2, 4, 8, 16, 32}) {
+				status = status && measure_c_entropy_calls(ctxt, is_cached, request_size, num_threads);
+			}
+		}
+	}
+	alrng_destroy_ctxt(ctxt);
+	return status;
+}
+
+/**
+ * Measure alrng_get_entropy() calls of many threads sharing one context for about half a second
+ *
+ * @param[in] ctxt connected context
+ * @param[in] is_cached true when the context is in thread cache mode, otherwise calls are serialized by a lock
+ * @param[in] request_size amount of bytes per call
+ * @param[in] num_threads amount of threads calling
+ *
+ * @return true for successful operation
+ */
+static bool measure_c_entropy_calls(alrng_context *ctxt, bool is_cached, int request_size, int num_threads) {
+	const chrono::steady_clock::duration duration = chrono::milliseconds(500);
+	mutex caller_mtx;
+	atomic<bool> is_ok(true);
+	atomic<int64_t> num_calls(0);
+	vector<thread> threads;
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	for (int i = 0; i < num_threads; i++) {
+		threads.push_back(thread([&, begin]() {
+			unsigned char buffer[64];
+			int64_t calls = 0;
+			while (is_ok && chrono::steady_clock::now() - begin < duration) {
+				for (int r = 0; r < 64 && is_ok; r++, calls++) {
+					int ret;
+					if (is_cached) {
+						ret = alrng_get_entropy(ctxt, buffer, request_size);
+					} else {
+						lock_guard<mutex> lock(caller_mtx);
+						ret = alrng_get_entropy(ctxt, buffer, request_size);
+					}
+					if (ret != 0) {
+						is_ok = false;
+					}
+				}
+			}
+			num_calls += calls;
+		}));
+	}
+	for (thread &t : threads) {
+		t.join();
+	}
+	double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	if (!is_ok) {
+		char msg[256];
+		alrng_get_last_error(ctxt, msg, sizeof(msg));
+		cerr << "Entropy request failed: " << msg << endl;
+		return false;
+	}
+	cout << (is_cached ? "Thread cache" : "Caller lock ") << ", " << std::setw(2) << request_size << " bytes, "
+			<< std::setw(2) << num_threads << " thread(s) ..... " << std::fixed << std::setprecision(0) << std::setw(10)
+			<< num_calls / secs << " calls/sec, " << std::setprecision(2) << std::setw(8)
+			<< num_calls * request_size / secs / 1048576 << " MB/sec" << endl;
+	return true;
+}
+
+/**
+ * A random range sequence fed by the OpenSSL generator, for measuring the algorithm without a device
+ */
+class BenchmarkRangeSequence : public tl_algorithm::RandomRangeSequence {
+public:
+	BenchmarkRangeSequence(int32_t min_limit, int32_t max_limit) : RandomRangeSequence(min_limit, max_limit) {}
+	bool get_entropy(int32_t *dest, const uint32_t size) override {
+		return RAND_bytes((unsigned char*)dest, (int)(size * sizeof(int32_t))) == 1;
+	}
+};
+
+/**
+ * A random range permutation keyed by the OpenSSL generator, for measuring the algorithm without a device
+ */
+class BenchmarkRangePermutation : public tl_algorithm::RandomRangePermutation {
+public:
+	BenchmarkRangePermutation(int32_t min_limit, int32_t max_limit) : RandomRangePermutation(min_limit, max_limit) {}
+	bool get_entropy(int32_t *dest, const uint32_t size) override {
+		return RAND_bytes((unsigned char*)dest, (int)(size * sizeof(int32_t))) == 1;
+	}
+};
+
+/**
+ * Compare full permutations of 10^3 to max_size numbers generated by the partial Fisher-Yates shuffle
+ * with the round based algorithm previously used by RandomRangeSequence and with the constant memory
+ * stream of RandomRangePermutation. Sizes that do not fit in the available memory are skipped,
+ * except for the stream.
+ *
+ * @param[in] max_size largest sequence size, up to 10^9
+ *
+ * @return true for successful operation
+ */
+static bool run_sequence_benchmark(uint64_t max_size) {
+	cout << "-------------------------------------------------------------------------------" << endl;
+	cout << "------ TectroLabs - alperftest - random range sequence performance test -------" << endl;
+	cout << "-------------------------------------------------------------------------------" << endl;
+	const uint64_t available_bytes = (uint64_t)sysconf(_SC_AVPHYS_PAGES) * (uint64_t)sysconf(_SC_PAGESIZE);
+	for (uint64_t size = 1000; size <= max_size && size <= 1000000000ULL; size *= 10) {
+		cout << "n = " << std::setw(10) << size << " ......";
+		// Destination plus the number buffer, the round based algorithm uses three buffers
+		const uint64_t shuffle_bytes = size * 8;
+		const uint64_t rounds_bytes = size * 16;
+		vector<int32_t> dest;
+		if (shuffle_bytes < available_bytes) {
+			dest.resize(size);
+			BenchmarkRangeSequence seq(1, (int32_t)size);
+			chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+			if (!seq.generate_sequence(dest.data(), (uint32_t)size)) {
+				cerr << seq.get_last_err_msg();
+				return false;
+			}
+			double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+			cout << " shuffle: " << std::fixed << std::setprecision(3) << std::setw(8) << secs << " s, "
+					<< std::setprecision(1) << std::setw(5) << seq.get_entropy_bytes_used() * 8.0 / size << " bits/number";
+		} else {
+			cout << " shuffle: skipped, needs " << shuffle_bytes / 1048576 << " MB";
+		}
+		if (rounds_bytes < available_bytes) {
+			dest.resize(size);
+			uint64_t entropy_bytes = 0;
+			chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+			if (!generate_sequence_by_rounds(dest.data(), (uint32_t)size, &entropy_bytes)) {
+				cerr << endl << "Could not generate the sequence by rounds" << endl;
+				return false;
+			}
+			double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+			cout << ", rounds: " << std::fixed << std::setprecision(3) << std::setw(8) << secs << " s, "
+					<< std::setprecision(1) << std::setw(5) << entropy_bytes * 8.0 / size << " bits/number";
+		} else {
+			cout << ", rounds: skipped, needs " << rounds_bytes / 1048576 << " MB";
+		}
+		dest.clear();
+		dest.shrink_to_fit();
+		double secs;
+		if (!stream_permutation(size, &secs)) {
+			cerr << endl << "Could not stream the permutation" << endl;
+			return false;
+		}
+		cout << ", stream: " << std::fixed << std::setprecision(3) << std::setw(8) << secs << " s" << endl;
+	}
+	return true;
+}
+
+/**
+ * Generate a sequence of the numbers from 1 to size with RandomRangePermutation, one chunk at a time
+ *
+ * @param[in] size amount of numbers
+ * @param[out] secs time spent generating the sequence
+ *
+ * @return true for successful operation
+ */
+static bool stream_permutation(uint64_t size, double *secs) {
+	const uint32_t chunk_size = 1000000;
+	vector<int32_t> chunk(chunk_size);
+	BenchmarkRangePermutation perm(1, (int32_t)size);
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	if (!perm.generate_key()) {
+		cerr << perm.get_last_err_msg();
+		return false;
+	}
+	for (uint64_t start_index = 0; start_index < size; start_index += chunk_size) {
+		if (!perm.generate_sequence(chunk.data(), (uint32_t)min((uint64_t)chunk_size, size - start_index), start_index)) {
+			cerr << perm.get_last_err_msg();
+			return false;
+		}
+	}
+	*secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	return true;
+}
+
+/**
+ * The round based algorithm previously used by RandomRangeSequence, kept as a reference: each round draws
+ * `size` random indexes modulo the amount of numbers left, takes the numbers not taken yet and compacts the rest.
+ *
+ * @param[out] dest location for the sequence of numbers from 1 to size
+ * @param[in] size amount of numbers
+ * @param[out] entropy_bytes amount of random bytes used
+ *
+ * @return true for successful operation
+ */
+static bool generate_sequence_by_rounds(int32_t *dest, uint32_t size, uint64_t *entropy_bytes) {
+	vector<int32_t> numbers(size);
+	vector<int32_t> other_numbers(size);
+	vector<int32_t> random_indexes(size);
+	for (uint32_t i = 0; i < size; i++) {
+		numbers[i] = i + 1;
+	}
+	uint32_t numbers_size = size;
+	uint32_t dest_idx = 0;
+	*entropy_bytes = 0;
+	while (numbers_size > 0 && dest_idx < size) {
+		if (RAND_bytes((unsigned char*)random_indexes.data(), (int)(size * sizeof(int32_t))) != 1) {
+			return false;
+		}
+		*entropy_bytes += (uint64_t)size * sizeof(int32_t);
+		for (uint32_t i = 0; i < size && dest_idx < size; i++) {
+			uint32_t idx = (uint32_t)random_indexes[i] % numbers_size;
+			if (numbers[idx] != -1) {
+				dest[dest_idx++] = numbers[idx];
+				numbers[idx] = -1;
+			}
+		}
+		uint32_t new_numbers_size = 0;
+		for (uint32_t i = 0; i < numbers_size; i++) {
+			if (numbers[i] != -1) {
+				other_numbers[new_numbers_size++] = numbers[i];
+			}
+		}
+		numbers_size = new_numbers_size;
+		numbers.swap(other_numbers);
+	}
+	return true;
+}
+
+/**
+ * Compare the CPU cost of delivering buffered entropy bytes to socket readers:
+ * copying them into a staging buffer before send() as the entropy server did, sending them straight
+ * from the buffer with sendmsg(), and gifting freshly filled pages to a pipe with vmsplice() and
+ * splicing them into the socket. Buffers are refilled before each delivery like the device cache is.
+ *
+ * @return true for successful operation
+ */
+static bool run_copy_benchmark() {
+	cout << "-------------------------------------------------------------------------------" << endl;
+	cout << "-------- TectroLabs - alperftest - buffer delivery benchmark ------------------" << endl;
+	cout << "-------------------------------------------------------------------------------" << endl;
+	for (int num_readers : {1, 8}) {
+		for (int method = 0; method < 3; method++) {
+			if (!measure_delivery(method, num_readers)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * @param[in] method 0 for staging copy and send(), 1 for sendmsg() from the buffer, 2 for vmsplice() and splice()
+ * @param[in] num_readers amount of reader processes served in turns
+ *
+ * @return true for successful operation
+ */
+static bool measure_delivery(int method, int num_readers) {
+	static const char * const method_names[] = {"copy + send()", "sendmsg() from buffer", "vmsplice() + splice()"};
+	const size_t chunk_size = 65536;
+	const size_t total_bytes = (size_t)1 << 30;
+	vector<int> fds;
+	vector<pid_t> readers;
+	for (int i = 0; i < num_readers; i++) {
+		int sv[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) < 0) {
+			cerr << "Could not create a socket pair, error code: " << errno << endl;
+			return false;
+		}
+		pid_t pid = fork();
+		if (pid == 0) {
+			close(sv[0]);
+			vector<unsigned char> buffer(chunk_size);
+			while (recv(sv[1], buffer.data(), buffer.size(), 0) > 0) {
+			}
+			_exit(0);
+		}
+		close(sv[1]);
+		fds.push_back(sv[0]);
+		readers.push_back(pid);
+	}
+	int pipe_fds[2] = {-1, -1};
+	if (method == 2 && (pipe2(pipe_fds, O_CLOEXEC) < 0 || fcntl(pipe_fds[1], F_SETPIPE_SZ, (int)chunk_size) < 0)) {
+		cerr << "Could not create a pipe, error code: " << errno << endl;
+		return false;
+	}
+
+	vector<unsigned char> cache(chunk_size);
+	vector<unsigned char> staging(chunk_size);
+	rusage usage_begin;
+	getrusage(RUSAGE_SELF, &usage_begin);
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	bool status = true;
+	for (size_t sent = 0, turn = 0; status && sent < total_bytes; sent += chunk_size, turn++) {
+		const int fd = fds[turn % fds.size()];
+		if (method == 0) {
+			memset(cache.data(), (int)turn, chunk_size);
+			memcpy(staging.data(), cache.data(), chunk_size);
+			status = send_bytes(fd, staging.data(), chunk_size);
+		} else if (method == 1) {
+			memset(cache.data(), (int)turn, chunk_size);
+			iovec iov {cache.data(), chunk_size};
+			msghdr msg {};
+			msg.msg_iov = &iov;
+			msg.msg_iovlen = 1;
+			for (ssize_t n = 0; status && iov.iov_len > 0; iov.iov_base = (unsigned char*)iov.iov_base + n, iov.iov_len -= n) {
+				n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+				status = n > 0;
+			}
+		} else {
+			// Pages referenced by the pipe must not be reused, every chunk is filled into new pages
+			void *pages = mmap(nullptr, chunk_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			status = pages != MAP_FAILED;
+			if (status) {
+				memset(pages, (int)turn, chunk_size);
+				iovec iov {pages, chunk_size};
+				for (ssize_t n = 0; status && iov.iov_len > 0; iov.iov_base = (unsigned char*)iov.iov_base + n, iov.iov_len -= n) {
+					n = vmsplice(pipe_fds[1], &iov, 1, SPLICE_F_GIFT);
+					status = n > 0;
+				}
+				for (size_t left = chunk_size; status && left > 0; ) {
+					ssize_t n = splice(pipe_fds[0], nullptr, fd, nullptr, left, SPLICE_F_MOVE);
+					status = n > 0;
+					left -= status ? n : 0;
+				}
+				munmap(pages, chunk_size);
+			}
+		}
+	}
+	double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	rusage usage_end;
+	getrusage(RUSAGE_SELF, &usage_end);
+	double cpu_secs = (usage_end.ru_utime.tv_sec - usage_begin.ru_utime.tv_sec) + (usage_end.ru_stime.tv_sec - usage_begin.ru_stime.tv_sec)
+			+ ((usage_end.ru_utime.tv_usec - usage_begin.ru_utime.tv_usec) + (usage_end.ru_stime.tv_usec - usage_begin.ru_stime.tv_usec)) / 1e6;
+
+	for (int fd : fds) {
+		close(fd);
+	}
+	for (pid_t pid : readers) {
+		waitpid(pid, nullptr, 0);
+	}
+	if (pipe_fds[0] >= 0) {
+		close(pipe_fds[0]);
+		close(pipe_fds[1]);
+	}
+	if (!status) {
+		cerr << "Delivery with " << method_names[method] << " failed, error code: " << errno << endl;
+		return false;
+	}
+	cout << std::setw(22) << std::left << method_names[method] << std::right << ", " << num_readers << " reader(s) ... "
+			<< std::fixed << std::setprecision(0) << std::setw(6) << total_bytes / secs / 1048576 << " MB/sec, sender CPU "
+			<< std::setprecision(3) << cpu_secs * 1073741824 / total_bytes << " sec/GB" << endl;
+	return true;
+}
+
+/**
+ * Compare small getrandom() and /dev/urandom read() calls with the same system calls made directly.
+ * Run it once as is and once with LD_PRELOAD=libalrng-preload.so to measure the overhead of the
+ * preload library, the system call rows are never intercepted.
+ *
+ * @return true for successful operation
+ */
+static bool run_getrandom_benchmark() {
+	cout << "-------------------------------------------------------------------------------" << endl;
+	cout << "-------- TectroLabs - alperftest - getrandom() benchmark ----------------------" << endl;
+	cout << "-------------------------------------------------------------------------------" << endl;
+	for (int num_threads : {1, 4}) {
+		for (size_t request_size : {4, 16, 64}) {
+			for (int method = 0; method < 4; method++) {
+				if (!measure_random_calls(method, request_size, num_threads)) {
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * @param[in] method 0 for the getrandom system call, 1 for getrandom(), 2 for the read system call
+ *                   on /dev/urandom and 3 for read() on /dev/urandom
+ * @param[in] request_size amount of bytes requested by each call
+ * @param[in] num_threads amount of threads making calls at the same time
+ *
+ * @return true for successful operation
+ */
+static bool measure_random_calls(int method, size_t request_size, int num_threads) {
+	static const char * const method_names[] = {"SYS_getrandom", "getrandom()", "SYS_read /dev/urandom", "read() /dev/urandom"};
+	// Device throughput rather than the call overhead would be measured with more bytes
+	const int num_calls = 200000;
+	int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		cerr << "Could not open /dev/urandom, error code: " << errno << endl;
+		return false;
+	}
+	atomic<bool> is_ok(true);
+	vector<thread> threads;
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	for (int i = 0; i < num_threads; i++) {
+		threads.push_back(thread([&is_ok, method, fd, request_size, num_calls, num_threads]() {
+			unsigned char buffer[64];
+			for (int c = 0; c < num_calls / num_threads && is_ok; c++) {
+				ssize_t n;
+				switch (method) {
+				case 0:
+					n = syscall(SYS_getrandom, buffer, request_size, 0);
+					break;
+				case 1:
+					n = getrandom(buffer, request_size, 0);
+					break;
+				case 2:
+					n = syscall(SYS_read, fd, buffer, request_size);
+					break;
+				default:
+					n = read(fd, buffer, request_size);
+				}
+				if (n != (ssize_t)request_size) {
+					is_ok = false;
+				}
+			}
+		}));
+	}
+	for (thread &t : threads) {
+		t.join();
+	}
+	double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	close(fd);
+	if (!is_ok) {
+		cerr << method_names[method] << " failed, error code: " << errno << endl;
+		return false;
+	}
+	cout << std::setw(21) << std::left << method_names[method] << std::right << ", " << std::setw(3) << request_size << " bytes, "
+			<< num_threads << " thread(s) ... " << std::fixed << std::setprecision(0) << std::setw(9) << num_calls / secs
+			<< " calls/sec, " << std::setprecision(1) << std::setw(6) << secs * num_threads / num_calls * 1e9 << " ns/call" << endl;
+	return true;
+}
+
+/**
+ * Measure RAND_bytes() and DRBG reseeds in three library contexts: with the default seed source,
+ * with ALPHARNG as the seed source and with ALPHARNG serving RAND_bytes() directly.
+ *
+ * @param[in] config_file_name OpenSSL configuration file activating the AlphaRNG provider
+ *
+ * @return true for successful operation
+ */
+static bool run_openssl_benchmark(const string &config_file_name) {
+	cout << "-------------------------------------------------------------------------------" << endl;
+	cout << "-------- TectroLabs - alperftest - OpenSSL RAND_bytes() benchmark -------------" << endl;
+	cout << "-------------------------------------------------------------------------------" << endl;
+	static const char * const labels[] = {"SEED-SRC seed", "ALPHARNG seed", "ALPHARNG DRBG"};
+	bool status = true;
+	for (int mode = 0; mode < 3 && status; mode++) {
+		OSSL_LIB_CTX *libctx = OSSL_LIB_CTX_new();
+		if (libctx == nullptr) {
+			cerr << "Could not create an OpenSSL library context" << endl;
+			return false;
+		}
+		if (mode > 0 && (!OSSL_LIB_CTX_load_config(libctx, config_file_name.c_str())
+				|| !OSSL_PROVIDER_available(libctx, "alpharng"))) {
+			cerr << "Could not load the alpharng provider with " << config_file_name << endl;
+			OSSL_LIB_CTX_free(libctx);
+			return false;
+		}
+		if (mode == 1) {
+			status = RAND_set_seed_source_type(libctx, "ALPHARNG", nullptr) == 1;
+		} else if (mode == 2) {
+			status = RAND_set_DRBG_type(libctx, "ALPHARNG", nullptr, nullptr, nullptr) == 1;
+		}
+		for (int num_threads : {1, 4}) {
+			for (size_t request_size : {16, 256, 4096}) {
+				status = status && measure_rand_bytes(libctx, labels[mode], request_size, num_threads);
+			}
+		}
+		// ALPHARNG as the DRBG has no seed to refresh
+		status = status && (mode == 2 || measure_reseeds(libctx, labels[mode]));
+		OSSL_LIB_CTX_free(libctx);
+	}
+	return status;
+}
+
+/**
+ * @param[in] libctx library context used
+ * @param[in] label name of the configuration measured
+ * @param[in] request_size amount of bytes requested by each call
+ * @param[in] num_threads amount of threads making calls at the same time for about a second
+ *
+ * @return true for successful operation
+ */
+static bool measure_rand_bytes(OSSL_LIB_CTX *libctx, const string &label, size_t request_size, int num_threads) {
+	atomic<bool> is_ok(true);
+	atomic<int64_t> num_calls(0);
+	vector<thread> threads;
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	chrono::steady_clock::time_point end = begin + chrono::seconds(1);
+	for (int i = 0; i < num_threads; i++) {
+		threads.push_back(thread([libctx, &is_ok, &num_calls, request_size, end]() {
+			unsigned char buffer[4096];
+			int64_t calls = 0;
+			while (is_ok && (calls & 63 || chrono::steady_clock::now() < end)) {
+				if (RAND_bytes_ex(libctx, buffer, request_size, 0) != 1) {
+					is_ok = false;
+				}
+				calls++;
+			}
+			num_calls += calls;
+		}));
+	}
+	for (thread &t : threads) {
+		t.join();
+	}
+	double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	if (!is_ok) {
+		cerr << "RAND_bytes() failed with " << label << endl;
+		return false;
+	}
+	cout << label << ", " << std::setw(4) << request_size << " bytes, " << num_threads << " thread(s) ... " << std::fixed
+			<< std::setprecision(0) << std::setw(9) << num_calls / secs << " calls/sec, " << std::setprecision(1) << std::setw(7)
+			<< num_calls * request_size / secs / 1048576 << " MB/sec, mean latency: " << std::setprecision(2) << std::setw(8)
+			<< secs * num_threads / num_calls * 1e6 << " us" << endl;
+	return true;
+}
+
+/**
+ * Reseed the primary DRBG with prediction resistance for about a second, each reseed pulls fresh
+ * bytes from the seed source.
+ *
+ * @param[in] libctx library context used
+ * @param[in] label name of the configuration measured
+ *
+ * @return true for successful operation
+ */
+static bool measure_reseeds(OSSL_LIB_CTX *libctx, const string &label) {
+	EVP_RAND_CTX *primary = RAND_get0_primary(libctx);
+	if (primary == nullptr) {
+		cerr << "Could not get the primary DRBG with " << label << endl;
+		return false;
+	}
+	int64_t num_reseeds = 0;
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	chrono::steady_clock::time_point end = begin + chrono::seconds(1);
+	while (num_reseeds & 63 || chrono::steady_clock::now() < end) {
+		if (EVP_RAND_reseed(primary, 1, nullptr, 0, nullptr, 0) != 1) {
+			cerr << "Reseed failed with " << label << endl;
+			return false;
+		}
+		num_reseeds++;
+	}
+	double secs = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	cout << label << ", primary DRBG reseeds ........ " << std::fixed << std::setprecision(0) << std::setw(9)
+			<< num_reseeds / secs << " reseeds/sec, mean latency: " << std::setprecision(2) << std::setw(8)
+			<< secs / num_reseeds * 1e6 << " us" << endl;
+	return true;
+}
 
+#endif
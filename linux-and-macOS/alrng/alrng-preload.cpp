@@ -0,0 +1,515 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This library may only be used in conjunction with TectroLabs devices.
+
+ This library is used for serving the random bytes that unmodified applications request from the Linux
+ kernel with getrandom(), getentropy() or by reading /dev/urandom and /dev/random, with true random bytes
+ generated by an AlphaRNG device and distributed by the entropy server.
+
+ Usage:
+     LD_PRELOAD=/usr/local/lib/libalrng-preload.so application
+
+ Environment variables:
+     ALRNG_PRELOAD_RING    name of the shared memory ring of the entropy server (for example /alpharng),
+                           when not set the entropy server is used over its Unix domain socket.
+     ALRNG_PRELOAD_SOCKET  Unix domain socket path of the entropy server (default: /run/alpharng.sock).
+     ALRNG_PRELOAD_BUFFER  size of the per-process buffer in bytes (default: 16384).
+     ALRNG_PRELOAD_SERVER_UID  user id of the entropy server when it runs neither as root nor as
+                           the user of the application.
+
+ The entropy server socket and ring are trusted only when they belong to root, to the user of the
+ application or to ALRNG_PRELOAD_SERVER_UID, checked with the peer credentials of the socket and the
+ owner of the ring. Whenever the entropy server is not available or not trusted the calls are served
+ by the kernel, another attempt to reach the server is made after one second.
+
+ */
+
+/**
+ *    @file alrng-preload.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.1
+ *
+ *    @brief A preload library routing kernel random byte requests to the entropy server.
+ */
+
+// The intercepted functions are defined here, so they must not be replaced by fortified inline wrappers
+#undef _FORTIFY_SOURCE
+
+#include <SharedEntropyRing.h>
+#include <EntropyServerClient.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/random.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+
+#ifndef GRND_INSECURE
+#define GRND_INSECURE 0x0004
+#endif
+
+using namespace std;
+using namespace alpharng;
+
+namespace {
+
+/**
+ * Per-process source of entropy bytes, either a shared memory ring or the entropy server socket.
+ * Small requests are served from a buffer, larger requests are read from the source directly.
+ */
+class PreloadSource {
+public:
+	bool read(unsigned char *out, size_t size);
+	void prepare_fork() {m_mtx.lock();}
+	void complete_fork_in_parent() {m_mtx.unlock();}
+	void complete_fork_in_child();
+
+	PreloadSource();
+	PreloadSource(const PreloadSource &source) = delete;
+	PreloadSource & operator=(const PreloadSource &source) = delete;
+
+public:
+	static const size_t c_default_buffer_bytes = 16384;
+	static const size_t c_max_buffer_bytes = 1048576;
+
+private:
+	bool read_source(unsigned char *out, size_t size);
+	bool open_source();
+	void close_source();
+
+private:
+	static const int c_retry_interval_secs = 1;
+
+	mutex m_mtx;
+	string m_ring_name;
+	string m_socket_path;
+	// Trusted besides root and the user of the application
+	uid_t m_server_uid = 0;
+	unique_ptr<SharedEntropyRing> m_ring;
+	unique_ptr<EntropyServerClient> m_client;
+	// Bytes from m_buffer_offset to m_buffer_level are available
+	vector<unsigned char> m_buffer;
+	size_t m_buffer_offset = 0;
+	size_t m_buffer_level = 0;
+	bool m_is_forked = false;
+	bool m_is_available = false;
+	chrono::steady_clock::time_point m_retry_time;
+};
+
+PreloadSource::PreloadSource() {
+	const char *ring_name = secure_getenv("ALRNG_PRELOAD_RING");
+	const char *socket_path = secure_getenv("ALRNG_PRELOAD_SOCKET");
+	const char *buffer_bytes = secure_getenv("ALRNG_PRELOAD_BUFFER");
+	const char *server_uid = secure_getenv("ALRNG_PRELOAD_SERVER_UID");
+	m_ring_name = ring_name != nullptr ? ring_name : "";
+	m_socket_path = socket_path != nullptr ? socket_path : EntropyServerClient::c_default_socket_path;
+	m_server_uid = server_uid != nullptr ? (uid_t)strtoul(server_uid, nullptr, 10) : 0;
+	size_t size = buffer_bytes != nullptr ? strtoul(buffer_bytes, nullptr, 10) : c_default_buffer_bytes;
+	m_buffer.resize(size < c_max_buffer_bytes ? size : c_max_buffer_bytes);
+}
+
+/**
+ * @param[out] out location for the random bytes
+ * @param[in] size amount of random bytes requested
+ *
+ * @return false if the entropy server is not available and the kernel should be used
+ */
+bool PreloadSource::read(unsigned char *out, size_t size) {
+	lock_guard<mutex> lock(m_mtx);
+	if (m_is_forked) {
+		// Bytes of the parent must not be used again, the connection and the ring slot belong to the parent
+		m_is_forked = false;
+		close_source();
+		m_retry_time = chrono::steady_clock::time_point();
+	}
+	if (!m_is_available && !open_source()) {
+		return false;
+	}
+	const size_t available = m_buffer_level - m_buffer_offset;
+	if (size > available) {
+		if (size > m_buffer.size() / 2) {
+			return read_source(out, size);
+		}
+		// Keep the remaining bytes at the start, so the refill is one contiguous read
+		memmove(m_buffer.data(), m_buffer.data() + m_buffer_offset, available);
+		m_buffer_offset = 0;
+		m_buffer_level = available;
+		if (!read_source(m_buffer.data() + m_buffer_level, m_buffer.size() - m_buffer_level)) {
+			return false;
+		}
+		m_buffer_level = m_buffer.size();
+	}
+	memcpy(out, m_buffer.data() + m_buffer_offset, size);
+	memset(m_buffer.data() + m_buffer_offset, 0, size);
+	m_buffer_offset += size;
+	return true;
+}
+
+/**
+ * @param[out] out location for the random bytes
+ * @param[in] size amount of random bytes requested
+ *
+ * @return false if the source failed, it is retried after c_retry_interval_secs
+ */
+bool PreloadSource::read_source(unsigned char *out, size_t size) {
+	bool status = m_ring ? m_ring->read(out, size) : m_client->get_entropy(out, size);
+	if (!status) {
+		close_source();
+	}
+	return status;
+}
+
+/**
+ * @return true if the ring is attached or the entropy server is connected, either one owned by a trusted user
+ */
+bool PreloadSource::open_source() {
+	if (chrono::steady_clock::now() < m_retry_time) {
+		return false;
+	}
+	if (!m_ring_name.empty()) {
+		m_ring.reset(new SharedEntropyRing());
+		m_is_available = m_ring->attach(m_ring_name, m_server_uid);
+	} else {
+		m_client.reset(new EntropyServerClient(m_socket_path, 0));
+		m_client->set_server_uid(m_server_uid);
+		m_is_available = m_client->connect();
+	}
+	if (!m_is_available) {
+		close_source();
+	}
+	return m_is_available;
+}
+
+void PreloadSource::close_source() {
+	m_ring.reset();
+	m_client.reset();
+	memset(m_buffer.data(), 0, m_buffer.size());
+	m_buffer_offset = 0;
+	m_buffer_level = 0;
+	m_is_available = false;
+	m_retry_time = chrono::steady_clock::now() + chrono::seconds(c_retry_interval_secs);
+}
+
+/**
+ * Called in the child process right after fork(), only releases the lock and forgets buffered bytes.
+ * Closing the source is left to the next request.
+ */
+void PreloadSource::complete_fork_in_child() {
+	memset(m_buffer.data(), 0, m_buffer.size());
+	m_buffer_offset = 0;
+	m_buffer_level = 0;
+	m_is_forked = true;
+	m_mtx.unlock();
+}
+
+typedef ssize_t (*getrandom_fn)(void *, size_t, unsigned int);
+typedef int (*getentropy_fn)(void *, size_t);
+typedef int (*open_fn)(const char *, int, ...);
+typedef int (*openat_fn)(int, const char *, int, ...);
+typedef int (*open_2_fn)(const char *, int);
+typedef int (*openat_2_fn)(int, const char *, int);
+typedef ssize_t (*read_fn)(int, void *, size_t);
+typedef ssize_t (*read_chk_fn)(int, void *, size_t, size_t);
+typedef int (*close_fn)(int);
+typedef int (*close_range_fn)(unsigned int, unsigned int, int);
+typedef void (*closefrom_fn)(int);
+typedef int (*dup2_fn)(int, int);
+typedef int (*dup3_fn)(int, int, int);
+typedef FILE * (*fdopen_fn)(int, const char *);
+
+atomic<getrandom_fn> g_getrandom(nullptr);
+atomic<getentropy_fn> g_getentropy(nullptr);
+atomic<open_fn> g_open(nullptr);
+atomic<open_fn> g_open64(nullptr);
+atomic<openat_fn> g_openat(nullptr);
+atomic<openat_fn> g_openat64(nullptr);
+atomic<open_2_fn> g_open_2(nullptr);
+atomic<open_2_fn> g_open64_2(nullptr);
+atomic<openat_2_fn> g_openat_2(nullptr);
+atomic<openat_2_fn> g_openat64_2(nullptr);
+atomic<read_fn> g_read(nullptr);
+atomic<read_chk_fn> g_read_chk(nullptr);
+atomic<close_fn> g_close(nullptr);
+atomic<close_range_fn> g_close_range(nullptr);
+atomic<closefrom_fn> g_closefrom(nullptr);
+atomic<dup2_fn> g_dup2(nullptr);
+atomic<dup3_fn> g_dup3(nullptr);
+atomic<fdopen_fn> g_fdopen(nullptr);
+
+// Descriptors of /dev/urandom and /dev/random opened by the application, higher descriptors are served by the kernel
+const int c_max_tracked_fds = 65536;
+atomic<bool> g_is_random_fd[c_max_tracked_fds];
+
+// The source is created on first use and never destroyed, applications may request bytes from exit handlers
+atomic<PreloadSource*> g_source(nullptr);
+once_flag g_source_once;
+
+// Set while the library itself runs, so requests made by the source are served by the kernel
+__thread bool t_is_in_preload = false;
+
+/**
+ * @param[in,out] cached address resolved by a previous call
+ * @param[in] name name of the next definition of an intercepted function
+ *
+ * @return address of the function, nullptr if not available in this C library
+ */
+template <typename T>
+T get_next(atomic<T> &cached, const char *name) {
+	T fn = cached.load(memory_order_acquire);
+	if (fn == nullptr) {
+		fn = (T)dlsym(RTLD_NEXT, name);
+		cached.store(fn, memory_order_release);
+	}
+	return fn;
+}
+
+void prepare_fork() {
+	g_source.load()->prepare_fork();
+}
+
+void complete_fork_in_parent() {
+	g_source.load()->complete_fork_in_parent();
+}
+
+void complete_fork_in_child() {
+	g_source.load()->complete_fork_in_child();
+}
+
+PreloadSource * get_source() {
+	PreloadSource *source = g_source.load(memory_order_acquire);
+	if (source == nullptr) {
+		call_once(g_source_once, []() {
+			g_source.store(new PreloadSource(), memory_order_release);
+			pthread_atfork(prepare_fork, complete_fork_in_parent, complete_fork_in_child);
+		});
+		source = g_source.load(memory_order_acquire);
+	}
+	return source;
+}
+
+/**
+ * @param[out] out location for the random bytes
+ * @param[in] size amount of random bytes requested
+ *
+ * @return false if the kernel should serve the request
+ */
+bool read_entropy(void *out, size_t size) {
+	if (t_is_in_preload) {
+		return false;
+	}
+	t_is_in_preload = true;
+	bool status = size == 0 || get_source()->read((unsigned char*)out, size);
+	t_is_in_preload = false;
+	return status;
+}
+
+/**
+ * Remember a newly opened descriptor if it refers to the kernel random devices
+ *
+ * @param[in] fd descriptor returned by the C library
+ * @param[in] path path used to open it
+ *
+ * @return fd
+ */
+int track_fd(int fd, const char *path) {
+	if (fd < 0 || fd >= c_max_tracked_fds) {
+		return fd;
+	}
+	bool is_random = false;
+	// Only paths that may name the random devices are checked, the check costs a system call
+	if (path != nullptr && strstr(path, "random") != nullptr) {
+		struct stat st;
+		is_random = fstat(fd, &st) == 0 && S_ISCHR(st.st_mode) && major(st.st_rdev) == 1
+				&& (minor(st.st_rdev) == 8 || minor(st.st_rdev) == 9);
+	}
+	g_is_random_fd[fd].store(is_random, memory_order_relaxed);
+	return fd;
+}
+
+void untrack_fd(int fd) {
+	if (fd >= 0 && fd < c_max_tracked_fds) {
+		g_is_random_fd[fd].store(false, memory_order_relaxed);
+	}
+}
+
+bool is_random_fd(int fd) {
+	return fd >= 0 && fd < c_max_tracked_fds && g_is_random_fd[fd].load(memory_order_relaxed);
+}
+
+} /* namespace */
+
+// The library is built with hidden visibility, only the intercepted functions are exported
+#pragma GCC visibility push(default)
+extern "C" {
+
+int __open_2(const char *path, int flags);
+int __open64_2(const char *path, int flags);
+int __openat_2(int dirfd, const char *path, int flags);
+int __openat64_2(int dirfd, const char *path, int flags);
+ssize_t __read_chk(int fd, void *buf, size_t count, size_t buf_size);
+int close_range(unsigned int first, unsigned int last, int flags);
+void closefrom(int lowfd);
+
+ssize_t getrandom(void *buf, size_t count, unsigned int flags) {
+	// Unknown flags are left to the kernel to reject
+	if ((flags & ~(GRND_NONBLOCK | GRND_RANDOM | GRND_INSECURE)) == 0 && read_entropy(buf, count)) {
+		return (ssize_t)count;
+	}
+	getrandom_fn next = get_next(g_getrandom, "getrandom");
+	return next != nullptr ? next(buf, count, flags) : syscall(SYS_getrandom, buf, count, flags);
+}
+
+int getentropy(void *buf, size_t count) {
+	if (count > 256) {
+		errno = EIO;
+		return -1;
+	}
+	if (read_entropy(buf, count)) {
+		return 0;
+	}
+	return get_next(g_getentropy, "getentropy")(buf, count);
+}
+
+int open(const char *path, int flags, ...) {
+	mode_t mode = 0;
+	if (flags & (O_CREAT | O_TMPFILE)) {
+		va_list args;
+		va_start(args, flags);
+		mode = va_arg(args, mode_t);
+		va_end(args);
+	}
+	return track_fd(get_next(g_open, "open")(path, flags, mode), path);
+}
+
+int open64(const char *path, int flags, ...) {
+	mode_t mode = 0;
+	if (flags & (O_CREAT | O_TMPFILE)) {
+		va_list args;
+		va_start(args, flags);
+		mode = va_arg(args, mode_t);
+		va_end(args);
+	}
+	return track_fd(get_next(g_open64, "open64")(path, flags, mode), path);
+}
+
+int openat(int dirfd, const char *path, int flags, ...) {
+	mode_t mode = 0;
+	if (flags & (O_CREAT | O_TMPFILE)) {
+		va_list args;
+		va_start(args, flags);
+		mode = va_arg(args, mode_t);
+		va_end(args);
+	}
+	return track_fd(get_next(g_openat, "openat")(dirfd, path, flags, mode), path);
+}
+
+int openat64(int dirfd, const char *path, int flags, ...) {
+	mode_t mode = 0;
+	if (flags & (O_CREAT | O_TMPFILE)) {
+		va_list args;
+		va_start(args, flags);
+		mode = va_arg(args, mode_t);
+		va_end(args);
+	}
+	return track_fd(get_next(g_openat64, "openat64")(dirfd, path, flags, mode), path);
+}
+
+int __open_2(const char *path, int flags) {
+	return track_fd(get_next(g_open_2, "__open_2")(path, flags), path);
+}
+
+int __open64_2(const char *path, int flags) {
+	return track_fd(get_next(g_open64_2, "__open64_2")(path, flags), path);
+}
+
+int __openat_2(int dirfd, const char *path, int flags) {
+	return track_fd(get_next(g_openat_2, "__openat_2")(dirfd, path, flags), path);
+}
+
+int __openat64_2(int dirfd, const char *path, int flags) {
+	return track_fd(get_next(g_openat64_2, "__openat64_2")(dirfd, path, flags), path);
+}
+
+ssize_t read(int fd, void *buf, size_t count) {
+	if (is_random_fd(fd) && read_entropy(buf, count)) {
+		return (ssize_t)count;
+	}
+	return get_next(g_read, "read")(fd, buf, count);
+}
+
+ssize_t __read_chk(int fd, void *buf, size_t count, size_t buf_size) {
+	if (count <= buf_size && is_random_fd(fd) && read_entropy(buf, count)) {
+		return (ssize_t)count;
+	}
+	return get_next(g_read_chk, "__read_chk")(fd, buf, count, buf_size);
+}
+
+int close(int fd) {
+	untrack_fd(fd);
+	return get_next(g_close, "close")(fd);
+}
+
+int close_range(unsigned int first, unsigned int last, int flags) {
+	close_range_fn next = get_next(g_close_range, "close_range");
+	if (next == nullptr) {
+		errno = ENOSYS;
+		return -1;
+	}
+	int status = next(first, last, flags);
+	if (status == 0) {
+		for (unsigned int fd = first; fd <= last && fd < (unsigned int)c_max_tracked_fds; fd++) {
+			untrack_fd((int)fd);
+		}
+	}
+	return status;
+}
+
+void closefrom(int lowfd) {
+	for (int fd = lowfd < 0 ? 0 : lowfd; fd < c_max_tracked_fds; fd++) {
+		untrack_fd(fd);
+	}
+	closefrom_fn next = get_next(g_closefrom, "closefrom");
+	if (next != nullptr) {
+		next(lowfd);
+	}
+}
+
+int dup2(int oldfd, int newfd) {
+	int fd = get_next(g_dup2, "dup2")(oldfd, newfd);
+	if (fd >= 0 && fd != oldfd) {
+		untrack_fd(fd);
+	}
+	return fd;
+}
+
+int dup3(int oldfd, int newfd, int flags) {
+	int fd = get_next(g_dup3, "dup3")(oldfd, newfd, flags);
+	untrack_fd(fd);
+	return fd;
+}
+
+FILE * fdopen(int fd, const char *mode) {
+	// The stream reads and closes the descriptor inside the C library, it is served by the kernel
+	untrack_fd(fd);
+	return get_next(g_fdopen, "fdopen")(fd, mode);
+}
+
+} /* extern "C" */
+#pragma GCC visibility pop
@@ -0,0 +1,632 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This provider may only be used in conjunction with TectroLabs devices.
+
+ This provider is used for seeding the random generators of OpenSSL 3 applications with true random bytes
+ generated by an AlphaRNG device, either downloaded from a running entropy server or from the device directly.
+
+ It registers the EVP_RAND algorithm ALPHARNG. Example of an OpenSSL configuration using it as the seed
+ source of all DRBGs:
+
+     openssl_conf = openssl_init
+
+     [openssl_init]
+     providers = provider_sect
+     random = random_sect
+
+     [provider_sect]
+     default = default_sect
+     alpharng = alpharng_sect
+
+     [default_sect]
+     activate = 1
+
+     [alpharng_sect]
+     module = /usr/local/lib/alrng-provider.so
+     # Optional: entropy server socket path (default: /run/alpharng.sock), user id of the server when
+     # it runs neither as root nor as the user of the application, device used when the server is
+     # not running or not trusted (default: 0) and size of the buffer in bytes (default: 32768)
+     socket_path = /run/alpharng.sock
+     server_uid = 0
+     device_number = 0
+     buffer_size = 32768
+     activate = 1
+
+     [random_sect]
+     seed = ALPHARNG
+
+ With 'random = ALPHARNG' instead of 'seed = ALPHARNG' in the random section, RAND_bytes() returns
+ device bytes directly, at the rate of the device.
+
+ It uses OpenSSL library.
+
+ */
+
+/**
+ *    @file alrng-provider.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.1
+ *
+ *    @brief An OpenSSL 3 provider of an AlphaRNG backed seed source
+ */
+
+#include <AlphaRngApi.h>
+#include <EntropyServerClient.h>
+#include <openssl/core.h>
+#include <openssl/core_dispatch.h>
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#include <openssl/evp.h>
+#include <openssl/crypto.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <pthread.h>
+
+using namespace std;
+using namespace alpharng;
+
+namespace {
+
+/**
+ * Process wide buffer of device bytes shared by all instances of the provider. A background thread
+ * keeps it above half full, so seed requests are served from memory without device round trips.
+ * The entropy server is preferred, the device is used directly when the server is not running or not trusted.
+ */
+class ProviderSource {
+public:
+	bool read(unsigned char *out, size_t size);
+	void release();
+	void prepare_fork() {m_mtx.lock();}
+	void complete_fork_in_parent() {m_mtx.unlock();}
+	void complete_fork_in_child();
+
+	ProviderSource(const string &socket_path, uid_t server_uid, int device_number, size_t buffer_bytes);
+	ProviderSource(const ProviderSource &source) = delete;
+	ProviderSource & operator=(const ProviderSource &source) = delete;
+
+public:
+	static const size_t c_default_buffer_bytes = 32768;
+	static const size_t c_min_buffer_bytes = 1024;
+	static const size_t c_max_buffer_bytes = 1048576;
+
+private:
+	virtual ~ProviderSource();
+	void run_filler();
+	bool fill(unsigned char *out, size_t size);
+	bool open_source();
+
+private:
+	static const int c_retry_interval_secs = 1;
+	static const int c_wait_timeout_secs = 5;
+
+	string m_socket_path;
+	// Trusted besides root and the user of the application
+	uid_t m_server_uid;
+	int m_device_number;
+	mutex m_mtx;
+	condition_variable m_data_cv;
+	condition_variable m_space_cv;
+	// Bytes from m_buffer_offset to m_buffer_level are available
+	vector<unsigned char> m_buffer;
+	size_t m_buffer_offset = 0;
+	size_t m_buffer_level = 0;
+	bool m_is_failed = false;
+	bool m_is_stopping = false;
+	bool m_is_filling = false;
+	bool m_is_detached = false;
+	chrono::steady_clock::time_point m_retry_time;
+	// The objects below are only used by the filler thread
+	unique_ptr<thread> m_filler;
+	unique_ptr<EntropyServerClient> m_client;
+	unique_ptr<AlphaRngApi> m_rng;
+	vector<unsigned char> m_chunk;
+};
+
+ProviderSource::ProviderSource(const string &socket_path, uid_t server_uid, int device_number, size_t buffer_bytes) :
+		m_socket_path(socket_path), m_server_uid(server_uid), m_device_number(device_number),
+		m_buffer(buffer_bytes < c_min_buffer_bytes ? c_min_buffer_bytes : buffer_bytes > c_max_buffer_bytes ? c_max_buffer_bytes : buffer_bytes),
+		m_chunk(m_buffer.size()) {
+}
+
+/**
+ * @param[out] out location for the random bytes
+ * @param[in] size amount of random bytes requested
+ *
+ * @return true when successful
+ */
+bool ProviderSource::read(unsigned char *out, size_t size) {
+	unique_lock<mutex> lock(m_mtx);
+	if (!m_filler) {
+		m_is_failed = false;
+		m_filler.reset(new thread(&ProviderSource::run_filler, this));
+	}
+	while (size > 0) {
+		size_t available = m_buffer_level - m_buffer_offset;
+		if (available == 0) {
+			if (m_is_failed) {
+				// Connecting the device is expensive, so it is retried on demand at most every c_retry_interval_secs
+				if (chrono::steady_clock::now() < m_retry_time) {
+					return false;
+				}
+				m_is_failed = false;
+			}
+			m_space_cv.notify_one();
+			if (!m_data_cv.wait_for(lock, chrono::seconds(c_wait_timeout_secs),
+					[this]() {return m_buffer_level > m_buffer_offset || m_is_failed;})) {
+				return false;
+			}
+			continue;
+		}
+		size_t count = size < available ? size : available;
+		memcpy(out, m_buffer.data() + m_buffer_offset, count);
+		OPENSSL_cleanse(m_buffer.data() + m_buffer_offset, count);
+		m_buffer_offset += count;
+		out += count;
+		size -= count;
+		if (m_buffer_level - m_buffer_offset < m_buffer.size() / 2) {
+			m_space_cv.notify_one();
+		}
+	}
+	return true;
+}
+
+/**
+ * The device API draws its session keys from the default library context. The filler thread uses a
+ * private one, which is seeded by the kernel, so the device connection never waits for DRBGs that
+ * are waiting for this source.
+ */
+void ProviderSource::run_filler() {
+	OSSL_LIB_CTX *libctx = OSSL_LIB_CTX_new();
+	OSSL_LIB_CTX *previous_libctx = libctx != nullptr ? OSSL_LIB_CTX_set0_default(libctx) : nullptr;
+	unique_lock<mutex> lock(m_mtx);
+	while (!m_is_stopping) {
+		size_t available = m_buffer_level - m_buffer_offset;
+		if (available >= m_buffer.size() / 2 || m_is_failed) {
+			m_space_cv.wait(lock);
+			continue;
+		}
+		const size_t size = m_buffer.size() - available;
+		m_is_filling = true;
+		lock.unlock();
+		bool status = fill(m_chunk.data(), size);
+		lock.lock();
+		m_is_filling = false;
+		if (status) {
+			memmove(m_buffer.data(), m_buffer.data() + m_buffer_offset, available);
+			memcpy(m_buffer.data() + available, m_chunk.data(), size);
+			OPENSSL_cleanse(m_chunk.data(), size);
+			m_buffer_offset = 0;
+			m_buffer_level = available + size;
+			m_is_failed = false;
+		} else {
+			m_is_failed = true;
+			m_retry_time = chrono::steady_clock::now() + chrono::seconds(c_retry_interval_secs);
+		}
+		m_data_cv.notify_all();
+	}
+	const bool is_detached = m_is_detached;
+	lock.unlock();
+	m_client.reset();
+	if (is_detached) {
+		// Released while busy with the device, likely at process exit while OpenSSL is being cleaned up,
+		// so the device connection and the library context are abandoned instead of freed
+		m_rng.release();
+		delete this;
+		return;
+	}
+	m_rng.reset();
+	if (previous_libctx != nullptr) {
+		OSSL_LIB_CTX_set0_default(previous_libctx);
+	}
+	OSSL_LIB_CTX_free(libctx);
+}
+
+/**
+ * @param[out] out location for the random bytes
+ * @param[in] size amount of random bytes requested
+ *
+ * @return true when successful
+ */
+bool ProviderSource::fill(unsigned char *out, size_t size) {
+	if (!m_client && !m_rng && !open_source()) {
+		return false;
+	}
+	if (m_client ? m_client->get_entropy(out, size) : m_rng->get_entropy(out, (int)size)) {
+		return true;
+	}
+	m_client.reset();
+	m_rng.reset();
+	return false;
+}
+
+/**
+ * The entropy server is used only when it runs as root, as the user of the application or as m_server_uid
+ *
+ * @return true if the entropy server or the device is connected
+ */
+bool ProviderSource::open_source() {
+	m_client.reset(new EntropyServerClient(m_socket_path, 0));
+	m_client->set_server_uid(m_server_uid);
+	if (m_client->connect()) {
+		return true;
+	}
+	m_client.reset();
+	m_rng.reset(new AlphaRngApi());
+	if (m_rng->connect(m_device_number)) {
+		return true;
+	}
+	m_rng.reset();
+	return false;
+}
+
+/**
+ * Called in the child process right after fork(). The filler thread does not exist in the child and
+ * the connection may be in the middle of an operation, both are abandoned and the buffered bytes of
+ * the parent are discarded. The next request starts a new filler thread with a new connection.
+ */
+void ProviderSource::complete_fork_in_child() {
+	m_filler.release();
+	m_client.release();
+	m_rng.release();
+	OPENSSL_cleanse(m_buffer.data(), m_buffer.size());
+	m_buffer_offset = 0;
+	m_buffer_level = 0;
+	m_is_failed = false;
+	// Waiters of the parent threads stay recorded in the condition variables, so they are created anew
+	new (&m_data_cv) condition_variable();
+	new (&m_space_cv) condition_variable();
+	m_mtx.unlock();
+}
+
+/**
+ * Stop using the source. An idle filler thread is joined. A filler thread busy with the device is
+ * not waited for, it may be blocked in a device operation at process exit, it deletes the source
+ * when it stops.
+ */
+void ProviderSource::release() {
+	unique_lock<mutex> lock(m_mtx);
+	m_is_stopping = true;
+	m_space_cv.notify_all();
+	if (m_filler && m_is_filling) {
+		m_is_detached = true;
+		m_filler->detach();
+		return;
+	}
+	lock.unlock();
+	if (m_filler) {
+		m_filler->join();
+	}
+	delete this;
+}
+
+ProviderSource::~ProviderSource() {
+	OPENSSL_cleanse(m_buffer.data(), m_buffer.size());
+}
+
+/**
+ * State of one EVP_RAND_CTX
+ */
+struct RandContext {
+	int state = EVP_RAND_STATE_UNINITIALISED;
+	unique_ptr<mutex> mtx;
+};
+
+const unsigned int c_strength = 1024;
+const size_t c_max_request_bytes = 1 << 16;
+
+mutex g_source_mtx;
+ProviderSource *g_source = nullptr;
+int g_source_refs = 0;
+once_flag g_atfork_once;
+
+void prepare_fork() {
+	g_source_mtx.lock();
+	if (g_source != nullptr) {
+		g_source->prepare_fork();
+	}
+}
+
+void complete_fork_in_parent() {
+	if (g_source != nullptr) {
+		g_source->complete_fork_in_parent();
+	}
+	g_source_mtx.unlock();
+}
+
+void complete_fork_in_child() {
+	if (g_source != nullptr) {
+		g_source->complete_fork_in_child();
+	}
+	g_source_mtx.unlock();
+}
+
+void * rand_newctx(void *provctx, void *parent, const OSSL_DISPATCH *parent_calls) {
+	(void)provctx;
+	(void)parent;
+	(void)parent_calls;
+	return new (nothrow) RandContext();
+}
+
+void rand_freectx(void *vctx) {
+	delete (RandContext*)vctx;
+}
+
+int rand_instantiate(void *vctx, unsigned int strength, int prediction_resistance, const unsigned char *pstr,
+		size_t pstr_len, const OSSL_PARAM params[]) {
+	(void)prediction_resistance;
+	(void)pstr;
+	(void)pstr_len;
+	(void)params;
+	RandContext *ctx = (RandContext*)vctx;
+	if (strength > c_strength) {
+		ctx->state = EVP_RAND_STATE_ERROR;
+		return 0;
+	}
+	ctx->state = EVP_RAND_STATE_READY;
+	return 1;
+}
+
+int rand_uninstantiate(void *vctx) {
+	((RandContext*)vctx)->state = EVP_RAND_STATE_UNINITIALISED;
+	return 1;
+}
+
+int rand_generate(void *vctx, unsigned char *out, size_t outlen, unsigned int strength, int prediction_resistance,
+		const unsigned char *adin, size_t adin_len) {
+	(void)prediction_resistance;
+	(void)adin;
+	(void)adin_len;
+	RandContext *ctx = (RandContext*)vctx;
+	if (ctx->state != EVP_RAND_STATE_READY || strength > c_strength) {
+		return 0;
+	}
+	return g_source->read(out, outlen) ? 1 : 0;
+}
+
+int rand_reseed(void *vctx, int prediction_resistance, const unsigned char *ent, size_t ent_len,
+		const unsigned char *adin, size_t adin_len) {
+	(void)prediction_resistance;
+	(void)ent;
+	(void)ent_len;
+	(void)adin;
+	(void)adin_len;
+	return ((RandContext*)vctx)->state == EVP_RAND_STATE_READY ? 1 : 0;
+}
+
+int rand_enable_locking(void *vctx) {
+	RandContext *ctx = (RandContext*)vctx;
+	if (!ctx->mtx) {
+		ctx->mtx.reset(new (nothrow) mutex());
+	}
+	return ctx->mtx ? 1 : 0;
+}
+
+int rand_lock(void *vctx) {
+	RandContext *ctx = (RandContext*)vctx;
+	if (ctx->mtx) {
+		ctx->mtx->lock();
+	}
+	return 1;
+}
+
+void rand_unlock(void *vctx) {
+	RandContext *ctx = (RandContext*)vctx;
+	if (ctx->mtx) {
+		ctx->mtx->unlock();
+	}
+}
+
+const OSSL_PARAM * rand_gettable_ctx_params(void *vctx, void *provctx) {
+	(void)vctx;
+	(void)provctx;
+	static const OSSL_PARAM params[] = {
+		OSSL_PARAM_int(OSSL_RAND_PARAM_STATE, nullptr),
+		OSSL_PARAM_uint(OSSL_RAND_PARAM_STRENGTH, nullptr),
+		OSSL_PARAM_size_t(OSSL_RAND_PARAM_MAX_REQUEST, nullptr),
+		OSSL_PARAM_END
+	};
+	return params;
+}
+
+int rand_get_ctx_params(void *vctx, OSSL_PARAM params[]) {
+	OSSL_PARAM *p = OSSL_PARAM_locate(params, OSSL_RAND_PARAM_STATE);
+	if (p != nullptr && !OSSL_PARAM_set_int(p, ((RandContext*)vctx)->state)) {
+		return 0;
+	}
+	p = OSSL_PARAM_locate(params, OSSL_RAND_PARAM_STRENGTH);
+	if (p != nullptr && !OSSL_PARAM_set_uint(p, c_strength)) {
+		return 0;
+	}
+	p = OSSL_PARAM_locate(params, OSSL_RAND_PARAM_MAX_REQUEST);
+	if (p != nullptr && !OSSL_PARAM_set_size_t(p, c_max_request_bytes)) {
+		return 0;
+	}
+	return 1;
+}
+
+int rand_verify_zeroization(void *vctx) {
+	(void)vctx;
+	return 1;
+}
+
+/**
+ * Seed requested by a DRBG using this algorithm as its parent, device bytes carry full entropy
+ */
+size_t rand_get_seed(void *vctx, unsigned char **pout, int entropy, size_t min_len, size_t max_len,
+		int prediction_resistance, const unsigned char *adin, size_t adin_len) {
+	(void)prediction_resistance;
+	(void)adin;
+	(void)adin_len;
+	if (((RandContext*)vctx)->state != EVP_RAND_STATE_READY) {
+		return 0;
+	}
+	size_t size = entropy > 0 ? ((size_t)entropy + 7) / 8 : 0;
+	if (size < min_len) {
+		size = min_len;
+	}
+	if (size > max_len || size == 0) {
+		return 0;
+	}
+	unsigned char *out = (unsigned char*)OPENSSL_secure_malloc(size);
+	if (out == nullptr) {
+		return 0;
+	}
+	if (!g_source->read(out, size)) {
+		OPENSSL_secure_clear_free(out, size);
+		return 0;
+	}
+	*pout = out;
+	return size;
+}
+
+void rand_clear_seed(void *vctx, unsigned char *out, size_t outlen) {
+	(void)vctx;
+	OPENSSL_secure_clear_free(out, outlen);
+}
+
+const OSSL_DISPATCH c_rand_functions[] = {
+	{OSSL_FUNC_RAND_NEWCTX, (void (*)(void))rand_newctx},
+	{OSSL_FUNC_RAND_FREECTX, (void (*)(void))rand_freectx},
+	{OSSL_FUNC_RAND_INSTANTIATE, (void (*)(void))rand_instantiate},
+	{OSSL_FUNC_RAND_UNINSTANTIATE, (void (*)(void))rand_uninstantiate},
+	{OSSL_FUNC_RAND_GENERATE, (void (*)(void))rand_generate},
+	{OSSL_FUNC_RAND_RESEED, (void (*)(void))rand_reseed},
+	{OSSL_FUNC_RAND_ENABLE_LOCKING, (void (*)(void))rand_enable_locking},
+	{OSSL_FUNC_RAND_LOCK, (void (*)(void))rand_lock},
+	{OSSL_FUNC_RAND_UNLOCK, (void (*)(void))rand_unlock},
+	{OSSL_FUNC_RAND_GETTABLE_CTX_PARAMS, (void (*)(void))rand_gettable_ctx_params},
+	{OSSL_FUNC_RAND_GET_CTX_PARAMS, (void (*)(void))rand_get_ctx_params},
+	{OSSL_FUNC_RAND_VERIFY_ZEROIZATION, (void (*)(void))rand_verify_zeroization},
+	{OSSL_FUNC_RAND_GET_SEED, (void (*)(void))rand_get_seed},
+	{OSSL_FUNC_RAND_CLEAR_SEED, (void (*)(void))rand_clear_seed},
+	{0, nullptr}
+};
+
+const OSSL_ALGORITHM c_rand_algorithms[] = {
+	{"ALPHARNG", "provider=alpharng", c_rand_functions, "AlphaRNG hardware entropy source"},
+	{nullptr, nullptr, nullptr, nullptr}
+};
+
+const OSSL_ALGORITHM * provider_query_operation(void *provctx, int operation_id, int *no_cache) {
+	(void)provctx;
+	*no_cache = 0;
+	return operation_id == OSSL_OP_RAND ? c_rand_algorithms : nullptr;
+}
+
+const OSSL_PARAM * provider_gettable_params(void *provctx) {
+	(void)provctx;
+	static const OSSL_PARAM params[] = {
+		OSSL_PARAM_utf8_ptr(OSSL_PROV_PARAM_NAME, nullptr, 0),
+		OSSL_PARAM_utf8_ptr(OSSL_PROV_PARAM_VERSION, nullptr, 0),
+		OSSL_PARAM_utf8_ptr(OSSL_PROV_PARAM_BUILDINFO, nullptr, 0),
+		OSSL_PARAM_int(OSSL_PROV_PARAM_STATUS, nullptr),
+		OSSL_PARAM_END
+	};
+	return params;
+}
+
+int provider_get_params(void *provctx, OSSL_PARAM params[]) {
+	(void)provctx;
+	OSSL_PARAM *p = OSSL_PARAM_locate(params, OSSL_PROV_PARAM_NAME);
+	if (p != nullptr && !OSSL_PARAM_set_utf8_ptr(p, "TectroLabs AlphaRNG provider")) {
+		return 0;
+	}
+	p = OSSL_PARAM_locate(params, OSSL_PROV_PARAM_VERSION);
+	if (p != nullptr && !OSSL_PARAM_set_utf8_ptr(p, "1.0")) {
+		return 0;
+	}
+	p = OSSL_PARAM_locate(params, OSSL_PROV_PARAM_BUILDINFO);
+	if (p != nullptr && !OSSL_PARAM_set_utf8_ptr(p, "1.0")) {
+		return 0;
+	}
+	p = OSSL_PARAM_locate(params, OSSL_PROV_PARAM_STATUS);
+	if (p != nullptr && !OSSL_PARAM_set_int(p, 1)) {
+		return 0;
+	}
+	return 1;
+}
+
+void provider_teardown(void *provctx) {
+	(void)provctx;
+	lock_guard<mutex> lock(g_source_mtx);
+	if (--g_source_refs == 0) {
+		g_source->release();
+		g_source = nullptr;
+	}
+}
+
+const OSSL_DISPATCH c_provider_functions[] = {
+	{OSSL_FUNC_PROVIDER_TEARDOWN, (void (*)(void))provider_teardown},
+	{OSSL_FUNC_PROVIDER_QUERY_OPERATION, (void (*)(void))provider_query_operation},
+	{OSSL_FUNC_PROVIDER_GETTABLE_PARAMS, (void (*)(void))provider_gettable_params},
+	{OSSL_FUNC_PROVIDER_GET_PARAMS, (void (*)(void))provider_get_params},
+	{0, nullptr}
+};
+
+} /* namespace */
+
+/**
+ * Entry point of the provider module. The source is created by the first instance, the
+ * configuration of later instances in other library contexts is ignored.
+ *
+ * @param[in] handle handle of the provider object in the core
+ * @param[in] in functions offered by the core
+ * @param[out] out functions of the provider
+ * @param[out] provctx provider context
+ *
+ * @return 1 when successful
+ */
+extern "C" __attribute__((visibility("default")))
+int OSSL_provider_init(const OSSL_CORE_HANDLE *handle, const OSSL_DISPATCH *in, const OSSL_DISPATCH **out, void **provctx) {
+	OSSL_FUNC_core_get_params_fn *core_get_params = nullptr;
+	for (; in->function_id != 0; in++) {
+		if (in->function_id == OSSL_FUNC_CORE_GET_PARAMS) {
+			core_get_params = OSSL_FUNC_core_get_params(in);
+		}
+	}
+	const char *socket_path = nullptr;
+	const char *server_uid = nullptr;
+	const char *device_number = nullptr;
+	const char *buffer_size = nullptr;
+	OSSL_PARAM params[] = {
+		OSSL_PARAM_construct_utf8_ptr("socket_path", (char**)&socket_path, 0),
+		OSSL_PARAM_construct_utf8_ptr("server_uid", (char**)&server_uid, 0),
+		OSSL_PARAM_construct_utf8_ptr("device_number", (char**)&device_number, 0),
+		OSSL_PARAM_construct_utf8_ptr("buffer_size", (char**)&buffer_size, 0),
+		OSSL_PARAM_construct_end()
+	};
+	if (core_get_params != nullptr && !core_get_params(handle, params)) {
+		return 0;
+	}
+
+	call_once(g_atfork_once, []() {
+		pthread_atfork(prepare_fork, complete_fork_in_parent, complete_fork_in_child);
+	});
+	lock_guard<mutex> lock(g_source_mtx);
+	if (g_source == nullptr) {
+		g_source = new (nothrow) ProviderSource(socket_path != nullptr ? socket_path : EntropyServerClient::c_default_socket_path,
+				server_uid != nullptr ? (uid_t)strtoul(server_uid, nullptr, 10) : 0,
+				device_number != nullptr ? atoi(device_number) : 0,
+				buffer_size != nullptr ? strtoul(buffer_size, nullptr, 10) : ProviderSource::c_default_buffer_bytes);
+		if (g_source == nullptr) {
+			return 0;
+		}
+	}
+	g_source_refs++;
+	*out = c_provider_functions;
+	*provctx = g_source;
+	return 1;
+}
@@ -13,15 +13,22 @@
 
 /**
  *    @file alrng.cpp
- *    @date 07/20/2024
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 2.2
+ *    @version 2.8
  *
  *    @brief A utility used for downloading data from the AlphaRNG device
  */
 #include <AlphaRngApi.h>
 #include <AppArguments.h>
+#include <FanoutStreamWriter.h>
+#include <DigestStreamWriter.h>
+#include <TreeDigest.h>
+#ifdef __linux__
+#include <KernelEntropyFeeder.h>
+#endif
 #include <iomanip>
+#include <csignal>
 
 using namespace std;
 using namespace alpharng;
@@ -37,7 +44,7 @@ AppArguments appArgs ({
 	{"-x", ArgDef::noArgument},
 	{"-X", ArgDef::noArgument},
 	{"-t", ArgDef::noArgument},
-	{"-o", ArgDef::requireArgument},
+	{"-o", ArgDef::requireRepeatableArgument},
 	{"-n", ArgDef::requireArgument},
 	{"-d", ArgDef::requireArgument},
 	{"-l", ArgDef::noArgument},
@@ -49,13 +56,26 @@ AppArguments appArgs ({
 	{"-p", ArgDef::requireArgument},
 	{"-dt", ArgDef::noArgument},
 	{"-th", ArgDef::requireArgument},
-	{"-ttl", ArgDef::requireArgument}
+	{"-ttl", ArgDef::requireArgument},
+	{"-rate", ArgDef::requireArgument},
+	{"-pi", ArgDef::requireArgument},
+	{"-pj", ArgDef::noArgument},
+	{"-enc", ArgDef::requireArgument},
+	{"-dg", ArgDef::noArgument},
+	{"-V", ArgDef::requireArgument},
+	{"-K", ArgDef::noArgument},
+	{"-kb", ArgDef::requireArgument}
 });
 
 /**
 * Current version of this utility application
 */
-static double const version = 2.2;
+static double const version = 2.8;
+
+/**
+* Largest amount of bytes distributed to the output sinks at once
+*/
+static int const c_fanout_block_size_bytes = 100000;
 
 /**
 * Local functions used
@@ -65,6 +85,11 @@ static bool validate_comand(const Cmd &cmd);
 static bool list_connected_devices(const RngConfig cfg);
 static void reset_statistics(DeviceStatistics *ds);
 static void generate_statistics(DeviceStatistics &ds, const Cmd &cmd);
+static bool is_fanout_output(const Cmd &cmd);
+static bool is_stdout_output(const Cmd &cmd);
+static bool download_to_sinks(AlphaRngApi &rng, const Cmd &cmd, FanoutStreamWriter &writer);
+static CommandType to_command_type(CmdOpt cmd_opt);
+static bool verify_digest(const Cmd &cmd);
 static void display_help();
 
 /**
@@ -103,7 +128,23 @@ int main(const int argc, const char **argv) {
 		return -1;
 	}
 
-	if (cmd.cmd_type != CmdOpt::listDevices && cmd.cmd_type != CmdOpt::getHelp && !rng.connect(cmd.device_number)) {
+	if (!rng.set_stream_rate(cmd.rate_kbsec * 1024)) {
+		cerr << rng.get_last_error() << endl;
+		return -1;
+	}
+
+	rng.set_output_encoding(cmd.e_encoding);
+	rng.set_output_digest(cmd.is_digest_enabled);
+
+	// Progress goes to the standard error so it never mixes with downloaded bytes
+	ProgressReporter progress_reporter(cerr, cmd.progress_interval_secs,
+			cmd.is_progress_json ? ProgressFormat::json : ProgressFormat::text);
+	if (cmd.progress_interval_secs > 0) {
+		rng.set_progress_reporter(&progress_reporter);
+	}
+
+	if (cmd.cmd_type != CmdOpt::listDevices && cmd.cmd_type != CmdOpt::getHelp && cmd.cmd_type != CmdOpt::verifyDigest
+			&& !rng.connect(cmd.device_number)) {
 		cerr << rng.get_last_error() << endl;
 		return -1;
 	}
@@ -117,24 +158,44 @@ int main(const int argc, const char **argv) {
 
 	rng.set_num_failures_threshold(cmd.num_failures_threshold);
 
+	const bool is_fanout = is_fanout_output(cmd);
+	FanoutStreamWriter fanout_writer(c_fanout_block_size_bytes);
+
 	switch (cmd.cmd_type) {
 	case CmdOpt::getEntropy:
-		status = rng.entropy_to_file(cmd.out_file_name, cmd.num_bytes);
-		break;
 	case CmdOpt::extractSha256Entropy:
-		status = rng.extract_sha256_entropy_to_file(cmd.out_file_name, cmd.num_bytes);
-		break;
 	case CmdOpt::extractSha512Entropy:
-		status = rng.extract_sha512_entropy_to_file(cmd.out_file_name, cmd.num_bytes);
-		break;
 	case CmdOpt::getNoiseSourceOne:
-		status = rng.noise_source_one_to_file(cmd.out_file_name, cmd.num_bytes);
-		break;
 	case CmdOpt::getNoiseSourceTwo:
-		status = rng.noise_source_two_to_file(cmd.out_file_name, cmd.num_bytes);
-		break;
 	case CmdOpt::getNoise:
-		status = rng.noise_to_file(cmd.out_file_name, cmd.num_bytes);
+		if (is_fanout) {
+			status = download_to_sinks(rng, cmd, fanout_writer);
+			if (!status) {
+				cerr << "Err: " << fanout_writer.get_last_error() << rng.get_last_error() << endl;
+				return -1;
+			}
+			break;
+		}
+		switch (cmd.cmd_type) {
+		case CmdOpt::extractSha256Entropy:
+			status = rng.extract_sha256_entropy_to_file(cmd.out_file_name, cmd.num_bytes);
+			break;
+		case CmdOpt::extractSha512Entropy:
+			status = rng.extract_sha512_entropy_to_file(cmd.out_file_name, cmd.num_bytes);
+			break;
+		case CmdOpt::getNoiseSourceOne:
+			status = rng.noise_source_one_to_file(cmd.out_file_name, cmd.num_bytes);
+			break;
+		case CmdOpt::getNoiseSourceTwo:
+			status = rng.noise_source_two_to_file(cmd.out_file_name, cmd.num_bytes);
+			break;
+		case CmdOpt::getNoise:
+			status = rng.noise_to_file(cmd.out_file_name, cmd.num_bytes);
+			break;
+		default:
+			status = rng.entropy_to_file(cmd.out_file_name, cmd.num_bytes);
+			break;
+		}
 		break;
 	case CmdOpt::runDiagnostics:
 		status = rng.run_health_test();
@@ -151,6 +212,22 @@ int main(const int argc, const char **argv) {
 		status = true;
 		display_help();
 		break;
+	case CmdOpt::verifyDigest:
+		// The device is not used, the outcome is reported by verify_digest()
+		return verify_digest(cmd) ? 0 : -1;
+	case CmdOpt::feedKernel: {
+#ifdef __linux__
+		KernelEntropyFeeder feeder(&rng, &cmd);
+		if (!feeder.run()) {
+			cerr << "Err: " << feeder.get_last_error() << endl;
+			return -1;
+		}
+		return 0;
+#else
+		cerr << "Feeding the kernel entropy pool is only supported on Linux" << endl;
+		return -1;
+#endif
+	}
 	default:
 		cerr << "Invalid option: " << (int)cmd.cmd_type << endl;
 		return -1;
@@ -169,11 +246,30 @@ int main(const int argc, const char **argv) {
 		case CmdOpt::extractSha512Entropy:
 		case CmdOpt::getNoiseSourceOne:
 		case CmdOpt::getNoiseSourceTwo:
-		case CmdOpt::getNoise:
-			cout << "Recorded " << cmd.num_bytes << " bytes to " << cmd.out_file_name << " file, download speed: " << ds.download_speed_kbsec << " KB/sec";
-			cout << ", retries: " << rng.get_operation_retry_count() << ", sessions: " << rng.get_session_count();
-			cout << ", max RCT/APT block events: " << rng.get_health_tests().get_max_rct_failures() << "/" << rng.get_health_tests().get_max_apt_failures() << endl;
+		case CmdOpt::getNoise: {
+			// Keep the standard output clean when it receives the device data
+			ostream &log = is_stdout_output(cmd) ? cerr : cout;
+			if (is_fanout) {
+				log << "Recorded " << cmd.num_bytes << " bytes to " << fanout_writer.get_sink_count() << " sinks";
+			} else {
+				log << "Recorded " << cmd.num_bytes << " bytes to " << cmd.out_file_name << " file";
+			}
+			log << ", download speed: " << ds.download_speed_kbsec << " KB/sec";
+			log << ", retries: " << rng.get_operation_retry_count() << ", sessions: " << rng.get_session_count();
+			log << ", max RCT/APT block events: " << rng.get_health_tests().get_max_rct_failures() << "/" << rng.get_health_tests().get_max_apt_failures() << endl;
+			if (cmd.rate_kbsec > 0) {
+				PacingStatistics ps = rng.get_pacing_statistics();
+				log << "Paced at " << cmd.rate_kbsec << " KB/sec, achieved rate: " << std::fixed << std::setprecision(1)
+						<< ps.achieved_rate_bytes_sec / 1024 << " KB/sec, device requests: " << ps.request_count
+						<< ", jitter mean/max: " << std::setprecision(3) << ps.mean_jitter_mlsecs << "/" << ps.max_jitter_mlsecs << " ms" << endl;
+			}
+			for (int i = 0; is_fanout && i < fanout_writer.get_sink_count(); i++) {
+				SinkStatistics stats = fanout_writer.get_sink_statistics(i);
+				log << "Sink " << stats.name << ": written " << stats.bytes_written << " bytes, dropped " << stats.bytes_dropped << " bytes";
+				log << (stats.is_failed ? ", failed" : "") << endl;
+			}
 			break;
+		}
 		default:
 			break;
 		}
@@ -202,12 +298,19 @@ static bool extract_command(Cmd &cmd, RngConfig &cfg, const int argc, const char
 	cmd.num_bytes = 0;
 	cmd.op_count = 0;
 	cmd.out_file_name = "";
+	cmd.out_sinks.clear();
 	cmd.cmd_type = CmdOpt::none;
 	cmd.log_statistics = false;
 	cmd.disable_stat_tests = false;
 	cmd.num_failures_threshold = HealthTests::s_min_num_failures_threshold;
 	cmd.err_log_enabled = false;
 	cmd.ttl_minutes = 0;
+	cmd.rate_kbsec = 0;
+	cmd.progress_interval_secs = 0;
+	cmd.is_progress_json = false;
+	cmd.e_encoding = OutputEncoding::none;
+	cmd.is_digest_enabled = false;
+	cmd.entropy_credit_bits = 8;
 
 	cfg.e_mac_type = MacType::None;
 	cfg.e_aes_key_size = KeySize::k256;
@@ -233,10 +336,21 @@ static bool extract_command(Cmd &cmd, RngConfig &cfg, const int argc, const char
 			break;
 		case 'o':
 			cmd.out_file_name = value;
+			cmd.out_sinks = appArgs.get_argument_values(option);
 			break;
 		case 'e':
-			cmd.cmd_type = CmdOpt::getEntropy;
-			cmd.op_count++;
+			if (option.length() == 2) {
+				cmd.cmd_type = CmdOpt::getEntropy;
+				cmd.op_count++;
+			} else if (option.compare("-enc") == 0) {
+				if (!TextEncoder::parse_encoding(value, cmd.e_encoding)) {
+					cerr << "unexpected encoding specified, must be hex, base64, base64url, base32 or none" << endl;
+					return false;
+				}
+			} else {
+				cerr << "unexpected option " << option << endl;
+				return false;
+			}
 			break;
 		case 'x':
 			cmd.cmd_type = CmdOpt::extractSha256Entropy;
@@ -281,8 +395,19 @@ static bool extract_command(Cmd &cmd, RngConfig &cfg, const int argc, const char
 			}
 			break;
 		case 'r':
-			cmd.cmd_type = CmdOpt::getNoise;
-			cmd.op_count++;
+			if (option.length() == 2) {
+				cmd.cmd_type = CmdOpt::getNoise;
+				cmd.op_count++;
+			} else if (option.compare("-rate") == 0) {
+				cmd.rate_kbsec = atoll(value.c_str());
+				if (cmd.rate_kbsec < 1 || cmd.rate_kbsec > 1000000) {
+					cerr << "unexpected rate " << value << ", must be between 1 and 1000000 KB/sec" << endl;
+					return false;
+				}
+			} else {
+				cerr << "unexpected option " << option << endl;
+				return false;
+			}
 			break;
 		case 'l':
 			cmd.cmd_type = CmdOpt::listDevices;
@@ -296,8 +421,20 @@ static bool extract_command(Cmd &cmd, RngConfig &cfg, const int argc, const char
 			}
 			break;
 		case 'k':
+			if (option.compare("-kb") == 0) {
+				cmd.entropy_credit_bits = atoi(value.c_str());
+				if (cmd.entropy_credit_bits < 1 || cmd.entropy_credit_bits > 8) {
+					cerr << "unexpected entropy credit " << value << ", must be between 1 and 8 bits per byte" << endl;
+					return false;
+				}
+				break;
+			}
 			cfg.key_file = value;
 			break;
+		case 'K':
+			cmd.cmd_type = CmdOpt::feedKernel;
+			cmd.op_count++;
+			break;
 		case 'm':
 			if (value.compare("hmacSha160") == 0) {
 				cfg.e_mac_type = MacType::hmacSha160;
@@ -335,6 +472,19 @@ static bool extract_command(Cmd &cmd, RngConfig &cfg, const int argc, const char
 			return false;
 			break;
 		case 'p':
+			if (option.compare("-pi") == 0) {
+				int val = atoi(value.c_str());
+				if (val < 1 || val > 86400) {
+					cerr << "unexpected progress interval " << value << ", must be between 1 and 86400 seconds" << endl;
+					return false;
+				}
+				cmd.progress_interval_secs = val;
+				break;
+			}
+			if (option.compare("-pj") == 0) {
+				cmd.is_progress_json = true;
+				break;
+			}
 			if (value.compare("RSA1024") == 0) {
 				cfg.e_rsa_key_size = RsaKeySize::rsa1024;
 				break;
@@ -349,6 +499,8 @@ static bool extract_command(Cmd &cmd, RngConfig &cfg, const int argc, const char
 		case 'd':
 			if (option.length() == 3 && option.at(2) == 't') {
 				cmd.disable_stat_tests = true;
+			} else if (option.compare("-dg") == 0) {
+				cmd.is_digest_enabled = true;
 			} else {
 				cmd.device_number = atoi(value.c_str());
 			}
@@ -356,6 +508,11 @@ static bool extract_command(Cmd &cmd, RngConfig &cfg, const int argc, const char
 		case 's':
 			cmd.log_statistics = true;
 			break;
+		case 'V':
+			cmd.cmd_type = CmdOpt::verifyDigest;
+			cmd.out_file_name = value;
+			cmd.op_count++;
+			break;
 		default:
 			cerr << "Unexpected option: " << c << endl;
 			return false;
@@ -383,11 +540,29 @@ static bool validate_comand(const Cmd &cmd) {
 	}
 
 	if (cmd.out_file_name.length() == 0 && cmd.cmd_type != CmdOpt::listDevices
-			&& cmd.cmd_type != CmdOpt::getHelp && cmd.cmd_type != CmdOpt::runDiagnostics) {
+			&& cmd.cmd_type != CmdOpt::getHelp && cmd.cmd_type != CmdOpt::runDiagnostics
+			&& cmd.cmd_type != CmdOpt::feedKernel) {
 		cerr << "Output file name not specified" << endl;
 		return false;
 	}
 
+	if (cmd.is_digest_enabled) {
+		if (cmd.num_bytes == 0) {
+			cerr << "Option -dg requires the number of bytes, a continuous download has no end to digest" << endl;
+			return false;
+		}
+		const string &first_sink = cmd.out_sinks.empty() ? cmd.out_file_name : cmd.out_sinks.front();
+		if (first_sink.compare(0, 1, "-") == 0 || first_sink.compare(0, 3, "fd:") == 0) {
+			cerr << "Option -dg requires the first output to be a file" << endl;
+			return false;
+		}
+	}
+
+	if (cmd.is_progress_json && cmd.progress_interval_secs == 0) {
+		cerr << "Option -pj requires a progress interval, use -pi" << endl;
+		return false;
+	}
+
 	if (cmd.device_number < 0 || cmd.device_number > 25) {
 		cerr << "Invalid device number specified: " << cmd.device_number << endl;
 		return false;
@@ -396,6 +571,111 @@ static bool validate_comand(const Cmd &cmd) {
 	return true;
 }
 
+/**
+ * Check if the device data should be distributed to more than one sink or
+ * to a sink that is not a plain file.
+ *
+ * @param[in] cmd command with the output sinks
+ *
+ * @return true if the fan-out stream writer is needed
+ */
+static bool is_fanout_output(const Cmd &cmd) {
+	if (cmd.out_sinks.size() > 1) {
+		return true;
+	}
+	for (const string &sink : cmd.out_sinks) {
+		if (sink == "-" || sink.compare(0, 3, "fd:") == 0 || sink.find(',') != string::npos) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @param[in] cmd command with the output sinks
+ *
+ * @return true if the standard output is one of the sinks
+ */
+static bool is_stdout_output(const Cmd &cmd) {
+	for (const string &sink : cmd.out_sinks) {
+		if (sink == "-" || sink.compare(0, 2, "-,") == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Download device data once and distribute it to all output sinks
+ *
+ * @param[in] rng connected device
+ * @param[in] cmd command with the output sinks
+ * @param[out] writer fan-out stream writer, holds per sink statistics after the download
+ *
+ * @return true for successful operation
+ */
+static bool download_to_sinks(AlphaRngApi &rng, const Cmd &cmd, FanoutStreamWriter &writer) {
+	for (const string &sink : cmd.out_sinks) {
+		if (!writer.add_sink(sink)) {
+			return false;
+		}
+	}
+	// A disconnected reader must not terminate the whole download
+	signal(SIGPIPE, SIG_IGN);
+	if (!writer.open()) {
+		return false;
+	}
+	if (cmd.is_digest_enabled) {
+		// All sinks receive the same bytes, the digest is stored next to the first one
+		const string &first_sink = cmd.out_sinks.front();
+		DigestStreamWriter digest_writer(writer, first_sink.substr(0, first_sink.find(',')) + TreeDigest::c_sidecar_suffix,
+				TreeDigest::get_default_thread_count());
+		return rng.to_stream(to_command_type(cmd.cmd_type), digest_writer, cmd.num_bytes);
+	}
+	return rng.to_stream(to_command_type(cmd.cmd_type), writer, cmd.num_bytes);
+}
+
+/**
+ * Map an operation mode to the corresponding device command
+ *
+ * @param[in] cmd_opt download operation mode
+ *
+ * @return device command type
+ */
+static CommandType to_command_type(CmdOpt cmd_opt) {
+	switch (cmd_opt) {
+	case CmdOpt::extractSha256Entropy:
+		return CommandType::extractSha256Entropy;
+	case CmdOpt::extractSha512Entropy:
+		return CommandType::extractSha512Entropy;
+	case CmdOpt::getNoiseSourceOne:
+		return CommandType::getNoiseSourceOne;
+	case CmdOpt::getNoiseSourceTwo:
+		return CommandType::getNoiseSourceTwo;
+	case CmdOpt::getNoise:
+		return CommandType::getNoise;
+	default:
+		return CommandType::getEntropy;
+	}
+}
+
+/**
+ * Verify a file against the tree digest stored in its sidecar file
+ *
+ * @param[in] cmd command with the file name
+ *
+ * @return true if the file matches the digest
+ */
+static bool verify_digest(const Cmd &cmd) {
+	TreeDigest digest;
+	if (!digest.verify_file(cmd.out_file_name, TreeDigest::get_default_thread_count())) {
+		cerr << "Err: " << digest.get_last_error() << endl;
+		return false;
+	}
+	cout << cmd.out_file_name << ": OK" << endl;
+	return true;
+}
+
 /**
  * Display information about all AlphaRNG connected and available devices.
  * @param[in] cfg RNG configuration data
@@ -439,8 +719,8 @@ static bool list_connected_devices(const RngConfig cfg) {
  *
  */
 static void reset_statistics(DeviceStatistics *ds) {
-	memset(ds, 0x0, sizeof(DeviceStatistics));
-	time(&ds->begin_time);
+	*ds = DeviceStatistics();
+	ds->begin_time = chrono::steady_clock::now();
 }
 
 /**
@@ -452,12 +732,12 @@ static void reset_statistics(DeviceStatistics *ds) {
  *
  */
 static void generate_statistics(DeviceStatistics &ds, const Cmd &cmd) {
-	time(&ds.end_time);
-	ds.total_time = ds.end_time - ds.begin_time;
-	if (ds.total_time == 0) {
-		ds.total_time = 1;
+	ds.end_time = chrono::steady_clock::now();
+	ds.total_time_secs = chrono::duration<double>(ds.end_time - ds.begin_time).count();
+	if (ds.total_time_secs <= 0) {
+		ds.total_time_secs = 1e-6;
 	}
-	ds.download_speed_kbsec = (int) (cmd.num_bytes / (int64_t) 1024 / ds.total_time);
+	ds.download_speed_kbsec = (int) ((double)cmd.num_bytes / 1024.0 / ds.total_time_secs);
 }
 
 /**
@@ -471,7 +751,7 @@ static void display_help() {
 	cout << "NAME" << endl;
 	cout << "     alrng  - True Random Number Generator AlphaRNG download utility" << endl;
 	cout << "SYNOPSIS" << endl;
-	cout << "     alrng <operation mode> -o <file name> -n <number of bytes> [options]" << endl;
+	cout << "     alrng <operation mode> -o <file name> [-o <sink> ...] -n <number of bytes> [options]" << endl;
 	cout << endl;
 	cout << "DESCRIPTION" << endl;
 	cout << "     alrng establishes a secure data communication channel with AlphaRNG devices" << endl;
@@ -511,6 +791,16 @@ static void display_help() {
 	cout << "     -t" << endl;
 	cout << "           run AlphaRNG device internal diagnostics." << endl;
 	cout << endl;
+	cout << "     -V FILE" << endl;
+	cout << "           verify FILE against the tree digest stored in FILE" << TreeDigest::c_sidecar_suffix << " sidecar file." << endl;
+	cout << "           Leaves are verified in parallel, the first mismatching 1 MiB leaf is reported." << endl;
+	cout << endl;
+	cout << "     -K" << endl;
+	cout << "           feed the Linux kernel entropy pool with entropy bytes whenever the kernel wants entropy:" << endl;
+	cout << "           when /dev/random is writable or the pool is below the write wake up threshold." << endl;
+	cout << "           Runs until SIGINT or SIGTERM, requires root privileges. Replaces rngd reading a named pipe." << endl;
+	cout << "           Use '-pi' for reporting the contributed bytes and the device duty cycle." << endl;
+	cout << endl;
 	cout << "     -h" << endl;
 	cout << "           display help." << endl;
 	cout << endl;
@@ -518,6 +808,11 @@ static void display_help() {
 	cout << endl;
 	cout << "     -o FILE" << endl;
 	cout << "           a FILE name for storing downloaded bytes." << endl;
+	cout << "           May be repeated to distribute the same bytes to multiple sinks: FILE can be" << endl;
+	cout << "           a file, a named pipe (FIFO), '-' for standard output or 'fd:N' for file descriptor N," << endl;
+	cout << "           optionally followed by a back-pressure policy applied when the sink is slow:" << endl;
+	cout << "           ',block' wait for the sink (default), ',drop' drop bytes for this sink only," << endl;
+	cout << "           ',buffer=MB' queue up to MB megabytes for this sink, then drop bytes." << endl;
 	cout << endl;
 	cout << "     -n NUMBER" << endl;
 	cout << "           NUMBER of bytes to download, max value 200000000000" << endl;
@@ -553,6 +848,34 @@ static void display_help() {
 	cout << "           amount of minutes within a connection. MINUTES must be a positive number." << endl;
 	cout << "           Skip this option if session should never expire for a connection." << endl;
 	cout << endl;
+	cout << "     -rate KBSEC" << endl;
+	cout << "           Limit the download rate to KBSEC kilobytes (1024 bytes) per second, between 1 and 1000000." << endl;
+	cout << "           Device requests are paced evenly, up to 10 per second, each a multiple of 16000 bytes." << endl;
+	cout << "           With '-s' the achieved rate and the jitter of the device requests are logged." << endl;
+	cout << "           Skip this option for downloading at the device speed." << endl;
+	cout << endl;
+	cout << "     -pi SECONDS" << endl;
+	cout << "           Report download progress to the standard error every SECONDS seconds, between 1 and 86400:" << endl;
+	cout << "           current and average download speed, device block latency percentiles (p50/p90/p99/max)," << endl;
+	cout << "           retries, sessions and max RCT/APT block events. A final total line is reported at the end." << endl;
+	cout << endl;
+	cout << "     -pj" << endl;
+	cout << "           Report download progress as JSON lines, one JSON object per line. Requires '-pi'." << endl;
+	cout << endl;
+	cout << "     -enc ENCODING" << endl;
+	cout << "           Store downloaded bytes as text. ENCODING: hex, base64, base64url, base32 or none - skip this" << endl;
+	cout << "           option for none (binary). base64 and base32 output is padded with '=', base64url is not padded." << endl;
+	cout << "           '-n' refers to the amount of bytes downloaded, before encoding." << endl;
+	cout << endl;
+	cout << "     -dg" << endl;
+	cout << "           Compute a SHA-256 Merkle tree digest of the stored bytes while downloading and store it" << endl;
+	cout << "           into FILE" << TreeDigest::c_sidecar_suffix << " sidecar file, where FILE is the first output file." << endl;
+	cout << "           Bytes are hashed in 1 MiB leaves by worker threads. Requires '-n', use '-V' for verifying." << endl;
+	cout << endl;
+	cout << "     -kb BITS" << endl;
+	cout << "           Entropy BITS credited to the kernel per byte fed with '-K', between 1 and 8 - skip this" << endl;
+	cout << "           option for 8." << endl;
+	cout << endl;
 	cout << "     -s" << endl;
 	cout << "           Log statistics such as file name, amount of bytes downloaded, download speed, e.t.c " << endl;
 	cout << endl;
@@ -565,5 +888,18 @@ static void display_help() {
 	cout << "           alrng  -e -o rnd.bin -n 1000000 -c aes128 -m hmacSha256" << endl;
 	cout << "     To download 1 MB of raw (unprocessed) random bytes to 'rnd.bin' file using AES-256-GCM cipher:" << endl;
 	cout << "           alrng  -r -o rnd.bin -n 1000000" << endl;
+	cout << "     To download entropy bytes to 'rnd.bin' file at a steady rate of 200 KB/sec:" << endl;
+	cout << "           alrng  -e -o rnd.bin -rate 200 -s" << endl;
+	cout << "     To download entropy bytes continuously to 'rnd.bin' file reporting progress every 60 seconds:" << endl;
+	cout << "           alrng  -e -o rnd.bin -pi 60" << endl;
+	cout << "     To download 32 entropy bytes to standard output as a base64url token:" << endl;
+	cout << "           alrng  -e -o - -n 32 -enc base64url" << endl;
+	cout << "     To archive entropy bytes to 'rnd.bin' file while feeding a consumer through 'rnd.fifo' named pipe:" << endl;
+	cout << "           alrng  -e -o rnd.bin -o rnd.fifo,buffer=64" << endl;
+	cout << "     To download 1 GB of entropy bytes to 'rnd.bin' file with a digest and verify it later:" << endl;
+	cout << "           alrng  -e -o rnd.bin -n 1000000000 -dg" << endl;
+	cout << "           alrng  -V rnd.bin" << endl;
+	cout << "     To feed the kernel entropy pool and report the contributed bytes every hour:" << endl;
+	cout << "           alrng  -K -pi 3600" << endl;
 	cout << endl;
 }
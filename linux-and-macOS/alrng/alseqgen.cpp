@@ -13,9 +13,9 @@
 
 /**
  *    @file alseqgen.cpp
- *    @date 11/05/2024
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 1.0
+ *    @version 1.2
  *
  *    @brief A program for generating random sequences of unique integer numbers based on true random bytes produced by an AlphaRNG device.
  */
@@ -23,8 +23,12 @@
 #include <AlphaRngApi.h>
 #include <AppArguments.h>
 #include <AlphaRandomRangeSequence.h>
+#include <AlphaRandomRangePermutation.h>
 #include <iomanip>
 #include <memory>
+#include <thread>
+#include <vector>
+#include <algorithm>
 
 using namespace std;
 using namespace alpharng;
@@ -43,13 +47,25 @@ AppArguments appArgs ({
 	{"-m", ArgDef::requireArgument},
 	{"-k", ArgDef::requireArgument},
 	{"-c", ArgDef::requireArgument},
-	{"-p", ArgDef::requireArgument}
+	{"-p", ArgDef::requireArgument},
+	{"-enc", ArgDef::requireArgument},
+	{"-stream", ArgDef::noArgument}
 });
 
 /**
 * Current version of this utility application
 */
-static double const version = 1.0;
+static double const version = 1.2;
+
+/**
+* Numbers per chunk when streaming, 3932160 bytes that are a multiple of the hex, base64 and base32 input groups
+*/
+static uint32_t const stream_chunk_numbers = 983040;
+
+/**
+* Maximum amount of threads computing a streamed chunk
+*/
+static unsigned const max_stream_threads = 64;
 
 /**
 * Local functions used
@@ -57,7 +73,11 @@ static double const version = 1.0;
 static bool extract_command(Cmd &cmd, RngConfig &cfg, const int argc, const char **argv);
 static bool validate_comand(const Cmd &cmd);
 static void display_help();
-static bool generate_sequence(AlphaRngApi *rng, int32_t smallest_value, int32_t largest_value, uint32_t sequence_size, const string &file_path_name);
+static bool generate_sequence(AlphaRngApi *rng, int32_t smallest_value, int32_t largest_value, uint32_t sequence_size, const string &file_path_name,
+		OutputEncoding e_encoding);
+static bool stream_sequence(AlphaRngApi *rng, int32_t smallest_value, int32_t largest_value, uint32_t sequence_size, const string &file_path_name,
+		OutputEncoding e_encoding);
+static void generate_chunk(const AlphaRandomRangePermutation &perm, int32_t *dest, uint64_t start_index, uint32_t size, unsigned num_threads);
 
 /**
  * Application entry point
@@ -102,7 +122,13 @@ int main(const int argc, const char **argv) {
 		display_help();
 		break;
 	case CmdOpt::generateSequence:
-			status = generate_sequence(&rng, (int32_t)cmd.smallest_value, (int32_t)cmd.largest_value, (uint32_t)cmd.sequence_size, cmd.out_file_name);
+			if (cmd.is_stream_sequence) {
+				status = stream_sequence(&rng, (int32_t)cmd.smallest_value, (int32_t)cmd.largest_value, (uint32_t)cmd.sequence_size,
+						cmd.out_file_name, cmd.e_encoding);
+				break;
+			}
+			status = generate_sequence(&rng, (int32_t)cmd.smallest_value, (int32_t)cmd.largest_value, (uint32_t)cmd.sequence_size, cmd.out_file_name,
+					cmd.e_encoding);
 			break;
 	default:
 		cerr << "Invalid option: " << (int)cmd.cmd_type << endl;
@@ -124,11 +150,13 @@ int main(const int argc, const char **argv) {
  * @param[in] int32_t largest_value largest value in sequence
  * @param[in] uint32_t sequence_size how many random integer numbers to generate
  * @param[in] string &file_path_name file name for storing generated integers in binary format
+ * @param[in] OutputEncoding e_encoding text encoding applied to the binary format stored in the file
  *
  * @return true when executed successfully
  */
 
-static bool generate_sequence(AlphaRngApi *rng, int32_t smallest_value, int32_t largest_value, uint32_t sequence_size, const string &file_path_name) {
+static bool generate_sequence(AlphaRngApi *rng, int32_t smallest_value, int32_t largest_value, uint32_t sequence_size, const string &file_path_name,
+		OutputEncoding e_encoding) {
 	int32_t *buffer = new (std::nothrow) int32_t[sequence_size];
 	if (buffer == nullptr) {
 		cerr << "Could not allocate memory for data buffer." << endl;
@@ -153,7 +181,23 @@ static bool generate_sequence(AlphaRngApi *rng, int32_t smallest_value, int32_t
 			if(!os_file.good()) {
 				cerr << "Could not open file: " << file_path_name << ". " << endl;
 			} else {
-				os_file.write((const char*)buffer, sequence_size * sizeof(int32_t));
+				if (e_encoding == OutputEncoding::none) {
+					os_file.write((const char*)buffer, sequence_size * sizeof(int32_t));
+				} else {
+					TextEncoder encoder(e_encoding);
+					int64_t num_bytes = (int64_t)sequence_size * sizeof(int32_t);
+					string text((size_t)encoder.get_encoded_size(num_bytes, true), '\0');
+					int64_t done = 0;
+					char *out = &text[0];
+					// Encode in whole groups, keeping each slice within the int range of the encoder
+					const int64_t slice_bytes = 100000LL * encoder.get_input_group_size();
+					while (done < num_bytes) {
+						int64_t len = num_bytes - done < slice_bytes ? num_bytes - done : slice_bytes;
+						out += encoder.encode((const unsigned char*)buffer + done, (int)len, out, done + len == num_bytes);
+						done += len;
+					}
+					os_file.write(text.data(), text.size());
+				}
 				if(!os_file.good()) {
 					cerr << "Could not write bytes to file: " << file_path_name << ". " << endl;
 				}
@@ -169,6 +213,117 @@ static bool generate_sequence(AlphaRngApi *rng, int32_t smallest_value, int32_t
 	return status;
 }
 
+/**
+ * Stream a sequence taken from a permutation of the range keyed by the device. Only one chunk is kept
+ * in memory, so the sequence may contain up to all 4294967295 numbers of the largest range.
+ *
+ * @param[in] AlphaRngApi *rng a pointer to RNG
+ * @param[in] int32_t smallest_value smallest value in sequence
+ * @param[in] int32_t largest_value largest value in sequence
+ * @param[in] uint32_t sequence_size how many random integer numbers to generate
+ * @param[in] string &file_path_name file name for storing generated integers in binary format
+ * @param[in] OutputEncoding e_encoding text encoding applied to the binary format stored in the file
+ *
+ * @return true when executed successfully
+ */
+static bool stream_sequence(AlphaRngApi *rng, int32_t smallest_value, int32_t largest_value, uint32_t sequence_size, const string &file_path_name,
+		OutputEncoding e_encoding) {
+	AlphaRandomRangePermutation perm {rng, smallest_value, largest_value};
+	if (!perm.generate_key()) {
+		cerr << perm.get_last_err_msg();
+		return false;
+	}
+	if (sequence_size > perm.get_range_size()) {
+		cerr << "Amount of integers requested " << sequence_size << " cannot exceed " << perm.get_range_size() << endl;
+		return false;
+	}
+
+	unique_ptr<int32_t[]> buffer(new (std::nothrow) int32_t[stream_chunk_numbers]);
+	if (buffer == nullptr) {
+		cerr << "Could not allocate memory for data buffer." << endl;
+		return false;
+	}
+
+	ofstream os_file;
+	TextEncoder encoder(e_encoding);
+	string text;
+	if (file_path_name.empty()) {
+		cout << std::endl;
+		cout << "-- Beginning of random sequence --" << endl;
+	} else {
+		os_file.open(file_path_name.c_str(), ios::out | ios::binary);
+		if (!os_file.good()) {
+			cerr << "Could not open file: " << file_path_name << ". " << endl;
+			return false;
+		}
+		if (e_encoding != OutputEncoding::none) {
+			text.resize((size_t)encoder.get_encoded_size((int64_t)stream_chunk_numbers * sizeof(int32_t), true));
+		}
+	}
+
+	const unsigned num_threads = max(1U, min(thread::hardware_concurrency(), max_stream_threads));
+	bool status = true;
+	for (uint64_t start_index = 0; start_index < sequence_size && status; start_index += stream_chunk_numbers) {
+		const uint32_t size = (uint32_t)min((uint64_t)stream_chunk_numbers, sequence_size - start_index);
+		generate_chunk(perm, buffer.get(), start_index, size, num_threads);
+		if (file_path_name.empty()) {
+			for (uint32_t i = 0; i < size; ++i) {
+				cout << buffer[i] << '\n';
+			}
+			continue;
+		}
+		if (e_encoding == OutputEncoding::none) {
+			os_file.write((const char*)buffer.get(), size * sizeof(int32_t));
+		} else {
+			// Every chunk but the last one holds whole encoder groups
+			const bool is_final = start_index + size == sequence_size;
+			const int length = encoder.encode((const unsigned char*)buffer.get(), (int)(size * sizeof(int32_t)), &text[0], is_final);
+			os_file.write(text.data(), length);
+		}
+		if (!os_file.good()) {
+			cerr << "Could not write bytes to file: " << file_path_name << ". " << endl;
+			status = false;
+		}
+	}
+
+	if (file_path_name.empty()) {
+		cout << "-- Ending of random sequence --" << endl;
+	} else {
+		os_file.close();
+		if (!os_file.good()) {
+			cerr << "Could not close file: " << file_path_name << ". " << endl;
+			status = false;
+		}
+	}
+	return status;
+}
+
+/**
+ * Compute a chunk of a streamed sequence, splitting it evenly between threads
+ *
+ * @param[in] perm a keyed permutation
+ * @param[out] dest location for the numbers
+ * @param[in] start_index position of the first number in the sequence
+ * @param[in] size amount of numbers in the chunk
+ * @param[in] num_threads amount of threads, including the calling one
+ */
+static void generate_chunk(const AlphaRandomRangePermutation &perm, int32_t *dest, uint64_t start_index, uint32_t size, unsigned num_threads) {
+	auto fill = [&perm](int32_t *part, uint64_t part_start_index, uint32_t part_size) {
+		for (uint32_t i = 0; i < part_size; ++i) {
+			part[i] = perm.get_number(part_start_index + i);
+		}
+	};
+	const uint32_t part_size = (size + num_threads - 1) / num_threads;
+	vector<thread> threads;
+	for (uint32_t offset = part_size; offset < size; offset += part_size) {
+		threads.emplace_back(fill, dest + offset, start_index + offset, min(part_size, size - offset));
+	}
+	fill(dest, start_index, min(part_size, size));
+	for (thread &t : threads) {
+		t.join();
+	}
+}
+
 /**
  * Parse and extract command and options from the command line
  *
@@ -194,6 +349,8 @@ static bool extract_command(Cmd &cmd, RngConfig &cfg, const int argc, const char
 	cmd.smallest_value = -10000000000;
 	cmd.largest_value = -10000000000;
 	cmd.sequence_size = 0;
+	cmd.e_encoding = OutputEncoding::none;
+	cmd.is_stream_sequence = false;
 
 	cfg.e_mac_type = MacType::None;
 	cfg.e_aes_key_size = KeySize::k256;
@@ -222,6 +379,10 @@ static bool extract_command(Cmd &cmd, RngConfig &cfg, const int argc, const char
 			cmd.op_count++;
 			break;
 		case 's':
+			if (option.compare("-stream") == 0) {
+				cmd.is_stream_sequence = true;
+				break;
+			}
 			cmd.smallest_value = atol(value.c_str());
 			break;
 		case 'l':
@@ -287,6 +448,12 @@ static bool extract_command(Cmd &cmd, RngConfig &cfg, const int argc, const char
 		case 'd':
 			cmd.device_number = atoi(value.c_str());
 			break;
+		case 'e':
+			if (option.compare("-enc") == 0 && TextEncoder::parse_encoding(value, cmd.e_encoding)) {
+				break;
+			}
+			cerr << "unexpected encoding specified, must be hex, base64, base64url, base32 or none" << endl;
+			return false;
 		default:
 			cerr << "Unexpected option: " << c << endl;
 			return false;
@@ -332,6 +499,16 @@ static bool validate_comand(const Cmd &cmd) {
 		return false;
 	}
 
+	if (cmd.sequence_size < 0 || cmd.sequence_size > 4294967295LL) {
+		cerr << "Number of random integers must be between 1 and 4294967295" << endl;
+		return false;
+	}
+
+	if (cmd.e_encoding != OutputEncoding::none && cmd.out_file_name.empty()) {
+		cerr << "Option -enc requires an output file, use -o" << endl;
+		return false;
+	}
+
 	if (cmd.device_number < 0 || cmd.device_number > 25) {
 		cerr << "Invalid device number specified: " << cmd.device_number << endl;
 		return false;
@@ -383,6 +560,15 @@ static void display_help() {
 	cout << "     -o FILE" << endl;
 	cout << "           a FILE name for storing generated numbers using signed 32-bit binary format." << endl;
 	cout << endl;
+	cout << "     -enc ENCODING" << endl;
+	cout << "           Store the binary format in the FILE as text. ENCODING: hex, base64, base64url, base32 or none." << endl;
+	cout << "           Skip this option for none (binary). Requires '-o'." << endl;
+	cout << endl;
+	cout << "     -stream" << endl;
+	cout << "           Stream the sequence from a permutation of the range keyed by the AlphaRNG device, using constant" << endl;
+	cout << "           memory, for sequences of billions of integers. The sequence is pseudorandom, it is determined" << endl;
+	cout << "           by a 128-bit key retrieved from the device." << endl;
+	cout << endl;
 	cout << "     -d NUMBER" << endl;
 	cout << "           USB device NUMBER, if more than one. Skip this option if only" << endl;
 	cout << "           one AlphaRNG device is connected." << endl;
@@ -409,5 +595,7 @@ static void display_help() {
 	cout << "           alseqgen -g -s 1 -l 10000 -n 1" << endl;
 	cout << "     Generating sequence of 100 integers within [-10000..10000] range" << endl;
 	cout << "           alseqgen -g -s -10000 -l 10000 -n 100" << endl;
+	cout << "     Streaming a sequence of 4000000000 integers within [-2147483647..2147483647] range to a file" << endl;
+	cout << "           alseqgen -g -stream -s -2147483647 -l 2147483647 -n 4000000000 -o seq.bin" << endl;
 	cout << endl;
 }
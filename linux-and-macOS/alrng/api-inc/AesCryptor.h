@@ -15,9 +15,9 @@
 
 /**
  *    @file AesCryptor.h
- *    @date 09/16/2023
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 1.3
+ *    @version 1.4
  *
  *    @brief Encrypts or decrypts session data using AES-GCM with 128 or 256 bit keys.
  */
@@ -45,6 +45,9 @@ public:
 	bool get_aad(unsigned char* out) const;
 	int get_key_size_bytes() const {return (int)m_e_key_size;}
 	bool initialize_iv();
+	bool set_key(const unsigned char *in, int in_byte_count);
+	bool set_iv(const unsigned char *in);
+	bool set_aad(const unsigned char *in);
 	explicit AesCryptor(KeySize e_key_size);
 	AesCryptor();
 	virtual ~AesCryptor();
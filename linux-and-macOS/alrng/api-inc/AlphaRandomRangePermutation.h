@@ -0,0 +1,47 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a keyed pseudorandom permutation of a range of integers, keyed with true random bytes
+ produced by an AlphaRNG device. Sequences taken from the permutation do not contain duplicates.
+
+ */
+
+/**
+ *    @file AlphaRandomRangePermutation.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief A class for streaming sequences of unique integers from a permutation keyed by an AlphaRNG device.
+ */
+#ifndef ALPHA_RANDOMRANGEPERMUTATION_H_
+#define ALPHA_RANDOMRANGEPERMUTATION_H_
+
+#include <RandomRangePermutation.h>
+#include <AlphaRngApi.h>
+#include <cstdint>
+
+
+namespace alpharng {
+
+class AlphaRandomRangePermutation : public tl_algorithm::RandomRangePermutation {
+public:
+	AlphaRandomRangePermutation(AlphaRngApi *api, const int32_t min_limit, const int32_t max_limit);
+	AlphaRandomRangePermutation(const AlphaRandomRangePermutation &perm) = delete;
+	AlphaRandomRangePermutation & operator=(const AlphaRandomRangePermutation &perm) = delete;
+	bool get_entropy(int32_t *dest, const uint32_t size);
+
+	virtual ~AlphaRandomRangePermutation();
+
+private:
+	AlphaRngApi *m_api;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHA_RANDOMRANGEPERMUTATION_H_ */
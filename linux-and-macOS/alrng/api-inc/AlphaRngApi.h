@@ -12,9 +12,9 @@
 
 /**
  *    @file AlphaRngApi.h
- *    @date 07/20/2024
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 1.7
+ *    @version 1.15
  *
  *    @brief Implements the API for securely interacting with the AlphaRNG device.
  */
@@ -27,6 +27,10 @@
 #include <fstream>
 #include <chrono>
 #include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 #include <RsaCryptor.h>
 #include <AesCryptor.h>
@@ -43,11 +47,19 @@
 #include <Sha512.h>
 #include <ShaInterface.h>
 #include <ShaEntropyExtractor.h>
+#include <StreamWriter.h>
+#include <FileStreamWriter.h>
+#include <TokenBucket.h>
+#include <ProgressReporter.h>
+#include <EncodingStreamWriter.h>
+#include <DigestStreamWriter.h>
+#include <SeedFile.h>
 
 #ifdef _WIN64
 #include <WinUsbSerialDevice.h>
 #else
 #include <UsbSerialDevice.h>
+#include <sys/uio.h>
 #endif
 
 namespace alpharng {
@@ -75,6 +87,12 @@ public:
 	bool get_noise_source_1(unsigned char *out, int out_length);
 	bool get_noise_source_2(unsigned char *out, int out_length);
 	bool get_entropy(unsigned char *out, int out_length);
+	bool load_seed_file(const std::string &file_name);
+	bool save_seed_file();
+	uint64_t get_seed_bytes_served();
+#ifndef _WIN64
+	bool get_entropy_v(const struct iovec *iov, int iov_count);
+#endif
 	bool extract_sha256_entropy(unsigned char *out, int out_length);
 	bool extract_sha512_entropy(unsigned char *out, int out_length);
 	bool get_noise(unsigned char *out, int out_length);
@@ -85,10 +103,17 @@ public:
 	bool noise_source_one_to_file(const std::string &file_path_name, const int64_t num_bytes);
 	bool noise_source_two_to_file(const std::string &file_path_name, const int64_t num_bytes);
 	bool noise_to_file(const std::string &file_path_name, int64_t num_bytes);
+	bool to_stream(CommandType cmd_type, StreamWriter &writer, int64_t num_bytes);
 	void disable_stat_tests();
 	void enable_stat_tests();
 	void set_num_failures_threshold(uint8_t num_failures_threshold);
 	bool set_session_ttl(time_t time_to_live_minutes);
+	bool set_stream_rate(int64_t rate_bytes_per_sec);
+	PacingStatistics get_pacing_statistics() const {return m_pacing_stats;}
+	void set_progress_reporter(ProgressReporter *reporter) {m_progress_reporter = reporter;}
+	void set_output_encoding(OutputEncoding e_encoding);
+	void set_output_digest(bool is_enabled);
+	StreamCounters get_stream_counters() const;
 
 	HealthTests get_health_tests() const {return m_health_test;}
 	int get_operation_retry_count() const {return m_op_retry_count;}
@@ -129,9 +154,17 @@ private:
 	bool get_unpacked_bytes(char cmd, unsigned char *out, int out_length, int block_size_bytes, bool test_data);
 	bool get_payload_bytes_with_retry(char cmd, unsigned char *out, int out_length);
 	bool to_file(CommandType cmd_type, const std::string &file_path_name, int64_t num_bytes);
+	bool validate_stream_size(int64_t num_bytes);
+	bool is_stream_ready();
+	bool stream_to_writer(CommandType cmd_type, StreamWriter &writer, int64_t num_bytes);
+	int get_stream_chunk_size(int64_t rate_bytes_per_sec) const;
 	bool get_data(CommandType cmd_type, unsigned char *out, int out_length);
 	bool execute_command_internal (Response *resp, Command *cmd, int resp_payload_size_bytes);
 	bool connect_internal(int device_number);
+	bool connect_with_retry(int device_number);
+	bool get_device_entropy(unsigned char *out, int out_length);
+	bool take_seed_bytes(unsigned char *out, int out_length);
+	void finish_seeded_connect(bool is_connected);
 	bool initialize_rsa_keyfile();
 	bool initialize_serial_device();
 	bool create_token(uint64_t *new_token);
@@ -160,7 +193,6 @@ private:
 	const int c_test_data_block_size_bytes = 256;
 	const int c_file_output_buff_size_bytes = 100000;
 	const int64_t c_max_file_ouput_bytes = 200000000000LL;
-	unsigned char *m_file_buffer = nullptr;
 	HealthTests m_health_test;
 	int m_op_retry_count;
 	int m_session_count = 0;
@@ -170,6 +202,23 @@ private:
 	ShaEntropyExtractor *m_sha_ent_extr = nullptr;
 	time_t m_expire_time_secs = 0;
 	time_t m_time_to_live_mins = 0;
+	// Paced streams issue about this many device requests per second
+	const int c_pacing_requests_per_sec = 10;
+	TokenBucket m_token_bucket;
+	PacingStatistics m_pacing_stats {};
+	ProgressReporter *m_progress_reporter = nullptr;
+	OutputEncoding m_e_output_encoding = OutputEncoding::none;
+	bool m_is_output_digest = false;
+	// Bytes generated from the seed file, get_entropy() serves them until connect() succeeds
+	static const int c_seed_output_bytes = 65536;
+	std::string m_seed_file_name;
+	std::vector<unsigned char> m_seed_bytes;
+	size_t m_seed_offset = 0;
+	uint64_t m_seed_bytes_served = 0;
+	bool m_is_connecting = false;
+	std::atomic<bool> m_has_seed_bytes {false};
+	std::mutex m_seed_mtx;
+	std::condition_variable m_cv_seed;
 
 };
 
@@ -0,0 +1,128 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for retrieving random bytes from the AlphaRNG device without blocking the caller,
+ so event loops can integrate device reads without dedicating threads to them.
+
+ */
+
+/**
+ *    @file AlphaRngApiAsync.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Asynchronous requests executed by an I/O thread that owns an AlphaRngApi connection.
+ */
+
+#ifndef ALPHARNG_API_INC_ALPHARNGAPIASYNC_H_
+#define ALPHARNG_API_INC_ALPHARNGAPIASYNC_H_
+
+#include <AlphaRngApi.h>
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+
+namespace alpharng {
+
+enum class AsyncOperation {
+	getEntropy = 0,
+	extractSha256Entropy = 1,
+	extractSha512Entropy = 2,
+	getNoise = 3,
+	getNoiseSource1 = 4,
+	getNoiseSource2 = 5
+};
+
+/*
+ * Requests are queued and executed one at a time by an I/O thread in submission order. A completed
+ * request is reported by its callback, which is only invoked from poll() on the thread calling it.
+ * The file descriptor returned by get_fd() is readable while completions wait for poll(), so it can
+ * be watched by epoll, libuv or libevent.
+ *
+ * A queued request may be cancelled, it is then reported as cancelled without touching its buffer.
+ * A request already executing completes as cancelled once the device call returns. Each submitted
+ * request is reported exactly once, except for the ones still waiting when the object is destroyed.
+ *
+ * The AlphaRngApi instance must be connected and must not be used by other threads while this
+ * object exists.
+ */
+class AlphaRngApiAsync {
+public:
+	typedef std::function<void(int64_t request_id, int status)> Callback;
+
+	int64_t submit(AsyncOperation e_op, unsigned char *out, int out_length, const Callback &callback);
+	int poll(int timeout_mlsecs);
+	int cancel(int64_t request_id);
+	int get_status(int64_t request_id);
+	int get_fd() const {return m_read_fd;}
+	int get_queue_size() const {return m_queue_size;}
+	std::string get_last_error();
+	bool is_initialized() const {return m_is_initialized;}
+
+	AlphaRngApiAsync(AlphaRngApi *rng, int queue_size);
+	AlphaRngApiAsync(const AlphaRngApiAsync &async) = delete;
+	AlphaRngApiAsync & operator=(const AlphaRngApiAsync &async) = delete;
+	virtual ~AlphaRngApiAsync();
+
+public:
+	// Request status, the values match the C API
+	static const int c_status_completed = 0;
+	static const int c_status_invalid = -1;
+	static const int c_status_failed = -2;
+	static const int c_status_cancelled = -3;
+	static const int c_status_queue_full = -4;
+	static const int c_status_queued = 1;
+	static const int c_status_running = 2;
+
+	static const int c_default_queue_size = 64;
+	static const int c_max_queue_size = 65536;
+
+private:
+	struct Request {
+		int64_t id;
+		AsyncOperation e_op;
+		unsigned char *out;
+		int out_length;
+		Callback callback;
+		int status;
+		bool is_cancelled;
+	};
+
+	void run();
+	bool execute(const Request *request);
+	void complete(Request *request, int status);
+	void drain_fd();
+
+private:
+	AlphaRngApi *m_rng;
+	int m_queue_size;
+	bool m_is_initialized = false;
+	int m_read_fd = -1;
+	int m_write_fd = -1;
+	std::thread m_thread;
+	std::mutex m_mtx;
+	std::condition_variable m_cv_queue;
+	std::condition_variable m_cv_completed;
+	int64_t m_next_id = 1;
+	std::deque<Request*> m_queue;
+	std::deque<Request*> m_completed;
+	// Requests not reported yet by id
+	std::unordered_map<int64_t, Request*> m_requests;
+	bool m_is_stopping = false;
+	std::string m_last_error;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_ALPHARNGAPIASYNC_H_ */
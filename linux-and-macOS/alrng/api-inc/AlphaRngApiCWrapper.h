@@ -16,9 +16,9 @@
 
 /**
  *    @file AlphaRngApiCWrapper.h
- *    @date 06/28/2023
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 1.0
+ *    @version 1.5
  *
  *    @brief Implements a C API wrapper around the C++ API for securely interacting with the AlphaRNG device.
  */
@@ -26,6 +26,7 @@
 #define __ALRNGCWRAPPER_H
 
 #include <stdint.h>
+#include <sys/uio.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -39,6 +40,23 @@ enum alrng_cipher_type {cipher_type_none = 0, aes_256_gcm = 32, aes_128_gcm = 16
 /* Define a type for referencing the API context */
 typedef struct alrng_context alrng_context;
 
+/* Define thread cache sizes, the default holds one device block */
+#define ALRNG_DEFAULT_THREAD_CACHE_BYTES 16000
+#define ALRNG_MIN_THREAD_CACHE_BYTES 256
+#define ALRNG_MAX_THREAD_CACHE_BYTES 1048576
+
+/* Define asynchronous operations and request status */
+enum alrng_async_op {alrng_op_get_entropy = 0, alrng_op_extract_sha256_entropy = 1, alrng_op_extract_sha512_entropy = 2,
+	alrng_op_get_noise = 3, alrng_op_get_noise_source_1 = 4, alrng_op_get_noise_source_2 = 5};
+enum alrng_async_status {alrng_async_completed = 0, alrng_async_invalid = -1, alrng_async_failed = -2,
+	alrng_async_cancelled = -3, alrng_async_queue_full = -4, alrng_async_queued = 1, alrng_async_running = 2};
+
+/* Define a type for referencing asynchronous requests of a context */
+typedef struct alrng_async alrng_async;
+
+/* Completion callback, `status` is alrng_async_completed, alrng_async_failed or alrng_async_cancelled */
+typedef void (*alrng_async_callback)(alrng_async *async, int64_t request_id, int status, unsigned char *out, int out_length, void *user_data);
+
 /**
  * Create a context for referencing AlphaRngApi class instance using default security configuration:
  *
@@ -242,6 +260,71 @@ int alrng_get_noise_source_2(alrng_context* ctxt, unsigned char *out, int out_le
  */
 int alrng_get_entropy(alrng_context* ctxt, unsigned char *out, int out_length);
 
+/**
+ * Enable or disable the thread cache mode of a context.
+ *
+ * In thread cache mode alrng_get_entropy() may be called by any number of threads at the same time.
+ * Each thread keeps a cache of `cache_size_bytes` entropy bytes per context, so small reads are served
+ * by a memory copy. Caches are refilled from a staging block of the context holding up to 4 caches,
+ * retrieved with one device request under a context lock and health tested like any other entropy bytes;
+ * a refill waits for the device only when the staging block is used up. Bytes are handed out only once
+ * and erased from the cache when copied.
+ * Reads larger than a quarter of the cache bypass it but are still serialized by the context lock.
+ * Other functions of the context must not run concurrently with alrng_get_entropy(), this includes
+ * disabling the mode. The cache size may be changed at any time.
+ *
+ * @param[in] ctxt pointer to a connected context structure, must not be NULL
+ * @param[in] cache_size_bytes size of the cache of each thread, between ALRNG_MIN_THREAD_CACHE_BYTES
+ *            and ALRNG_MAX_THREAD_CACHE_BYTES, ALRNG_DEFAULT_THREAD_CACHE_BYTES is recommended, 0 to disable the mode
+ *
+ * @return 0 for successful operation
+ */
+int alrng_set_thread_cache(alrng_context* ctxt, int cache_size_bytes);
+
+/**
+ * Retrieve entropy bytes for several buffers at once, such as a batch of keys.
+ * The buffers are filled from as few device blocks as their total size allows.
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ * @param[in] iov buffers to fill with random bytes, entries with zero length are skipped
+ * @param[in] iov_count number of entries in iov
+ *
+ * @return 0 for successful operation
+ */
+int alrng_get_entropy_v(alrng_context* ctxt, const struct iovec *iov, int iov_count);
+
+/**
+ * Consume a seed file saved by an earlier connection. Until alrng_connect() succeeds, alrng_get_entropy()
+ * returns bytes generated from the seed, so an application may start before the device is ready.
+ * While alrng_connect() runs, one other thread may call alrng_get_entropy(). After connecting, a new seed
+ * from device entropy replaces the file. Must be called before alrng_connect().
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ * @param[in] file_name seed file pathname, a new seed is still saved after connecting when the file cannot be consumed
+ *
+ * @return 0 for successful operation
+ */
+int alrng_load_seed_file(alrng_context* ctxt, const char *file_name);
+
+/**
+ * Replace the seed file loaded with alrng_load_seed_file() by new device entropy bytes.
+ *
+ * @param[in] ctxt pointer to a connected context structure, must not be NULL
+ *
+ * @return 0 for successful operation
+ */
+int alrng_save_seed_file(alrng_context* ctxt);
+
+/**
+ * Retrieve the amount of bytes generated from the seed file and returned by alrng_get_entropy().
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ * @param[out] byte_count location for the amount of bytes
+ *
+ * @return 0 for successful operation
+ */
+int alrng_get_seed_bytes_served(alrng_context* ctxt, uint64_t *byte_count);
+
 /**
  * Extract entropy bytes by applying SHA-256 method to RAW random bytes retrieved from an AlphaRNG device.
  * This is the method for generating high quality, non biased, random bytes that can be directly used in applications
@@ -389,6 +472,96 @@ int alrng_noise_to_file(alrng_context* ctxt, const char *file_path_name, int64_t
  */
 int alrng_retrieve_frequency_tables(alrng_context* ctxt, uint16_t *freq_table_1, uint16_t *freq_table_2);
 
+/**
+ * Create a handle for submitting requests to a connected context without blocking the caller.
+ * Requests are executed in submission order by an I/O thread. While the handle exists,
+ * the context must not be used by any other function.
+ *
+ * @param[in] ctxt pointer to a connected context structure, must not be NULL
+ * @param[in] queue_size max amount of requests submitted and not reported yet, 0 for the default of 64
+ *
+ * @return pointer to the new handle or NULL if failed
+ */
+alrng_async* alrng_async_create(alrng_context* ctxt, int queue_size);
+
+/**
+ * Stop the I/O thread and destroy the handle. It waits for a request being executed,
+ * requests that are not reported yet are dropped without invoking their callbacks.
+ *
+ * @param[in] async pointer to the handle, must not be NULL
+ *
+ * @return 0 for successful operation
+ */
+int alrng_async_destroy(alrng_async* async);
+
+/**
+ * Submit a request for retrieving bytes from the device
+ *
+ * @param[in] async pointer to the handle, must not be NULL
+ * @param[in] op the operation to execute
+ * @param[out] out points to a byte array for storing the bytes, it must stay valid until the request is reported
+ * @param[in] out_length how many bytes to retrieve
+ * @param[in] callback invoked from alrng_async_poll() when the request is completed, may be NULL
+ * @param[in] user_data passed to the callback
+ *
+ * @return a positive request id or a negative alrng_async_status when the request is rejected
+ */
+int64_t alrng_async_submit(alrng_async* async, enum alrng_async_op op, unsigned char *out, int out_length,
+		alrng_async_callback callback, void *user_data);
+
+/**
+ * Retrieve a file descriptor that becomes readable when completed requests wait for alrng_async_poll().
+ * It can be added to select(), poll(), epoll or an event loop, it must not be read or closed by the caller.
+ *
+ * @param[in] async pointer to the handle, must not be NULL
+ *
+ * @return the file descriptor or -1 for invalid parameters
+ */
+int alrng_async_get_fd(alrng_async* async);
+
+/**
+ * Report completed requests by invoking their callbacks on the calling thread
+ *
+ * @param[in] async pointer to the handle, must not be NULL
+ * @param[in] timeout_mlsecs how long to wait for a completion, 0 to return immediately, negative to wait indefinitely
+ *
+ * @return amount of requests reported or -1 for invalid parameters
+ */
+int alrng_async_poll(alrng_async* async, int timeout_mlsecs);
+
+/**
+ * Retrieve the status of a request that is not reported yet
+ *
+ * @param[in] async pointer to the handle, must not be NULL
+ * @param[in] request_id request id returned by alrng_async_submit()
+ *
+ * @return alrng_async_queued, alrng_async_running, a final status waiting for alrng_async_poll()
+ *         or alrng_async_invalid when the request is unknown or already reported
+ */
+int alrng_async_get_status(alrng_async* async, int64_t request_id);
+
+/**
+ * Cancel a request that is not reported yet. A queued request is not executed, a running request
+ * is allowed to finish. Either way it is reported as alrng_async_cancelled.
+ *
+ * @param[in] async pointer to the handle, must not be NULL
+ * @param[in] request_id request id returned by alrng_async_submit()
+ *
+ * @return 0 for successful operation, -1 when the request is unknown or already completed
+ */
+int alrng_async_cancel(alrng_async* async, int64_t request_id);
+
+/**
+ * Retrieve the message associated with the last failed request.
+ *
+ * @param[in] async pointer to the handle, must not be NULL
+ * @param[out] msg_buffer points to a location for storing a zero terminated error message
+ * @param[in] msg_buffer_size the memory allocated to msg_buffer in bytes
+ *
+ * @return 0 for successful operation
+ */
+int alrng_async_get_last_error(alrng_async* async, char *msg_buffer, int msg_buffer_size);
+
 
 #ifdef __cplusplus
 }
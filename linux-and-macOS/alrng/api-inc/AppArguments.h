@@ -12,9 +12,9 @@
 
 /**
  *    @file AppArguments.h
- *    @date 09/16/2023
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 1.3
+ *    @version 1.4
  *
  *    @brief Parse application command line arguments
  */
@@ -23,11 +23,12 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <sstream>
 
 namespace alpharng {
 
-enum class ArgDef {noArgument, requireArgument};
+enum class ArgDef {noArgument, requireArgument, requireRepeatableArgument};
 
 class AppArguments {
 
@@ -36,6 +37,7 @@ public:
 	void load_arguments(const int argc, const char **argv);
 	std::string get_last_error() const {return m_error_log_oss.str();}
 	std::map<std::string, std::string> & get_argument_map() {return m_argument_map;}
+	std::vector<std::string> get_argument_values(const std::string &option) const;
 	std::map<std::string, ArgDef>& get_definition_map() { return m_definition_map; }
 	bool is_error() const {return m_is_error;}
 	std::string& get_app_name() { return m_app_name; }
@@ -47,6 +49,7 @@ private:
 private:
 	std::map<std::string, ArgDef> m_definition_map;
 	std::map<std::string, std::string> m_argument_map;
+	std::map<std::string, std::vector<std::string>> m_argument_values_map;
 	std::string m_app_name;
 	std::ostringstream m_error_log_oss;
 	bool m_is_error {false};
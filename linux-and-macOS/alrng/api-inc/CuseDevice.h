@@ -0,0 +1,98 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for registering a character device with CUSE (Character device in user space) on Linux
+ and exchanging its file operations with the kernel.
+
+ */
+
+/**
+ *    @file CuseDevice.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief A read-only character device served through the CUSE kernel protocol
+ */
+
+#ifndef ALPHARNG_API_INC_CUSEDEVICE_H_
+#define ALPHARNG_API_INC_CUSEDEVICE_H_
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace alpharng {
+
+/*
+ * The CUSE kernel protocol is used directly through /dev/cuse, no FUSE library is needed. The kernel
+ * creates /dev/NAME after the reply to CUSE_INIT. Opens, reads, releases and interrupts are passed to the
+ * FileHandler given to open(); a read is completed later by the handler with reply() or with a reply added to a buffer
+ * by create_reply_header() and written with write_replies(). Writes and ioctls are refused, flushes
+ * succeed and the device is always reported as readable.
+ *
+ * Experimental: the protocol handling has only been exercised against a scripted stand-in for /dev/cuse,
+ * the entropy server accepts -C only when built with ALPHARNG_EXPERIMENTAL_CUSE (make EXPERIMENTAL_CUSE=1).
+ */
+class CuseDevice {
+public:
+	class FileHandler {
+	public:
+		// Return a new file handle or a negative errno value
+		virtual int64_t open_file(pid_t pid) = 0;
+		// Queue a read of up to size bytes to be replied for unique, false when the handle is not open
+		virtual bool read_file(uint64_t handle, uint64_t unique, uint32_t size) = 0;
+		virtual void release_file(uint64_t handle) = 0;
+		// Fail the read of unique with -EINTR when it still waits
+		virtual void interrupt_read(uint64_t unique) = 0;
+		virtual void report_error(const std::string &error) = 0;
+		virtual ~FileHandler() {}
+	};
+
+	bool open(FileHandler *handler);
+	bool handle_requests();
+	bool reply(uint64_t unique, int error, const void *data, size_t size);
+	bool write_replies(const unsigned char *replies, size_t size);
+	static size_t create_reply_header(uint64_t unique, int error, uint32_t size, unsigned char *header);
+	int get_fd() const {return m_fd;}
+	const std::string &get_name() const {return m_name;}
+	std::string get_last_error() const {return m_error_log_oss.str();}
+
+	explicit CuseDevice(const std::string &name);
+	CuseDevice(const CuseDevice &device) = delete;
+	CuseDevice & operator=(const CuseDevice &device) = delete;
+	virtual ~CuseDevice();
+
+public:
+	static const int c_max_read_bytes = 65536;
+	static const int c_max_write_bytes = 4096;
+	static const size_t c_reply_header_size_bytes = 16;
+
+private:
+	void handle_request(const unsigned char *in, size_t size);
+	void init_device(uint64_t unique, const unsigned char *arg, size_t arg_size);
+	void send_reply(uint64_t unique, int error, const void *data, size_t size);
+	void clear_error_log();
+
+private:
+	static const int c_input_buffer_size_bytes = 16384;
+	// Requests read per handle_requests() call, the rest waits for the next call
+	static const int c_max_requests_per_call = 256;
+
+	std::string m_name;
+	int m_fd = -1;
+	FileHandler *m_handler = nullptr;
+	std::vector<unsigned char> m_input;
+	std::ostringstream m_error_log_oss;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_CUSEDEVICE_H_ */
@@ -0,0 +1,89 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a stream writer that computes a SHA-256 Merkle tree digest of the bytes passed
+ to another stream writer and stores it into a sidecar file when the stream is finished.
+
+ */
+
+/**
+ *    @file DigestStreamWriter.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements a stream writer computing an on the fly tree digest of device data.
+ */
+
+#ifndef ALPHARNG_API_INC_DIGESTSTREAMWRITER_H_
+#define ALPHARNG_API_INC_DIGESTSTREAMWRITER_H_
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include <StreamWriter.h>
+#include <TreeDigest.h>
+
+namespace alpharng {
+
+class DigestStreamWriter : public StreamWriter {
+public:
+	unsigned char* acquire_buffer(int size) override;
+	bool commit_buffer(int size) override;
+	bool finish() override;
+	std::string get_last_error() const override {return m_error_log_oss.str();}
+	DigestValue get_root() const {return m_root;}
+
+	DigestStreamWriter(StreamWriter &target, const std::string &sidecar_path, int num_threads);
+	DigestStreamWriter(const DigestStreamWriter &writer) = delete;
+	DigestStreamWriter & operator=(const DigestStreamWriter &writer) = delete;
+	~DigestStreamWriter() override;
+
+private:
+	struct Leaf {
+		size_t index;
+		int size;
+		// One spare byte in front for the leaf prefix
+		unsigned char *data;
+	};
+
+	bool start_workers();
+	void stop_workers();
+	void run_worker();
+	bool next_leaf();
+	bool submit_leaf();
+
+private:
+	StreamWriter &m_target;
+	const std::string m_sidecar_path;
+	const int c_num_threads;
+	unsigned char *m_acquired_buffer = nullptr;
+	Leaf m_current_leaf {0, 0, nullptr};
+	int64_t m_total_bytes = 0;
+	std::vector<DigestValue> m_leaves;
+	std::vector<unsigned char*> m_all_buffers;
+	std::vector<unsigned char*> m_free_buffers;
+	std::deque<Leaf> m_queue;
+	std::vector<std::thread> m_workers;
+	std::mutex m_mtx;
+	std::condition_variable m_cv_work;
+	std::condition_variable m_cv_free;
+	bool m_is_stopping = false;
+	bool m_is_hash_error = false;
+	DigestValue m_root {};
+	std::ostringstream m_error_log_oss;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_DIGESTSTREAMWRITER_H_ */
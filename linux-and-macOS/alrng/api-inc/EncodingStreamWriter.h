@@ -0,0 +1,63 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a stream writer that encodes bytes downloaded from an AlphaRNG device into text
+ before passing those to another stream writer.
+
+ */
+
+/**
+ *    @file EncodingStreamWriter.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements a stream writer for text encoding of device data.
+ */
+
+#ifndef ALPHARNG_API_INC_ENCODINGSTREAMWRITER_H_
+#define ALPHARNG_API_INC_ENCODINGSTREAMWRITER_H_
+
+#include <string>
+#include <sstream>
+#include <new>
+
+#include <StreamWriter.h>
+#include <TextEncoder.h>
+
+namespace alpharng {
+
+class EncodingStreamWriter : public StreamWriter {
+public:
+	unsigned char* acquire_buffer(int size) override;
+	bool commit_buffer(int size) override;
+	bool finish() override;
+	std::string get_last_error() const override {return m_error_log_oss.str();}
+
+	EncodingStreamWriter(StreamWriter &target, OutputEncoding e_encoding, int buffer_size_bytes, int target_block_size_bytes);
+	EncodingStreamWriter(const EncodingStreamWriter &writer) = delete;
+	EncodingStreamWriter & operator=(const EncodingStreamWriter &writer) = delete;
+	~EncodingStreamWriter() override;
+
+private:
+	bool encode_to_target(const unsigned char *in, int in_length, bool is_final);
+
+private:
+	StreamWriter &m_target;
+	TextEncoder m_encoder;
+	const int c_buffer_size_bytes;
+	const int c_target_block_size_bytes;
+	// Bytes not forming a whole encoding group are kept at the beginning of the buffer
+	unsigned char *m_buffer = nullptr;
+	int m_carry_bytes = 0;
+	std::ostringstream m_error_log_oss;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_ENCODINGSTREAMWRITER_H_ */
@@ -0,0 +1,407 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for interacting with the hardware random data generator device AlphaRNG for the purpose of
+ downloading and distributing true random bytes using a Unix domain socket on Linux.
+
+ It uses OpenSSL library.
+
+ */
+
+/**
+ *    @file EntropyServer.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.14
+ *
+ *    @brief A Unix domain socket service for distributing true random bytes generated by an AlphaRNG device
+ */
+
+#ifndef ALPHARNG_API_INC_ENTROPYSERVER_H_
+#define ALPHARNG_API_INC_ENTROPYSERVER_H_
+
+#include <AlphaRngApi.h>
+#include <SharedEntropyRing.h>
+#include <TokenBucket.h>
+#include <ProgressReporter.h>
+#include <ServerMetrics.h>
+#include <PskChannel.h>
+#include <SeedFile.h>
+#include <CuseDevice.h>
+#include <MetricsEndpoint.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+namespace alpharng {
+
+/*
+ * Clients use the same protocol as the Windows entropy server: each request is a READCMD
+ * structure and the reply is exactly cbReqData bytes. The connection is closed when a
+ * request cannot be served.
+ *
+ * Starting with server version 1.6 a client may switch its connection to protocol version 2
+ * with the c_cmd_protocol_version_id request (cbReqData = 1, the reply is the protocol version).
+ * After that each request is a READCMD2 structure with a client chosen id and each reply is a
+ * REPLY2 structure followed by cbData bytes. Clients may send many requests at once without
+ * waiting for replies, replies are sent as soon as they are ready and may come out of order.
+ * A request that cannot be served gets a reply with a non zero status and no data.
+ *
+ * Entropy requests are scheduled with deficit round robin: every client with waiting requests
+ * receives up to c_quantum_bytes per turn, so one client pulling large replies cannot delay the
+ * small requests of others by more than one round. A client may select a priority class with one
+ * of the c_cmd_..._priority_id requests, higher classes are always served first. An optional
+ * per-client rate quota throttles a client without affecting the others.
+ *
+ * All clients are served by one epoll event loop. Every device used by the server has a worker
+ * thread that owns its connection, refills a shared cache of prefetched entropy bytes through its
+ * own prefetch chunk and executes the other device requests routed to it. Entropy requests are
+ * served from the cache without waiting for a device. The workers start refilling the cache when
+ * it drops below the low watermark and stop at the high watermark (the cache size), so devices are
+ * used in long bursts between idle periods. Each idle worker claims the next chunk of a refill, so
+ * a faster device takes a larger share and the refill rate adds up over the devices. Other device
+ * requests go to the device with the shortest queue weighted by its chunk read latency.
+ *
+ * A device that fails a read or reports a health test failure in its periodic status is taken out
+ * of rotation, its queued requests move to the other devices. The worker reconnects once per
+ * c_device_retry_mlsecs and returns the device to rotation when its status is healthy again.
+ * Clients only see device failures when no device is left in rotation.
+ * Optionally a ring thread publishes prefetched entropy bytes into a shared memory ring for local
+ * readers that cannot afford a system call per read.
+ *
+ * Optionally the server also registers a character device /dev/NAME with a CuseDevice and serves its
+ * readers from the same event loop. Every open file of the device is a client of the entropy scheduler
+ * and each read() is an entropy request, replied with up to CuseDevice::c_max_read_bytes bytes.
+ * Requires access to /dev/cuse.
+ *
+ * Optionally the server also accepts TCP connections from other hosts. They use the same requests
+ * and replies, carried in AES-GCM frames of a PskChannel: only clients holding the pre-shared key are
+ * served and the entropy bytes are never sent in the clear. TCP clients are served by the same event
+ * loop and scheduler as the local clients.
+ *
+ * Optionally the server exposes its metrics, the device API counters and per-client statistics in
+ * Prometheus text format over HTTP on a loopback port with a MetricsEndpoint. Scrapes are served by the event loop.
+ *
+ * Optionally the server keeps a SeedFile with device entropy, replaced every c_seed_save_interval_secs
+ * and when the server stops. At startup the seed is consumed and fills the cache with
+ * c_seeded_cache_bytes, clients are served at once while the device thread connects to the device.
+ * The seeded bytes are served before any device byte and are counted apart from device entropy.
+ */
+class EntropyServer : private CuseDevice::FileHandler, private MetricsEndpoint::StateSource {
+public:
+	EntropyServer(AlphaRngApi *rng, Cmd *cmd);
+	EntropyServer(const EntropyServer &server) = delete;
+	EntropyServer & operator=(const EntropyServer &server) = delete;
+	bool run();
+	virtual ~EntropyServer();
+
+public:
+	static const int c_max_clients = 4096;
+	static const int c_default_clients = 256;
+	static const int c_default_cache_size_kb = 400;
+	static const int c_min_cache_size_kb = 128;
+	static const int c_max_cache_size_kb = 65536;
+	static const char * const c_default_socket_path;
+	static const int c_seeded_cache_bytes = 65536;
+	static const int c_seed_save_interval_secs = 600;
+
+private:
+#pragma pack (1)
+	struct READCMD {
+		uint32_t cmd;
+		uint32_t cbReqData;
+	};
+
+	struct READCMD2 {
+		uint32_t id;
+		uint32_t cmd;
+		uint32_t cbReqData;
+	};
+
+	struct REPLY2 {
+		uint32_t id;
+		uint32_t status;
+		uint32_t cbData;
+	};
+#pragma pack ()
+
+	static const int c_device_status_interval_secs = 10;
+
+	static const int c_input_buffer_size_bytes = 4096;
+	// Requests are small, a client frame carries at most one input buffer of requests
+	static const int c_max_request_frame_bytes = c_input_buffer_size_bytes + PskChannel::c_frame_overhead_bytes;
+	static const int c_priority_classes = 3;
+	static const int c_default_priority = 1;
+
+	struct ClientStatistics {
+		uint64_t byte_count;
+		// Entropy request latencies in microseconds
+		LatencyHistogram latency;
+	};
+
+	struct Request;
+
+	struct Client {
+		int fd;
+		uint32_t events;
+		bool is_pipelined;
+		unsigned char input[c_input_buffer_size_bytes];
+		size_t input_level;
+		std::vector<unsigned char> output;
+		size_t output_bytes_written;
+		// Requests waiting for entropy bytes or for the device and the size of their replies
+		int pending_requests;
+		size_t pending_bytes;
+		// The client is released when the device thread completes all its requests
+		int device_requests;
+		bool is_closed;
+		bool is_resumed;
+		// Entropy requests waiting for the scheduler, served in arrival order
+		std::deque<Request*> entropy_requests;
+		int priority;
+		bool is_active;
+		bool has_turn;
+		uint32_t deficit_bytes;
+		TokenBucket quota;
+		bool is_throttled;
+		std::chrono::steady_clock::time_point throttled_until;
+		pid_t pid;
+		ClientStatistics stats;
+		// An open file of the CUSE device, replies are written to /dev/cuse one at a time
+		bool is_cuse;
+		uint64_t cuse_handle;
+		// A TCP connection: received frames are decrypted into the input buffer, replies are sealed into tx
+		std::unique_ptr<PskChannel> channel;
+		std::vector<unsigned char> rx;
+		size_t rx_level;
+		std::vector<unsigned char> rx_payload;
+		size_t rx_payload_offset;
+		std::vector<unsigned char> tx;
+		size_t tx_written;
+	};
+
+	struct DeviceWorker {
+		int device_number;
+		AlphaRngApi *rng;
+		// Devices other than the first one use an API instance of their own
+		std::unique_ptr<AlphaRngApi> owned_rng;
+		std::thread thread;
+		// Device requests routed to this device
+		std::deque<Request*> requests;
+		bool is_in_rotation;
+		// Reading a prefetch chunk or executing a request
+		bool is_busy;
+		// Smoothed time of reading one prefetch chunk in microseconds
+		double latency_usecs;
+		uint64_t chunk_count;
+		uint64_t rotation_exit_count;
+		// Used by the worker thread only
+		std::chrono::steady_clock::time_point next_status_time;
+	};
+
+	struct Request {
+		Client *client;
+		// Request id of the client or the unique id of a CUSE request
+		uint64_t id;
+		uint32_t cmd;
+		uint32_t size;
+		std::chrono::steady_clock::time_point received_time;
+		// Populated by the device thread or gradually by the entropy scheduler
+		std::vector<unsigned char> data;
+		uint32_t filled_bytes;
+		bool is_device_ok;
+	};
+
+private:
+	bool create_socket();
+	bool create_events();
+	bool create_tcp_socket();
+	void accept_clients(int listen_fd);
+	void handle_client_event(Client *client, uint32_t events);
+	bool serve_client(Client *client);
+	bool parse_requests(Client *client);
+	bool handle_request(Client *client, uint64_t id, uint32_t cmd, uint32_t size);
+	bool is_accepting_requests(const Client *client) const;
+	unsigned char *add_reply(Client *client, uint64_t id, uint32_t status, uint32_t size);
+	size_t create_reply_header(const Client *client, uint64_t id, uint32_t status, uint32_t size, unsigned char *header);
+	void send_reply(Client *client, iovec *iov, int count);
+	void reply_prefetched(Client *client, uint64_t id, uint32_t size, bool has_header);
+	bool fail_request(Client *client, uint64_t id, uint32_t status);
+	Request *queue_request(Client *client, uint64_t id, uint32_t cmd, uint32_t size);
+	void finish_request(Request *request);
+	bool write_output(Client *client);
+	ssize_t receive_input(Client *client);
+	ssize_t receive_channel_input(Client *client);
+	bool write_channel_output(Client *client);
+	size_t get_buffered_bytes(const Client *client) const;
+	bool watch_client(Client *client);
+	void close_client(Client *client);
+	void resume_client(Client *client);
+	void serve_resumed_clients();
+	void handle_device_events();
+	void handle_signal(bool *is_running);
+	bool queue_entropy_request(Client *client, uint64_t id, uint32_t size);
+	void activate_client(Client *client);
+	void deactivate_client(Client *client);
+	void schedule_entropy();
+	bool serve_active_clients(std::deque<Client*> &clients);
+	bool serve_client_turn(Client *client);
+	void release_throttled_clients();
+	int get_throttle_timeout_mlsecs() const;
+	void fail_entropy_requests();
+	bool take_entropy(Client *client, uint64_t id, uint32_t size);
+	void record_latency(Client *client, std::chrono::steady_clock::time_point received_time, uint32_t size);
+	void log_client_statistics() const;
+	void take_prefetched(unsigned char *out, size_t size);
+	bool is_refill_needed();
+	void log_cache_statistics() const;
+	void notify_event_loop();
+	bool create_workers();
+	void run_device(DeviceWorker *worker);
+	DeviceWorker *select_worker(uint32_t cmd);
+	void take_out_of_rotation(DeviceWorker *worker);
+	bool is_any_device_in_rotation() const;
+	bool prefetch_entropy(DeviceWorker *worker, unsigned char *chunk);
+	bool execute_device_request(DeviceWorker *worker, Request *request);
+	bool fill_reply(DeviceWorker *worker, Request *request);
+	bool reconnect_device(DeviceWorker *worker);
+	bool connect_device(DeviceWorker *worker);
+	bool check_device_health(DeviceWorker *worker, bool is_forced);
+	std::string get_device_description(DeviceWorker *worker);
+	bool seed_cache();
+	void save_seed_file(DeviceWorker *worker);
+	void log_device_error(DeviceWorker *worker);
+	void log_device_statistics() const;
+	void log_error(const std::string &error);
+	void run_ring();
+	void stop_device();
+	bool create_cuse_device();
+	int64_t open_file(pid_t pid) override;
+	bool read_file(uint64_t handle, uint64_t unique, uint32_t size) override;
+	void release_file(uint64_t handle) override;
+	void interrupt_read(uint64_t unique) override;
+	void report_error(const std::string &error) override;
+	Client *find_cuse_client(uint64_t handle) const;
+	bool write_cuse_output(Client *client);
+	bool create_metrics_endpoint();
+	void get_server_state(ServerState *state) const override;
+	void update_device_metrics(DeviceWorker *worker, bool is_device_ok);
+	static bool get_stream_type(uint32_t cmd, StreamType *e_type);
+
+private:
+	AlphaRngApi *m_rng;
+	Cmd *m_cmd;
+
+	static const char c_server_major_version = 1;
+	static const char c_server_minor_version = 6;
+	static const char c_protocol_version = 2;
+
+	static const int c_write_buff_size_bytes = 100000;
+	static const int c_prefetch_chunk_bytes = 16000;
+	// Replies of at least this size are sent without copying them into the client output first
+	static const size_t c_min_direct_send_bytes = 16384;
+	// Largest part of a reply sent while holding m_mtx, the device workers wait for it
+	static const size_t c_max_direct_send_bytes = 16384;
+	// Segments of a reply: header and the two parts of the prefetch buffer at most
+	static const int c_max_reply_segments = 3;
+	static const size_t c_max_reply_header_bytes = 16;
+	static const int c_device_retry_mlsecs = 1000;
+	static const int c_max_epoll_events = 256;
+	static const int c_listen_backlog = 128;
+	static const int c_max_pipelined_requests = 256;
+	static const int c_max_client_buffer_bytes = 1000000;
+	static const int c_max_receives_per_event = 16;
+	static const uint32_t c_quantum_bytes = 4096;
+	static const int c_cmd_entropy_retrieve_id = 0;
+	static const int c_cmd_diag_id = 1;
+	static const int c_cmd_dev_ser_num_id = 2;
+	static const int c_cmd_dev_model_id = 3;
+	static const int c_cmd_dev_minor_version_id = 4;
+	static const int c_cmd_dev_major_version_id = 5;
+	static const int c_cmd_serv_minor_version_id = 6;
+	static const int c_cmd_serv_major_version_id = 7;
+	static const int c_cmd_noise_src_one_id = 8;
+	static const int c_cmd_noise_src_two_id = 9;
+	static const int c_cmd_entropy_sha256_extract_id = 10;
+	static const int c_cmd_entropy_sha512_extract_id = 11;
+	static const int c_cmd_noise_id = 12;
+	static const int c_cmd_protocol_version_id = 13;
+	static const int c_cmd_high_priority_id = 14;
+	static const int c_cmd_normal_priority_id = 15;
+	static const int c_cmd_bulk_priority_id = 16;
+
+	static const uint32_t c_status_ok = 0;
+	static const uint32_t c_status_invalid_request = 1;
+	static const uint32_t c_status_device_failure = 2;
+
+	std::string m_socket_path;
+	int m_listen_fd = -1;
+	int m_epoll_fd = -1;
+	int m_event_fd = -1;
+	int m_signal_fd = -1;
+	std::unordered_map<int, Client*> m_clients;
+	std::unique_ptr<CuseDevice> m_cuse;
+	// Open files of the CUSE device by file handle
+	std::unordered_map<uint64_t, Client*> m_cuse_clients;
+	uint64_t m_next_cuse_handle = 1;
+	int m_tcp_fd = -1;
+	unsigned char m_psk[PskChannel::c_psk_size_bytes];
+	ServerMetrics m_metrics;
+	std::unique_ptr<MetricsEndpoint> m_metrics_endpoint;
+	// Clients with waiting entropy requests per priority class, in round robin order
+	std::deque<Client*> m_active_clients[c_priority_classes];
+	std::vector<Client*> m_throttled_clients;
+	size_t m_waiting_requests = 0;
+	// Entropy requests served from the cache on arrival and the ones that waited for the device
+	uint64_t m_cache_hit_count = 0;
+	uint64_t m_cache_miss_count = 0;
+	// Reply bytes sent without copying them into the client output
+	uint64_t m_direct_send_bytes = 0;
+	// Closed clients are deleted after all events of an epoll_wait() call are handled
+	std::vector<Client*> m_released_clients;
+	// Clients with completed requests, served again after all completions are handled
+	std::vector<Client*> m_resumed_clients;
+
+	// Shared between the event loop and the device workers, the list is not changed once they run
+	std::vector<std::unique_ptr<DeviceWorker>> m_workers;
+	std::thread m_ring_thread;
+	mutable std::mutex m_mtx;
+	std::condition_variable m_cv_device;
+	std::condition_variable m_cv_ring;
+	std::deque<Request*> m_completed_requests;
+	std::vector<unsigned char> m_prefetch_buffer;
+	size_t m_prefetch_head = 0;
+	size_t m_prefetch_level = 0;
+	// Bytes generated from the seed file left at the head of the cache and the ones served so far
+	size_t m_seed_level = 0;
+	uint64_t m_seed_bytes_served = 0;
+	// Room in the cache claimed by the chunks workers are reading
+	size_t m_prefetch_claimed = 0;
+	std::chrono::steady_clock::time_point m_next_seed_time;
+	size_t m_cache_low_bytes = 0;
+	bool m_is_refilling = true;
+	uint64_t m_refill_count = 0;
+	uint64_t m_device_failure_count = 0;
+	uint64_t m_handled_failure_count = 0;
+	bool m_is_stopping = false;
+
+	SharedEntropyRing m_ring;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_ENTROPYSERVER_H_ */
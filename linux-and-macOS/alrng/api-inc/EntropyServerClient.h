@@ -0,0 +1,155 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for interacting with the entropy server using a Unix domain socket on Linux.
+
+ */
+
+/**
+ *    @file EntropyServerClient.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.1
+ *
+ *    @brief A Unix domain socket client for downloading true random bytes from the entropy server.
+ */
+
+#ifndef ALPHARNG_API_INC_ENTROPYSERVERCLIENT_H_
+#define ALPHARNG_API_INC_ENTROPYSERVERCLIENT_H_
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace alpharng {
+
+enum class EntropyServerCommand : uint32_t {
+	getEntropy = 0,
+	getTestData = 1,
+	getDeviceSerialNumber = 2,
+	getDeviceModel = 3,
+	getDeviceMinorVersion = 4,
+	getDeviceMajorVersion = 5,
+	getServerMinorVersion = 6,
+	getServerMajorVersion = 7,
+	getNoiseSourceOne = 8,
+	getNoiseSourceTwo = 9,
+	extractSha256Entropy = 10,
+	extractSha512Entropy = 11,
+	getNoise = 12,
+	getProtocolVersion = 13
+};
+
+/*
+ * The client uses protocol version 2 of the entropy server, so a read-ahead request can be in
+ * flight while other requests are sent on the same connection.
+ *
+ * Entropy bytes are served from a read-ahead buffer. Once it drops to half of its size the client
+ * requests a refill without waiting for it; the reply is only collected when the buffer runs out,
+ * by then it is usually already in the socket. Small requests are served by a copy from memory,
+ * requests larger than half of the buffer bypass it. A connection lost while the server restarts
+ * is re-established once per call, bytes already buffered stay valid.
+ *
+ * The client trusts only a server running as root, as the user of the client or as the user given
+ * to set_server_uid(), checked with the peer credentials of each connection. This keeps a process of another
+ * user that binds the socket path first from serving the entropy bytes.
+ *
+ * All methods may be called from many threads, the calls are serialized.
+ */
+class EntropyServerClient {
+public:
+	bool connect();
+	void disconnect();
+	bool is_connected();
+	std::string get_last_error();
+	bool get_entropy(unsigned char *out, size_t size);
+	bool extract_sha256_entropy(unsigned char *out, size_t size);
+	bool extract_sha512_entropy(unsigned char *out, size_t size);
+	bool get_noise_source_1(unsigned char *out, size_t size);
+	bool get_noise_source_2(unsigned char *out, size_t size);
+	bool get_noise(unsigned char *out, size_t size);
+	bool get_test_data(unsigned char *out, size_t size);
+	bool get_device_serial_number(std::string &device_serial_number);
+	bool get_device_model(std::string &device_model);
+	bool get_device_minor_version(int &device_minor_version);
+	bool get_device_major_version(int &device_major_version);
+	bool get_server_minor_version(int &server_minor_version);
+	bool get_server_major_version(int &server_major_version);
+	const std::string & get_socket_path() const {return m_socket_path;}
+	void set_server_uid(uid_t server_uid);
+	size_t get_read_ahead_bytes() const {return m_buffer.size();}
+
+	explicit EntropyServerClient(const std::string &socket_path = c_default_socket_path, size_t read_ahead_bytes = c_default_read_ahead_bytes);
+	EntropyServerClient(const EntropyServerClient &client) = delete;
+	EntropyServerClient & operator=(const EntropyServerClient &client) = delete;
+	virtual ~EntropyServerClient();
+
+public:
+	static const char * const c_default_socket_path;
+	static const size_t c_default_read_ahead_bytes = 16384;
+	// The largest request accepted by the server
+	static const size_t c_max_request_bytes = 100000;
+
+private:
+#pragma pack (1)
+	struct READCMD {
+		uint32_t cmd;
+		uint32_t cbReqData;
+	};
+
+	struct READCMD2 {
+		uint32_t id;
+		uint32_t cmd;
+		uint32_t cbReqData;
+	};
+
+	struct REPLY2 {
+		uint32_t id;
+		uint32_t status;
+		uint32_t cbData;
+	};
+#pragma pack ()
+
+	bool open_connection();
+	void close_connection();
+	bool get_bytes(EntropyServerCommand cmd, unsigned char *out, size_t size);
+	bool fill_entropy(unsigned char *out, size_t size, size_t *filled);
+	bool request_bytes(EntropyServerCommand cmd, unsigned char *out, uint32_t size);
+	bool start_read_ahead();
+	bool send_request(uint32_t id, EntropyServerCommand cmd, uint32_t size);
+	bool receive_reply(uint32_t id, unsigned char *out, uint32_t size);
+	bool send_bytes(const void *in, size_t size);
+	bool receive_bytes(void *out, size_t size);
+	void clear_error_log();
+
+private:
+	static const uint32_t c_protocol_version = 2;
+	static const uint32_t c_status_ok = 0;
+
+	std::mutex m_mtx;
+	std::string m_socket_path;
+	// Trusted besides root and the user of the client
+	uid_t m_server_uid = 0;
+	int m_fd = -1;
+	uint32_t m_next_id = 0;
+	// Bytes from m_buffer_offset to m_buffer_level are available
+	std::vector<unsigned char> m_buffer;
+	size_t m_buffer_offset = 0;
+	size_t m_buffer_level = 0;
+	bool m_is_read_ahead_pending = false;
+	uint32_t m_read_ahead_id = 0;
+	uint32_t m_read_ahead_size = 0;
+	std::ostringstream m_error_log_oss;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_ENTROPYSERVERCLIENT_H_ */
@@ -0,0 +1,168 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a C wrapper around the C++ client of the entropy server running on Linux.
+
+ Most of C wrapper functions will return:
+	0 when invoked successfully;
+	-1 for invalid parameters;
+	-2 for other errors (invoke alrng_server_get_last_error() to retrieve the error message)
+ */
+
+/**
+ *    @file EntropyServerClientCWrapper.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.1
+ *
+ *    @brief Implements a C API wrapper around the C++ client of the entropy server.
+ */
+#ifndef __ALRNGSERVERCWRAPPER_H
+#define __ALRNGSERVERCWRAPPER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Define a type for referencing the client context */
+typedef struct alrng_server_context alrng_server_context;
+
+/**
+ * Create a context for referencing an EntropyServerClient class instance.
+ * A context may be used by many threads at once, the calls are serialized.
+ * Only a server running as root or as the user of the caller is trusted, see alrng_server_set_server_uid().
+ *
+ * @param[in] socket_path Unix domain socket of the entropy server, NULL for /run/alpharng.sock
+ * @param[in] read_ahead_bytes size of the buffer serving small entropy requests from memory,
+ *            up to 100000 bytes, 0 to send every request to the server
+ *
+ * @return pointer to the new context or NULL if failed
+ */
+alrng_server_context* alrng_server_create_ctxt(const char *socket_path, int read_ahead_bytes);
+
+/**
+ * Connect to the entropy server. Requests connect automatically, a lost connection is re-established.
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ *
+ * @return 0 if connection was successful
+ */
+int alrng_server_connect(alrng_server_context* ctxt);
+
+/**
+ * Also trust an entropy server running as another user. The user of the server is checked
+ * with the peer credentials of each new connection.
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ * @param[in] server_uid user id of the entropy server
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_set_server_uid(alrng_server_context* ctxt, uint32_t server_uid);
+
+/**
+ * Disconnect from the entropy server
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_disconnect(alrng_server_context* ctxt);
+
+/**
+ * Close any active connection and destroy the context.
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_destroy_ctxt(alrng_server_context* ctxt);
+
+/**
+ * Retrieve the message associated with the last error.
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ * @param[out] msg_buffer points to a location for storing a zero terminated error message
+ * @param[in] msg_buffer_size the memory allocated to msg_buffer in bytes
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_get_last_error(alrng_server_context* ctxt, char *msg_buffer, int msg_buffer_size);
+
+/**
+ * Retrieve entropy bytes from the entropy server, served from the read-ahead buffer when possible.
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ * @param[out] out points to a byte array for storing the random bytes retrieved
+ * @param[in] out_length how many random bytes to retrieve
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_get_entropy(alrng_server_context* ctxt, unsigned char *out, int out_length);
+
+/**
+ * Retrieve entropy bytes extracted by the entropy server with SHA-256 method.
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ * @param[out] out points to a byte array for storing the random bytes extracted
+ * @param[in] out_length how many entropy bytes to retrieve
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_extract_sha256_entropy(alrng_server_context* ctxt, unsigned char *out, int out_length);
+
+/**
+ * Retrieve entropy bytes extracted by the entropy server with SHA-512 method.
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ * @param[out] out points to a byte array for storing the random bytes extracted
+ * @param[in] out_length how many entropy bytes to retrieve
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_extract_sha512_entropy(alrng_server_context* ctxt, unsigned char *out, int out_length);
+
+/**
+ * Retrieve concatenated raw random bytes of both noise sources.
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ * @param[out] out points to a byte array for storing the random bytes retrieved
+ * @param[in] out_length how many random bytes to retrieve
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_get_noise(alrng_server_context* ctxt, unsigned char *out, int out_length);
+
+/**
+ * Retrieve test bytes, each byte is the incremented value of the previous byte starting with 0.
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ * @param[out] out points to a byte array for storing the test data
+ * @param[in] out_length how many bytes of test data to receive
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_get_test_data(alrng_server_context* ctxt, unsigned char *out, int out_length);
+
+/**
+ * Retrieve the version of the entropy server
+ *
+ * @param[in] ctxt pointer to context structure, must not be NULL
+ * @param[out] major_version points to location for major version number
+ * @param[out] minor_version points to location for minor version number
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_retrieve_version(alrng_server_context* ctxt, int *major_version, int *minor_version);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,134 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a stream writer that distributes one stream of bytes downloaded from an AlphaRNG device
+ to multiple output sinks such as files, named pipes (FIFO), standard output or file descriptors.
+
+ */
+
+/**
+ *    @file FanoutStreamWriter.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements a stream writer for distributing device data to multiple output sinks.
+ */
+
+#ifndef ALPHARNG_API_INC_FANOUTSTREAMWRITER_H_
+#define ALPHARNG_API_INC_FANOUTSTREAMWRITER_H_
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+#include <StreamWriter.h>
+
+namespace alpharng {
+
+enum class SinkKind : uint8_t {file = 0, fifo = 1, standardOutput = 2, fileDescriptor = 3};
+
+// What to do with a new block when a sink did not consume the previous ones yet
+enum class SinkPolicy : uint8_t {
+	block = 0,	// wait for the sink, the whole stream is throttled by the slowest blocking sink
+	drop = 1,	// drop the block for this sink only
+	buffer = 2	// queue up to a configured amount of bytes, drop the block when exceeded
+};
+
+struct SinkStatistics {
+	std::string name;
+	SinkKind e_kind;
+	SinkPolicy e_policy;
+	int64_t bytes_written;
+	int64_t bytes_dropped;
+	bool is_failed;
+};
+
+class FanoutStreamWriter : public StreamWriter {
+public:
+	bool add_sink(const std::string &sink_spec);
+	bool open();
+	unsigned char* acquire_buffer(int size) override;
+	bool commit_buffer(int size) override;
+	bool finish() override;
+	std::string get_last_error() const override {return m_error_log_oss.str();}
+	int get_sink_count() const {return (int)m_sinks.size();}
+	SinkStatistics get_sink_statistics(int sink_idx) const;
+
+	explicit FanoutStreamWriter(int block_size_bytes);
+	FanoutStreamWriter(const FanoutStreamWriter &writer) = delete;
+	FanoutStreamWriter & operator=(const FanoutStreamWriter &writer) = delete;
+	~FanoutStreamWriter() override;
+
+private:
+	// A block of device data shared by all sinks without copying
+	struct Block {
+		unsigned char *data;
+		int size;
+		std::atomic<int> ref_count;
+	};
+
+	struct Sink {
+		std::string name;
+		SinkKind e_kind;
+		SinkPolicy e_policy;
+		int fd {-1};
+		bool owns_fd {false};
+		int64_t max_queued_bytes {0};
+		int64_t queued_bytes {0};
+		std::deque<Block*> queue;
+		std::mutex mtx;
+		std::condition_variable cv_not_empty;
+		std::condition_variable cv_not_full;
+		std::thread thread;
+		bool is_closing {false};
+		std::atomic<bool> is_failed {false};
+		std::atomic<int64_t> bytes_written {0};
+		std::atomic<int64_t> bytes_dropped {0};
+		std::string error;
+	};
+
+private:
+	bool parse_sink_spec(const std::string &sink_spec, Sink &sink);
+	bool open_sink(Sink &sink);
+	bool open_fifo(Sink &sink);
+	void run_sink(Sink *sink);
+	bool write_block(Sink &sink, const Block *block);
+	void fail_sink(Sink &sink, const std::string &error);
+	void dispatch_block(Sink &sink, Block *block);
+	void release_block(Block *block);
+	void stop_sinks();
+
+private:
+	// How many blocks may wait for a sink with the 'block' policy
+	static const int c_max_blocking_queue_blocks = 4;
+	// How long a non blocking sink may stall after the stream is finished
+	static const int c_drain_timeout_mlsecs = 5000;
+	// How often a stalled FIFO sink checks if the stream was finished
+	static const int c_poll_interval_mlsecs = 100;
+
+	const int c_block_size_bytes;
+	std::vector<std::unique_ptr<Sink>> m_sinks;
+	std::vector<Block*> m_free_blocks;
+	std::vector<Block*> m_all_blocks;
+	std::mutex m_pool_mtx;
+	Block *m_current_block = nullptr;
+	bool m_is_open = false;
+	std::ostringstream m_error_log_oss;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_FANOUTSTREAMWRITER_H_ */
@@ -0,0 +1,57 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a stream writer that stores bytes downloaded from an AlphaRNG device into a single file.
+
+ */
+
+/**
+ *    @file FileStreamWriter.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements a stream writer for storing device data into a file.
+ */
+
+#ifndef ALPHARNG_API_INC_FILESTREAMWRITER_H_
+#define ALPHARNG_API_INC_FILESTREAMWRITER_H_
+
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <new>
+
+#include <StreamWriter.h>
+
+namespace alpharng {
+
+class FileStreamWriter : public StreamWriter {
+public:
+	bool open(const std::string &file_path_name);
+	unsigned char* acquire_buffer(int size) override;
+	bool commit_buffer(int size) override;
+	bool finish() override;
+	std::string get_last_error() const override {return m_error_log_oss.str();}
+
+	explicit FileStreamWriter(int buffer_size_bytes);
+	FileStreamWriter(const FileStreamWriter &writer) = delete;
+	FileStreamWriter & operator=(const FileStreamWriter &writer) = delete;
+	~FileStreamWriter() override;
+
+private:
+	std::ofstream m_os_file;
+	std::string m_file_path_name;
+	std::ostringstream m_error_log_oss;
+	unsigned char *m_buffer = nullptr;
+	const int c_buffer_size_bytes;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_FILESTREAMWRITER_H_ */
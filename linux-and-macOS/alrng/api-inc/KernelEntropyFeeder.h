@@ -0,0 +1,94 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for interacting with the hardware random data generator device AlphaRNG for the purpose of
+ feeding the Linux kernel entropy pool with true random bytes.
+
+ It uses OpenSSL library.
+
+ */
+
+/**
+ *    @file KernelEntropyFeeder.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Feeds the Linux kernel entropy pool with entropy bytes generated by an AlphaRNG device
+ */
+
+#ifndef ALPHARNG_API_INC_KERNELENTROPYFEEDER_H_
+#define ALPHARNG_API_INC_KERNELENTROPYFEEDER_H_
+
+#include <AlphaRngApi.h>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <cstdint>
+
+namespace alpharng {
+
+struct FeederStatistics {
+	int64_t bytes_contributed;
+	int64_t bits_credited;
+	// How many times the kernel asked for entropy
+	int64_t wakeup_count;
+	double device_secs;
+	double elapsed_secs;
+	int entropy_avail_bits;
+	int pool_size_bits;
+};
+
+/*
+ * Health tested entropy bytes are added to the kernel input pool with the RNDADDENTROPY ioctl,
+ * credited with the configured amount of entropy bits per byte. The device is only used when the
+ * kernel wants entropy: when /dev/random reports it is writable or when the pool entropy count
+ * falls below the write wake up threshold. Requires CAP_SYS_ADMIN.
+ */
+class KernelEntropyFeeder {
+public:
+	KernelEntropyFeeder(AlphaRngApi *rng, Cmd *cmd);
+	KernelEntropyFeeder(const KernelEntropyFeeder &feeder) = delete;
+	KernelEntropyFeeder & operator=(const KernelEntropyFeeder &feeder) = delete;
+	bool run();
+	FeederStatistics get_statistics() const;
+	std::string get_last_error() const {return m_error_log_oss.str();}
+	virtual ~KernelEntropyFeeder();
+
+public:
+	static const int c_max_credit_bits_per_byte = 8;
+
+private:
+	bool open_pool();
+	bool read_pool_setting(const char *path, int *value);
+	bool get_entropy_avail(int *bits);
+	bool feed(int entropy_avail_bits);
+	bool retrieve_entropy(unsigned char *out, int num_bytes);
+	bool add_entropy(const unsigned char *in, int num_bytes);
+	void report(bool is_final);
+
+private:
+	AlphaRngApi *m_rng;
+	Cmd *m_cmd;
+
+	static const int c_check_interval_mlsecs = 1000;
+	static const int c_min_feed_bytes = 16;
+	static const int c_max_feed_bytes = 512;
+	static const int c_max_feeds_per_wakeup = 16;
+
+	int m_random_fd = -1;
+	int m_signal_fd = -1;
+	int m_wakeup_threshold_bits = 0;
+	FeederStatistics m_stats {};
+	std::chrono::steady_clock::time_point m_start_time;
+	std::ostringstream m_error_log_oss;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_KERNELENTROPYFEEDER_H_ */
@@ -0,0 +1,139 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for serving the run time metrics of a server distributing true random bytes
+ generated by an AlphaRNG device over HTTP in Prometheus text format.
+
+ */
+
+/**
+ *    @file MetricsEndpoint.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.1
+ *
+ *    @brief A loopback HTTP endpoint serving server metrics in Prometheus text format
+ */
+
+#ifndef ALPHARNG_API_INC_METRICSENDPOINT_H_
+#define ALPHARNG_API_INC_METRICSENDPOINT_H_
+
+#include <ServerMetrics.h>
+#include <string>
+#include <sstream>
+#include <ostream>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace alpharng {
+
+// Statistics of one device of the server
+struct DeviceState {
+	int device_number;
+	bool is_in_rotation;
+	uint64_t chunk_count;
+	// Smoothed time of reading one prefetch chunk in microseconds
+	double latency_usecs;
+	size_t queued_requests;
+	uint64_t rotation_exit_count;
+};
+
+// Statistics of one connected client of the server
+struct ClientState {
+	// Tells apart several connections of a process: the socket descriptor or the CUSE file handle
+	std::string id;
+	pid_t pid;
+	const char *priority;
+	const char *transport;
+	uint64_t byte_count;
+	int64_t latency_p50_usecs;
+	int64_t latency_p99_usecs;
+	int64_t latency_count;
+};
+
+// Server state that is not kept in ServerMetrics, collected for each scrape
+struct ServerState {
+	std::vector<DeviceState> devices;
+	size_t cache_level_bytes;
+	// Bytes generated from the seed file, part of cache_level_bytes
+	size_t seed_level_bytes;
+	uint64_t seed_bytes_served;
+	size_t cache_low_watermark_bytes;
+	size_t cache_high_watermark_bytes;
+	uint64_t refill_count;
+	uint64_t cache_hit_count;
+	uint64_t cache_miss_count;
+	uint64_t direct_send_bytes;
+	size_t waiting_requests;
+	bool has_ring;
+	uint64_t ring_level_bytes;
+	uint64_t ring_claimed_bytes;
+	int ring_reader_count;
+	std::vector<ClientState> clients;
+};
+
+/*
+ * Scrape connections are watched by an epoll instance of the endpoint. Its descriptor, returned by
+ * get_fd(), is added to the event loop of the server, which calls handle_events() when it is readable.
+ * Each scrape gets the ServerMetrics counters and the ServerState provided by the StateSource given
+ * to open(), the connection is closed after the reply is sent.
+ */
+class MetricsEndpoint {
+public:
+	class StateSource {
+	public:
+		// Called by handle_events() for each scrape
+		virtual void get_server_state(ServerState *state) const = 0;
+		virtual ~StateSource() {}
+	};
+
+	bool open(int port, StateSource *source);
+	void handle_events();
+	int get_fd() const {return m_epoll_fd;}
+	std::string get_last_error() const {return m_error_log_oss.str();}
+
+	explicit MetricsEndpoint(const ServerMetrics &metrics);
+	MetricsEndpoint(const MetricsEndpoint &endpoint) = delete;
+	MetricsEndpoint & operator=(const MetricsEndpoint &endpoint) = delete;
+	virtual ~MetricsEndpoint();
+
+public:
+	static const int c_max_clients = 16;
+
+private:
+	struct Scrape {
+		std::string input;
+		std::string output;
+		size_t output_bytes_written;
+	};
+
+	void accept_clients();
+	bool serve_client(int fd, Scrape *scrape);
+	bool write_output(int fd, Scrape *scrape);
+	void close_client(int fd);
+	void write(std::ostream &os) const;
+	void clear_error_log();
+	static void write_state(std::ostream &os, const ServerState &state);
+
+private:
+	static const int c_max_request_bytes = 4096;
+	static const int c_max_epoll_events = c_max_clients + 1;
+
+	const ServerMetrics &m_metrics;
+	StateSource *m_source = nullptr;
+	int m_listen_fd = -1;
+	int m_epoll_fd = -1;
+	std::unordered_map<int, Scrape> m_clients;
+	std::ostringstream m_error_log_oss;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_METRICSENDPOINT_H_ */
@@ -0,0 +1,95 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements periodic progress reporting for long running downloads from an AlphaRNG device.
+
+ */
+
+/**
+ *    @file ProgressReporter.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements periodic throughput and latency reporting for device downloads.
+ */
+
+#ifndef ALPHARNG_API_INC_PROGRESSREPORTER_H_
+#define ALPHARNG_API_INC_PROGRESSREPORTER_H_
+
+#include <cstdint>
+#include <chrono>
+#include <ostream>
+
+namespace alpharng {
+
+enum class ProgressFormat : uint8_t {text = 0, json = 1};
+
+// Device counters sampled with each reported block
+struct StreamCounters {
+	int retry_count;
+	int session_count;
+	uint16_t max_rct_failures;
+	uint16_t max_apt_failures;
+};
+
+// Log-linear histogram of latencies in microseconds, relative error is below 1/16
+class LatencyHistogram {
+public:
+	void record(int64_t latency_usecs);
+	void clear();
+	int64_t get_count() const {return m_count;}
+	int64_t get_max() const {return m_max_usecs;}
+	int64_t get_percentile(double percentile) const;
+
+	LatencyHistogram() {clear();}
+	virtual ~LatencyHistogram() = default;
+
+private:
+	static int get_bucket(int64_t latency_usecs);
+	static int64_t get_bucket_value(int bucket);
+
+private:
+	static const int c_sub_bucket_bits = 4;
+	static const int c_sub_buckets = 1 << c_sub_bucket_bits;
+	static const int c_max_exponent = 40;
+	static const int c_bucket_count = c_sub_buckets * (c_max_exponent - c_sub_bucket_bits + 2);
+	int64_t m_buckets[c_bucket_count];
+	int64_t m_count;
+	int64_t m_max_usecs;
+};
+
+class ProgressReporter {
+public:
+	void start();
+	void record_block(int num_bytes, std::chrono::steady_clock::duration latency, const StreamCounters &counters);
+	void finish(const StreamCounters &counters);
+
+	ProgressReporter(std::ostream &os, int interval_secs, ProgressFormat e_format);
+	ProgressReporter(const ProgressReporter &reporter) = delete;
+	ProgressReporter & operator=(const ProgressReporter &reporter) = delete;
+	virtual ~ProgressReporter() = default;
+
+private:
+	void report(std::chrono::steady_clock::time_point now, const StreamCounters &counters, bool is_final);
+
+private:
+	std::ostream &m_os;
+	const std::chrono::steady_clock::duration m_interval;
+	const ProgressFormat m_e_format;
+	std::chrono::steady_clock::time_point m_start_time;
+	std::chrono::steady_clock::time_point m_interval_start_time;
+	int64_t m_total_bytes {0};
+	int64_t m_interval_bytes {0};
+	LatencyHistogram m_interval_latency;
+	LatencyHistogram m_total_latency;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_PROGRESSREPORTER_H_ */
@@ -0,0 +1,91 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for protecting the connection between an entropy server and its clients
+ over TCP with a pre-shared key.
+
+ It uses OpenSSL library.
+
+ */
+
+/**
+ *    @file PskChannel.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Pre-shared key authenticated AES-GCM framing for entropy server connections
+ */
+
+#ifndef ALPHARNG_API_INC_PSKCHANNEL_H_
+#define ALPHARNG_API_INC_PSKCHANNEL_H_
+
+#include <AesCryptor.h>
+#include <HmacSha256.h>
+#include <string>
+#include <sstream>
+#include <cstdint>
+
+namespace alpharng {
+
+/*
+ * Both peers send a hello with a random nonce first. Each direction then uses its own AES-256-GCM key,
+ * derived from the pre-shared key and both nonces with HMAC-SHA256, so keys are fresh for every
+ * connection. A frame is a 4 byte payload length, the encrypted payload and a 16 byte tag. The IV is
+ * a per-direction frame counter and the length is authenticated, so dropped, reordered, replayed or
+ * modified frames fail decryption. A peer without the pre-shared key cannot produce a valid frame.
+ */
+class PskChannel {
+public:
+	bool create_hello(unsigned char *out);
+	bool accept_hello(const unsigned char *in);
+	bool seal(const unsigned char *in, uint32_t size, unsigned char *out);
+	bool open(const unsigned char *frame, unsigned char *out);
+	static uint32_t get_payload_size(const unsigned char *frame);
+	bool is_initialized() const {return m_is_initialized;}
+	bool is_established() const {return m_is_established;}
+	std::string get_last_error() const {return m_error_log_oss.str();}
+	static bool read_psk_file(const std::string &file_name, unsigned char *out, std::string *error);
+
+	PskChannel(const unsigned char *psk, bool is_server);
+	PskChannel(const PskChannel &channel) = delete;
+	PskChannel & operator=(const PskChannel &channel) = delete;
+	virtual ~PskChannel();
+
+public:
+	static const int c_psk_size_bytes = 32;
+	static const int c_nonce_size_bytes = 16;
+	static const int c_hello_size_bytes = 8 + c_nonce_size_bytes;
+	static const int c_header_size_bytes = 4;
+	static const int c_tag_size_bytes = 16;
+	static const int c_frame_overhead_bytes = c_header_size_bytes + c_tag_size_bytes;
+	static const uint32_t c_max_payload_bytes = 65536;
+
+private:
+	bool derive_key(const char *label, const unsigned char *client_nonce, const unsigned char *server_nonce, AesCryptor &cryptor);
+	bool prepare_frame(AesCryptor &cryptor, uint64_t *counter, uint32_t size);
+
+private:
+	static const uint32_t c_magic = 0x474e5241;
+	static const uint32_t c_version = 1;
+
+	bool m_is_server;
+	bool m_is_initialized = false;
+	bool m_is_established = false;
+	unsigned char m_psk[c_psk_size_bytes];
+	unsigned char m_nonce[c_nonce_size_bytes];
+	AesCryptor m_tx_cryptor {KeySize::k256};
+	AesCryptor m_rx_cryptor {KeySize::k256};
+	uint64_t m_tx_counter = 0;
+	uint64_t m_rx_counter = 0;
+	std::ostringstream m_error_log_oss;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_PSKCHANNEL_H_ */
@@ -0,0 +1,92 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a keyed pseudorandom permutation of a range of integers for generating sequences
+ without duplicates in constant memory.
+
+ */
+
+/**
+ *    @file RandomRangePermutation.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements a class for streaming up to 4294967295 unique integers within [-2147483647,2147483647] range in constant memory.
+ */
+#ifndef TL_RANDOMRANGEPERMUTATION_H_
+#define TL_RANDOMRANGEPERMUTATION_H_
+
+#include <cstdint>
+#include <sstream>
+#include <iostream>
+
+
+namespace tl_algorithm {
+
+/*
+ * The number at position i of the sequence is the image of i under a permutation of the range, so no
+ * number buffer is needed and any chunk of the sequence can be computed on its own. The permutation is
+ * a Feistel network over the smallest power of two covering the range, with halves differing by at most
+ * one bit and SipHash-2-4 as the round function keyed by 128 bits of entropy. Images outside of the
+ * range are encrypted again (cycle walking) until they fall inside, which takes fewer than two
+ * encryptions on average.
+ *
+ * Unlike RandomRangeSequence, the sequence is pseudorandom: it is fully determined by the key.
+ * After generate_key() succeeds, get_number() may be called concurrently from many threads.
+ */
+class RandomRangePermutation {
+public:
+	bool generate_key();
+	bool generate_sequence(int32_t *dest, uint32_t size, uint64_t start_index = 0);
+	int32_t get_number(uint64_t index) const {return (int32_t)((int64_t)permute((uint32_t)index) + c_min_limit);}
+	uint64_t get_range_size() const {return c_actual_range;}
+	bool is_keyed() const {return m_is_keyed;}
+	std::string get_last_err_msg() const {return m_error_log_oss.str();}
+	virtual bool get_entropy(int32_t *dest, const uint32_t size) = 0;
+
+	RandomRangePermutation(const int32_t min_limit, const int32_t max_limit);
+	RandomRangePermutation(const RandomRangePermutation &perm) = delete;
+	RandomRangePermutation & operator=(const RandomRangePermutation &perm) = delete;
+	virtual ~RandomRangePermutation();
+
+private:
+	uint32_t permute(uint32_t index) const;
+	uint32_t encrypt(uint32_t value) const;
+	uint32_t round_function(uint32_t round, uint32_t value) const;
+	void clear_error_log();
+
+private:
+	// Smallest possible value in the randomized sequence.
+	const int32_t c_min_range_value {-2147483647};
+
+	// Largest possible value in the randomized sequence
+	const int32_t c_max_range_value  {2147483647};
+
+	// Feistel rounds, an even amount as in NIST SP 800-38G FF1
+	const uint32_t c_feistel_rounds {10};
+
+	// Smallest value in the randomized sequence
+	const int32_t c_min_limit;
+
+	// Largest value in the randomized sequence
+	const int32_t c_max_limit;
+
+	std::ostringstream m_error_log_oss;
+	uint32_t c_actual_range {0};
+	bool m_is_error {true};
+	bool m_is_keyed {false};
+	// Sizes of the Feistel halves, the left half has one bit less for an odd amount of bits
+	int m_left_bits {0};
+	int m_right_bits {0};
+	uint64_t m_key[2] {0, 0};
+};
+
+} /* namespace tl_algorithm */
+
+#endif /* TL_RANDOMRANGEPERMUTATION_H_ */
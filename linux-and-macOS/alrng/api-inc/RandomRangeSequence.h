@@ -12,9 +12,9 @@
 
 /**
  *    @file RandomRangeSequence.h
- *    @date 11/2/2024
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 1.0
+ *    @version 1.1
  *
  *    @brief Implements a class with an algorithm for generating up to 4294967295 unique sequence of integers within [-2147483647,2147483647] range.
  */
@@ -29,19 +29,29 @@
 
 namespace tl_algorithm {
 
+/*
+ * The sequence is produced by a partial Fisher-Yates shuffle of the range in a single pass.
+ * Each swap position is drawn with Lemire's nearly divisionless method from a pool of entropy bits,
+ * using only a few more bits than the bound requires, so the sequence is uniform and a draw costs
+ * about log2(remaining numbers) + c_extra_draw_bits bits of entropy.
+ */
 class RandomRangeSequence {
 public:
 	bool generate_sequence(int32_t *dest, uint32_t size);
 	std::string get_last_err_msg() const {return m_error_log_oss.str();}
+	uint64_t get_entropy_bytes_used() const {return m_entropy_words_used * sizeof(uint32_t);}
 	virtual bool get_entropy(int32_t *dest, const uint32_t size) = 0;
 
 	RandomRangeSequence(const int32_t min_limit, const int32_t max_limit);
+	RandomRangeSequence(const RandomRangeSequence &seq) = delete;
+	RandomRangeSequence & operator=(const RandomRangeSequence &seq) = delete;
 	virtual ~RandomRangeSequence();
 
 private:
-	void init();
-	void iterate(uint32_t *dest, uint32_t size);
-	void defragment();
+	bool draw_below(uint32_t bound, int bound_bits, uint32_t *value);
+	bool draw_bits(int num_bits, uint32_t *value);
+	bool refill_entropy();
+	uint64_t get_expected_bits(uint32_t size) const;
 	void clear_error_log();
 
 private:
@@ -54,6 +64,15 @@ private:
 	// Maximum amount of numbers that can be generated in the sequence
 	const uint32_t c_max_sequences   {4294967295};
 
+	// Entropy words retrieved at most at once, four device blocks
+	const uint32_t c_entropy_buffer_words {16000};
+
+	// Entropy words retrieved at least at once, so rejected draws do not cost a device request each
+	const uint32_t c_min_entropy_refill_words {16};
+
+	// Bits drawn above the bound size, a draw is rejected with a probability below 2^-c_extra_draw_bits
+	const int c_extra_draw_bits {3};
+
 	// Smallest value in the randomized sequence
 	const int32_t c_min_limit;
 
@@ -61,15 +80,17 @@ private:
 	const int32_t c_max_limit;
 
 	std::ostringstream m_error_log_oss;
-	uint32_t m_dest_idx {0};
 	uint32_t c_actual_range {0};
 	bool m_is_error {true};
-	int32_t *m_number_buffer_1 {nullptr};
-	int32_t *m_number_buffer_2 {nullptr};
-	int32_t *mn_random_buffer {nullptr};
-	int32_t *m_current_number_buffer {nullptr};
-	int32_t *m_other_current_number_buffer {nullptr};
-	uint32_t m_current_number_buffer_size {0};
+	uint32_t *m_number_buffer {nullptr};
+	uint32_t *m_entropy_buffer {nullptr};
+	uint32_t m_entropy_buffer_size {0};
+	uint32_t m_entropy_idx {0};
+	uint64_t m_entropy_words_used {0};
+	uint64_t m_bit_pool {0};
+	int m_bit_pool_size {0};
+	// Entropy bits still expected by the current sequence, limits how much is retrieved
+	uint64_t m_expected_bits {0};
 };
 
 } /* namespace tl_algorithm */
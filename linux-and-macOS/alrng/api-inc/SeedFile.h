@@ -0,0 +1,81 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for keeping a seed of true random bytes generated by an AlphaRNG device across restarts,
+ so random bytes are available before a device connection is established.
+
+ It uses OpenSSL library.
+
+ */
+
+/**
+ *    @file SeedFile.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief A protected, consume once seed file for generating random bytes at startup.
+ */
+
+#ifndef ALPHARNG_API_INC_SEEDFILE_H_
+#define ALPHARNG_API_INC_SEEDFILE_H_
+
+#include <string>
+#include <sstream>
+#include <cstddef>
+
+namespace alpharng {
+
+/*
+ * The file holds a magic value, c_seed_size_bytes of device entropy and a SHA-256 checksum of both.
+ * It is written to a temporary file with 0600 permissions, synced and renamed over the previous
+ * file, so a crash leaves either the old or the new seed behind.
+ *
+ * consume() only accepts a regular file owned by the effective user and not accessible by others.
+ * The file is removed and the removal is synced before any byte is generated from the seed, so the
+ * same seed is never used twice even if the process crashes right after. The seed and bytes from
+ * the operating system, when available without blocking, are hashed into an AES-256 key and the
+ * output is the AES-CTR key stream, the key is erased before returning.
+ */
+class SeedFile {
+public:
+	bool save(const unsigned char *seed);
+	bool consume(unsigned char *out, size_t size);
+	const std::string & get_file_name() const {return m_file_name;}
+	std::string get_last_error() const {return m_error_log_oss.str();}
+
+	explicit SeedFile(const std::string &file_name);
+	SeedFile(const SeedFile &file) = delete;
+	SeedFile & operator=(const SeedFile &file) = delete;
+	virtual ~SeedFile() = default;
+
+public:
+	static const size_t c_seed_size_bytes = 64;
+	// The largest amount of bytes generated from one seed
+	static const size_t c_max_output_bytes = 1048576;
+
+private:
+	static const size_t c_magic_size_bytes = 8;
+	static const size_t c_checksum_size_bytes = 32;
+	static const size_t c_file_size_bytes = c_magic_size_bytes + c_seed_size_bytes + c_checksum_size_bytes;
+	static const char c_magic[c_magic_size_bytes + 1];
+
+	bool read_seed(unsigned char *file_data);
+	bool remove_file();
+	bool sync_directory();
+	bool generate(const unsigned char *seed, unsigned char *out, size_t size);
+	void clear_error_log();
+
+private:
+	std::string m_file_name;
+	std::ostringstream m_error_log_oss;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_SEEDFILE_H_ */
@@ -0,0 +1,101 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for collecting the run time metrics of a server distributing true random bytes
+ generated by an AlphaRNG device and for exposing them in Prometheus text format.
+
+ */
+
+/**
+ *    @file ServerMetrics.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Lock-free server metrics exposed in Prometheus text format
+ */
+
+#ifndef ALPHARNG_API_INC_SERVERMETRICS_H_
+#define ALPHARNG_API_INC_SERVERMETRICS_H_
+
+#include <ProgressReporter.h>
+#include <atomic>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+namespace alpharng {
+
+enum class StreamType : int {entropy = 0, sha256 = 1, sha512 = 2, noise = 3, noise_source_1 = 4, noise_source_2 = 5, test = 6};
+
+// Prometheus histogram of latencies with fixed bucket bounds, any thread may record latencies
+class MetricsHistogram {
+public:
+	void record(int64_t latency_usecs);
+	void write(std::ostream &os, const std::string &name, const std::string &help) const;
+
+	MetricsHistogram();
+	MetricsHistogram(const MetricsHistogram &histogram) = delete;
+	MetricsHistogram & operator=(const MetricsHistogram &histogram) = delete;
+	virtual ~MetricsHistogram() = default;
+
+private:
+	static const int c_bucket_count = 16;
+	static const int64_t c_bucket_bounds_usecs[c_bucket_count];
+	// The last bucket counts latencies above all bounds
+	std::atomic<uint64_t> m_buckets[c_bucket_count + 1];
+	std::atomic<uint64_t> m_sum_usecs;
+	std::atomic<uint64_t> m_count;
+};
+
+/*
+ * Counters and gauges of the server and of the device API. The event loop and the device thread
+ * update them with relaxed atomic operations, a scrape never blocks either of them.
+ */
+class ServerMetrics {
+public:
+	void add_request() {m_request_count.fetch_add(1, std::memory_order_relaxed);}
+	void add_invalid_request() {m_invalid_request_count.fetch_add(1, std::memory_order_relaxed);}
+	void add_failed_request() {m_failed_request_count.fetch_add(1, std::memory_order_relaxed);}
+	void add_bytes_served(StreamType e_type, uint64_t num_bytes);
+	void record_request_latency(int64_t latency_usecs) {m_request_latency.record(latency_usecs);}
+	void record_device_read(int64_t latency_usecs, uint64_t num_bytes);
+	void add_device_failure() {m_device_failure_count.fetch_add(1, std::memory_order_relaxed);}
+	void set_device_counters(const StreamCounters &counters, bool is_connected);
+	void set_rng_status(unsigned char status);
+	void write(std::ostream &os) const;
+
+	ServerMetrics();
+	ServerMetrics(const ServerMetrics &metrics) = delete;
+	ServerMetrics & operator=(const ServerMetrics &metrics) = delete;
+	virtual ~ServerMetrics() = default;
+
+private:
+	static const int c_stream_type_count = 7;
+	static const char * const c_stream_type_names[c_stream_type_count];
+
+	std::atomic<uint64_t> m_bytes_served[c_stream_type_count];
+	std::atomic<uint64_t> m_request_count;
+	std::atomic<uint64_t> m_invalid_request_count;
+	std::atomic<uint64_t> m_failed_request_count;
+	MetricsHistogram m_request_latency;
+	std::atomic<uint64_t> m_device_bytes;
+	std::atomic<uint64_t> m_device_failure_count;
+	MetricsHistogram m_device_latency;
+	std::atomic<int> m_retry_count;
+	std::atomic<int> m_session_count;
+	std::atomic<int> m_max_rct_failures;
+	std::atomic<int> m_max_apt_failures;
+	std::atomic<int> m_is_device_connected;
+	// Negative until the device status is retrieved
+	std::atomic<int> m_rng_status;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_SERVERMETRICS_H_ */
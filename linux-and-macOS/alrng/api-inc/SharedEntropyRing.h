@@ -0,0 +1,144 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a single producer, multiple consumer ring buffer in POSIX shared memory
+ for distributing random bytes to local processes on Linux.
+
+ */
+
+/**
+ *    @file SharedEntropyRing.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.1
+ *
+ *    @brief A shared memory ring for distributing random bytes to local processes without system calls.
+ */
+
+#ifndef ALPHARNG_API_INC_SHAREDENTROPYRING_H_
+#define ALPHARNG_API_INC_SHAREDENTROPYRING_H_
+
+#include <string>
+#include <sstream>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <sys/types.h>
+
+namespace alpharng {
+
+struct RingStatistics {
+	uint64_t bytes_published;
+	uint64_t bytes_claimed;
+	uint64_t level_bytes;
+	int reader_count;
+};
+
+/*
+ * One producer process publishes bytes, any amount of reader processes claim them.
+ * Each byte is handed to exactly one reader: a reader claims a range of bytes with one atomic
+ * add on the shared claim position and copies the range out of the ring.
+ *
+ * Every reader owns a slot where it announces the position it is copying from, the producer
+ * never overwrites bytes at or after the lowest announced position. Readers block on a futex
+ * only when the ring is drained, the producer blocks on another futex when the ring is full.
+ *
+ * The ring is made of two shared memory objects. NAME holds the bytes and the write position,
+ * only the producer can write it and readers map it read only. NAME.ctl holds the claim position,
+ * the futex words and the reader slots, readers write it. Both are created with 0600 permissions,
+ * or with read (NAME) and write (NAME.ctl) access for the group given to create(). Readers
+ * attach only to objects owned by root, by their own user or by the user given to attach(),
+ * and with no write access to NAME for anyone else. A reader with access can read the bytes
+ * claimed by other readers and can stall the ring through NAME.ctl, but it cannot change
+ * the published bytes.
+ */
+class SharedEntropyRing {
+public:
+	bool create(const std::string &name, size_t capacity_bytes, const std::string &reader_group = "");
+	bool attach(const std::string &name, uid_t producer_uid = 0);
+	void detach();
+
+	// Producer
+	bool wait_for_space(size_t num_bytes, int timeout_mlsecs);
+	bool publish(const unsigned char *in, size_t num_bytes);
+	RingStatistics get_statistics() const;
+
+	// Reader
+	bool read(unsigned char *out, size_t num_bytes);
+
+	bool is_attached() const {return m_header != nullptr;}
+	std::string get_last_error() const {return m_error_log_oss.str();}
+
+	SharedEntropyRing() = default;
+	SharedEntropyRing(const SharedEntropyRing &ring) = delete;
+	SharedEntropyRing & operator=(const SharedEntropyRing &ring) = delete;
+	virtual ~SharedEntropyRing();
+
+public:
+	static const size_t c_default_capacity_bytes = 4194304;
+	static const int c_max_readers = 256;
+
+private:
+	struct ReaderSlot {
+		alignas(64) std::atomic<uint64_t> busy_pos;
+		std::atomic<int32_t> pid;
+		std::atomic<uint64_t> bytes_claimed;
+	};
+
+	// Written by the producer only
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint64_t capacity;
+		std::atomic<int32_t> producer_pid;
+		std::atomic<uint32_t> is_closed;
+		alignas(64) std::atomic<uint64_t> write_pos;
+	};
+
+	// Written by the producer and the readers
+	struct Control {
+		alignas(64) std::atomic<uint32_t> data_seq;
+		std::atomic<uint32_t> reader_waiters;
+		alignas(64) std::atomic<uint64_t> claim_pos;
+		alignas(64) std::atomic<uint32_t> space_seq;
+		std::atomic<uint32_t> is_producer_waiting;
+		ReaderSlot slots[c_max_readers];
+	};
+
+private:
+	int create_object(const std::string &name, size_t size_bytes, mode_t mode, gid_t gid);
+	int open_object(const std::string &name, int flags, uid_t producer_uid);
+	bool map(int fd, int control_fd, size_t capacity_bytes);
+	bool register_reader();
+	bool wait_for_data(uint64_t end_pos);
+	uint64_t get_release_pos();
+	void release_dead_readers();
+	void copy_out(uint64_t pos, unsigned char *out, size_t num_bytes) const;
+	static bool is_process_alive(int32_t pid);
+	static size_t get_header_size();
+	static std::string get_control_name(const std::string &name);
+
+private:
+	static const uint32_t c_magic = 0x414c5247;
+	static const uint32_t c_version = 2;
+	static const uint64_t c_idle_pos = UINT64_MAX;
+	static const int c_wait_timeout_mlsecs = 100;
+
+	std::string m_name;
+	Header *m_header = nullptr;
+	unsigned char *m_data = nullptr;
+	size_t m_mapped_bytes = 0;
+	Control *m_control = nullptr;
+	ReaderSlot *m_slot = nullptr;
+	bool m_is_producer = false;
+	std::ostringstream m_error_log_oss;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_SHAREDENTROPYRING_H_ */
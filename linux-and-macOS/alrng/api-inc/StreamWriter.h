@@ -0,0 +1,45 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This interface may only be used in conjunction with TectroLabs devices.
+
+ This interface is used for streaming bytes downloaded from an AlphaRNG device to an output destination.
+
+ */
+
+/**
+ *    @file StreamWriter.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Provides an API for streaming device data to an output destination.
+ */
+
+#ifndef ALPHARNG_API_INC_STREAMWRITER_H_
+#define ALPHARNG_API_INC_STREAMWRITER_H_
+
+#include <string>
+
+namespace alpharng {
+
+class StreamWriter {
+public:
+	// Retrieve a buffer of at least 'size' bytes to be filled with device data, nullptr if failed
+	virtual unsigned char* acquire_buffer(int size) = 0;
+	// Write 'size' bytes of the buffer previously retrieved with acquire_buffer()
+	virtual bool commit_buffer(int size) = 0;
+	// Flush any pending data and close the output destination
+	virtual bool finish() = 0;
+	virtual std::string get_last_error() const = 0;
+
+	StreamWriter() = default;
+	virtual ~StreamWriter() = default;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_STREAMWRITER_H_ */
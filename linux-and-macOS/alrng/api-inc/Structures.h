@@ -12,9 +12,9 @@
 
 /**
  *    @file Structures.h
- *    @date 11/03/2024
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 1.7
+ *    @version 1.16
  *
  *    @brief Data structures used in the API implementation.
  */
@@ -24,6 +24,8 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
+#include <chrono>
 
 namespace alpharng {
 
@@ -99,31 +101,60 @@ enum class CmdOpt : uint8_t {
 	runDiagnostics = 7,
 	extractSha256Entropy = 8,
 	extractSha512Entropy = 9,
-	generateSequence = 10
+	generateSequence = 10,
+	verifyDigest = 11,
+	feedKernel = 12
+};
+
+enum class OutputEncoding : uint8_t {
+	none = 0,
+	hex = 1,
+	base64 = 2,
+	base64url = 3,
+	base32 = 4
 };
 
 struct Cmd {
 	CmdOpt cmd_type;
 	std::string out_file_name;
+	std::vector<std::string> out_sinks;
 	std::string pipe_name;
+	std::string shm_ring_name;
+	std::string shm_ring_group;
+	std::string cuse_device_name;
 	int64_t num_bytes;
 	int op_count;
 	int device_number;
+	bool is_all_devices;
 	int pipe_instances;
 	bool log_statistics;
 	bool disable_stat_tests;
 	int num_failures_threshold;
 	bool err_log_enabled;
 	int ttl_minutes;
+	int entropy_credit_bits;
+	int64_t rate_kbsec;
+	int64_t cache_high_kb;
+	int64_t cache_low_kb;
+	int metrics_port;
+	std::string tcp_address;
+	int tcp_port;
+	std::string psk_file_name;
+	std::string seed_file_name;
+	int progress_interval_secs;
+	bool is_progress_json;
+	OutputEncoding e_encoding;
+	bool is_digest_enabled;
 	int64_t smallest_value;
 	int64_t largest_value;
 	int64_t sequence_size;
+	bool is_stream_sequence;
 };
 struct DeviceStatistics {
 	// Used for measuring performance
-	time_t begin_time;
-	time_t end_time;
-	time_t total_time;
+	std::chrono::steady_clock::time_point begin_time;
+	std::chrono::steady_clock::time_point end_time;
+	double total_time_secs;
 	int download_speed_kbsec; // Measured download speed in KB/sec
 };
 
@@ -0,0 +1,62 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements hex, base64, base64url and base32 text encoders for random bytes.
+ SSSE3 and AVX2 implementations are selected at run time when supported by the CPU.
+
+ */
+
+/**
+ *    @file TextEncoder.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements vectorized text encoders for random bytes.
+ */
+
+#ifndef ALPHARNG_API_INC_TEXTENCODER_H_
+#define ALPHARNG_API_INC_TEXTENCODER_H_
+
+#include <cstdint>
+#include <string>
+
+#include <Structures.h>
+
+namespace alpharng {
+
+class TextEncoder {
+public:
+	int encode(const unsigned char *in, int in_length, char *out, bool is_final) const;
+	int64_t get_encoded_size(int64_t num_bytes, bool is_final) const;
+	int get_input_group_size() const {return m_in_group_bytes;}
+	int get_output_group_size() const {return m_out_group_bytes;}
+	OutputEncoding get_encoding() const {return m_e_encoding;}
+	const char* get_implementation_name() const;
+	static bool parse_encoding(const std::string &name, OutputEncoding &e_encoding);
+
+	explicit TextEncoder(OutputEncoding e_encoding, bool is_simd_enabled = true);
+	virtual ~TextEncoder() = default;
+
+private:
+	enum class SimdLevel : uint8_t {scalar = 0, ssse3 = 1, avx2 = 2};
+
+	int encode_groups(const unsigned char *in, int in_length, char *out) const;
+	int encode_tail(const unsigned char *in, int in_length, char *out) const;
+	static SimdLevel detect_simd_level();
+
+private:
+	const OutputEncoding m_e_encoding;
+	int m_in_group_bytes;
+	int m_out_group_bytes;
+	SimdLevel m_e_simd_level;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_TEXTENCODER_H_ */
@@ -0,0 +1,72 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a token bucket used for pacing device requests to a steady rate.
+
+ */
+
+/**
+ *    @file TokenBucket.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.1
+ *
+ *    @brief Implements a token bucket for pacing device requests.
+ */
+
+#ifndef ALPHARNG_API_INC_TOKENBUCKET_H_
+#define ALPHARNG_API_INC_TOKENBUCKET_H_
+
+#include <cstdint>
+#include <chrono>
+
+namespace alpharng {
+
+struct PacingStatistics {
+	int64_t total_bytes;
+	int64_t request_count;
+	double elapsed_secs;
+	double achieved_rate_bytes_sec;
+	// Deviation of the interval between two device requests from the nominal interval
+	double mean_jitter_mlsecs;
+	double max_jitter_mlsecs;
+};
+
+class TokenBucket {
+public:
+	void configure(int64_t rate_bytes_per_sec, int64_t capacity_bytes);
+	void reset();
+	void acquire(int64_t num_bytes);
+	int64_t try_acquire(int64_t num_bytes, double *wait_secs);
+	bool is_enabled() const {return m_rate_bytes_per_sec > 0;}
+	int64_t get_rate() const {return m_rate_bytes_per_sec;}
+	PacingStatistics get_statistics() const;
+
+	TokenBucket() = default;
+	virtual ~TokenBucket() = default;
+
+private:
+	void refill(std::chrono::steady_clock::time_point now);
+
+private:
+	int64_t m_rate_bytes_per_sec {0};
+	int64_t m_capacity_bytes {0};
+	double m_tokens {0};
+	std::chrono::steady_clock::time_point m_last_refill_time;
+	std::chrono::steady_clock::time_point m_start_time;
+	std::chrono::steady_clock::time_point m_last_request_time;
+	int64_t m_last_request_bytes {0};
+	int64_t m_total_bytes {0};
+	int64_t m_request_count {0};
+	double m_total_jitter_mlsecs {0};
+	double m_max_jitter_mlsecs {0};
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_TOKENBUCKET_H_ */
@@ -0,0 +1,74 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a SHA-256 Merkle tree digest used for verifying the integrity of files
+ with bytes downloaded from an AlphaRNG device.
+
+ */
+
+/**
+ *    @file TreeDigest.h
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements a SHA-256 Merkle tree digest with a sidecar file and parallel verification.
+ */
+
+#ifndef ALPHARNG_API_INC_TREEDIGEST_H_
+#define ALPHARNG_API_INC_TREEDIGEST_H_
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <array>
+#include <cstdint>
+
+namespace alpharng {
+
+typedef std::array<unsigned char, 32> DigestValue;
+
+/*
+ * The stream is split into leaves of c_leaf_size_bytes, the last leaf may be shorter.
+ * Leaf hash: SHA-256(0x00 || leaf bytes). Node hash: SHA-256(0x01 || left || right).
+ * A node without a right sibling is moved to the next level unchanged.
+ * An empty stream has a single empty leaf.
+ */
+class TreeDigest {
+public:
+	static bool hash_leaf(unsigned char *prefixed_leaf, int leaf_bytes, DigestValue &out);
+	static bool compute_root(const std::vector<DigestValue> &leaves, DigestValue &root);
+	static std::string to_hex(const DigestValue &value);
+	static bool from_hex(const std::string &hex, DigestValue &value);
+	static int get_default_thread_count();
+
+	bool write_sidecar(const std::string &sidecar_path, int64_t total_bytes, const std::vector<DigestValue> &leaves,
+			const DigestValue &root);
+	bool read_sidecar(const std::string &sidecar_path, int64_t &total_bytes, std::vector<DigestValue> &leaves,
+			DigestValue &root);
+	bool verify_file(const std::string &file_path_name, int num_threads);
+	std::string get_last_error() const {return m_error_log_oss.str();}
+
+	TreeDigest() = default;
+	virtual ~TreeDigest() = default;
+
+public:
+	static const int c_leaf_size_bytes = 1048576;
+	static const char * const c_sidecar_suffix;
+
+private:
+	static void verify_leaves(const std::string &file_path_name, int64_t total_bytes, int first_leaf, int leaf_step,
+			std::vector<DigestValue> *leaves, bool *is_error);
+
+private:
+	std::ostringstream m_error_log_oss;
+};
+
+} /* namespace alpharng */
+
+#endif /* ALPHARNG_API_INC_TREEDIGEST_H_ */
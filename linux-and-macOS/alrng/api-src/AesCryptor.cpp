@@ -15,9 +15,9 @@
 
 /**
  *    @file AesCryptor.cpp
- *    @date 09/16/2023
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 1.3
+ *    @version 1.4
  *
  *    @brief Encrypts or decrypts session data using AES-GCM with 128 or 256 bit keys.
  */
@@ -191,6 +191,63 @@ bool AesCryptor::initialize_iv() {
 	return true;
 }
 
+/**
+ * Replace the random key with a key agreed on by other means, such as a key derived from a pre-shared secret.
+ * Call set_iv() before encrypting or decrypting with the new key.
+ *
+ * @param[in] in points to the new key
+ * @param[in] in_byte_count key size in bytes, must match the AES key size
+ *
+ * @return true if the key was replaced successfully
+ */
+bool AesCryptor::set_key(const unsigned char *in, int in_byte_count) {
+	if (!m_initialized || in == nullptr || in_byte_count != get_key_size_bytes()) {
+		return false;
+	}
+	memcpy(m_key, in, in_byte_count);
+	return true;
+}
+
+/**
+ * Use the IV provided by the caller for the next encryption and decryption, for example a message counter.
+ * The caller is responsible for never repeating an IV with the same key.
+ *
+ * @param[in] in points to 12 bytes of the new IV
+ *
+ * @return true if IV updated successfully
+ */
+bool AesCryptor::set_iv(const unsigned char *in) {
+	if (!m_initialized || in == nullptr) {
+		return false;
+	}
+	memcpy(m_iv, in, sizeof(m_iv));
+
+	if (EVP_EncryptInit_ex(m_ctx_enc, nullptr, nullptr, m_key, m_iv) != 1) {
+		return false;
+	}
+
+	if (EVP_DecryptInit_ex(m_ctx_dec, nullptr, nullptr, m_key, m_iv) != 1) {
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Replace the random AAD authenticated with each encryption and decryption
+ *
+ * @param[in] in points to 16 bytes of the new AAD
+ *
+ * @return true if AAD updated successfully
+ */
+bool AesCryptor::set_aad(const unsigned char *in) {
+	if (!m_initialized || in == nullptr) {
+		return false;
+	}
+	memcpy(m_aad, in, sizeof(m_aad));
+	return true;
+}
+
 /**
  * Decrypt bytes with AES using the current key
  *
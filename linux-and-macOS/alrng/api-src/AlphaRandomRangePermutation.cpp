@@ -0,0 +1,51 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a keyed pseudorandom permutation of a range of integers, keyed with true random bytes
+ produced by an AlphaRNG device. Sequences taken from the permutation do not contain duplicates.
+
+ */
+
+/**
+ *    @file AlphaRandomRangePermutation.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief A class for streaming sequences of unique integers from a permutation keyed by an AlphaRNG device.
+ */
+#include <AlphaRandomRangePermutation.h>
+
+namespace alpharng {
+
+/**
+ *
+ * @param AlphaRngApi *api - a connected AlphaRNG device used for the permutation keys
+ * @param int32_t min_limit - the smallest number in the range
+ * @param int32_t max_limit - the largest number in the range
+ */
+AlphaRandomRangePermutation::AlphaRandomRangePermutation(AlphaRngApi *api, const int32_t min_limit, const int32_t max_limit)
+		: RandomRangePermutation(min_limit, max_limit), m_api(api) {
+}
+
+/**
+ * Implementing a method for retrieving entropy from AlphaRNG device
+ *
+ * @param int32_t *dest - destination memory
+ * @param uint32_t size - how many numbers of entropy to retrieve
+ * @return bool - true when entropy successfully retrieved
+ *
+ */
+bool AlphaRandomRangePermutation::get_entropy(int32_t *dest, const uint32_t size) {
+	return m_api->get_entropy((uint8_t*)dest, size * 4);
+}
+
+AlphaRandomRangePermutation::~AlphaRandomRangePermutation() {
+}
+
+} /* namespace alpharng */
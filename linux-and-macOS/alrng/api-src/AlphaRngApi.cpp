@@ -12,14 +12,16 @@
 
 /**
  *    @file AlphaRngApi.cpp
- *    @date 07/20/2024
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 1.10
+ *    @version 1.18
  *
  *    @brief Implements the API for securely interacting with the AlphaRNG device.
  */
 
 #include <AlphaRngApi.h>
+#include <climits>
+#include <openssl/crypto.h>
 
 using namespace std;
 
@@ -299,12 +301,31 @@ bool AlphaRngApi::get_noise_source_2(unsigned char *out, int out_length) {
  * This is the method for retrieving high quality, non biased, random bytes that can be directly used in applications
  * or can feed the entropy inputs of DRBG(s).
  *
+ * After load_seed_file() the bytes are generated from the seed until connect() succeeds.
+ * While connect() runs, one other thread may call this method: the request is served from the seed
+ * or, once the seed bytes are used up, waits until connect() returns.
+ *
  * @param[out] out points to a byte array for storing the random bytes retrieved
  * @param[in] out_length how many random bytes to retrieve
  *
  * @return true for successful operation
  */
 bool AlphaRngApi::get_entropy(unsigned char *out, int out_length) {
+	if (m_has_seed_bytes.load() && take_seed_bytes(out, out_length)) {
+		return true;
+	}
+	return get_device_entropy(out, out_length);
+}
+
+/**
+ * Retrieve entropy bytes from the AlphaRNG device, never from the seed
+ *
+ * @param[out] out points to a byte array for storing the random bytes retrieved
+ * @param[in] out_length how many random bytes to retrieve
+ *
+ * @return true for successful operation
+ */
+bool AlphaRngApi::get_device_entropy(unsigned char *out, int out_length) {
 	if (!is_initialized() || !is_connected()) {
 		return false;
 	}
@@ -316,6 +337,82 @@ bool AlphaRngApi::get_entropy(unsigned char *out, int out_length) {
 	}
 }
 
+#ifndef _WIN64
+/**
+ * Retrieve entropy bytes for several buffers at once, such as a batch of keys.
+ * The buffers are filled in order from consecutive device blocks, so the amount of device
+ * requests depends on the total size only. Whole blocks are retrieved straight into buffers
+ * that are large enough, the rest goes through a block buffer that is erased before returning.
+ *
+ * @param[in] iov buffers to fill with random bytes, entries with zero length are skipped
+ * @param[in] iov_count number of entries in iov
+ *
+ * @return true for successful operation
+ */
+bool AlphaRngApi::get_entropy_v(const struct iovec *iov, int iov_count) {
+	if (!is_initialized() || !is_connected()) {
+		return false;
+	}
+	clear_error_log();
+	if (iov == nullptr || iov_count < 1) {
+		m_error_log_oss << "Invalid amount of buffers requested: " << iov_count << ". " << endl;
+		return false;
+	}
+	size_t remaining_bytes = 0;
+	for (int i = 0; i < iov_count; ++i) {
+		if (iov[i].iov_base == nullptr && iov[i].iov_len > 0) {
+			m_error_log_oss << "Buffer " << i << " is not allocated. " << endl;
+			return false;
+		}
+		remaining_bytes += iov[i].iov_len;
+	}
+	if (remaining_bytes == 0) {
+		m_error_log_oss << "Invalid amount of bytes requested: 0. " << endl;
+		return false;
+	}
+
+	const size_t block_size = (size_t)c_rnd_data_block_size_bytes;
+	const size_t max_direct_bytes = (size_t)(INT_MAX - INT_MAX % c_rnd_data_block_size_bytes);
+	vector<unsigned char> block;
+	size_t block_level = 0;
+	size_t block_offset = 0;
+	bool status = true;
+	for (int i = 0; status && i < iov_count; ++i) {
+		unsigned char *dest = (unsigned char*)iov[i].iov_base;
+		size_t size = iov[i].iov_len;
+		while (status && size > 0) {
+			if (block_offset == block_level) {
+				if (size >= block_size) {
+					size_t direct_bytes = min(size - size % block_size, max_direct_bytes);
+					status = get_entropy(dest, (int)direct_bytes);
+					dest += direct_bytes;
+					size -= direct_bytes;
+					remaining_bytes -= direct_bytes;
+					continue;
+				}
+				block.resize(block_size);
+				block_level = min(remaining_bytes, block_size);
+				block_offset = 0;
+				status = get_entropy(block.data(), (int)block_level);
+				if (!status) {
+					break;
+				}
+			}
+			size_t copy_bytes = min(size, block_level - block_offset);
+			memcpy(dest, block.data() + block_offset, copy_bytes);
+			block_offset += copy_bytes;
+			dest += copy_bytes;
+			size -= copy_bytes;
+			remaining_bytes -= copy_bytes;
+		}
+	}
+	if (!block.empty()) {
+		OPENSSL_cleanse(block.data(), block.size());
+	}
+	return status;
+}
+#endif
+
 /**
  * Extract entropy bytes by applying SHA-256 method to RAW random bytes retrieved from an AlphaRNG device.
  * This is the method for generating high quality, non biased, random bytes that can be directly used in applications
@@ -439,9 +536,6 @@ bool AlphaRngApi::get_test_data(unsigned char *out, int out_length) {
  * @return true for successful operation
  */
 bool AlphaRngApi::entropy_to_file(const string &file_path_name, int64_t num_bytes) {
-	if (!is_initialized() || !is_connected()) {
-		return false;
-	}
 	return to_file(CommandType::getEntropy, file_path_name, num_bytes);
 }
 
@@ -456,9 +550,6 @@ bool AlphaRngApi::entropy_to_file(const string &file_path_name, int64_t num_byte
  * @return true for successful operation
  */
 bool AlphaRngApi::extract_sha256_entropy_to_file(const string &file_path_name, int64_t num_bytes) {
-	if (!is_initialized() || !is_connected()) {
-		return false;
-	}
 	return to_file(CommandType::extractSha256Entropy, file_path_name, num_bytes);
 }
 
@@ -473,9 +564,6 @@ bool AlphaRngApi::extract_sha256_entropy_to_file(const string &file_path_name, i
  * @return true for successful operation
  */
 bool AlphaRngApi::extract_sha512_entropy_to_file(const string &file_path_name, int64_t num_bytes) {
-	if (!is_initialized() || !is_connected()) {
-		return false;
-	}
 	return to_file(CommandType::extractSha512Entropy, file_path_name, num_bytes);
 }
 
@@ -491,9 +579,6 @@ bool AlphaRngApi::extract_sha512_entropy_to_file(const string &file_path_name, i
  * @return true for successful operation
  */
 bool AlphaRngApi::noise_to_file(const string &file_path_name, int64_t num_bytes) {
-	if (!is_initialized() || !is_connected()) {
-		return false;
-	}
 	return to_file(CommandType::getNoise, file_path_name, num_bytes);
 }
 
@@ -528,9 +613,6 @@ bool AlphaRngApi::get_data(CommandType cmd_type, unsigned char *out, int out_len
  * @return true for successful operation
  */
 bool AlphaRngApi::noise_source_one_to_file(const string &file_path_name, const int64_t num_bytes) {
-	if (!is_initialized() || !is_connected()) {
-		return false;
-	}
 	return to_file(CommandType::getNoiseSourceOne, file_path_name, num_bytes);
 }
 
@@ -545,80 +627,196 @@ bool AlphaRngApi::noise_source_one_to_file(const string &file_path_name, const i
  * @return true for successful operation
  */
 bool AlphaRngApi::noise_source_two_to_file(const string &file_path_name, const int64_t num_bytes) {
-	if (!is_initialized() || !is_connected()) {
-		return false;
-	}
 	return to_file(CommandType::getNoiseSourceTwo, file_path_name, num_bytes);
 }
 
 bool AlphaRngApi::to_file(CommandType cmd_type, const string &file_path_name, int64_t num_bytes) {
 	clear_error_log();
-	if (num_bytes < 0) {
-		m_error_log_oss << "Invalid amount of bytes requested: " << num_bytes << ". " << endl;
+	// Check the device before the output file is created or truncated
+	if (!is_stream_ready() || !validate_stream_size(num_bytes)) {
 		return false;
 	}
-	if (num_bytes > c_max_file_ouput_bytes) {
-		m_error_log_oss << "Amount of bytes cannot exceed: " << c_max_file_ouput_bytes << ". " << endl;
+	FileStreamWriter writer(c_file_output_buff_size_bytes);
+	if (!writer.open(file_path_name)) {
+		m_error_log_oss << writer.get_last_error();
 		return false;
 	}
-
-	if (m_file_buffer == nullptr) {
-		m_file_buffer = new (nothrow) unsigned char[c_file_output_buff_size_bytes];
-		if (m_file_buffer == nullptr) {
-			m_error_log_oss << "Could not allocate memory for the file buffer" << ". " << endl;
-			return false;
-		}
+	if (m_is_output_digest && num_bytes > 0) {
+		DigestStreamWriter digest_writer(writer, file_path_name + TreeDigest::c_sidecar_suffix,
+				TreeDigest::get_default_thread_count());
+		return to_stream(cmd_type, digest_writer, num_bytes);
 	}
+	return to_stream(cmd_type, writer, num_bytes);
+}
 
-	ofstream os_file(file_path_name.c_str(), ios::out | ios::binary);
-	if(!os_file.good()) {
-		m_error_log_oss << "Could not open file: " << file_path_name << ". " << endl;
+/**
+ * Retrieve bytes from the AlphaRNG device and stream those to a writer.
+ * Each block of bytes is retrieved directly into a buffer supplied by the writer.
+ * When an output encoding is set, the writer receives text in blocks of up to 100000 characters.
+ *
+ * @param[in] cmd_type type of data to retrieve: entropy, extracted entropy or noise
+ * @param[in] writer destination for the retrieved bytes
+ * @param[in] num_bytes how many bytes to retrieve, 0 - for continuous operation
+ *
+ * @return true for successful operation
+ */
+bool AlphaRngApi::to_stream(CommandType cmd_type, StreamWriter &writer, int64_t num_bytes) {
+	clear_error_log();
+	if (!is_stream_ready() || !validate_stream_size(num_bytes)) {
 		return false;
 	}
-
-	if (num_bytes == 0) {
-		// Infinite loop
-		while (true) {
-			if(!get_data(cmd_type, m_file_buffer, c_file_output_buff_size_bytes)) {
-				return false;
-			}
-			os_file.write((const char*)m_file_buffer, c_file_output_buff_size_bytes);
-			if(!os_file.good()) {
-				m_error_log_oss << "Could not continuously write " << c_file_output_buff_size_bytes << " bytes to file: " << file_path_name << ". " << endl;
-				return false;
-			}
-		}
+	if (m_e_output_encoding != OutputEncoding::none) {
+		EncodingStreamWriter encoding_writer(writer, m_e_output_encoding, c_file_output_buff_size_bytes, c_file_output_buff_size_bytes);
+		return stream_to_writer(cmd_type, encoding_writer, num_bytes);
 	}
+	return stream_to_writer(cmd_type, writer, num_bytes);
+}
 
-	int64_t num_chunks = num_bytes / c_file_output_buff_size_bytes;
-	int64_t num_remaining_bytes = num_bytes % c_file_output_buff_size_bytes;
+/**
+ * Check that the device can stream bytes, logging the reason when it cannot.
+ *
+ * @return true when the API is initialized and the device is connected
+ */
+bool AlphaRngApi::is_stream_ready() {
+	if (!is_initialized()) {
+		m_error_log_oss << "AlphaRNG API is not initialized. " << endl;
+		return false;
+	}
+	if (!is_connected()) {
+		m_error_log_oss << "AlphaRNG device is not connected. " << endl;
+		return false;
+	}
+	return true;
+}
 
-	for (int64_t i = 0; i < num_chunks; ++i) {
-		if(!get_data(cmd_type, m_file_buffer, c_file_output_buff_size_bytes)) {
-			return false;
+bool AlphaRngApi::stream_to_writer(CommandType cmd_type, StreamWriter &writer, int64_t num_bytes) {
+	const int stream_chunk_bytes = get_stream_chunk_size(m_token_bucket.get_rate());
+	int64_t remaining_bytes = num_bytes;
+	m_token_bucket.reset();
+	if (m_progress_reporter) {
+		m_progress_reporter->start();
+	}
+	// Zero amount of bytes requested means infinite loop
+	while (num_bytes == 0 || remaining_bytes > 0) {
+		int chunk_bytes = stream_chunk_bytes;
+		if (num_bytes > 0 && remaining_bytes < chunk_bytes) {
+			chunk_bytes = (int)remaining_bytes;
 		}
-		os_file.write((const char*)m_file_buffer, c_file_output_buff_size_bytes);
-		if(!os_file.good()) {
-			m_error_log_oss << "Could not write " << c_file_output_buff_size_bytes << " bytes to file: " << file_path_name << ". " << endl;
+		unsigned char *buffer = writer.acquire_buffer(chunk_bytes);
+		if (buffer == nullptr) {
+			m_error_log_oss << writer.get_last_error();
 			return false;
 		}
-	}
-	if (num_remaining_bytes) {
-		if(!get_data(cmd_type, m_file_buffer, (int)num_remaining_bytes)) {
+		// Pace the device requests, not just the writes
+		m_token_bucket.acquire(chunk_bytes);
+		chrono::steady_clock::time_point request_time = chrono::steady_clock::now();
+		if (!get_data(cmd_type, buffer, chunk_bytes)) {
 			return false;
 		}
-		os_file.write((const char*)m_file_buffer, num_remaining_bytes);
-		if(!os_file.good()) {
-			m_error_log_oss << "Could not write last " <<  num_remaining_bytes << " to file: " << file_path_name << ". " << endl;
+		chrono::steady_clock::duration latency = chrono::steady_clock::now() - request_time;
+		if (!writer.commit_buffer(chunk_bytes)) {
+			m_error_log_oss << writer.get_last_error();
 			return false;
 		}
+		remaining_bytes -= chunk_bytes;
+		if (m_progress_reporter) {
+			m_progress_reporter->record_block(chunk_bytes, latency, get_stream_counters());
+		}
 	}
-	os_file.close();
-	if(!os_file.good()) {
-		m_error_log_oss << "Could not close file: " << file_path_name << ". " << endl;
+	m_pacing_stats = m_token_bucket.get_statistics();
+	if (m_progress_reporter) {
+		m_progress_reporter->finish(get_stream_counters());
+	}
+
+	if (!writer.finish()) {
+		m_error_log_oss << writer.get_last_error();
 		return false;
 	}
+	return true;
+}
 
+/**
+ * Limit the rate at which bytes are retrieved from the device by to_stream() and the *_to_file() methods.
+ * Device requests are paced with a token bucket so the device is not polled faster than needed.
+ * Bytes are requested in multiples of the device block size, so rates below one block
+ * per second result in one block delivered at a time.
+ *
+ * @param[in] rate_bytes_per_sec amount of bytes per second, 0 - no rate limit
+ *
+ * @return true for successful operation
+ */
+bool AlphaRngApi::set_stream_rate(int64_t rate_bytes_per_sec) {
+	if (rate_bytes_per_sec < 0) {
+		m_error_log_oss << "Stream rate " << rate_bytes_per_sec << " cannot be negative." << endl;
+		return false;
+	}
+	m_token_bucket.configure(rate_bytes_per_sec, get_stream_chunk_size(rate_bytes_per_sec));
+	return true;
+}
+
+/**
+ * Set the text encoding applied to bytes streamed by to_stream() and the *_to_file() methods.
+ * The amount of bytes requested refers to the bytes retrieved from the device, before encoding.
+ *
+ * @param[in] e_encoding hex, base64, base64url, base32 or none for binary output
+ */
+void AlphaRngApi::set_output_encoding(OutputEncoding e_encoding) {
+	m_e_output_encoding = e_encoding;
+}
+
+/**
+ * Enable a SHA-256 tree digest of the bytes stored by the *_to_file() methods.
+ * The digest is computed while downloading and stored next to the output file
+ * with the TreeDigest::c_sidecar_suffix suffix. It is not created for continuous operation.
+ *
+ * @param[in] is_enabled true to create the digest sidecar file
+ */
+void AlphaRngApi::set_output_digest(bool is_enabled) {
+	m_is_output_digest = is_enabled;
+}
+
+/**
+ * @param[in] rate_bytes_per_sec stream rate, 0 - no rate limit
+ *
+ * @return amount of bytes retrieved from the device per stream request, about
+ * c_pacing_requests_per_sec requests per second when the stream is paced
+ */
+int AlphaRngApi::get_stream_chunk_size(int64_t rate_bytes_per_sec) const {
+	if (rate_bytes_per_sec == 0) {
+		return c_file_output_buff_size_bytes;
+	}
+	int64_t chunk_bytes = rate_bytes_per_sec / c_pacing_requests_per_sec;
+	chunk_bytes -= chunk_bytes % c_rnd_data_block_size_bytes;
+	if (chunk_bytes < c_rnd_data_block_size_bytes) {
+		chunk_bytes = c_rnd_data_block_size_bytes;
+	}
+	if (chunk_bytes > c_file_output_buff_size_bytes) {
+		chunk_bytes = c_file_output_buff_size_bytes;
+	}
+	return (int)chunk_bytes;
+}
+
+/**
+ * @return retry, session and health test counters of the current connection
+ */
+StreamCounters AlphaRngApi::get_stream_counters() const {
+	StreamCounters counters;
+	counters.retry_count = m_op_retry_count;
+	counters.session_count = m_session_count;
+	counters.max_rct_failures = m_health_test.get_max_rct_failures();
+	counters.max_apt_failures = m_health_test.get_max_apt_failures();
+	return counters;
+}
+
+bool AlphaRngApi::validate_stream_size(int64_t num_bytes) {
+	if (num_bytes < 0) {
+		m_error_log_oss << "Invalid amount of bytes requested: " << num_bytes << ". " << endl;
+		return false;
+	}
+	if (num_bytes > c_max_file_ouput_bytes) {
+		m_error_log_oss << "Amount of bytes cannot exceed: " << c_max_file_ouput_bytes << ". " << endl;
+		return false;
+	}
 	return true;
 }
 
@@ -885,7 +1083,21 @@ bool AlphaRngApi::connect(int device_number) {
 	if (!is_initialized() || m_device->is_connected()) {
 		return false;
 	}
+	{
+		lock_guard<mutex> lock(m_seed_mtx);
+		m_is_connecting = true;
+	}
+	bool status = connect_with_retry(device_number);
+	finish_seeded_connect(status);
+	return status;
+}
 
+/**
+ * @param[in] device_number device number, 0 for the first device
+ *
+ * @return true if connection was successful
+ */
+bool AlphaRngApi::connect_with_retry(int device_number) {
 	m_op_retry_count = 0;
 
 	for (int tries = 0; tries < c_max_command_retry_count; ++tries) {
@@ -900,6 +1112,129 @@ bool AlphaRngApi::connect(int device_number) {
 	return false;
 }
 
+/**
+ * Consume a seed file saved by an earlier connection, get_entropy() then serves bytes generated
+ * from the seed until connect() succeeds. The file name is kept even when the file cannot be
+ * consumed, so a successful connect() saves a new seed for the next start.
+ * Must be called before connect().
+ *
+ * @param[in] file_name seed file pathname
+ *
+ * @return true when the seed was consumed
+ */
+bool AlphaRngApi::load_seed_file(const string &file_name) {
+	if (!is_initialized()) {
+		return false;
+	}
+	clear_error_log();
+	if (m_device->is_connected()) {
+		m_error_log_oss << "The seed file must be loaded before connecting to the device. " << endl;
+		return false;
+	}
+	m_seed_file_name = file_name;
+	vector<unsigned char> seed_bytes(c_seed_output_bytes);
+	SeedFile seed_file(file_name);
+	if (!seed_file.consume(seed_bytes.data(), seed_bytes.size())) {
+		m_error_log_oss << seed_file.get_last_error();
+		return false;
+	}
+	lock_guard<mutex> lock(m_seed_mtx);
+	if (!m_seed_bytes.empty()) {
+		OPENSSL_cleanse(m_seed_bytes.data(), m_seed_bytes.size());
+	}
+	m_seed_bytes.swap(seed_bytes);
+	m_seed_offset = 0;
+	m_has_seed_bytes = true;
+	return true;
+}
+
+/**
+ * Replace the seed file with entropy bytes retrieved from the device, the bytes are not returned
+ * to the caller. connect() calls it after load_seed_file(), applications may call it periodically
+ * and before exiting.
+ *
+ * @return true for successful operation
+ */
+bool AlphaRngApi::save_seed_file() {
+	if (!is_initialized()) {
+		return false;
+	}
+	if (m_seed_file_name.empty()) {
+		clear_error_log();
+		m_error_log_oss << "No seed file was loaded. " << endl;
+		return false;
+	}
+	unsigned char seed[SeedFile::c_seed_size_bytes];
+	if (!get_device_entropy(seed, (int)sizeof(seed))) {
+		return false;
+	}
+	SeedFile seed_file(m_seed_file_name);
+	bool status = seed_file.save(seed);
+	if (!status) {
+		m_error_log_oss << seed_file.get_last_error();
+	}
+	OPENSSL_cleanse(seed, sizeof(seed));
+	return status;
+}
+
+/**
+ * @return amount of bytes generated from the seed file and returned by get_entropy()
+ */
+uint64_t AlphaRngApi::get_seed_bytes_served() {
+	lock_guard<mutex> lock(m_seed_mtx);
+	return m_seed_bytes_served;
+}
+
+/**
+ * Serve a get_entropy() request from the seed. When the seed bytes left are not enough while another
+ * thread connects, wait until connect() returns so the device serves the request.
+ *
+ * @param[out] out points to a byte array for storing the random bytes retrieved
+ * @param[in] out_length how many random bytes to retrieve
+ *
+ * @return true when the request was served from the seed
+ */
+bool AlphaRngApi::take_seed_bytes(unsigned char *out, int out_length) {
+	unique_lock<mutex> lock(m_seed_mtx);
+	if (m_seed_bytes.empty() || out_length < 1 || out == nullptr) {
+		return false;
+	}
+	if (m_seed_bytes.size() - m_seed_offset >= (size_t)out_length) {
+		unsigned char *seed_bytes = m_seed_bytes.data() + m_seed_offset;
+		memcpy(out, seed_bytes, out_length);
+		OPENSSL_cleanse(seed_bytes, out_length);
+		m_seed_offset += out_length;
+		m_seed_bytes_served += out_length;
+		return true;
+	}
+	m_cv_seed.wait(lock, [this] {return !m_is_connecting;});
+	return false;
+}
+
+/**
+ * Stop serving the seed after a successful connection, saving a new seed file first.
+ * Requests waiting for the connection are released afterwards.
+ *
+ * @param[in] is_connected true if connect() succeeded
+ */
+void AlphaRngApi::finish_seeded_connect(bool is_connected) {
+	if (is_connected && !m_seed_file_name.empty()) {
+		// A failed save does not fail the connection, the error is left in the error log
+		save_seed_file();
+	}
+	{
+		lock_guard<mutex> lock(m_seed_mtx);
+		m_is_connecting = false;
+		if (is_connected && !m_seed_bytes.empty()) {
+			OPENSSL_cleanse(m_seed_bytes.data(), m_seed_bytes.size());
+			m_seed_bytes.clear();
+			m_seed_offset = 0;
+			m_has_seed_bytes = false;
+		}
+	}
+	m_cv_seed.notify_all();
+}
+
 bool AlphaRngApi::connect_internal(int device_number) {
 	clear_error_log();
 	get_device_count();
@@ -1493,6 +1828,9 @@ bool AlphaRngApi::set_session_ttl(time_t time_to_live_mins) {
 }
 
 AlphaRngApi::~AlphaRngApi() {
+	if (!m_seed_bytes.empty()) {
+		OPENSSL_cleanse(m_seed_bytes.data(), m_seed_bytes.size());
+	}
 	if (m_hmac) {
 		delete m_hmac;
 	}
@@ -1508,9 +1846,6 @@ AlphaRngApi::~AlphaRngApi() {
 	if (m_device_name) {
 		delete [] m_device_name;
 	}
-	if (m_file_buffer) {
-		delete [] m_file_buffer;
-	}
 	if (m_sha_256) {
 		delete m_sha_256;
 	}
@@ -0,0 +1,304 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for retrieving random bytes from the AlphaRNG device without blocking the caller,
+ so event loops can integrate device reads without dedicating threads to them.
+
+ */
+
+/**
+ *    @file AlphaRngApiAsync.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Asynchronous requests executed by an I/O thread that owns an AlphaRngApi connection.
+ */
+
+#include <AlphaRngApiAsync.h>
+
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+using namespace std;
+
+namespace alpharng {
+
+/**
+ * Constructor, starts the I/O thread
+ *
+ * @param[in] rng a connected AlphaRngApi instance used only by the I/O thread
+ * @param[in] queue_size max amount of requests submitted and not reported yet, 0 for the default
+ */
+AlphaRngApiAsync::AlphaRngApiAsync(AlphaRngApi *rng, int queue_size) : m_rng(rng),
+		m_queue_size(queue_size == 0 ? c_default_queue_size : queue_size) {
+	if (m_rng == nullptr || m_queue_size < 1 || m_queue_size > c_max_queue_size) {
+		m_last_error = "Invalid parameters for the asynchronous API";
+		return;
+	}
+#ifdef __linux__
+	m_read_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	m_write_fd = m_read_fd;
+	if (m_read_fd < 0) {
+		m_last_error = string("Could not create an eventfd, error: ") + strerror(errno);
+		return;
+	}
+#else
+	int fds[2];
+	if (pipe(fds) != 0) {
+		m_last_error = string("Could not create a pipe, error: ") + strerror(errno);
+		return;
+	}
+	m_read_fd = fds[0];
+	m_write_fd = fds[1];
+	for (int fd : fds) {
+		fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+		fcntl(fd, F_SETFD, FD_CLOEXEC);
+	}
+#endif
+	m_thread = thread(&AlphaRngApiAsync::run, this);
+	m_is_initialized = true;
+}
+
+/**
+ * Queue a request for the I/O thread
+ *
+ * @param[in] e_op operation to execute
+ * @param[out] out location for the bytes, must stay valid until the request is reported
+ * @param[in] out_length how many bytes to retrieve
+ * @param[in] callback invoked from poll() with the request id and its final status
+ *
+ * @return the request id, a positive number, or a negative status when the request is rejected
+ */
+int64_t AlphaRngApiAsync::submit(AsyncOperation e_op, unsigned char *out, int out_length, const Callback &callback) {
+	if (!m_is_initialized || out == nullptr || out_length < 1 || e_op < AsyncOperation::getEntropy
+			|| e_op > AsyncOperation::getNoiseSource2) {
+		return c_status_invalid;
+	}
+	unique_lock<mutex> lock(m_mtx);
+	if (m_is_stopping) {
+		return c_status_failed;
+	}
+	if ((int)m_requests.size() >= m_queue_size) {
+		return c_status_queue_full;
+	}
+	Request *request = new (nothrow) Request {m_next_id, e_op, out, out_length, callback, c_status_queued, false};
+	if (request == nullptr) {
+		return c_status_failed;
+	}
+	m_next_id++;
+	m_queue.push_back(request);
+	m_requests[request->id] = request;
+	lock.unlock();
+	m_cv_queue.notify_one();
+	return request->id;
+}
+
+/**
+ * Report completed requests by invoking their callbacks on the calling thread
+ *
+ * @param[in] timeout_mlsecs how long to wait for a completion, 0 to return immediately, negative to wait indefinitely
+ *
+ * @return amount of requests reported
+ */
+int AlphaRngApiAsync::poll(int timeout_mlsecs) {
+	if (!m_is_initialized) {
+		return c_status_invalid;
+	}
+	deque<Request*> completed;
+	{
+		unique_lock<mutex> lock(m_mtx);
+		auto is_ready = [this] {return !m_completed.empty() || m_is_stopping;};
+		if (timeout_mlsecs < 0) {
+			m_cv_completed.wait(lock, is_ready);
+		} else if (timeout_mlsecs > 0) {
+			m_cv_completed.wait_for(lock, chrono::milliseconds(timeout_mlsecs), is_ready);
+		}
+		completed.swap(m_completed);
+		for (Request *request : completed) {
+			m_requests.erase(request->id);
+		}
+		drain_fd();
+	}
+	for (Request *request : completed) {
+		if (request->callback) {
+			request->callback(request->id, request->status);
+		}
+		delete request;
+	}
+	return (int)completed.size();
+}
+
+/**
+ * Cancel a request that is not reported yet
+ *
+ * @param[in] request_id the id returned by submit()
+ *
+ * @return 0 when the request will be reported as cancelled, c_status_invalid when it is unknown or already completed
+ */
+int AlphaRngApiAsync::cancel(int64_t request_id) {
+	lock_guard<mutex> lock(m_mtx);
+	auto it = m_requests.find(request_id);
+	if (it == m_requests.end()) {
+		return c_status_invalid;
+	}
+	Request *request = it->second;
+	if (request->status == c_status_queued) {
+		for (auto qit = m_queue.begin(); qit != m_queue.end(); ++qit) {
+			if (*qit == request) {
+				m_queue.erase(qit);
+				break;
+			}
+		}
+		complete(request, c_status_cancelled);
+		return c_status_completed;
+	}
+	if (request->status == c_status_running) {
+		request->is_cancelled = true;
+		return c_status_completed;
+	}
+	return c_status_invalid;
+}
+
+/**
+ * Retrieve the status of a request that is not reported yet
+ *
+ * @param[in] request_id the id returned by submit()
+ *
+ * @return the request status, c_status_invalid when the request is unknown or already reported
+ */
+int AlphaRngApiAsync::get_status(int64_t request_id) {
+	lock_guard<mutex> lock(m_mtx);
+	auto it = m_requests.find(request_id);
+	return it == m_requests.end() ? c_status_invalid : it->second->status;
+}
+
+/**
+ * Retrieve the message of the last failed request
+ *
+ * @return the error message
+ */
+string AlphaRngApiAsync::get_last_error() {
+	lock_guard<mutex> lock(m_mtx);
+	return m_last_error;
+}
+
+/**
+ * Execute queued requests until the object is destroyed
+ */
+void AlphaRngApiAsync::run() {
+	unique_lock<mutex> lock(m_mtx);
+	while (true) {
+		m_cv_queue.wait(lock, [this] {return !m_queue.empty() || m_is_stopping;});
+		if (m_is_stopping) {
+			return;
+		}
+		Request *request = m_queue.front();
+		m_queue.pop_front();
+		request->status = c_status_running;
+		lock.unlock();
+
+		const bool is_successful = execute(request);
+		const string error = is_successful ? "" : m_rng->get_last_error();
+
+		lock.lock();
+		if (!is_successful) {
+			m_last_error = error;
+		}
+		complete(request, request->is_cancelled ? c_status_cancelled : is_successful ? c_status_completed : c_status_failed);
+	}
+}
+
+/**
+ * Execute a request on the AlphaRngApi instance
+ *
+ * @param[in] request the request to execute
+ *
+ * @return true when successful
+ */
+bool AlphaRngApiAsync::execute(const Request *request) {
+	switch (request->e_op) {
+	case AsyncOperation::getEntropy:
+		return m_rng->get_entropy(request->out, request->out_length);
+	case AsyncOperation::extractSha256Entropy:
+		return m_rng->extract_sha256_entropy(request->out, request->out_length);
+	case AsyncOperation::extractSha512Entropy:
+		return m_rng->extract_sha512_entropy(request->out, request->out_length);
+	case AsyncOperation::getNoise:
+		return m_rng->get_noise(request->out, request->out_length);
+	case AsyncOperation::getNoiseSource1:
+		return m_rng->get_noise_source_1(request->out, request->out_length);
+	case AsyncOperation::getNoiseSource2:
+		return m_rng->get_noise_source_2(request->out, request->out_length);
+	default:
+		return false;
+	}
+}
+
+/**
+ * Move a request to the completed list and make the file descriptor readable, must be called with m_mtx held
+ *
+ * @param[in] request the request to complete
+ * @param[in] status final status of the request
+ */
+void AlphaRngApiAsync::complete(Request *request, int status) {
+	request->status = status;
+	const bool was_empty = m_completed.empty();
+	m_completed.push_back(request);
+	if (was_empty) {
+		const uint64_t value = 1;
+		ssize_t count;
+		do {
+			count = write(m_write_fd, &value, m_write_fd == m_read_fd ? sizeof(value) : 1);
+		} while (count < 0 && errno == EINTR);
+		m_cv_completed.notify_all();
+	}
+}
+
+/**
+ * Consume the pending notification of the file descriptor, must be called with m_mtx held
+ */
+void AlphaRngApiAsync::drain_fd() {
+	uint64_t value;
+	ssize_t count;
+	do {
+		count = read(m_read_fd, &value, sizeof(value));
+	} while (count > 0 ? m_write_fd != m_read_fd : count < 0 && errno == EINTR);
+}
+
+/**
+ * Destructor, stops the I/O thread and drops requests that are not reported yet without invoking their callbacks
+ */
+AlphaRngApiAsync::~AlphaRngApiAsync() {
+	if (m_thread.joinable()) {
+		{
+			lock_guard<mutex> lock(m_mtx);
+			m_is_stopping = true;
+		}
+		m_cv_queue.notify_all();
+		m_cv_completed.notify_all();
+		m_thread.join();
+	}
+	for (auto &entry : m_requests) {
+		delete entry.second;
+	}
+	if (m_read_fd >= 0) {
+		close(m_read_fd);
+	}
+	if (m_write_fd >= 0 && m_write_fd != m_read_fd) {
+		close(m_write_fd);
+	}
+}
+
+} /* namespace alpharng */
@@ -16,17 +16,253 @@
 
 /**
  *    @file AlphaRngApiCWrapper.cpp
- *    @date 9/16/2023
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 1.2
+ *    @version 1.8
  *
  *    @brief Implements a C wrapper around the C++ API for securely interacting with the AlphaRNG device.
  */
 #include <AlphaRngApi.h>
 #include <AlphaRngApiCWrapper.h>
+#include <AlphaRngApiAsync.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <openssl/crypto.h>
 
 using namespace alpharng;
 
+namespace {
+
+/*
+ * Device bytes of a context in thread cache mode, shared by its threads. One thread at a time reads a
+ * staging block of several caches from the device under device_mtx; threads refill their caches with
+ * slices of the block under staging_mtx, which is held only for the copy. A thread waits for the device
+ * only when the block is used up.
+ */
+struct ThreadCacheSource {
+	std::mutex device_mtx;
+	std::mutex staging_mtx;
+	std::vector<unsigned char> staging;
+	size_t staging_offset = 0;
+	// Filled from the device under device_mtx, then swapped with the used up staging block
+	std::vector<unsigned char> spare;
+
+	~ThreadCacheSource() {
+		if (!staging.empty()) {
+			OPENSSL_cleanse(staging.data(), staging.size());
+		}
+		if (!spare.empty()) {
+			OPENSSL_cleanse(spare.data(), spare.size());
+		}
+	}
+};
+
+/*
+ * Thread cache mode of a context. Each thread keeps its own cache of entropy bytes per context
+ * and refills it from the ThreadCacheSource of the context, so tiny reads are a memcpy.
+ * Threads find the mode through the registry and remember it until the registry generation changes,
+ * which happens whenever a context enables, disables or loses the mode. A thread then drops the
+ * caches of contexts that lost the mode, so their bytes are erased at the next call of that thread.
+ */
+struct ThreadCacheMode {
+	// Kept when the cache size of a context changes, threads may still refill with the previous mode
+	std::shared_ptr<ThreadCacheSource> source;
+	size_t cache_size_bytes;
+	size_t staging_size_bytes;
+};
+
+struct ThreadCache {
+	alrng_context *ctxt = nullptr;
+	std::shared_ptr<ThreadCacheMode> mode;
+	std::vector<unsigned char> buffer;
+	size_t offset = 0;
+
+	~ThreadCache() {
+		if (!buffer.empty()) {
+			OPENSSL_cleanse(buffer.data(), buffer.size());
+		}
+	}
+};
+
+std::mutex g_cache_registry_mtx;
+std::unordered_map<alrng_context*, std::shared_ptr<ThreadCacheMode>> g_cache_registry;
+std::atomic<uint64_t> g_cache_generation {1};
+std::atomic<int> g_cache_context_count {0};
+// Caches of the calling thread, only for contexts in thread cache mode as of t_cache_generation
+thread_local std::list<ThreadCache> t_caches;
+thread_local uint64_t t_cache_generation = 0;
+// The last context the calling thread found without the mode, saves a registry lookup per call
+thread_local alrng_context *t_uncached_ctxt = nullptr;
+// Caches of a context a staging block holds
+const size_t c_caches_per_staging_block = 4;
+
+/**
+ * Drop the caches of the calling thread whose context lost or changed its mode
+ */
+void drop_stale_thread_caches() {
+	std::lock_guard<std::mutex> lock(g_cache_registry_mtx);
+	for (auto it = t_caches.begin(); it != t_caches.end();) {
+		auto entry = g_cache_registry.find(it->ctxt);
+		if (entry == g_cache_registry.end() || entry->second != it->mode) {
+			it = t_caches.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+/**
+ * Find the cache of the calling thread for a context in thread cache mode
+ *
+ * @param[in] ctxt pointer to context structure
+ *
+ * @return the cache or nullptr when the context is not in thread cache mode
+ */
+ThreadCache* find_thread_cache(alrng_context *ctxt) {
+	const uint64_t generation = g_cache_generation.load(std::memory_order_acquire);
+	if (t_cache_generation != generation) {
+		drop_stale_thread_caches();
+		t_cache_generation = generation;
+		t_uncached_ctxt = nullptr;
+	}
+	for (ThreadCache &entry : t_caches) {
+		if (entry.ctxt == ctxt) {
+			return &entry;
+		}
+	}
+	if (ctxt == t_uncached_ctxt) {
+		return nullptr;
+	}
+
+	std::shared_ptr<ThreadCacheMode> mode;
+	{
+		std::lock_guard<std::mutex> lock(g_cache_registry_mtx);
+		auto it = g_cache_registry.find(ctxt);
+		if (it != g_cache_registry.end()) {
+			mode = it->second;
+		}
+	}
+	if (!mode) {
+		t_uncached_ctxt = ctxt;
+		return nullptr;
+	}
+	t_caches.emplace_back();
+	ThreadCache *cache = &t_caches.back();
+	cache->ctxt = ctxt;
+	cache->mode = mode;
+	cache->buffer.assign(mode->cache_size_bytes, 0);
+	cache->offset = cache->buffer.size();
+	return cache;
+}
+
+/**
+ * Refill the cache of the calling thread with the rest of the staging block, the caller holds staging_mtx.
+ * Bytes are placed at the end of the cache when the rest is smaller than the cache.
+ *
+ * @param[in] source device bytes of the context
+ * @param[in] cache cache of the calling thread, used up
+ *
+ * @return false if the staging block is used up
+ */
+bool take_staged_entropy(ThreadCacheSource &source, ThreadCache *cache) {
+	const size_t available = source.staging.size() - source.staging_offset;
+	if (available == 0) {
+		return false;
+	}
+	const size_t take_bytes = std::min(available, cache->buffer.size());
+	unsigned char *staged = source.staging.data() + source.staging_offset;
+	cache->offset = cache->buffer.size() - take_bytes;
+	memcpy(cache->buffer.data() + cache->offset, staged, take_bytes);
+	memset(staged, 0, take_bytes);
+	source.staging_offset += take_bytes;
+	return true;
+}
+
+/**
+ * Refill the cache of the calling thread from the staging block of the context, reading a new block
+ * from the device when it is used up
+ *
+ * @param[in] api the AlphaRngApi instance of the context
+ * @param[in] cache cache of the calling thread, used up
+ *
+ * @return true for successful operation
+ */
+bool refill_thread_cache(AlphaRngApi *api, ThreadCache *cache) {
+	ThreadCacheSource &source = *cache->mode->source;
+	{
+		std::lock_guard<std::mutex> staging_lock(source.staging_mtx);
+		if (take_staged_entropy(source, cache)) {
+			return true;
+		}
+	}
+	std::lock_guard<std::mutex> device_lock(source.device_mtx);
+	{
+		// Another thread may have read a block while this one waited for the device
+		std::lock_guard<std::mutex> staging_lock(source.staging_mtx);
+		if (take_staged_entropy(source, cache)) {
+			return true;
+		}
+	}
+	source.spare.resize(cache->mode->staging_size_bytes);
+	if (!api->get_entropy(source.spare.data(), (int)source.spare.size())) {
+		return false;
+	}
+	std::lock_guard<std::mutex> staging_lock(source.staging_mtx);
+	source.staging.swap(source.spare);
+	source.staging_offset = 0;
+	return take_staged_entropy(source, cache);
+}
+
+/**
+ * Retrieve entropy bytes from the cache of the calling thread, refilling it as needed
+ *
+ * @param[in] api the AlphaRngApi instance of the context
+ * @param[in] cache cache of the calling thread
+ * @param[out] out points to a byte array for storing the random bytes retrieved
+ * @param[in] out_length how many random bytes to retrieve
+ *
+ * @return true for successful operation
+ */
+bool get_cached_entropy(AlphaRngApi *api, ThreadCache *cache, unsigned char *out, size_t out_length) {
+	const size_t cache_size = cache->buffer.size();
+	if (out_length > cache_size / 4) {
+		std::lock_guard<std::mutex> lock(cache->mode->source->device_mtx);
+		return api->get_entropy(out, (int)out_length);
+	}
+	while (out_length > 0) {
+		if (cache->offset == cache_size && !refill_thread_cache(api, cache)) {
+			return false;
+		}
+		size_t copy_bytes = std::min(out_length, cache_size - cache->offset);
+		unsigned char *cached = cache->buffer.data() + cache->offset;
+		memcpy(out, cached, copy_bytes);
+		memset(cached, 0, copy_bytes);
+		cache->offset += copy_bytes;
+		out += copy_bytes;
+		out_length -= copy_bytes;
+	}
+	return true;
+}
+
+/**
+ * Take a context out of thread cache mode
+ *
+ * @param[in] ctxt pointer to context structure
+ */
+void remove_thread_cache_mode(alrng_context *ctxt) {
+	std::lock_guard<std::mutex> lock(g_cache_registry_mtx);
+	if (g_cache_registry.erase(ctxt) > 0) {
+		g_cache_context_count--;
+		g_cache_generation++;
+	}
+}
+
+} /* namespace */
+
 extern "C" {
 
 /**
@@ -169,6 +405,7 @@ int alrng_destroy_ctxt(alrng_context *ctxt) {
 		return -1;
 	}
 	auto api = (AlphaRngApi*) ctxt;
+	remove_thread_cache_mode(ctxt);
 	// Close any existing connection to a device
 	api->disconnect();
 	delete api;
@@ -421,10 +658,119 @@ int alrng_get_entropy(alrng_context* ctxt, unsigned char *out, int out_length) {
 	}
 
 	auto api = (AlphaRngApi*) ctxt;
+	if (g_cache_context_count.load(std::memory_order_relaxed) > 0) {
+		ThreadCache *cache = find_thread_cache(ctxt);
+		if (nullptr != cache) {
+			return get_cached_entropy(api, cache, out, (size_t)out_length) ? 0 : -2;
+		}
+	}
 	bool status = api->get_entropy(out, out_length);
 	return status ? 0 : -2;
 }
 
+/**
+ * Enable or disable the thread cache mode of a context.
+ *
+ * @param[in] ctxt pointer to context structure, must not be nullptr
+ * @param[in] cache_size_bytes size of the cache of each thread, 0 to disable the mode
+ *
+ * @return 0 for successful operation
+ */
+int alrng_set_thread_cache(alrng_context* ctxt, int cache_size_bytes) {
+	if (nullptr == ctxt || cache_size_bytes < 0 || (cache_size_bytes > 0 && cache_size_bytes < ALRNG_MIN_THREAD_CACHE_BYTES)
+			|| cache_size_bytes > ALRNG_MAX_THREAD_CACHE_BYTES) {
+		return -1;
+	}
+	if (0 == cache_size_bytes) {
+		remove_thread_cache_mode(ctxt);
+		return 0;
+	}
+	auto mode = std::make_shared<ThreadCacheMode>();
+	mode->cache_size_bytes = (size_t)cache_size_bytes;
+	mode->staging_size_bytes = std::min(mode->cache_size_bytes * c_caches_per_staging_block, (size_t)ALRNG_MAX_THREAD_CACHE_BYTES);
+	std::lock_guard<std::mutex> lock(g_cache_registry_mtx);
+	auto it = g_cache_registry.find(ctxt);
+	if (it != g_cache_registry.end()) {
+		mode->source = it->second->source;
+		it->second = mode;
+	} else {
+		mode->source = std::make_shared<ThreadCacheSource>();
+		g_cache_registry[ctxt] = mode;
+		g_cache_context_count++;
+	}
+	g_cache_generation++;
+	return 0;
+}
+
+/**
+ * Retrieve entropy bytes for several buffers at once, such as a batch of keys.
+ * The buffers are filled from as few device blocks as their total size allows.
+ *
+ * @param[in] ctxt pointer to context structure, must not be nullptr
+ * @param[in] iov buffers to fill with random bytes, entries with zero length are skipped
+ * @param[in] iov_count number of entries in iov
+ *
+ * @return 0 for successful operation
+ */
+int alrng_get_entropy_v(alrng_context* ctxt, const struct iovec *iov, int iov_count) {
+	if (nullptr == ctxt || nullptr == iov || iov_count < 1) {
+		return -1;
+	}
+	auto api = (AlphaRngApi*) ctxt;
+	bool status = api->get_entropy_v(iov, iov_count);
+	return status ? 0 : -2;
+}
+
+/**
+ * Consume a seed file saved by an earlier connection, must be called before alrng_connect().
+ *
+ * @param[in] ctxt pointer to context structure, must not be nullptr
+ * @param[in] file_name seed file pathname
+ *
+ * @return 0 for successful operation
+ */
+int alrng_load_seed_file(alrng_context* ctxt, const char *file_name) {
+	if (nullptr == ctxt || nullptr == file_name) {
+		return -1;
+	}
+	auto api = (AlphaRngApi*) ctxt;
+	bool status = api->load_seed_file(file_name);
+	return status ? 0 : -2;
+}
+
+/**
+ * Replace the seed file with new device entropy bytes.
+ *
+ * @param[in] ctxt pointer to context structure, must not be nullptr
+ *
+ * @return 0 for successful operation
+ */
+int alrng_save_seed_file(alrng_context* ctxt) {
+	if (nullptr == ctxt) {
+		return -1;
+	}
+	auto api = (AlphaRngApi*) ctxt;
+	bool status = api->save_seed_file();
+	return status ? 0 : -2;
+}
+
+/**
+ * Retrieve the amount of bytes generated from the seed file and returned by alrng_get_entropy().
+ *
+ * @param[in] ctxt pointer to context structure, must not be nullptr
+ * @param[out] byte_count location for the amount of bytes
+ *
+ * @return 0 for successful operation
+ */
+int alrng_get_seed_bytes_served(alrng_context* ctxt, uint64_t *byte_count) {
+	if (nullptr == ctxt || nullptr == byte_count) {
+		return -1;
+	}
+	auto api = (AlphaRngApi*) ctxt;
+	*byte_count = api->get_seed_bytes_served();
+	return 0;
+}
+
 /**
  * Extract entropy bytes by applying SHA-256 method to RAW random bytes retrieved from an AlphaRNG device.
  * This is the method for generating high quality, non biased, random bytes that can be directly used in applications
@@ -665,5 +1011,153 @@ int alrng_retrieve_frequency_tables(alrng_context* ctxt, uint16_t *freq_table_1,
 	return 0;
 }
 
+/**
+ * Create a handle for submitting requests to a connected context without blocking the caller.
+ *
+ * @param[in] ctxt pointer to a connected context structure, must not be nullptr
+ * @param[in] queue_size max amount of requests submitted and not reported yet, 0 for the default
+ *
+ * @return pointer to the new handle or NULL if failed
+ */
+alrng_async* alrng_async_create(alrng_context* ctxt, int queue_size) {
+	if (nullptr == ctxt || queue_size < 0 || queue_size > AlphaRngApiAsync::c_max_queue_size) {
+		return nullptr;
+	}
+	auto api = (AlphaRngApi*) ctxt;
+	if (!api->is_connected()) {
+		return nullptr;
+	}
+	auto async = new (std::nothrow) AlphaRngApiAsync(api, queue_size);
+	if (nullptr != async && !async->is_initialized()) {
+		delete async;
+		async = nullptr;
+	}
+	return (alrng_async*) async;
+}
+
+/**
+ * Stop the I/O thread and destroy the handle.
+ *
+ * @param[in] async pointer to the handle, must not be nullptr
+ *
+ * @return 0 for successful operation
+ */
+int alrng_async_destroy(alrng_async* async) {
+	if (nullptr == async) {
+		return -1;
+	}
+	delete (AlphaRngApiAsync*) async;
+	return 0;
+}
+
+/**
+ * Submit a request for retrieving bytes from the device
+ *
+ * @param[in] async pointer to the handle, must not be nullptr
+ * @param[in] op the operation to execute
+ * @param[out] out points to a byte array for storing the bytes, it must stay valid until the request is reported
+ * @param[in] out_length how many bytes to retrieve
+ * @param[in] callback invoked from alrng_async_poll() when the request is completed, may be nullptr
+ * @param[in] user_data passed to the callback
+ *
+ * @return a positive request id or a negative alrng_async_status when the request is rejected
+ */
+int64_t alrng_async_submit(alrng_async* async, enum alrng_async_op op, unsigned char *out, int out_length,
+		alrng_async_callback callback, void *user_data) {
+	if (nullptr == async || nullptr == out || out_length < 1 || op < alrng_op_get_entropy || op > alrng_op_get_noise_source_2) {
+		return alrng_async_invalid;
+	}
+	auto api_async = (AlphaRngApiAsync*) async;
+	AlphaRngApiAsync::Callback cpp_callback;
+	if (nullptr != callback) {
+		cpp_callback = [async, callback, out, out_length, user_data](int64_t request_id, int status) {
+			callback(async, request_id, status, out, out_length, user_data);
+		};
+	}
+	return api_async->submit((AsyncOperation)op, out, out_length, cpp_callback);
+}
+
+/**
+ * Retrieve a file descriptor that becomes readable when completed requests wait for alrng_async_poll().
+ *
+ * @param[in] async pointer to the handle, must not be nullptr
+ *
+ * @return the file descriptor or -1 for invalid parameters
+ */
+int alrng_async_get_fd(alrng_async* async) {
+	if (nullptr == async) {
+		return -1;
+	}
+	return ((AlphaRngApiAsync*) async)->get_fd();
+}
+
+/**
+ * Report completed requests by invoking their callbacks on the calling thread
+ *
+ * @param[in] async pointer to the handle, must not be nullptr
+ * @param[in] timeout_mlsecs how long to wait for a completion, 0 to return immediately, negative to wait indefinitely
+ *
+ * @return amount of requests reported or -1 for invalid parameters
+ */
+int alrng_async_poll(alrng_async* async, int timeout_mlsecs) {
+	if (nullptr == async) {
+		return -1;
+	}
+	return ((AlphaRngApiAsync*) async)->poll(timeout_mlsecs);
+}
+
+/**
+ * Retrieve the status of a request that is not reported yet
+ *
+ * @param[in] async pointer to the handle, must not be nullptr
+ * @param[in] request_id request id returned by alrng_async_submit()
+ *
+ * @return the request status or alrng_async_invalid when the request is unknown or already reported
+ */
+int alrng_async_get_status(alrng_async* async, int64_t request_id) {
+	if (nullptr == async) {
+		return alrng_async_invalid;
+	}
+	return ((AlphaRngApiAsync*) async)->get_status(request_id);
+}
+
+/**
+ * Cancel a request that is not reported yet
+ *
+ * @param[in] async pointer to the handle, must not be nullptr
+ * @param[in] request_id request id returned by alrng_async_submit()
+ *
+ * @return 0 for successful operation, -1 when the request is unknown or already completed
+ */
+int alrng_async_cancel(alrng_async* async, int64_t request_id) {
+	if (nullptr == async) {
+		return -1;
+	}
+	return ((AlphaRngApiAsync*) async)->cancel(request_id);
+}
+
+/**
+ * Retrieve the message associated with the last failed request.
+ *
+ * @param[in] async pointer to the handle, must not be nullptr
+ * @param[out] msg_buffer points to a location for storing zero terminated error message
+ * @param[in] msg_buffer_size the memory allocated to msg_buffer in bytes
+ *
+ * @return 0 for successful operation
+ */
+int alrng_async_get_last_error(alrng_async* async, char *msg_buffer, int msg_buffer_size) {
+	if (nullptr == async || nullptr == msg_buffer || msg_buffer_size <= 2) {
+		return -1;
+	}
+	std::string msg = ((AlphaRngApiAsync*) async)->get_last_error();
+	int size = (int)msg.size();
+	if (size >= msg_buffer_size) {
+		size = msg_buffer_size -1;
+	}
+	memcpy(msg_buffer, msg.c_str(), size);
+	msg_buffer[size] = '\0';
+	return 0;
+}
+
 }
 
@@ -12,9 +12,9 @@
 
 /**
  *    @file AppArguments.h
- *    @date 9/16/2023
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 1.4
+ *    @version 1.5
  *
  *    @brief Parse application command line arguments
  */
@@ -34,6 +34,7 @@ namespace alpharng {
 void AppArguments::load_arguments(const int argc, const char **argv) {
 	clear_error_log();
 	m_argument_map.clear();
+	m_argument_values_map.clear();
 	m_app_name = argv[0];
 	for (int i = 1; i < argc; ++i) {
 		string arg = argv[i];
@@ -43,7 +44,8 @@ void AppArguments::load_arguments(const int argc, const char **argv) {
 			return;
 		}
 
-		if (m_argument_map.find(arg) != m_argument_map.end()) {
+		if (m_argument_map.find(arg) != m_argument_map.end()
+				&& m_definition_map[arg] != ArgDef::requireRepeatableArgument) {
 			m_is_error = true;
 			m_error_log_oss << "Duplicate option: " << arg << ". " << endl;
 			return;
@@ -55,11 +57,14 @@ void AppArguments::load_arguments(const int argc, const char **argv) {
 			return;
 		} else {
 			ArgDef def = m_definition_map[arg];
-			if (def == ArgDef::requireArgument) {
+			if (def == ArgDef::requireArgument || def == ArgDef::requireRepeatableArgument) {
 				i++;
 				if (i < argc) {
 					string val = argv[i];
-					m_argument_map[arg] = val;
+					if (m_argument_map.find(arg) == m_argument_map.end()) {
+						m_argument_map[arg] = val;
+					}
+					m_argument_values_map[arg].push_back(val);
 				} else {
 					m_is_error = true;
 					m_error_log_oss << "No value was specified for option: " << arg  << ". " << endl;
@@ -72,6 +77,22 @@ void AppArguments::load_arguments(const int argc, const char **argv) {
 	}
 }
 
+/**
+ * Retrieve all values supplied for an option, in the order those appeared in the command line.
+ * Options defined with ArgDef::requireRepeatableArgument may have more than one value.
+ *
+ * @param[in] option command line option, for example "-o"
+ *
+ * @return a list of values, empty if the option was not supplied
+ */
+vector<string> AppArguments::get_argument_values(const string &option) const {
+	auto it = m_argument_values_map.find(option);
+	if (it == m_argument_values_map.end()) {
+		return vector<string>();
+	}
+	return it->second;
+}
+
 void AppArguments::clear_error_log() {
 	m_error_log_oss.str("");
 	m_error_log_oss.clear();
@@ -0,0 +1,307 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for registering a character device with CUSE (Character device in user space) on Linux
+ and exchanging its file operations with the kernel.
+
+ */
+
+/**
+ *    @file CuseDevice.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief A read-only character device served through the CUSE kernel protocol
+ */
+
+#include <CuseDevice.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <linux/fuse.h>
+
+using namespace std;
+
+namespace alpharng {
+
+static_assert(sizeof(fuse_out_header) == CuseDevice::c_reply_header_size_bytes, "Unexpected FUSE reply header size");
+
+/**
+ * Constructor
+ *
+ * @param[in] name name of the character device, created as /dev/NAME
+ */
+CuseDevice::CuseDevice(const string &name) : m_name(name) {
+}
+
+/**
+ * Open /dev/cuse. The device is registered when the kernel sends CUSE_INIT to handle_requests().
+ *
+ * @param[in] handler receives the file operations of the device
+ *
+ * @return true when successful
+ */
+bool CuseDevice::open(FileHandler *handler) {
+	clear_error_log();
+	if (m_name.empty() || m_name.find('/') != string::npos || m_name.size() + sizeof("DEVNAME=") > CUSE_INIT_INFO_MAX) {
+		m_error_log_oss << "Invalid character device name: " << m_name << endl;
+		return false;
+	}
+	m_fd = ::open("/dev/cuse", O_RDWR | O_NONBLOCK | O_CLOEXEC);
+	if (m_fd < 0) {
+		m_error_log_oss << "Could not open /dev/cuse, error code: " << errno << endl;
+		return false;
+	}
+	m_input.resize(c_input_buffer_size_bytes);
+	m_handler = handler;
+	return true;
+}
+
+/**
+ * Read and handle the pending CUSE requests, one request per read().
+ * Requests left after c_max_requests_per_call reads are handled by the next call.
+ *
+ * @return false if the kernel released the character device
+ */
+bool CuseDevice::handle_requests() {
+	for (int i = 0; i < c_max_requests_per_call; i++) {
+		ssize_t n = read(m_fd, m_input.data(), m_input.size());
+		if (n > 0) {
+			handle_request(m_input.data(), (size_t)n);
+			continue;
+		}
+		if (n < 0 && (errno == EINTR || errno == ENOENT)) {
+			// ENOENT: the request was interrupted before it was read
+			continue;
+		}
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			break;
+		}
+		clear_error_log();
+		m_error_log_oss << "Character device /dev/" << m_name << " was released, error code: " << errno << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @param[in] in CUSE request: a FUSE request header followed by the operation arguments
+ * @param[in] size amount of request bytes
+ */
+void CuseDevice::handle_request(const unsigned char *in, size_t size) {
+	fuse_in_header header;
+	if (size < sizeof(header)) {
+		return;
+	}
+	memcpy(&header, in, sizeof(header));
+	const unsigned char *arg = in + sizeof(header);
+	const size_t arg_size = size - sizeof(header);
+
+	switch (header.opcode) {
+	case CUSE_INIT:
+		init_device(header.unique, arg, arg_size);
+		return;
+	case FUSE_OPEN: {
+		const int64_t handle = m_handler->open_file((pid_t)header.pid);
+		if (handle < 0) {
+			send_reply(header.unique, (int)handle, nullptr, 0);
+			return;
+		}
+		fuse_open_out open_out {};
+		open_out.fh = (uint64_t)handle;
+		open_out.open_flags = FOPEN_DIRECT_IO | FOPEN_NONSEEKABLE;
+		send_reply(header.unique, 0, &open_out, sizeof(open_out));
+		return;
+	}
+	case FUSE_READ: {
+		fuse_read_in read_in;
+		if (arg_size < sizeof(read_in)) {
+			send_reply(header.unique, -EINVAL, nullptr, 0);
+			return;
+		}
+		memcpy(&read_in, arg, sizeof(read_in));
+		if (read_in.size == 0) {
+			send_reply(header.unique, 0, nullptr, 0);
+			return;
+		}
+		if (!m_handler->read_file(read_in.fh, header.unique, min(read_in.size, (uint32_t)c_max_read_bytes))) {
+			send_reply(header.unique, -EBADF, nullptr, 0);
+		}
+		return;
+	}
+	case FUSE_RELEASE: {
+		fuse_release_in release_in;
+		if (arg_size >= sizeof(release_in)) {
+			memcpy(&release_in, arg, sizeof(release_in));
+			m_handler->release_file(release_in.fh);
+		}
+		send_reply(header.unique, 0, nullptr, 0);
+		return;
+	}
+	case FUSE_FLUSH:
+		send_reply(header.unique, 0, nullptr, 0);
+		return;
+	case FUSE_POLL: {
+		// The device is always readable, a read waits for the handler at most
+		fuse_poll_out poll_out {};
+		poll_out.revents = POLLIN | POLLRDNORM;
+		send_reply(header.unique, 0, &poll_out, sizeof(poll_out));
+		return;
+	}
+	case FUSE_INTERRUPT: {
+		fuse_interrupt_in interrupt_in;
+		if (arg_size >= sizeof(interrupt_in)) {
+			memcpy(&interrupt_in, arg, sizeof(interrupt_in));
+			m_handler->interrupt_read(interrupt_in.unique);
+		}
+		return;
+	}
+	case FUSE_WRITE:
+		send_reply(header.unique, -EPERM, nullptr, 0);
+		return;
+	case FUSE_IOCTL:
+		send_reply(header.unique, -ENOTTY, nullptr, 0);
+		return;
+	default:
+		send_reply(header.unique, -ENOSYS, nullptr, 0);
+		return;
+	}
+}
+
+/**
+ * Reply to CUSE_INIT with the read size limits and the device name, the kernel then creates /dev/NAME
+ *
+ * @param[in] unique request unique id
+ * @param[in] arg CUSE_INIT arguments
+ * @param[in] arg_size amount of argument bytes
+ */
+void CuseDevice::init_device(uint64_t unique, const unsigned char *arg, size_t arg_size) {
+	cuse_init_in init_in;
+	if (arg_size < sizeof(init_in)) {
+		send_reply(unique, -EINVAL, nullptr, 0);
+		return;
+	}
+	memcpy(&init_in, arg, sizeof(init_in));
+	if (init_in.major != FUSE_KERNEL_VERSION) {
+		m_handler->report_error("Unsupported CUSE kernel protocol version: " + to_string(init_in.major));
+		send_reply(unique, -EPROTO, nullptr, 0);
+		return;
+	}
+
+	cuse_init_out init_out {};
+	init_out.major = FUSE_KERNEL_VERSION;
+	init_out.minor = FUSE_KERNEL_MINOR_VERSION;
+	init_out.max_read = c_max_read_bytes;
+	init_out.max_write = c_max_write_bytes;
+	// Zero device numbers let the kernel allocate them
+	const string info = "DEVNAME=" + m_name;
+	vector<unsigned char> init_reply(sizeof(init_out) + info.size() + 1);
+	memcpy(init_reply.data(), &init_out, sizeof(init_out));
+	memcpy(init_reply.data() + sizeof(init_out), info.c_str(), info.size() + 1);
+	send_reply(unique, 0, init_reply.data(), init_reply.size());
+}
+
+/**
+ * Write a reply to /dev/cuse. The kernel takes exactly one reply per write().
+ *
+ * @param[in] unique request unique id
+ * @param[in] error zero or a negative errno value
+ * @param[in] data reply data or nullptr
+ * @param[in] size amount of reply data bytes
+ *
+ * @return true when the reply was written or its request is already completed by the kernel
+ */
+bool CuseDevice::reply(uint64_t unique, int error, const void *data, size_t size) {
+	fuse_out_header header {};
+	header.len = (uint32_t)(sizeof(header) + size);
+	header.error = error;
+	header.unique = unique;
+	iovec iov[2] = {{&header, sizeof(header)}, {(void*)data, size}};
+	while (writev(m_fd, iov, size > 0 ? 2 : 1) < 0) {
+		if (errno != EINTR) {
+			// ENOENT: the request was interrupted and already completed by the kernel
+			if (errno == ENOENT) {
+				return true;
+			}
+			clear_error_log();
+			m_error_log_oss << "Could not reply to /dev/cuse, error code: " << errno;
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Write a reply of a request handled by this class, failures are reported to the handler
+ *
+ * @param[in] unique request unique id
+ * @param[in] error zero or a negative errno value
+ * @param[in] data reply data or nullptr
+ * @param[in] size amount of reply data bytes
+ */
+void CuseDevice::send_reply(uint64_t unique, int error, const void *data, size_t size) {
+	if (!reply(unique, error, data, size)) {
+		m_handler->report_error(get_last_error());
+	}
+}
+
+/**
+ * Write replies stored one after another, each with a header from create_reply_header()
+ *
+ * @param[in] replies the replies
+ * @param[in] size amount of reply bytes
+ *
+ * @return true when all replies were written, a failed reply does not prevent the next ones
+ */
+bool CuseDevice::write_replies(const unsigned char *replies, size_t size) {
+	bool status = true;
+	size_t offset = 0;
+	while (offset + sizeof(fuse_out_header) <= size) {
+		fuse_out_header header;
+		memcpy(&header, replies + offset, sizeof(header));
+		status = reply(header.unique, header.error, replies + offset + sizeof(header), header.len - sizeof(header)) && status;
+		offset += header.len;
+	}
+	return status;
+}
+
+/**
+ * @param[in] unique request unique id
+ * @param[in] error zero or a negative errno value
+ * @param[in] size amount of reply data bytes that follow the header
+ * @param[out] header location for c_reply_header_size_bytes bytes
+ *
+ * @return size of the reply header
+ */
+size_t CuseDevice::create_reply_header(uint64_t unique, int error, uint32_t size, unsigned char *header) {
+	fuse_out_header reply {};
+	reply.len = (uint32_t)sizeof(reply) + size;
+	reply.error = error;
+	reply.unique = unique;
+	memcpy(header, &reply, sizeof(reply));
+	return sizeof(reply);
+}
+
+void CuseDevice::clear_error_log() {
+	m_error_log_oss.str("");
+	m_error_log_oss.clear();
+}
+
+CuseDevice::~CuseDevice() {
+	if (m_fd >= 0) {
+		close(m_fd);
+	}
+}
+
+} /* namespace alpharng */
@@ -0,0 +1,198 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a stream writer that computes a SHA-256 Merkle tree digest of the bytes passed
+ to another stream writer and stores it into a sidecar file when the stream is finished.
+
+ */
+
+/**
+ *    @file DigestStreamWriter.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements a stream writer computing an on the fly tree digest of device data.
+ */
+
+#include <DigestStreamWriter.h>
+
+#include <cstring>
+#include <new>
+
+using namespace std;
+
+namespace alpharng {
+
+/**
+ * @param[in] target stream writer receiving the bytes
+ * @param[in] sidecar_path file path name for storing the digest
+ * @param[in] num_threads amount of hashing threads
+ */
+DigestStreamWriter::DigestStreamWriter(StreamWriter &target, const string &sidecar_path, int num_threads) :
+		m_target(target), m_sidecar_path(sidecar_path), c_num_threads(num_threads < 1 ? 1 : num_threads) {
+}
+
+unsigned char* DigestStreamWriter::acquire_buffer(int size) {
+	if (m_workers.empty() && !start_workers()) {
+		return nullptr;
+	}
+	m_acquired_buffer = m_target.acquire_buffer(size);
+	if (m_acquired_buffer == nullptr) {
+		m_error_log_oss << m_target.get_last_error();
+	}
+	return m_acquired_buffer;
+}
+
+bool DigestStreamWriter::commit_buffer(int size) {
+	// Copy the bytes into leaves before the target may reuse its buffer
+	const unsigned char *p = m_acquired_buffer;
+	int remaining = size;
+	while (remaining > 0) {
+		if (m_current_leaf.data == nullptr && !next_leaf()) {
+			return false;
+		}
+		int space = TreeDigest::c_leaf_size_bytes - m_current_leaf.size;
+		int n = remaining < space ? remaining : space;
+		memcpy(m_current_leaf.data + 1 + m_current_leaf.size, p, n);
+		m_current_leaf.size += n;
+		p += n;
+		remaining -= n;
+		if (m_current_leaf.size == TreeDigest::c_leaf_size_bytes && !submit_leaf()) {
+			return false;
+		}
+	}
+	m_total_bytes += size;
+	if (!m_target.commit_buffer(size)) {
+		m_error_log_oss << m_target.get_last_error();
+		return false;
+	}
+	return true;
+}
+
+bool DigestStreamWriter::finish() {
+	if (m_workers.empty() && !start_workers()) {
+		return false;
+	}
+	// The last leaf may be shorter, an empty stream has one empty leaf
+	bool status = true;
+	if (m_current_leaf.data != nullptr || m_total_bytes == 0) {
+		if (m_current_leaf.data == nullptr) {
+			status = next_leaf();
+		}
+		status = status && submit_leaf();
+	}
+	stop_workers();
+
+	if (!m_target.finish()) {
+		m_error_log_oss << m_target.get_last_error();
+		return false;
+	}
+	if (!status) {
+		return false;
+	}
+	if (m_is_hash_error) {
+		m_error_log_oss << "Could not compute the stream digest. " << endl;
+		return false;
+	}
+	TreeDigest digest;
+	if (!TreeDigest::compute_root(m_leaves, m_root) || !digest.write_sidecar(m_sidecar_path, m_total_bytes, m_leaves, m_root)) {
+		m_error_log_oss << "Could not store the stream digest. " << digest.get_last_error();
+		return false;
+	}
+	return true;
+}
+
+bool DigestStreamWriter::start_workers() {
+	// Enough leaf buffers to keep all workers busy while the next leaf is filled
+	for (int i = 0; i < 2 * c_num_threads + 1; i++) {
+		unsigned char *buffer = new (nothrow) unsigned char[TreeDigest::c_leaf_size_bytes + 1];
+		if (buffer == nullptr) {
+			m_error_log_oss << "Could not allocate memory for digest buffers. " << endl;
+			return false;
+		}
+		m_all_buffers.push_back(buffer);
+		m_free_buffers.push_back(buffer);
+	}
+	for (int i = 0; i < c_num_threads; i++) {
+		m_workers.push_back(thread(&DigestStreamWriter::run_worker, this));
+	}
+	return true;
+}
+
+void DigestStreamWriter::stop_workers() {
+	{
+		lock_guard<mutex> lock(m_mtx);
+		m_is_stopping = true;
+		m_cv_work.notify_all();
+	}
+	for (auto &worker : m_workers) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+}
+
+void DigestStreamWriter::run_worker() {
+	while (true) {
+		Leaf leaf;
+		{
+			unique_lock<mutex> lock(m_mtx);
+			m_cv_work.wait(lock, [this] {return !m_queue.empty() || m_is_stopping;});
+			if (m_queue.empty()) {
+				return;
+			}
+			leaf = m_queue.front();
+			m_queue.pop_front();
+		}
+		DigestValue value;
+		bool is_hashed = TreeDigest::hash_leaf(leaf.data, leaf.size, value);
+		{
+			lock_guard<mutex> lock(m_mtx);
+			if (is_hashed) {
+				m_leaves[leaf.index] = value;
+			} else {
+				m_is_hash_error = true;
+			}
+			m_free_buffers.push_back(leaf.data);
+			m_cv_free.notify_one();
+		}
+	}
+}
+
+bool DigestStreamWriter::next_leaf() {
+	unique_lock<mutex> lock(m_mtx);
+	m_cv_free.wait(lock, [this] {return !m_free_buffers.empty();});
+	m_current_leaf.data = m_free_buffers.back();
+	m_free_buffers.pop_back();
+	m_current_leaf.index = m_leaves.size();
+	m_current_leaf.size = 0;
+	m_leaves.push_back(DigestValue());
+	return true;
+}
+
+bool DigestStreamWriter::submit_leaf() {
+	lock_guard<mutex> lock(m_mtx);
+	if (m_is_hash_error) {
+		m_error_log_oss << "Could not compute the stream digest. " << endl;
+		return false;
+	}
+	m_queue.push_back(m_current_leaf);
+	m_current_leaf.data = nullptr;
+	m_cv_work.notify_one();
+	return true;
+}
+
+DigestStreamWriter::~DigestStreamWriter() {
+	stop_workers();
+	for (unsigned char *buffer : m_all_buffers) {
+		delete [] buffer;
+	}
+}
+
+} /* namespace alpharng */
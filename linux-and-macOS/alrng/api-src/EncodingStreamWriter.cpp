@@ -0,0 +1,114 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a stream writer that encodes bytes downloaded from an AlphaRNG device into text
+ before passing those to another stream writer.
+
+ */
+
+/**
+ *    @file EncodingStreamWriter.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements a stream writer for text encoding of device data.
+ */
+
+#include <EncodingStreamWriter.h>
+
+#include <cstring>
+
+using namespace std;
+
+namespace alpharng {
+
+/**
+ * @param[in] target stream writer receiving the encoded text
+ * @param[in] e_encoding text encoding
+ * @param[in] buffer_size_bytes the largest amount of bytes that can be acquired at once
+ * @param[in] target_block_size_bytes the largest amount of bytes the target accepts at once
+ */
+EncodingStreamWriter::EncodingStreamWriter(StreamWriter &target, OutputEncoding e_encoding, int buffer_size_bytes,
+		int target_block_size_bytes) : m_target(target), m_encoder(e_encoding), c_buffer_size_bytes(buffer_size_bytes),
+		c_target_block_size_bytes(target_block_size_bytes) {
+}
+
+unsigned char* EncodingStreamWriter::acquire_buffer(int size) {
+	if (size > c_buffer_size_bytes) {
+		m_error_log_oss << "Requested " << size << " bytes exceed the encoding buffer size: " << c_buffer_size_bytes << ". " << endl;
+		return nullptr;
+	}
+	if (m_buffer == nullptr) {
+		m_buffer = new (nothrow) unsigned char[c_buffer_size_bytes + m_encoder.get_input_group_size()];
+		if (m_buffer == nullptr) {
+			m_error_log_oss << "Could not allocate memory for the encoding buffer" << ". " << endl;
+			return nullptr;
+		}
+	}
+	return m_buffer + m_carry_bytes;
+}
+
+bool EncodingStreamWriter::commit_buffer(int size) {
+	int total_bytes = m_carry_bytes + size;
+	int whole_bytes = total_bytes - total_bytes % m_encoder.get_input_group_size();
+	if (!encode_to_target(m_buffer, whole_bytes, false)) {
+		return false;
+	}
+	m_carry_bytes = total_bytes - whole_bytes;
+	if (m_carry_bytes > 0) {
+		memmove(m_buffer, m_buffer + whole_bytes, m_carry_bytes);
+	}
+	return true;
+}
+
+bool EncodingStreamWriter::finish() {
+	bool status = true;
+	if (m_carry_bytes > 0) {
+		status = encode_to_target(m_buffer, m_carry_bytes, true);
+		m_carry_bytes = 0;
+	}
+	if (!m_target.finish()) {
+		m_error_log_oss << m_target.get_last_error();
+		return false;
+	}
+	return status;
+}
+
+/**
+ * Encode bytes in slices that fit into the target blocks
+ */
+bool EncodingStreamWriter::encode_to_target(const unsigned char *in, int in_length, bool is_final) {
+	const int max_slice_bytes = c_target_block_size_bytes / m_encoder.get_output_group_size() * m_encoder.get_input_group_size();
+	while (in_length > 0) {
+		int slice_bytes = in_length < max_slice_bytes ? in_length : max_slice_bytes;
+		bool is_last_slice = is_final && slice_bytes == in_length;
+		int out_length = (int)m_encoder.get_encoded_size(slice_bytes, is_last_slice);
+		unsigned char *out = m_target.acquire_buffer(out_length);
+		if (out == nullptr) {
+			m_error_log_oss << m_target.get_last_error();
+			return false;
+		}
+		m_encoder.encode(in, slice_bytes, (char*)out, is_last_slice);
+		if (!m_target.commit_buffer(out_length)) {
+			m_error_log_oss << m_target.get_last_error();
+			return false;
+		}
+		in += slice_bytes;
+		in_length -= slice_bytes;
+	}
+	return true;
+}
+
+EncodingStreamWriter::~EncodingStreamWriter() {
+	if (m_buffer) {
+		delete [] m_buffer;
+	}
+}
+
+} /* namespace alpharng */
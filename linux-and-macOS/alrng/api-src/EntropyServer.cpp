@@ -0,0 +1,2248 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for interacting with the hardware random data generator device AlphaRNG for the purpose of
+ downloading and distributing true random bytes using a Unix domain socket on Linux.
+
+ It uses OpenSSL library.
+
+ */
+
+/**
+ *    @file EntropyServer.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.16
+ *
+ *    @brief A Unix domain socket service for distributing true random bytes generated by an AlphaRNG device
+ */
+
+#include <EntropyServer.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <sstream>
+#include <csignal>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/uio.h>
+#include <openssl/crypto.h>
+
+using namespace std;
+
+namespace alpharng {
+
+const char * const EntropyServer::c_default_socket_path = "/run/alpharng.sock";
+
+/**
+ * Constructor
+ *
+ * @param[in] rng AlphaRNG API used for downloading device data
+ * @param[in] cmd server command with the socket path and the max amount of clients
+ */
+EntropyServer::EntropyServer(AlphaRngApi *rng, Cmd *cmd) : m_rng(rng), m_cmd(cmd) {
+}
+
+/**
+ * Start and run the socket service until SIGINT or SIGTERM is received
+ *
+ * @return true when run successfully
+ */
+bool EntropyServer::run() {
+	m_socket_path = m_cmd->pipe_name.empty() ? c_default_socket_path : m_cmd->pipe_name;
+	const int64_t cache_size_kb = m_cmd->cache_high_kb > 0 ? m_cmd->cache_high_kb : c_default_cache_size_kb;
+	m_prefetch_buffer.resize(cache_size_kb * 1024);
+	m_cache_low_bytes = m_cmd->cache_low_kb > 0 ? m_cmd->cache_low_kb * 1024 : m_prefetch_buffer.size() / 4 * 3;
+	// A refill always has room for at least one chunk
+	m_cache_low_bytes = min(m_cache_low_bytes, m_prefetch_buffer.size() - c_prefetch_chunk_bytes);
+
+	// A seeded cache serves clients at once, the device workers connect to the devices
+	const bool is_seeded = !m_cmd->seed_file_name.empty() && seed_cache();
+	if (!is_seeded && !m_rng->connect(m_cmd->device_number)) {
+		cerr << m_rng->get_last_error() << endl;
+		return false;
+	}
+	if (!create_workers()) {
+		return false;
+	}
+
+	if (!create_events() || !create_socket()) {
+		return false;
+	}
+
+	if (!m_cmd->shm_ring_name.empty() && !m_ring.create(m_cmd->shm_ring_name, SharedEntropyRing::c_default_capacity_bytes,
+			m_cmd->shm_ring_group)) {
+		cerr << m_ring.get_last_error() << endl;
+		return false;
+	}
+
+	if (!m_cmd->cuse_device_name.empty() && !create_cuse_device()) {
+		return false;
+	}
+
+	if (m_cmd->metrics_port > 0 && !create_metrics_endpoint()) {
+		return false;
+	}
+
+	if (m_cmd->tcp_port > 0 && !create_tcp_socket()) {
+		return false;
+	}
+
+	if (is_seeded) {
+		cout << "Entropy server started on " << m_socket_path << ", connecting to the device" << endl;
+	} else {
+		cout << "Entropy server started using " << get_device_description(m_workers.front().get()) << " on " << m_socket_path << endl;
+	}
+	if (m_workers.size() > 1) {
+		cout << "Balancing clients over " << m_workers.size() << " devices" << endl;
+	}
+
+	if (m_ring.is_attached()) {
+		cout << "Publishing entropy bytes to shared memory ring " << m_cmd->shm_ring_name << endl;
+		m_ring_thread = thread(&EntropyServer::run_ring, this);
+	}
+	if (m_cuse) {
+		cout << "Serving character device /dev/" << m_cuse->get_name() << endl;
+	}
+	if (m_tcp_fd >= 0) {
+		cout << "Serving TCP clients on " << m_cmd->tcp_address << ":" << m_cmd->tcp_port << endl;
+	}
+	if (m_metrics_endpoint) {
+		cout << "Metrics available at http://127.0.0.1:" << m_cmd->metrics_port << "/metrics" << endl;
+	}
+	cout << "Entropy cache of " << m_prefetch_buffer.size() << " bytes, refilled below " << m_cache_low_bytes
+			<< " bytes" << endl;
+	for (auto &worker : m_workers) {
+		worker->thread = thread(&EntropyServer::run_device, this, worker.get());
+	}
+
+	epoll_event events[c_max_epoll_events];
+	bool is_running = true;
+	bool is_cuse_ok = true;
+	while (is_running && is_cuse_ok) {
+		int count = epoll_wait(m_epoll_fd, events, c_max_epoll_events, get_throttle_timeout_mlsecs());
+		if (count < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			cerr << "epoll_wait failed with " << errno << " error code." << endl;
+			break;
+		}
+		for (int i = 0; i < count; i++) {
+			void *source = events[i].data.ptr;
+			if (source == &m_listen_fd || source == &m_tcp_fd) {
+				accept_clients(*(int*)source);
+			} else if (source == &m_event_fd) {
+				handle_device_events();
+			} else if (source == &m_signal_fd) {
+				handle_signal(&is_running);
+			} else if (source == m_cuse.get()) {
+				is_cuse_ok = m_cuse->handle_requests();
+				if (!is_cuse_ok) {
+					cerr << m_cuse->get_last_error();
+				}
+			} else if (source == m_metrics_endpoint.get()) {
+				m_metrics_endpoint->handle_events();
+			} else {
+				handle_client_event((Client*)source, events[i].events);
+			}
+		}
+		release_throttled_clients();
+		serve_resumed_clients();
+		for (Client *client : m_released_clients) {
+			delete client;
+		}
+		m_released_clients.clear();
+	}
+
+	stop_device();
+	log_client_statistics();
+	log_cache_statistics();
+	log_device_statistics();
+	cout << "Entropy server stopped" << endl;
+	return !is_running;
+}
+
+/**
+ * Create the epoll instance, the event used by the device thread and the signal descriptor
+ *
+ * @return true when successful
+ */
+bool EntropyServer::create_events() {
+	// Signals are received by the event loop only, the device thread inherits the mask
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGINT);
+	sigaddset(&mask, SIGTERM);
+	sigaddset(&mask, SIGUSR1);
+	pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+	signal(SIGPIPE, SIG_IGN);
+
+	m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	m_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	m_signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (m_epoll_fd < 0 || m_event_fd < 0 || m_signal_fd < 0) {
+		cerr << "Could not create server events, error code: " << errno << endl;
+		return false;
+	}
+
+	epoll_event ev {};
+	ev.events = EPOLLIN;
+	ev.data.ptr = &m_event_fd;
+	if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_event_fd, &ev) < 0) {
+		cerr << "Could not watch the device event, error code: " << errno << endl;
+		return false;
+	}
+	ev.data.ptr = &m_signal_fd;
+	if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_signal_fd, &ev) < 0) {
+		cerr << "Could not watch the signal events, error code: " << errno << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Create the listening Unix domain socket. A stale socket file left by a previous server is replaced.
+ *
+ * @return true when successful
+ */
+bool EntropyServer::create_socket() {
+	sockaddr_un addr {};
+	addr.sun_family = AF_UNIX;
+	if (m_socket_path.size() >= sizeof(addr.sun_path)) {
+		cerr << "Socket path is too long: " << m_socket_path << endl;
+		return false;
+	}
+	memcpy(addr.sun_path, m_socket_path.c_str(), m_socket_path.size());
+
+	struct stat st;
+	if (lstat(m_socket_path.c_str(), &st) == 0) {
+		if (!S_ISSOCK(st.st_mode)) {
+			cerr << "File " << m_socket_path << " exists and it is not a socket" << endl;
+			return false;
+		}
+		int probe_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		bool is_in_use = probe_fd >= 0 && connect(probe_fd, (sockaddr*)&addr, sizeof(addr)) == 0;
+		if (probe_fd >= 0) {
+			close(probe_fd);
+		}
+		if (is_in_use) {
+			cerr << "Socket " << m_socket_path << " is used by another server" << endl;
+			return false;
+		}
+		unlink(m_socket_path.c_str());
+	}
+
+	m_listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (m_listen_fd < 0) {
+		cerr << "Could not create socket, error code: " << errno << endl;
+		return false;
+	}
+	if (::bind(m_listen_fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+		cerr << "Could not bind socket " << m_socket_path << ", error code: " << errno << endl;
+		close(m_listen_fd);
+		m_listen_fd = -1;
+		return false;
+	}
+	// Any local user may read random bytes, as with the named pipe of run-alrng-pserver.sh
+	chmod(m_socket_path.c_str(), 0666);
+	if (listen(m_listen_fd, c_listen_backlog) < 0) {
+		cerr << "Could not listen on socket " << m_socket_path << ", error code: " << errno << endl;
+		return false;
+	}
+
+	epoll_event ev {};
+	ev.events = EPOLLIN;
+	ev.data.ptr = &m_listen_fd;
+	if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_listen_fd, &ev) < 0) {
+		cerr << "Could not watch the socket, error code: " << errno << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Accept all pending client connections
+ *
+ * @param[in] listen_fd the Unix domain socket or the TCP socket
+ */
+void EntropyServer::accept_clients(int listen_fd) {
+	while (true) {
+		int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) {
+				continue;
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				log_error("accept failed with " + to_string(errno) + " error code.");
+			}
+			return;
+		}
+		if ((int)m_clients.size() >= m_cmd->pipe_instances) {
+			log_error("Too many clients, connection refused.");
+			close(fd);
+			continue;
+		}
+		Client *client = new Client();
+		client->fd = fd;
+		client->events = EPOLLIN;
+		client->priority = c_default_priority;
+		if (m_cmd->rate_kbsec > 0) {
+			const int64_t rate = m_cmd->rate_kbsec * 1024;
+			client->quota.configure(rate, max(rate, (int64_t)c_write_buff_size_bytes));
+		}
+		if (listen_fd == m_tcp_fd) {
+			// Requests and replies are small frames, they should not wait for more data
+			int no_delay = 1;
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+			client->channel.reset(new PskChannel(m_psk, true));
+			client->rx.resize(2 * c_max_request_frame_bytes);
+			client->tx.resize(PskChannel::c_hello_size_bytes);
+			if (!client->channel->create_hello(client->tx.data())) {
+				log_error(client->channel->get_last_error());
+				close(fd);
+				delete client;
+				continue;
+			}
+		} else {
+			ucred credentials {};
+			socklen_t length = sizeof(credentials);
+			if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0) {
+				client->pid = credentials.pid;
+			}
+		}
+		epoll_event ev {};
+		ev.events = client->events;
+		ev.data.ptr = client;
+		if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+			log_error("Could not watch client, error code: " + to_string(errno));
+			close(fd);
+			delete client;
+			continue;
+		}
+		m_clients[fd] = client;
+		if (client->channel && !write_channel_output(client)) {
+			close_client(client);
+		}
+	}
+}
+
+/**
+ * @param[in] client connected client
+ * @param[in] events epoll events reported for the client
+ */
+void EntropyServer::handle_client_event(Client *client, uint32_t events) {
+	if (client->is_closed) {
+		// Closed while handling an earlier event of the same epoll_wait() call
+		return;
+	}
+	if ((events & (EPOLLERR | EPOLLHUP)) != 0
+			|| !serve_client(client)) {
+		close_client(client);
+	}
+}
+
+/**
+ * Receive and handle client requests, send the ready replies.
+ * A busy client is served for a limited amount of receives per event so other clients are not delayed.
+ *
+ * @param[in] client connected client
+ *
+ * @return false if the connection should be closed
+ */
+bool EntropyServer::serve_client(Client *client) {
+	int receive_count = 0;
+	while (true) {
+		if (!parse_requests(client) || !write_output(client)) {
+			return false;
+		}
+		if (!is_accepting_requests(client)) {
+			break;
+		}
+		const size_t header_size = client->is_pipelined ? sizeof(READCMD2) : sizeof(READCMD);
+		if (client->input_level >= header_size) {
+			// More requests can be handled after the replies were sent
+			continue;
+		}
+		if (receive_count++ == c_max_receives_per_event) {
+			// The socket stays readable, the client is served again by the next epoll_wait() call.
+			// Frames already received are not reported by epoll, the client is served again after this event.
+			if (client->channel && (client->rx_level > 0 || client->rx_payload_offset < client->rx_payload.size())) {
+				resume_client(client);
+			}
+			break;
+		}
+		ssize_t n = receive_input(client);
+		if (n > 0) {
+			client->input_level += n;
+			continue;
+		}
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			break;
+		}
+		return false;
+	}
+	return watch_client(client);
+}
+
+/**
+ * Handle all complete requests in the input buffer while the client may have more requests in progress
+ *
+ * @param[in] client connected client
+ *
+ * @return false if the connection should be closed
+ */
+bool EntropyServer::parse_requests(Client *client) {
+	size_t offset = 0;
+	while (is_accepting_requests(client)) {
+		bool status;
+		if (client->is_pipelined) {
+			READCMD2 request;
+			if (client->input_level - offset < sizeof(request)) {
+				break;
+			}
+			memcpy(&request, client->input + offset, sizeof(request));
+			offset += sizeof(request);
+			status = handle_request(client, request.id, request.cmd, request.cbReqData);
+		} else {
+			READCMD request;
+			if (client->input_level - offset < sizeof(request)) {
+				break;
+			}
+			memcpy(&request, client->input + offset, sizeof(request));
+			offset += sizeof(request);
+			status = handle_request(client, 0, request.cmd, request.cbReqData);
+		}
+		if (!status) {
+			return false;
+		}
+	}
+	if (offset > 0) {
+		client->input_level -= offset;
+		memmove(client->input, client->input + offset, client->input_level);
+	}
+	return true;
+}
+
+/**
+ * Serve a request: from the prefetch buffer, by the server itself or by the device thread
+ *
+ * @param[in] client connected client
+ * @param[in] id request id chosen by the client, protocol version 2 and CUSE requests only
+ * @param[in] cmd command id
+ * @param[in] size amount of bytes requested
+ *
+ * @return false if the connection should be closed
+ */
+bool EntropyServer::handle_request(Client *client, uint64_t id, uint32_t cmd, uint32_t size) {
+	m_metrics.add_request();
+	if (size == 0 || size > (uint32_t)c_write_buff_size_bytes) {
+		log_error("Invalid amount of bytes requested: " + to_string(size));
+		return fail_request(client, id, c_status_invalid_request);
+	}
+
+	unsigned char *out;
+	unsigned char test_counter = 0;
+	switch (cmd) {
+	case c_cmd_entropy_retrieve_id:
+		return queue_entropy_request(client, id, size);
+	case c_cmd_diag_id:
+		out = add_reply(client, id, c_status_ok, size);
+		for (uint32_t t = 0; t < size; t++) {
+			out[t] = test_counter++;
+		}
+		m_metrics.add_bytes_served(StreamType::test, size);
+		return true;
+	case c_cmd_serv_minor_version_id:
+		if (size != sizeof(c_server_minor_version)) {
+			return fail_request(client, id, c_status_invalid_request);
+		}
+		*add_reply(client, id, c_status_ok, size) = c_server_minor_version;
+		return true;
+	case c_cmd_serv_major_version_id:
+		if (size != sizeof(c_server_major_version)) {
+			return fail_request(client, id, c_status_invalid_request);
+		}
+		*add_reply(client, id, c_status_ok, size) = c_server_major_version;
+		return true;
+	case c_cmd_protocol_version_id:
+		if (size != sizeof(c_protocol_version)) {
+			return fail_request(client, id, c_status_invalid_request);
+		}
+		*add_reply(client, id, c_status_ok, size) = c_protocol_version;
+		// The following requests of the client are READCMD2 structures
+		client->is_pipelined = true;
+		return true;
+	case c_cmd_high_priority_id:
+	case c_cmd_normal_priority_id:
+	case c_cmd_bulk_priority_id:
+		if (size != 1) {
+			return fail_request(client, id, c_status_invalid_request);
+		}
+		if (client->is_active) {
+			deactivate_client(client);
+			client->priority = cmd - c_cmd_high_priority_id;
+			activate_client(client);
+		} else {
+			client->priority = cmd - c_cmd_high_priority_id;
+		}
+		*add_reply(client, id, c_status_ok, size) = (unsigned char)client->priority;
+		return true;
+	case c_cmd_dev_ser_num_id:
+	case c_cmd_dev_model_id:
+	case c_cmd_dev_minor_version_id:
+	case c_cmd_dev_major_version_id:
+	case c_cmd_noise_src_one_id:
+	case c_cmd_noise_src_two_id:
+	case c_cmd_entropy_sha256_extract_id:
+	case c_cmd_entropy_sha512_extract_id:
+	case c_cmd_noise_id: {
+		Request *request = queue_request(client, id, cmd, size);
+		request->data.resize(size);
+		client->device_requests++;
+		lock_guard<mutex> lock(m_mtx);
+		select_worker(cmd)->requests.push_back(request);
+		m_cv_device.notify_all();
+		return true;
+	}
+	default:
+		log_error("Invalid command received: " + to_string(cmd));
+		return fail_request(client, id, c_status_invalid_request);
+	}
+}
+
+/**
+ * @param[in] client connected client
+ *
+ * @return true if the client may have another request in progress
+ */
+bool EntropyServer::is_accepting_requests(const Client *client) const {
+	if (!client->is_pipelined) {
+		// One request at a time, the reply is sent before the next request is handled
+		return client->pending_requests == 0 && get_buffered_bytes(client) == 0;
+	}
+	return client->pending_requests < c_max_pipelined_requests
+			&& get_buffered_bytes(client) + client->pending_bytes < (size_t)c_max_client_buffer_bytes;
+}
+
+/**
+ * @param[in] client connected client
+ *
+ * @return amount of reply bytes not sent yet, including the frames of a TCP client
+ */
+size_t EntropyServer::get_buffered_bytes(const Client *client) const {
+	return client->output.size() - client->output_bytes_written + client->tx.size() - client->tx_written;
+}
+
+/**
+ * Append a reply to the client output, with a REPLY2 header when the client uses protocol version 2
+ * or with a FUSE reply header for an open file of the CUSE device
+ *
+ * @param[in] client connected client
+ * @param[in] id request id
+ * @param[in] status request status, one of c_status_ values
+ * @param[in] size amount of reply data bytes
+ *
+ * @return location for the reply data bytes
+ */
+unsigned char *EntropyServer::add_reply(Client *client, uint64_t id, uint32_t status, uint32_t size) {
+	unsigned char header[c_max_reply_header_bytes];
+	const size_t header_size = create_reply_header(client, id, status, size, header);
+	const size_t offset = client->output.size();
+	client->output.resize(offset + header_size + size);
+	memcpy(client->output.data() + offset, header, header_size);
+	return client->output.data() + offset + header_size;
+}
+
+/**
+ * @param[in] client connected client
+ * @param[in] id request id
+ * @param[in] status request status, one of c_status_ values
+ * @param[in] size amount of reply data bytes
+ * @param[out] header location for up to c_max_reply_header_bytes bytes of the reply header
+ *
+ * @return size of the reply header, 0 for protocol version 1
+ */
+size_t EntropyServer::create_reply_header(const Client *client, uint64_t id, uint32_t status, uint32_t size, unsigned char *header) {
+	static_assert(CuseDevice::c_reply_header_size_bytes <= c_max_reply_header_bytes && sizeof(REPLY2) <= c_max_reply_header_bytes,
+			"Reply headers must fit c_max_reply_header_bytes");
+	if (client->is_cuse) {
+		const int error = status == c_status_ok ? 0 : status == c_status_invalid_request ? -EINVAL : -EIO;
+		return CuseDevice::create_reply_header(id, error, size, header);
+	}
+	if (client->is_pipelined) {
+		REPLY2 reply {(uint32_t)id, status, size};
+		memcpy(header, &reply, sizeof(reply));
+		return sizeof(reply);
+	}
+	return 0;
+}
+
+/**
+ * Append reply bytes to the client output. Large replies of a socket client with no output waiting are
+ * sent straight from their source with one sendmsg() call, sparing the copy into the output buffer;
+ * only the bytes the socket does not take are copied. The caller holds m_mtx, so the device workers wait
+ * for the direct send: it is limited to c_max_direct_send_bytes and the rest of the reply is copied and
+ * sent by write_output() after the lock is released.
+ *
+ * @param[in] client connected client
+ * @param[in] iov reply segments in order
+ * @param[in] count amount of segments
+ */
+void EntropyServer::send_reply(Client *client, iovec *iov, int count) {
+	size_t total = 0;
+	for (int i = 0; i < count; i++) {
+		total += iov[i].iov_len;
+	}
+	size_t sent = 0;
+	if (client->output.empty() && total >= c_min_direct_send_bytes && !client->is_cuse && !client->channel) {
+		iovec direct_iov[c_max_reply_segments];
+		int direct_count = 0;
+		size_t direct_bytes = 0;
+		for (int i = 0; i < count && direct_bytes < c_max_direct_send_bytes; i++) {
+			direct_iov[direct_count].iov_base = iov[i].iov_base;
+			direct_iov[direct_count].iov_len = min(iov[i].iov_len, c_max_direct_send_bytes - direct_bytes);
+			direct_bytes += direct_iov[direct_count++].iov_len;
+		}
+		msghdr msg {};
+		msg.msg_iov = direct_iov;
+		msg.msg_iovlen = direct_count;
+		// The socket is non blocking, bytes not sent are queued and a failed connection is detected by write_output()
+		ssize_t n = sendmsg(client->fd, &msg, MSG_NOSIGNAL);
+		sent = n > 0 ? (size_t)n : 0;
+		m_direct_send_bytes += sent;
+	}
+	const size_t offset = client->output.size();
+	client->output.resize(offset + total - sent);
+	unsigned char *out = client->output.data() + offset;
+	for (int i = 0; i < count; i++) {
+		const size_t skip = min(sent, iov[i].iov_len);
+		sent -= skip;
+		memcpy(out, (const unsigned char*)iov[i].iov_base + skip, iov[i].iov_len - skip);
+		out += iov[i].iov_len - skip;
+	}
+}
+
+/**
+ * Reply to an entropy request with bytes taken from the prefetch buffer, the caller holds m_mtx
+ *
+ * @param[in] client connected client
+ * @param[in] id request id
+ * @param[in] size amount of entropy bytes, not more than m_prefetch_level
+ * @param[in] has_header false to append the bytes to a partially sent protocol version 1 reply
+ */
+void EntropyServer::reply_prefetched(Client *client, uint64_t id, uint32_t size, bool has_header) {
+	unsigned char header[c_max_reply_header_bytes];
+	iovec iov[c_max_reply_segments];
+	int count = 0;
+	if (has_header) {
+		iov[count].iov_base = header;
+		iov[count++].iov_len = create_reply_header(client, id, c_status_ok, size, header);
+	}
+	const size_t first = min((size_t)size, m_prefetch_buffer.size() - m_prefetch_head);
+	iov[count].iov_base = m_prefetch_buffer.data() + m_prefetch_head;
+	iov[count++].iov_len = first;
+	iov[count].iov_base = m_prefetch_buffer.data();
+	iov[count++].iov_len = size - first;
+	send_reply(client, iov, count);
+	take_prefetched(nullptr, size);
+}
+
+/**
+ * @param[in] client connected client
+ * @param[in] id request id
+ * @param[in] status reason of the failure
+ *
+ * @return false if the connection should be closed, which is the case for protocol version 1
+ */
+bool EntropyServer::fail_request(Client *client, uint64_t id, uint32_t status) {
+	if (status == c_status_invalid_request) {
+		m_metrics.add_invalid_request();
+	} else {
+		m_metrics.add_failed_request();
+	}
+	if (!client->is_pipelined && !client->is_cuse) {
+		return false;
+	}
+	add_reply(client, id, status, 0);
+	return true;
+}
+
+/**
+ * Create a request that completes later
+ *
+ * @return new request counted as pending by the client
+ */
+EntropyServer::Request *EntropyServer::queue_request(Client *client, uint64_t id, uint32_t cmd, uint32_t size) {
+	Request *request = new Request();
+	request->client = client;
+	request->id = id;
+	request->cmd = cmd;
+	request->size = size;
+	client->pending_requests++;
+	client->pending_bytes += size;
+	return request;
+}
+
+/**
+ * Stop counting a completed request as pending and release it
+ *
+ * @param[in] request completed request
+ */
+void EntropyServer::finish_request(Request *request) {
+	Client *client = request->client;
+	client->pending_requests--;
+	client->pending_bytes -= request->size;
+	delete request;
+	resume_client(client);
+}
+
+/**
+ * Send the ready replies to a client, continue when the socket becomes writable
+ *
+ * @param[in] client connected client
+ *
+ * @return false if the connection should be closed
+ */
+bool EntropyServer::write_output(Client *client) {
+	if (client->is_cuse) {
+		return write_cuse_output(client);
+	}
+	if (client->channel) {
+		return write_channel_output(client);
+	}
+	while (client->output_bytes_written < client->output.size()) {
+		ssize_t n = send(client->fd, client->output.data() + client->output_bytes_written,
+				client->output.size() - client->output_bytes_written, MSG_NOSIGNAL);
+		if (n > 0) {
+			client->output_bytes_written += n;
+			continue;
+		}
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+	}
+	client->output.clear();
+	client->output_bytes_written = 0;
+	return true;
+}
+
+/**
+ * Receive more request bytes into the input buffer
+ *
+ * @param[in] client connected client
+ *
+ * @return amount of bytes received, 0 when the connection was closed or -1 with errno set
+ */
+ssize_t EntropyServer::receive_input(Client *client) {
+	if (client->channel) {
+		return receive_channel_input(client);
+	}
+	return recv(client->fd, client->input + client->input_level, sizeof(client->input) - client->input_level, 0);
+}
+
+/**
+ * Receive the hello and the request frames of a TCP client, the decrypted requests are copied into the input buffer
+ *
+ * @param[in] client TCP client
+ *
+ * @return amount of request bytes added to the input buffer, 0 when the connection was closed or -1 with errno set
+ */
+ssize_t EntropyServer::receive_channel_input(Client *client) {
+	PskChannel *channel = client->channel.get();
+	while (true) {
+		if (client->rx_payload_offset < client->rx_payload.size()) {
+			const size_t size = min(client->rx_payload.size() - client->rx_payload_offset,
+					sizeof(client->input) - client->input_level);
+			memcpy(client->input + client->input_level, client->rx_payload.data() + client->rx_payload_offset, size);
+			client->rx_payload_offset += size;
+			return (ssize_t)size;
+		}
+
+		size_t frame_size = 0;
+		if (!channel->is_established()) {
+			if (client->rx_level >= (size_t)PskChannel::c_hello_size_bytes) {
+				if (!channel->accept_hello(client->rx.data())) {
+					log_error("TCP client " + to_string(client->fd) + ": " + channel->get_last_error());
+					errno = EPROTO;
+					return -1;
+				}
+				frame_size = PskChannel::c_hello_size_bytes;
+			}
+		} else if (client->rx_level >= (size_t)PskChannel::c_header_size_bytes) {
+			const uint32_t size = PskChannel::get_payload_size(client->rx.data());
+			if (size == 0 || size > (uint32_t)c_input_buffer_size_bytes) {
+				log_error("TCP client " + to_string(client->fd) + " sent an invalid frame of " + to_string(size) + " bytes.");
+				errno = EPROTO;
+				return -1;
+			}
+			if (client->rx_level >= size + PskChannel::c_frame_overhead_bytes) {
+				client->rx_payload.resize(size);
+				client->rx_payload_offset = 0;
+				if (!channel->open(client->rx.data(), client->rx_payload.data())) {
+					log_error("TCP client " + to_string(client->fd) + ": " + channel->get_last_error());
+					errno = EPROTO;
+					return -1;
+				}
+				frame_size = size + PskChannel::c_frame_overhead_bytes;
+			}
+		}
+		if (frame_size > 0) {
+			client->rx_level -= frame_size;
+			memmove(client->rx.data(), client->rx.data() + frame_size, client->rx_level);
+			continue;
+		}
+
+		ssize_t n = recv(client->fd, client->rx.data() + client->rx_level, client->rx.size() - client->rx_level, 0);
+		if (n <= 0) {
+			return n;
+		}
+		client->rx_level += n;
+	}
+}
+
+/**
+ * Encrypt the ready replies of a TCP client into frames and send them, continue when the socket becomes writable.
+ * Replies are sealed while they are copied into the frames, so they are not copied again before sending.
+ *
+ * @param[in] client TCP client
+ *
+ * @return false if the connection should be closed
+ */
+bool EntropyServer::write_channel_output(Client *client) {
+	if (!client->output.empty()) {
+		if (client->tx_written == client->tx.size()) {
+			client->tx.clear();
+			client->tx_written = 0;
+		}
+		for (size_t offset = 0; offset < client->output.size(); ) {
+			const uint32_t size = (uint32_t)min(client->output.size() - offset, (size_t)PskChannel::c_max_payload_bytes);
+			const size_t frame_offset = client->tx.size();
+			client->tx.resize(frame_offset + size + PskChannel::c_frame_overhead_bytes);
+			if (!client->channel->seal(client->output.data() + offset, size, client->tx.data() + frame_offset)) {
+				log_error("TCP client " + to_string(client->fd) + ": " + client->channel->get_last_error());
+				return false;
+			}
+			offset += size;
+		}
+		client->output.clear();
+		client->output_bytes_written = 0;
+	}
+	while (client->tx_written < client->tx.size()) {
+		ssize_t n = send(client->fd, client->tx.data() + client->tx_written, client->tx.size() - client->tx_written, MSG_NOSIGNAL);
+		if (n > 0) {
+			client->tx_written += n;
+			continue;
+		}
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+	}
+	client->tx.clear();
+	client->tx_written = 0;
+	return true;
+}
+
+/**
+ * Watch a client for more requests while it may have them in progress and for writing while replies are not sent.
+ * Hang ups are always reported.
+ *
+ * @param[in] client connected client
+ *
+ * @return true when successful
+ */
+bool EntropyServer::watch_client(Client *client) {
+	uint32_t events = 0;
+	if (is_accepting_requests(client)) {
+		events |= EPOLLIN;
+	}
+	if (get_buffered_bytes(client) > 0) {
+		events |= EPOLLOUT;
+	}
+	if (client->events == events) {
+		return true;
+	}
+	epoll_event ev {};
+	ev.events = events;
+	ev.data.ptr = client;
+	if (epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, client->fd, &ev) < 0) {
+		log_error("Could not watch client, error code: " + to_string(errno));
+		return false;
+	}
+	client->events = events;
+	return true;
+}
+
+/**
+ * Close the client connection. A client used by the device thread is released when its device requests complete.
+ *
+ * @param[in] client connected client
+ */
+void EntropyServer::close_client(Client *client) {
+	if (!client->is_closed) {
+		client->is_closed = true;
+		if (!client->is_cuse) {
+			epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, client->fd, nullptr);
+		}
+		deactivate_client(client);
+		if (client->is_throttled) {
+			m_throttled_clients.erase(remove(m_throttled_clients.begin(), m_throttled_clients.end(), client),
+					m_throttled_clients.end());
+		}
+		for (Request *request : client->entropy_requests) {
+			delete request;
+		}
+		m_waiting_requests -= client->entropy_requests.size();
+		client->entropy_requests.clear();
+	}
+	if (client->device_requests > 0) {
+		return;
+	}
+	if (client->is_cuse) {
+		m_cuse_clients.erase(client->cuse_handle);
+	} else {
+		m_clients.erase(client->fd);
+		close(client->fd);
+	}
+	m_released_clients.push_back(client);
+}
+
+/**
+ * Remember a client with completed requests, it is served again after all completions are handled
+ *
+ * @param[in] client connected client
+ */
+void EntropyServer::resume_client(Client *client) {
+	if (!client->is_resumed) {
+		client->is_resumed = true;
+		m_resumed_clients.push_back(client);
+	}
+}
+
+/**
+ * Complete the device requests and serve the entropy waiters after the device thread signaled progress
+ */
+void EntropyServer::handle_device_events() {
+	uint64_t value;
+	while (read(m_event_fd, &value, sizeof(value)) < 0 && errno == EINTR) {
+	}
+
+	deque<Request*> completed;
+	bool is_device_failed = false;
+	{
+		lock_guard<mutex> lock(m_mtx);
+		completed.swap(m_completed_requests);
+		is_device_failed = m_device_failure_count != m_handled_failure_count;
+		m_handled_failure_count = m_device_failure_count;
+	}
+
+	for (Request *request : completed) {
+		Client *client = request->client;
+		client->device_requests--;
+		if (client->is_closed) {
+			delete request;
+			close_client(client);
+			continue;
+		}
+		if (request->is_device_ok) {
+			memcpy(add_reply(client, request->id, c_status_ok, request->size), request->data.data(), request->size);
+			StreamType e_type;
+			if (get_stream_type(request->cmd, &e_type)) {
+				m_metrics.add_bytes_served(e_type, request->size);
+			}
+		} else if (!fail_request(client, request->id, c_status_device_failure)) {
+			delete request;
+			close_client(client);
+			continue;
+		}
+		finish_request(request);
+	}
+	if (is_device_failed) {
+		fail_entropy_requests();
+	}
+	schedule_entropy();
+}
+
+/**
+ * Serve the clients with completed requests, they may have more requests to handle or replies to send
+ */
+void EntropyServer::serve_resumed_clients() {
+	// Serving a client may complete requests of other clients, which are appended
+	for (size_t i = 0; i < m_resumed_clients.size(); i++) {
+		Client *client = m_resumed_clients[i];
+		client->is_resumed = false;
+		// An open file of the CUSE device has no socket, its requests are read from /dev/cuse
+		if (!client->is_closed && !(client->is_cuse ? write_output(client) : serve_client(client))) {
+			close_client(client);
+		}
+	}
+	m_resumed_clients.clear();
+}
+
+/**
+ * Stop the server on SIGINT or SIGTERM, log the client statistics on SIGUSR1
+ *
+ * @param[out] is_running set to false when the server should stop
+ */
+void EntropyServer::handle_signal(bool *is_running) {
+	signalfd_siginfo info;
+	while (read(m_signal_fd, &info, sizeof(info)) == sizeof(info)) {
+		if (info.ssi_signo == SIGUSR1) {
+			log_client_statistics();
+			log_cache_statistics();
+		} else {
+			*is_running = false;
+		}
+	}
+}
+
+/**
+ * Serve an entropy request immediately when no other requests wait, otherwise leave it to the scheduler
+ *
+ * @param[in] client connected client
+ * @param[in] id request id
+ * @param[in] size amount of entropy bytes requested
+ *
+ * @return false if the connection should be closed
+ */
+bool EntropyServer::queue_entropy_request(Client *client, uint64_t id, uint32_t size) {
+	const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	if (m_waiting_requests == 0 && !client->quota.is_enabled() && take_entropy(client, id, size)) {
+		record_latency(client, now, size);
+		m_cache_hit_count++;
+		return true;
+	}
+	m_cache_miss_count++;
+	Request *request = queue_request(client, id, c_cmd_entropy_retrieve_id, size);
+	request->received_time = now;
+	client->entropy_requests.push_back(request);
+	m_waiting_requests++;
+	if (!client->is_throttled) {
+		activate_client(client);
+	}
+	schedule_entropy();
+	return true;
+}
+
+/**
+ * Add a client with waiting entropy requests to the round robin of its priority class
+ *
+ * @param[in] client connected client
+ */
+void EntropyServer::activate_client(Client *client) {
+	if (!client->is_active) {
+		client->is_active = true;
+		client->has_turn = false;
+		m_active_clients[client->priority].push_back(client);
+	}
+}
+
+/**
+ * @param[in] client connected client
+ */
+void EntropyServer::deactivate_client(Client *client) {
+	if (client->is_active) {
+		deque<Client*> &clients = m_active_clients[client->priority];
+		clients.erase(remove(clients.begin(), clients.end(), client), clients.end());
+		client->is_active = false;
+		client->has_turn = false;
+		client->deficit_bytes = 0;
+	}
+}
+
+/**
+ * Distribute the prefetched entropy bytes to the waiting requests, higher priority classes first
+ */
+void EntropyServer::schedule_entropy() {
+	if (m_waiting_requests == 0) {
+		return;
+	}
+	for (deque<Client*> &clients : m_active_clients) {
+		if (!serve_active_clients(clients)) {
+			break;
+		}
+	}
+	m_cv_device.notify_all();
+}
+
+/**
+ * Deficit round robin over the clients of one priority class
+ *
+ * @param[in] clients active clients of a priority class
+ *
+ * @return true if all clients were served, false if the prefetch buffer was drained first
+ */
+bool EntropyServer::serve_active_clients(deque<Client*> &clients) {
+	while (!clients.empty()) {
+		Client *client = clients.front();
+		if (!client->has_turn) {
+			client->has_turn = true;
+			client->deficit_bytes += c_quantum_bytes;
+		}
+		if (!serve_client_turn(client)) {
+			// The turn continues when more bytes are prefetched
+			return false;
+		}
+		clients.pop_front();
+		client->has_turn = false;
+		if (client->entropy_requests.empty() || client->is_throttled) {
+			client->is_active = false;
+			client->deficit_bytes = 0;
+		} else {
+			clients.push_back(client);
+		}
+	}
+	return true;
+}
+
+/**
+ * Serve the waiting requests of a client up to its deficit. A large request is filled over several turns.
+ *
+ * @param[in] client active client
+ *
+ * @return false if the prefetch buffer was drained before the turn ended
+ */
+bool EntropyServer::serve_client_turn(Client *client) {
+	lock_guard<mutex> lock(m_mtx);
+	while (client->deficit_bytes > 0 && !client->entropy_requests.empty()) {
+		if (m_prefetch_level == 0) {
+			return false;
+		}
+		Request *request = client->entropy_requests.front();
+		uint32_t size = min(request->size - request->filled_bytes, client->deficit_bytes);
+		size = (uint32_t)min((size_t)size, m_prefetch_level);
+		double wait_secs;
+		size = (uint32_t)client->quota.try_acquire(size, &wait_secs);
+		if (size == 0) {
+			client->is_throttled = true;
+			client->throttled_until = chrono::steady_clock::now()
+					+ chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(wait_secs));
+			m_throttled_clients.push_back(client);
+			return true;
+		}
+
+		if (request->filled_bytes == 0 && size == request->size) {
+			reply_prefetched(client, request->id, size, true);
+		} else if (!client->is_pipelined && !client->is_cuse) {
+			// Only one request is in progress, its bytes are sent as they are taken
+			reply_prefetched(client, request->id, size, false);
+		} else {
+			// The reply header and data are sent together once all bytes are taken
+			request->data.resize(request->size);
+			take_prefetched(request->data.data() + request->filled_bytes, size);
+			if (request->filled_bytes + size == request->size) {
+				unsigned char header[c_max_reply_header_bytes];
+				iovec iov[2];
+				iov[0].iov_base = header;
+				iov[0].iov_len = create_reply_header(client, request->id, c_status_ok, request->size, header);
+				iov[1].iov_base = request->data.data();
+				iov[1].iov_len = request->size;
+				send_reply(client, iov, 2);
+			}
+		}
+		request->filled_bytes += size;
+		client->deficit_bytes -= size;
+		if (request->filled_bytes == request->size) {
+			client->entropy_requests.pop_front();
+			m_waiting_requests--;
+			record_latency(client, request->received_time, request->size);
+			finish_request(request);
+		}
+	}
+	return true;
+}
+
+/**
+ * Return the throttled clients to the scheduler once their quota allows it
+ */
+void EntropyServer::release_throttled_clients() {
+	if (m_throttled_clients.empty()) {
+		return;
+	}
+	const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	auto it = remove_if(m_throttled_clients.begin(), m_throttled_clients.end(), [this, now](Client *client) {
+		if (client->throttled_until > now) {
+			return false;
+		}
+		client->is_throttled = false;
+		if (!client->entropy_requests.empty()) {
+			activate_client(client);
+		}
+		return true;
+	});
+	if (it != m_throttled_clients.end()) {
+		m_throttled_clients.erase(it, m_throttled_clients.end());
+		schedule_entropy();
+	}
+}
+
+/**
+ * @return epoll_wait() timeout until the first throttled client can be served, -1 if none
+ */
+int EntropyServer::get_throttle_timeout_mlsecs() const {
+	if (m_throttled_clients.empty()) {
+		return -1;
+	}
+	chrono::steady_clock::time_point first = m_throttled_clients.front()->throttled_until;
+	for (const Client *client : m_throttled_clients) {
+		first = min(first, client->throttled_until);
+	}
+	double mlsecs = chrono::duration<double, milli>(first - chrono::steady_clock::now()).count();
+	return mlsecs > 0 ? (int)ceil(mlsecs) : 0;
+}
+
+/**
+ * Fail all waiting entropy requests after the device could not refill the prefetch buffer.
+ * Same as with a failed device request, protocol version 1 connections are closed.
+ */
+void EntropyServer::fail_entropy_requests() {
+	vector<Client*> waiting(m_throttled_clients);
+	for (deque<Client*> &clients : m_active_clients) {
+		waiting.insert(waiting.end(), clients.begin(), clients.end());
+	}
+	for (Client *client : waiting) {
+		if (!client->is_pipelined && !client->is_cuse) {
+			close_client(client);
+			continue;
+		}
+		while (!client->entropy_requests.empty()) {
+			Request *request = client->entropy_requests.front();
+			client->entropy_requests.pop_front();
+			m_waiting_requests--;
+			fail_request(client, request->id, c_status_device_failure);
+			finish_request(request);
+		}
+		deactivate_client(client);
+	}
+}
+
+/**
+ * Add a reply with prefetched entropy bytes to the client output
+ *
+ * @param[in] client connected client
+ * @param[in] id request id
+ * @param[in] size amount of entropy bytes requested
+ *
+ * @return true if the prefetch buffer had enough bytes
+ */
+bool EntropyServer::take_entropy(Client *client, uint64_t id, uint32_t size) {
+	{
+		lock_guard<mutex> lock(m_mtx);
+		if (m_prefetch_level < size) {
+			return false;
+		}
+		reply_prefetched(client, id, size, true);
+	}
+	m_cv_device.notify_all();
+	return true;
+}
+
+/**
+ * Add the latency of a completed entropy request to the client statistics
+ *
+ * @param[in] client connected client
+ * @param[in] received_time when the request was received
+ * @param[in] size amount of entropy bytes served
+ */
+void EntropyServer::record_latency(Client *client, chrono::steady_clock::time_point received_time, uint32_t size) {
+	const int64_t latency_usecs = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - received_time).count();
+	client->stats.latency.record(latency_usecs);
+	client->stats.byte_count += size;
+	m_metrics.record_request_latency(latency_usecs);
+	m_metrics.add_bytes_served(StreamType::entropy, size);
+}
+
+/**
+ * Log entropy request statistics of the connected clients on standard output
+ */
+void EntropyServer::log_client_statistics() const {
+	static const char * const priority_names[c_priority_classes] = {"high", "normal", "bulk"};
+	vector<const Client*> clients;
+	for (auto const &entry : m_clients) {
+		clients.push_back(entry.second);
+	}
+	for (auto const &entry : m_cuse_clients) {
+		clients.push_back(entry.second);
+	}
+	cout << clients.size() << " client(s) connected" << endl;
+	for (const Client *client : clients) {
+		const LatencyHistogram &latency = client->stats.latency;
+		cout << (client->is_cuse ? "Device reader pid " : "Client pid ") << client->pid << ", "
+				<< priority_names[client->priority] << " priority: "
+				<< latency.get_count() << " entropy requests, " << client->stats.byte_count << " bytes";
+		if (latency.get_count() > 0) {
+			cout << ", latency p50: " << latency.get_percentile(50) << " us, p99: " << latency.get_percentile(99)
+					<< " us, max: " << latency.get_max() << " us";
+		}
+		cout << endl;
+	}
+}
+
+/**
+ * Log how often entropy requests were served from the cache on arrival and the device refill cycles
+ */
+void EntropyServer::log_cache_statistics() const {
+	uint64_t refill_count;
+	size_t level;
+	{
+		lock_guard<mutex> lock(m_mtx);
+		refill_count = m_refill_count;
+		level = m_prefetch_level;
+	}
+	const uint64_t request_count = m_cache_hit_count + m_cache_miss_count;
+	cout << "Entropy cache: " << level << " of " << m_prefetch_buffer.size() << " bytes, " << refill_count
+			<< " refill(s), " << m_cache_hit_count << " of " << request_count << " entropy requests served on arrival";
+	if (request_count > 0) {
+		cout << " (" << m_cache_hit_count * 100 / request_count << "%)";
+	}
+	cout << endl;
+}
+
+/**
+ * Move bytes out of the prefetch buffer, the caller holds m_mtx
+ *
+ * @param[out] out location for the bytes, nullptr when they were already sent
+ * @param[in] size amount of bytes, not more than m_prefetch_level
+ */
+void EntropyServer::take_prefetched(unsigned char *out, size_t size) {
+	if (out != nullptr) {
+		size_t first = min(size, m_prefetch_buffer.size() - m_prefetch_head);
+		memcpy(out, m_prefetch_buffer.data() + m_prefetch_head, first);
+		memcpy(out + first, m_prefetch_buffer.data(), size - first);
+	}
+	m_prefetch_head = (m_prefetch_head + size) % m_prefetch_buffer.size();
+	m_prefetch_level -= size;
+	if (m_seed_level > 0) {
+		// Bytes generated from the seed file are at the head of the cache, they go out before any device byte
+		const size_t seed_bytes = min(size, m_seed_level);
+		m_seed_level -= seed_bytes;
+		m_seed_bytes_served += seed_bytes;
+		if (m_seed_level == 0) {
+			cout << "Served " << m_seed_bytes_served << " bytes generated from the seed file, serving device entropy only" << endl;
+		}
+	}
+}
+
+/**
+ * Start refilling the cache below the low watermark and continue up to the high watermark, the caller holds m_mtx.
+ * Chunks the workers are reading count as cache bytes.
+ *
+ * @return true if the device thread should prefetch another chunk
+ */
+bool EntropyServer::is_refill_needed() {
+	const size_t level = m_prefetch_level + m_prefetch_claimed;
+	if (!m_is_refilling && level < m_cache_low_bytes) {
+		m_is_refilling = true;
+		m_refill_count++;
+	}
+	if (level + c_prefetch_chunk_bytes > m_prefetch_buffer.size()) {
+		m_is_refilling = false;
+	}
+	return m_is_refilling;
+}
+
+/**
+ * Wake up the event loop from the device thread
+ */
+void EntropyServer::notify_event_loop() {
+	uint64_t value = 1;
+	while (write(m_event_fd, &value, sizeof(value)) < 0 && errno == EINTR) {
+	}
+}
+
+/**
+ * Create a worker for the device the server was started with and, with the all devices option,
+ * for every other connected device
+ *
+ * @return true when successful
+ */
+bool EntropyServer::create_workers() {
+	vector<int> device_numbers {m_cmd->device_number};
+	if (m_cmd->is_all_devices) {
+		const int device_count = m_rng->get_device_count();
+		for (int device_number = 0; device_number < device_count; device_number++) {
+			if (device_number != m_cmd->device_number) {
+				device_numbers.push_back(device_number);
+			}
+		}
+	}
+	for (int device_number : device_numbers) {
+		unique_ptr<DeviceWorker> worker {new DeviceWorker()};
+		worker->device_number = device_number;
+		worker->is_in_rotation = false;
+		worker->is_busy = false;
+		worker->latency_usecs = 0;
+		worker->chunk_count = 0;
+		worker->rotation_exit_count = 0;
+		if (m_workers.empty()) {
+			worker->rng = m_rng;
+		} else {
+			worker->owned_rng.reset(new AlphaRngApi(m_rng->get_configuration()));
+			worker->rng = worker->owned_rng.get();
+			if (!worker->rng->set_session_ttl(m_cmd->ttl_minutes)) {
+				cerr << worker->rng->get_last_error() << endl;
+				return false;
+			}
+			if (m_cmd->disable_stat_tests) {
+				worker->rng->disable_stat_tests();
+			}
+			worker->rng->set_num_failures_threshold(m_cmd->num_failures_threshold);
+		}
+		m_workers.push_back(move(worker));
+	}
+	return true;
+}
+
+/**
+ * Device worker: execute the device requests routed to the device and refill the cache between the watermarks.
+ * Device requests are executed first, they wait for one prefetch chunk at most.
+ *
+ * @param[in] worker the worker of the device
+ */
+void EntropyServer::run_device(DeviceWorker *worker) {
+	vector<unsigned char> chunk(c_prefetch_chunk_bytes);
+	if (!worker->rng->is_connected() && !connect_device(worker)) {
+		return;
+	}
+	worker->next_status_time = chrono::steady_clock::now();
+	const bool is_healthy = check_device_health(worker, true);
+	{
+		lock_guard<mutex> lock(m_mtx);
+		worker->is_in_rotation = is_healthy;
+	}
+	m_cv_device.notify_all();
+
+	while (true) {
+		unique_lock<mutex> lock(m_mtx);
+		m_cv_device.wait(lock, [this, worker] {
+			return m_is_stopping || !worker->requests.empty() || !worker->is_in_rotation || is_refill_needed();
+		});
+		if (m_is_stopping) {
+			return;
+		}
+
+		if (!worker->requests.empty()) {
+			Request *request = worker->requests.front();
+			worker->requests.pop_front();
+			worker->is_busy = true;
+			lock.unlock();
+			bool status = execute_device_request(worker, request);
+			lock.lock();
+			worker->is_busy = false;
+			request->is_device_ok = status;
+			m_completed_requests.push_back(request);
+			if (!status && worker->is_in_rotation) {
+				take_out_of_rotation(worker);
+			}
+			lock.unlock();
+			notify_event_loop();
+			continue;
+		}
+
+		if (!worker->is_in_rotation) {
+			lock.unlock();
+			bool status = reconnect_device(worker) && check_device_health(worker, true);
+			if (!status) {
+				log_device_error(worker);
+			}
+			update_device_metrics(worker, status);
+			lock.lock();
+			if (status) {
+				worker->is_in_rotation = true;
+				lock.unlock();
+				log_error("Device " + to_string(worker->device_number) + " is back in rotation");
+				m_cv_device.notify_all();
+				continue;
+			}
+			if (!is_any_device_in_rotation()) {
+				m_device_failure_count++;
+				lock.unlock();
+				notify_event_loop();
+				lock.lock();
+			}
+			m_cv_device.wait_for(lock, chrono::milliseconds(c_device_retry_mlsecs), [this, worker] {
+				return m_is_stopping || !worker->requests.empty();
+			});
+			continue;
+		}
+
+		m_prefetch_claimed += chunk.size();
+		worker->is_busy = true;
+		lock.unlock();
+		chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+		bool status = prefetch_entropy(worker, chunk.data());
+		const int64_t latency_usecs = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - begin).count();
+		if (status) {
+			m_metrics.record_device_read(latency_usecs, chunk.size());
+			status = check_device_health(worker, false);
+		}
+		update_device_metrics(worker, status);
+		lock.lock();
+		m_prefetch_claimed -= chunk.size();
+		worker->is_busy = false;
+		bool is_seed_due = false;
+		if (status) {
+			size_t tail = (m_prefetch_head + m_prefetch_level) % m_prefetch_buffer.size();
+			size_t first = min(chunk.size(), m_prefetch_buffer.size() - tail);
+			memcpy(m_prefetch_buffer.data() + tail, chunk.data(), first);
+			memcpy(m_prefetch_buffer.data(), chunk.data() + first, chunk.size() - first);
+			m_prefetch_level += chunk.size();
+			worker->chunk_count++;
+			worker->latency_usecs = worker->latency_usecs == 0 ? latency_usecs : worker->latency_usecs * 0.875 + latency_usecs * 0.125;
+			if (!m_cmd->seed_file_name.empty() && chrono::steady_clock::now() >= m_next_seed_time) {
+				m_next_seed_time = chrono::steady_clock::now() + chrono::seconds(c_seed_save_interval_secs);
+				is_seed_due = true;
+			}
+		} else {
+			take_out_of_rotation(worker);
+		}
+		lock.unlock();
+		m_cv_ring.notify_one();
+		notify_event_loop();
+		if (is_seed_due) {
+			save_seed_file(worker);
+		}
+	}
+}
+
+/**
+ * Pick the device for a device request, the caller holds m_mtx.
+ * Requests for device properties go to the first device in rotation, so they describe the same device.
+ *
+ * @param[in] cmd command id of the request
+ *
+ * @return the device in rotation with the shortest queue weighted by its latency, the first device if none is in rotation
+ */
+EntropyServer::DeviceWorker *EntropyServer::select_worker(uint32_t cmd) {
+	const bool is_device_property = cmd == c_cmd_dev_ser_num_id || cmd == c_cmd_dev_model_id
+			|| cmd == c_cmd_dev_minor_version_id || cmd == c_cmd_dev_major_version_id;
+	DeviceWorker *selected = nullptr;
+	double selected_cost = 0;
+	for (auto &worker : m_workers) {
+		if (!worker->is_in_rotation) {
+			continue;
+		}
+		if (is_device_property) {
+			return worker.get();
+		}
+		const double cost = (worker->requests.size() + (worker->is_busy ? 2 : 1)) * max(worker->latency_usecs, 1.0);
+		if (selected == nullptr || cost < selected_cost) {
+			selected = worker.get();
+			selected_cost = cost;
+		}
+	}
+	return selected != nullptr ? selected : m_workers.front().get();
+}
+
+/**
+ * Stop using a failed device until it reconnects, its queued requests move to the devices in rotation.
+ * The caller holds m_mtx.
+ *
+ * @param[in] worker the worker of the failed device
+ */
+void EntropyServer::take_out_of_rotation(DeviceWorker *worker) {
+	worker->is_in_rotation = false;
+	worker->rotation_exit_count++;
+	if (!is_any_device_in_rotation()) {
+		m_device_failure_count++;
+	}
+	deque<Request*> requests;
+	requests.swap(worker->requests);
+	for (Request *request : requests) {
+		select_worker(request->cmd)->requests.push_back(request);
+	}
+	m_cv_device.notify_all();
+	if (m_workers.size() > 1) {
+		log_error("Device " + to_string(worker->device_number) + " is taken out of rotation");
+	}
+}
+
+/**
+ * @return true if at least one device serves clients, the caller holds m_mtx
+ */
+bool EntropyServer::is_any_device_in_rotation() const {
+	for (auto const &worker : m_workers) {
+		if (worker->is_in_rotation) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Retrieve a chunk of entropy bytes, reconnect to the device once if needed
+ *
+ * @param[in] worker the worker of the device
+ * @param[out] chunk location for c_prefetch_chunk_bytes bytes
+ *
+ * @return true when successful
+ */
+bool EntropyServer::prefetch_entropy(DeviceWorker *worker, unsigned char *chunk) {
+	if (worker->rng->get_entropy(chunk, c_prefetch_chunk_bytes)) {
+		return true;
+	}
+	log_device_error(worker);
+	if (reconnect_device(worker) && worker->rng->get_entropy(chunk, c_prefetch_chunk_bytes)) {
+		return true;
+	}
+	log_device_error(worker);
+	return false;
+}
+
+/**
+ * Populate the request data by the device, reconnect to the device once if needed
+ *
+ * @param[in] worker the worker of the device
+ * @param[in] request device request
+ *
+ * @return true when successful
+ */
+bool EntropyServer::execute_device_request(DeviceWorker *worker, Request *request) {
+	bool status = fill_reply(worker, request);
+	if (!status && reconnect_device(worker)) {
+		status = fill_reply(worker, request);
+	}
+	if (!status) {
+		log_device_error(worker);
+	}
+	return status;
+}
+
+/**
+ * @param[in] worker the worker of the device
+ * @param[in] request device request
+ *
+ * @return true when successful
+ */
+bool EntropyServer::fill_reply(DeviceWorker *worker, Request *request) {
+	AlphaRngApi *rng = worker->rng;
+	unsigned char *out = request->data.data();
+	const int size = (int)request->size;
+	string str;
+	switch (request->cmd) {
+	case c_cmd_entropy_sha256_extract_id:
+		return rng->extract_sha256_entropy(out, size);
+	case c_cmd_entropy_sha512_extract_id:
+		return rng->extract_sha512_entropy(out, size);
+	case c_cmd_noise_id:
+		return rng->get_noise(out, size);
+	case c_cmd_noise_src_one_id:
+		return rng->get_noise_source_1(out, size);
+	case c_cmd_noise_src_two_id:
+		return rng->get_noise_source_2(out, size);
+	case c_cmd_dev_ser_num_id:
+		if (!rng->retrieve_device_id(str) || str.size() != (size_t)size) {
+			return false;
+		}
+		memcpy(out, str.c_str(), size);
+		return true;
+	case c_cmd_dev_model_id:
+		if (!rng->retrieve_device_model(str) || str.size() != (size_t)size) {
+			return false;
+		}
+		memcpy(out, str.c_str(), size);
+		return true;
+	case c_cmd_dev_minor_version_id:
+		return size == 1 && rng->retrieve_device_minor_version(out);
+	case c_cmd_dev_major_version_id:
+		return size == 1 && rng->retrieve_device_major_version(out);
+	default:
+		return false;
+	}
+}
+
+/**
+ * @param[in] worker the worker of the device
+ *
+ * @return true if the device connection was established again
+ */
+bool EntropyServer::reconnect_device(DeviceWorker *worker) {
+	worker->rng->disconnect();
+	return worker->rng->connect(worker->device_number);
+}
+
+/**
+ * Connect to the device, retry until connected or the server stops
+ *
+ * @param[in] worker the worker of the device
+ *
+ * @return true when connected
+ */
+bool EntropyServer::connect_device(DeviceWorker *worker) {
+	while (!worker->rng->connect(worker->device_number)) {
+		log_device_error(worker);
+		unique_lock<mutex> lock(m_mtx);
+		if (m_cv_device.wait_for(lock, chrono::milliseconds(c_device_retry_mlsecs), [this] {return m_is_stopping;})) {
+			return false;
+		}
+	}
+	cout << "Connected to " << get_device_description(worker) << endl;
+	return true;
+}
+
+/**
+ * Retrieve the health status of the device once per c_device_status_interval_secs
+ *
+ * @param[in] worker the worker of the device
+ * @param[in] is_forced true to retrieve the status now
+ *
+ * @return false if the status could not be retrieved or reports a health test failure
+ */
+bool EntropyServer::check_device_health(DeviceWorker *worker, bool is_forced) {
+	if (!is_forced && chrono::steady_clock::now() < worker->next_status_time) {
+		return true;
+	}
+	unsigned char status;
+	if (!worker->rng->retrieve_rng_status(&status)) {
+		return false;
+	}
+	worker->next_status_time = chrono::steady_clock::now() + chrono::seconds(c_device_status_interval_secs);
+	if (worker == m_workers.front().get()) {
+		m_metrics.set_rng_status(status);
+	}
+	if (status != 0) {
+		log_error("Device " + to_string(worker->device_number) + " reported health status " + to_string((int)status));
+	}
+	return status == 0;
+}
+
+/**
+ * @param[in] worker the worker of the device
+ *
+ * @return model, serial number and version of the connected device
+ */
+string EntropyServer::get_device_description(DeviceWorker *worker) {
+	string id;
+	string model;
+	unsigned char major_version = 0;
+	unsigned char minor_version = 0;
+	worker->rng->retrieve_device_id(id);
+	worker->rng->retrieve_device_model(model);
+	worker->rng->retrieve_device_major_version(&major_version);
+	worker->rng->retrieve_device_minor_version(&minor_version);
+
+	ostringstream oss;
+	oss << "device '" << model << "' with S/N: " << id << " and Ver: " << (int)major_version << "." << (int)minor_version;
+	return oss.str();
+}
+
+/**
+ * Consume the seed file and fill the cache with bytes generated from the seed
+ *
+ * @return true when the cache was filled
+ */
+bool EntropyServer::seed_cache() {
+	SeedFile seed_file(m_cmd->seed_file_name);
+	const size_t size = min((size_t)c_seeded_cache_bytes, m_prefetch_buffer.size());
+	if (!seed_file.consume(m_prefetch_buffer.data(), size)) {
+		cerr << seed_file.get_last_error();
+		return false;
+	}
+	m_prefetch_level = size;
+	m_seed_level = size;
+	cout << "Entropy cache seeded with " << size << " bytes from " << m_cmd->seed_file_name << endl;
+	return true;
+}
+
+/**
+ * Replace the seed file with device entropy that is not served to clients
+ *
+ * @param[in] worker the worker of the device, called by its thread or after the thread stopped
+ */
+void EntropyServer::save_seed_file(DeviceWorker *worker) {
+	unsigned char seed[SeedFile::c_seed_size_bytes];
+	if (!worker->rng->get_entropy(seed, sizeof(seed))) {
+		cerr << "Could not save the seed file, device latest error message : " << worker->rng->get_last_error() << endl;
+		return;
+	}
+	SeedFile seed_file(m_cmd->seed_file_name);
+	if (!seed_file.save(seed)) {
+		cerr << seed_file.get_last_error();
+	}
+	OPENSSL_cleanse(seed, sizeof(seed));
+}
+
+/**
+ * Log the latest device error message
+ *
+ * @param[in] worker the worker of the device
+ */
+void EntropyServer::log_device_error(DeviceWorker *worker) {
+	log_error("Device " + to_string(worker->device_number) + " latest error message : " + worker->rng->get_last_error());
+}
+
+/**
+ * Log how much each device contributed to the cache and how often it was taken out of rotation
+ */
+void EntropyServer::log_device_statistics() const {
+	if (m_workers.size() < 2) {
+		return;
+	}
+	lock_guard<mutex> lock(m_mtx);
+	for (auto const &worker : m_workers) {
+		cout << "Device " << worker->device_number << ": " << worker->chunk_count << " chunk(s) of " << c_prefetch_chunk_bytes
+				<< " bytes, " << (int64_t)worker->latency_usecs << " us per chunk, " << worker->rotation_exit_count
+				<< " time(s) taken out of rotation" << (worker->is_in_rotation ? "" : ", out of rotation") << endl;
+	}
+}
+
+/**
+ * Log an error message with a time stamp when error logging is enabled
+ *
+ * @param[in] error error message
+ */
+void EntropyServer::log_error(const string &error) {
+	if (m_cmd->err_log_enabled) {
+		time_t time_now = time(nullptr);
+		char str[32] {};
+		ctime_r(&time_now, str);
+		string s(str);
+		s.erase(remove(s.begin(), s.end(), '\n'), s.end());
+		cerr << s << ": " << error << endl;
+	}
+}
+
+/**
+ * Ring thread: move prefetched entropy bytes into the shared memory ring while it has room.
+ * Bytes for the largest socket client request are always left in the prefetch buffer.
+ */
+void EntropyServer::run_ring() {
+	vector<unsigned char> chunk(c_prefetch_chunk_bytes);
+	while (true) {
+		bool is_space = m_ring.wait_for_space(chunk.size(), c_device_retry_mlsecs);
+		{
+			unique_lock<mutex> lock(m_mtx);
+			if (!is_space) {
+				if (m_is_stopping) {
+					return;
+				}
+				continue;
+			}
+			m_cv_ring.wait(lock, [this] {
+				return m_is_stopping || m_prefetch_level >= c_prefetch_chunk_bytes + c_write_buff_size_bytes;
+			});
+			if (m_is_stopping) {
+				return;
+			}
+			take_prefetched(chunk.data(), chunk.size());
+		}
+		m_cv_device.notify_all();
+		if (!m_ring.publish(chunk.data(), chunk.size())) {
+			log_error(m_ring.get_last_error());
+		}
+	}
+}
+
+/**
+ * Stop the device workers and the ring thread, then save the seed file with the first device in rotation
+ */
+void EntropyServer::stop_device() {
+	{
+		lock_guard<mutex> lock(m_mtx);
+		m_is_stopping = true;
+	}
+	m_cv_device.notify_all();
+	m_cv_ring.notify_all();
+	bool is_running = false;
+	for (auto &worker : m_workers) {
+		if (worker->thread.joinable()) {
+			worker->thread.join();
+			is_running = true;
+		}
+	}
+	if (m_ring_thread.joinable()) {
+		m_ring_thread.join();
+	}
+	if (!is_running || m_cmd->seed_file_name.empty()) {
+		return;
+	}
+	for (auto &worker : m_workers) {
+		if (worker->is_in_rotation) {
+			save_seed_file(worker.get());
+			break;
+		}
+	}
+}
+
+/**
+ * Open /dev/cuse and watch it for requests. The device is registered when the kernel sends CUSE_INIT.
+ *
+ * @return true when successful
+ */
+bool EntropyServer::create_cuse_device() {
+	m_cuse.reset(new CuseDevice(m_cmd->cuse_device_name));
+	if (!m_cuse->open(this)) {
+		cerr << m_cuse->get_last_error();
+		return false;
+	}
+
+	epoll_event ev {};
+	ev.events = EPOLLIN;
+	ev.data.ptr = m_cuse.get();
+	if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_cuse->get_fd(), &ev) < 0) {
+		cerr << "Could not watch /dev/cuse, error code: " << errno << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Create a scheduler client for a new open file of the CUSE device
+ *
+ * @param[in] pid process opening the device
+ *
+ * @return file handle of the client or -EMFILE when too many clients are connected
+ */
+int64_t EntropyServer::open_file(pid_t pid) {
+	if ((int)(m_clients.size() + m_cuse_clients.size()) >= m_cmd->pipe_instances) {
+		log_error("Too many clients, device open refused.");
+		return -EMFILE;
+	}
+	Client *client = new Client();
+	client->fd = -1;
+	client->is_cuse = true;
+	client->cuse_handle = m_next_cuse_handle++;
+	client->priority = c_default_priority;
+	client->pid = pid;
+	if (m_cmd->rate_kbsec > 0) {
+		const int64_t rate = m_cmd->rate_kbsec * 1024;
+		client->quota.configure(rate, max(rate, (int64_t)c_write_buff_size_bytes));
+	}
+	m_cuse_clients[client->cuse_handle] = client;
+	return (int64_t)client->cuse_handle;
+}
+
+/**
+ * Queue a read of the CUSE device as an entropy request of its open file
+ *
+ * @param[in] handle file handle returned by open_file()
+ * @param[in] unique unique id of the read
+ * @param[in] size amount of bytes to read
+ *
+ * @return false when the file is not open
+ */
+bool EntropyServer::read_file(uint64_t handle, uint64_t unique, uint32_t size) {
+	Client *client = find_cuse_client(handle);
+	if (client == nullptr) {
+		return false;
+	}
+	queue_entropy_request(client, unique, size);
+	resume_client(client);
+	return true;
+}
+
+/**
+ * @param[in] handle file handle returned by open_file()
+ */
+void EntropyServer::release_file(uint64_t handle) {
+	Client *client = find_cuse_client(handle);
+	if (client != nullptr) {
+		close_client(client);
+	}
+}
+
+/**
+ * @param[in] handle file handle returned for FUSE_OPEN
+ *
+ * @return open file of the CUSE device or nullptr
+ */
+EntropyServer::Client *EntropyServer::find_cuse_client(uint64_t handle) const {
+	auto it = m_cuse_clients.find(handle);
+	return it == m_cuse_clients.end() || it->second->is_closed ? nullptr : it->second;
+}
+
+/**
+ * Fail a read that still waits for entropy bytes after the reader was interrupted by a signal.
+ * A read that was already replied needs nothing more.
+ *
+ * @param[in] unique unique id of the interrupted request
+ */
+void EntropyServer::interrupt_read(uint64_t unique) {
+	for (auto const &entry : m_cuse_clients) {
+		Client *client = entry.second;
+		auto it = find_if(client->entropy_requests.begin(), client->entropy_requests.end(),
+				[unique](const Request *request) {return request->id == unique;});
+		if (it == client->entropy_requests.end()) {
+			continue;
+		}
+		Request *request = *it;
+		client->entropy_requests.erase(it);
+		m_waiting_requests--;
+		if (client->entropy_requests.empty()) {
+			deactivate_client(client);
+		}
+		if (!m_cuse->reply(unique, -EINTR, nullptr, 0)) {
+			log_error(m_cuse->get_last_error());
+		}
+		finish_request(request);
+		return;
+	}
+}
+
+/**
+ * @param[in] error error reported by the CUSE device
+ */
+void EntropyServer::report_error(const string &error) {
+	log_error(error);
+}
+
+/**
+ * Write the ready replies of an open file of the CUSE device
+ *
+ * @param[in] client open file of the CUSE device
+ *
+ * @return true, a failed reply does not affect the open file
+ */
+bool EntropyServer::write_cuse_output(Client *client) {
+	if (!m_cuse->write_replies(client->output.data() + client->output_bytes_written,
+			client->output.size() - client->output_bytes_written)) {
+		log_error(m_cuse->get_last_error());
+	}
+	client->output.clear();
+	client->output_bytes_written = 0;
+	return true;
+}
+
+/**
+ * Load the pre-shared key and create the TCP socket for remote clients
+ *
+ * @return true when successful
+ */
+bool EntropyServer::create_tcp_socket() {
+	string error;
+	if (!PskChannel::read_psk_file(m_cmd->psk_file_name, m_psk, &error)) {
+		cerr << error << endl;
+		return false;
+	}
+	sockaddr_in addr {};
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons((uint16_t)m_cmd->tcp_port);
+	if (inet_pton(AF_INET, m_cmd->tcp_address.c_str(), &addr.sin_addr) != 1) {
+		cerr << "Invalid TCP address: " << m_cmd->tcp_address << endl;
+		return false;
+	}
+	m_tcp_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (m_tcp_fd < 0) {
+		cerr << "Could not create TCP socket, error code: " << errno << endl;
+		return false;
+	}
+	int reuse = 1;
+	setsockopt(m_tcp_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+	if (::bind(m_tcp_fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(m_tcp_fd, c_listen_backlog) < 0) {
+		cerr << "Could not listen on " << m_cmd->tcp_address << ":" << m_cmd->tcp_port << ", error code: " << errno << endl;
+		return false;
+	}
+
+	epoll_event ev {};
+	ev.events = EPOLLIN;
+	ev.data.ptr = &m_tcp_fd;
+	if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_tcp_fd, &ev) < 0) {
+		cerr << "Could not watch the TCP socket, error code: " << errno << endl;
+		return false;
+	}
+
+	// Every connection uses a descriptor, allow as many as the hard limit
+	rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+	return true;
+}
+
+/**
+ * Create the metrics endpoint on the loopback interface and watch it with the event loop
+ *
+ * @return true when successful
+ */
+bool EntropyServer::create_metrics_endpoint() {
+	m_metrics_endpoint.reset(new MetricsEndpoint(m_metrics));
+	if (!m_metrics_endpoint->open(m_cmd->metrics_port, this)) {
+		cerr << m_metrics_endpoint->get_last_error();
+		return false;
+	}
+
+	epoll_event ev {};
+	ev.events = EPOLLIN;
+	ev.data.ptr = m_metrics_endpoint.get();
+	if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_metrics_endpoint->get_fd(), &ev) < 0) {
+		cerr << "Could not watch the metrics endpoint, error code: " << errno << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Collect the cache levels and the device and per-client statistics for a metrics scrape.
+ * Called by the event loop.
+ *
+ * @param[out] state server state
+ */
+void EntropyServer::get_server_state(ServerState *state) const {
+	static const char * const priority_names[c_priority_classes] = {"high", "normal", "bulk"};
+	{
+		lock_guard<mutex> lock(m_mtx);
+		state->cache_level_bytes = m_prefetch_level;
+		state->seed_level_bytes = m_seed_level;
+		state->seed_bytes_served = m_seed_bytes_served;
+		state->refill_count = m_refill_count;
+		for (auto const &worker : m_workers) {
+			state->devices.push_back({worker->device_number, worker->is_in_rotation, worker->chunk_count,
+					worker->latency_usecs, worker->requests.size(), worker->rotation_exit_count});
+		}
+	}
+	state->cache_low_watermark_bytes = m_cache_low_bytes;
+	state->cache_high_watermark_bytes = m_prefetch_buffer.size();
+	state->cache_hit_count = m_cache_hit_count;
+	state->cache_miss_count = m_cache_miss_count;
+	state->direct_send_bytes = m_direct_send_bytes;
+	state->waiting_requests = m_waiting_requests;
+	state->has_ring = m_ring.is_attached();
+	if (state->has_ring) {
+		const RingStatistics ring = m_ring.get_statistics();
+		state->ring_level_bytes = ring.level_bytes;
+		state->ring_claimed_bytes = ring.bytes_claimed;
+		state->ring_reader_count = ring.reader_count;
+	}
+
+	vector<const Client*> clients;
+	for (auto const &entry : m_clients) {
+		clients.push_back(entry.second);
+	}
+	for (auto const &entry : m_cuse_clients) {
+		clients.push_back(entry.second);
+	}
+	for (const Client *client : clients) {
+		ClientState client_state;
+		client_state.id = client->is_cuse ? "cuse-" + to_string(client->cuse_handle) : to_string(client->fd);
+		client_state.pid = client->pid;
+		client_state.priority = priority_names[client->priority];
+		client_state.transport = client->is_cuse ? "cuse" : (client->channel ? "tcp" : "unix");
+		client_state.byte_count = client->stats.byte_count;
+		client_state.latency_p50_usecs = client->stats.latency.get_percentile(50);
+		client_state.latency_p99_usecs = client->stats.latency.get_percentile(99);
+		client_state.latency_count = client->stats.latency.get_count();
+		state->clients.push_back(client_state);
+	}
+}
+
+/**
+ * Count device failures after each device read, the device API counters are published for the first device.
+ * Called by the worker, which owns the device connection.
+ *
+ * @param[in] worker the worker of the device
+ * @param[in] is_device_ok false if the device read failed
+ */
+void EntropyServer::update_device_metrics(DeviceWorker *worker, bool is_device_ok) {
+	if (!is_device_ok) {
+		m_metrics.add_device_failure();
+	}
+	if (worker == m_workers.front().get()) {
+		m_metrics.set_device_counters(worker->rng->get_stream_counters(), is_device_ok);
+	}
+}
+
+/**
+ * @param[in] cmd command id
+ * @param[out] e_type type of the bytes the command retrieves
+ *
+ * @return true if the command retrieves a stream of bytes
+ */
+bool EntropyServer::get_stream_type(uint32_t cmd, StreamType *e_type) {
+	switch (cmd) {
+	case c_cmd_entropy_retrieve_id:
+		*e_type = StreamType::entropy;
+		return true;
+	case c_cmd_entropy_sha256_extract_id:
+		*e_type = StreamType::sha256;
+		return true;
+	case c_cmd_entropy_sha512_extract_id:
+		*e_type = StreamType::sha512;
+		return true;
+	case c_cmd_noise_id:
+		*e_type = StreamType::noise;
+		return true;
+	case c_cmd_noise_src_one_id:
+		*e_type = StreamType::noise_source_1;
+		return true;
+	case c_cmd_noise_src_two_id:
+		*e_type = StreamType::noise_source_2;
+		return true;
+	case c_cmd_diag_id:
+		*e_type = StreamType::test;
+		return true;
+	default:
+		return false;
+	}
+}
+
+EntropyServer::~EntropyServer() {
+	stop_device();
+	for (auto &worker : m_workers) {
+		for (Request *request : worker->requests) {
+			delete request;
+		}
+	}
+	for (Request *request : m_completed_requests) {
+		delete request;
+	}
+	for (auto &entry : m_clients) {
+		close(entry.first);
+		for (Request *request : entry.second->entropy_requests) {
+			delete request;
+		}
+		delete entry.second;
+	}
+	for (auto &entry : m_cuse_clients) {
+		for (Request *request : entry.second->entropy_requests) {
+			delete request;
+		}
+		delete entry.second;
+	}
+	for (Client *client : m_released_clients) {
+		delete client;
+	}
+	if (m_tcp_fd >= 0) {
+		close(m_tcp_fd);
+	}
+	OPENSSL_cleanse(m_psk, sizeof(m_psk));
+	if (m_listen_fd >= 0) {
+		close(m_listen_fd);
+		unlink(m_socket_path.c_str());
+	}
+	if (m_signal_fd >= 0) {
+		close(m_signal_fd);
+	}
+	if (m_event_fd >= 0) {
+		close(m_event_fd);
+	}
+	if (m_epoll_fd >= 0) {
+		close(m_epoll_fd);
+	}
+}
+
+} /* namespace alpharng */
@@ -0,0 +1,447 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for interacting with the entropy server using a Unix domain socket on Linux.
+
+ */
+
+/**
+ *    @file EntropyServerClient.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.2
+ *
+ *    @brief A Unix domain socket client for downloading true random bytes from the entropy server.
+ */
+
+#include <EntropyServerClient.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <openssl/crypto.h>
+
+using namespace std;
+
+namespace alpharng {
+
+const char * const EntropyServerClient::c_default_socket_path = "/run/alpharng.sock";
+
+/**
+ * Constructor, the connection is established by connect() or by the first request
+ *
+ * @param[in] socket_path Unix domain socket of the entropy server
+ * @param[in] read_ahead_bytes size of the read-ahead buffer, up to c_max_request_bytes, 0 to disable it
+ */
+EntropyServerClient::EntropyServerClient(const string &socket_path, size_t read_ahead_bytes) :
+		m_socket_path(socket_path), m_buffer(min(read_ahead_bytes, (size_t)c_max_request_bytes)) {
+}
+
+/**
+ * Trust an entropy server running as another user than root and the user of the client.
+ * Takes effect with the next connection.
+ *
+ * @param[in] server_uid user of the entropy server
+ */
+void EntropyServerClient::set_server_uid(uid_t server_uid) {
+	lock_guard<mutex> lock(m_mtx);
+	m_server_uid = server_uid;
+}
+
+/**
+ * Connect to the entropy server
+ *
+ * @return true if successful
+ */
+bool EntropyServerClient::connect() {
+	lock_guard<mutex> lock(m_mtx);
+	clear_error_log();
+	return m_fd >= 0 || open_connection();
+}
+
+/**
+ * Close the connection, the bytes in the read-ahead buffer are kept
+ */
+void EntropyServerClient::disconnect() {
+	lock_guard<mutex> lock(m_mtx);
+	close_connection();
+}
+
+bool EntropyServerClient::is_connected() {
+	lock_guard<mutex> lock(m_mtx);
+	return m_fd >= 0;
+}
+
+string EntropyServerClient::get_last_error() {
+	lock_guard<mutex> lock(m_mtx);
+	return m_error_log_oss.str();
+}
+
+/**
+ * Retrieve entropy bytes, served from the read-ahead buffer when possible
+ *
+ * @param[out] out location for the entropy bytes
+ * @param[in] size amount of bytes to retrieve
+ *
+ * @return true if successful
+ */
+bool EntropyServerClient::get_entropy(unsigned char *out, size_t size) {
+	lock_guard<mutex> lock(m_mtx);
+	clear_error_log();
+	size_t filled = 0;
+	if (fill_entropy(out, size, &filled)) {
+		return true;
+	}
+	// Reconnect once if the connection was lost, the bytes already filled are kept
+	return m_fd < 0 && open_connection() && fill_entropy(out, size, &filled);
+}
+
+bool EntropyServerClient::extract_sha256_entropy(unsigned char *out, size_t size) {
+	return get_bytes(EntropyServerCommand::extractSha256Entropy, out, size);
+}
+
+bool EntropyServerClient::extract_sha512_entropy(unsigned char *out, size_t size) {
+	return get_bytes(EntropyServerCommand::extractSha512Entropy, out, size);
+}
+
+bool EntropyServerClient::get_noise_source_1(unsigned char *out, size_t size) {
+	return get_bytes(EntropyServerCommand::getNoiseSourceOne, out, size);
+}
+
+bool EntropyServerClient::get_noise_source_2(unsigned char *out, size_t size) {
+	return get_bytes(EntropyServerCommand::getNoiseSourceTwo, out, size);
+}
+
+bool EntropyServerClient::get_noise(unsigned char *out, size_t size) {
+	return get_bytes(EntropyServerCommand::getNoise, out, size);
+}
+
+/**
+ * Retrieve test bytes, each byte is the incremented value of the previous byte starting with 0.
+ * Only used for testing the correctness of the data communication with the entropy server.
+ */
+bool EntropyServerClient::get_test_data(unsigned char *out, size_t size) {
+	return get_bytes(EntropyServerCommand::getTestData, out, size);
+}
+
+bool EntropyServerClient::get_device_serial_number(string &device_serial_number) {
+	unsigned char buff[15];
+	if (!get_bytes(EntropyServerCommand::getDeviceSerialNumber, buff, sizeof(buff))) {
+		return false;
+	}
+	device_serial_number.assign((const char*)buff, sizeof(buff));
+	return true;
+}
+
+bool EntropyServerClient::get_device_model(string &device_model) {
+	unsigned char buff[15];
+	if (!get_bytes(EntropyServerCommand::getDeviceModel, buff, sizeof(buff))) {
+		return false;
+	}
+	device_model.assign((const char*)buff, sizeof(buff));
+	return true;
+}
+
+bool EntropyServerClient::get_device_minor_version(int &device_minor_version) {
+	unsigned char value;
+	if (!get_bytes(EntropyServerCommand::getDeviceMinorVersion, &value, 1)) {
+		return false;
+	}
+	device_minor_version = value;
+	return true;
+}
+
+bool EntropyServerClient::get_device_major_version(int &device_major_version) {
+	unsigned char value;
+	if (!get_bytes(EntropyServerCommand::getDeviceMajorVersion, &value, 1)) {
+		return false;
+	}
+	device_major_version = value;
+	return true;
+}
+
+bool EntropyServerClient::get_server_minor_version(int &server_minor_version) {
+	unsigned char value;
+	if (!get_bytes(EntropyServerCommand::getServerMinorVersion, &value, 1)) {
+		return false;
+	}
+	server_minor_version = value;
+	return true;
+}
+
+bool EntropyServerClient::get_server_major_version(int &server_major_version) {
+	unsigned char value;
+	if (!get_bytes(EntropyServerCommand::getServerMajorVersion, &value, 1)) {
+		return false;
+	}
+	server_major_version = value;
+	return true;
+}
+
+/**
+ * Connect, check the user of the server and switch the connection to protocol version 2
+ *
+ * @return true if successful
+ */
+bool EntropyServerClient::open_connection() {
+	sockaddr_un addr {};
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, m_socket_path.c_str(), sizeof(addr.sun_path) - 1);
+	m_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (m_fd < 0 || ::connect(m_fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+		m_error_log_oss << "Could not connect to the entropy server " << m_socket_path << ", error code: " << errno << ". " << endl;
+		close_connection();
+		return false;
+	}
+	ucred peer {};
+	socklen_t peer_size = sizeof(peer);
+	if (getsockopt(m_fd, SOL_SOCKET, SO_PEERCRED, &peer, &peer_size) < 0) {
+		m_error_log_oss << "Could not retrieve the user of the entropy server " << m_socket_path << ", error code: " << errno << ". " << endl;
+		close_connection();
+		return false;
+	}
+	if (peer.uid != 0 && peer.uid != geteuid() && peer.uid != m_server_uid) {
+		m_error_log_oss << "The entropy server " << m_socket_path << " runs as untrusted user " << peer.uid << ". " << endl;
+		close_connection();
+		return false;
+	}
+	READCMD request {(uint32_t)EntropyServerCommand::getProtocolVersion, 1};
+	unsigned char protocol_version = 0;
+	if (!send_bytes(&request, sizeof(request)) || !receive_bytes(&protocol_version, sizeof(protocol_version))) {
+		return false;
+	}
+	if (protocol_version != c_protocol_version) {
+		m_error_log_oss << "The entropy server does not support protocol version " << c_protocol_version << ". " << endl;
+		close_connection();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Close the connection, a read-ahead request in flight is abandoned
+ */
+void EntropyServerClient::close_connection() {
+	if (m_fd >= 0) {
+		close(m_fd);
+		m_fd = -1;
+	}
+	m_is_read_ahead_pending = false;
+}
+
+/**
+ * Retrieve bytes that are not buffered, reconnecting once if the connection was lost
+ *
+ * @return true if successful
+ */
+bool EntropyServerClient::get_bytes(EntropyServerCommand cmd, unsigned char *out, size_t size) {
+	lock_guard<mutex> lock(m_mtx);
+	clear_error_log();
+	if (m_fd < 0 && !open_connection()) {
+		return false;
+	}
+	for (size_t offset = 0; offset < size; ) {
+		const uint32_t count = (uint32_t)min(size - offset, (size_t)c_max_request_bytes);
+		if (!request_bytes(cmd, out + offset, count) && (m_fd >= 0 || !open_connection() || !request_bytes(cmd, out + offset, count))) {
+			return false;
+		}
+		offset += count;
+	}
+	return true;
+}
+
+/**
+ * Fill the entropy bytes from the read-ahead buffer and refill it, large remainders are requested directly
+ *
+ * @param[out] out location for the entropy bytes
+ * @param[in] size amount of bytes to retrieve
+ * @param[in,out] filled amount of bytes already filled
+ *
+ * @return false if failed, the connection is closed if it was lost
+ */
+bool EntropyServerClient::fill_entropy(unsigned char *out, size_t size, size_t *filled) {
+	while (*filled < size) {
+		const size_t available = m_buffer_level - m_buffer_offset;
+		if (available > 0) {
+			const size_t count = min(available, size - *filled);
+			memcpy(out + *filled, m_buffer.data() + m_buffer_offset, count);
+			OPENSSL_cleanse(m_buffer.data() + m_buffer_offset, count);
+			m_buffer_offset += count;
+			*filled += count;
+			continue;
+		}
+		if (m_fd < 0 && !open_connection()) {
+			return false;
+		}
+		if (m_is_read_ahead_pending) {
+			// The refill was requested earlier, its reply is usually already received by the socket
+			if (!receive_reply(m_read_ahead_id, nullptr, 0)) {
+				return false;
+			}
+			continue;
+		}
+		const size_t remaining = size - *filled;
+		if (remaining > m_buffer.size() / 2) {
+			const uint32_t count = (uint32_t)min(remaining, (size_t)c_max_request_bytes);
+			if (!request_bytes(EntropyServerCommand::getEntropy, out + *filled, count)) {
+				return false;
+			}
+			*filled += count;
+			continue;
+		}
+		if (!start_read_ahead()) {
+			return false;
+		}
+	}
+	if (!m_is_read_ahead_pending && m_buffer_level - m_buffer_offset <= m_buffer.size() / 2 && !m_buffer.empty()) {
+		return (m_fd >= 0 || open_connection()) && start_read_ahead();
+	}
+	return true;
+}
+
+/**
+ * Send one request and wait for its reply
+ *
+ * @return true if successful
+ */
+bool EntropyServerClient::request_bytes(EntropyServerCommand cmd, unsigned char *out, uint32_t size) {
+	const uint32_t id = m_next_id++;
+	return send_request(id, cmd, size) && receive_reply(id, out, size);
+}
+
+/**
+ * Request enough entropy bytes to fill the read-ahead buffer, the reply is received later
+ *
+ * @return true if successful
+ */
+bool EntropyServerClient::start_read_ahead() {
+	const size_t available = m_buffer_level - m_buffer_offset;
+	memmove(m_buffer.data(), m_buffer.data() + m_buffer_offset, available);
+	// Erase the copies of the moved bytes left behind the new level
+	OPENSSL_cleanse(m_buffer.data() + available, m_buffer_offset);
+	m_buffer_offset = 0;
+	m_buffer_level = available;
+	m_read_ahead_id = m_next_id++;
+	m_read_ahead_size = (uint32_t)(m_buffer.size() - available);
+	if (!send_request(m_read_ahead_id, EntropyServerCommand::getEntropy, m_read_ahead_size)) {
+		return false;
+	}
+	m_is_read_ahead_pending = true;
+	return true;
+}
+
+bool EntropyServerClient::send_request(uint32_t id, EntropyServerCommand cmd, uint32_t size) {
+	READCMD2 request {id, (uint32_t)cmd, size};
+	return send_bytes(&request, sizeof(request));
+}
+
+/**
+ * Receive replies until the reply of a request arrives. Replies may come out of order, a read-ahead
+ * reply received meanwhile is stored in the read-ahead buffer.
+ *
+ * @param[in] id request id
+ * @param[out] out location for the reply bytes, not used for the read-ahead request
+ * @param[in] size expected amount of reply bytes
+ *
+ * @return true if successful
+ */
+bool EntropyServerClient::receive_reply(uint32_t id, unsigned char *out, uint32_t size) {
+	while (true) {
+		REPLY2 reply;
+		if (!receive_bytes(&reply, sizeof(reply))) {
+			return false;
+		}
+		const bool is_read_ahead = m_is_read_ahead_pending && reply.id == m_read_ahead_id;
+		if (!is_read_ahead && reply.id != id) {
+			m_error_log_oss << "Unexpected reply " << reply.id << " received from the entropy server. " << endl;
+			close_connection();
+			return false;
+		}
+		const uint32_t expected_size = reply.status == c_status_ok ? (is_read_ahead ? m_read_ahead_size : size) : 0;
+		if (reply.cbData != expected_size) {
+			m_error_log_oss << "Expected to receive " << expected_size << " bytes, the entropy server replied with "
+					<< reply.cbData << " bytes. " << endl;
+			close_connection();
+			return false;
+		}
+		if (is_read_ahead) {
+			m_is_read_ahead_pending = false;
+			if (!receive_bytes(m_buffer.data() + m_buffer_level, reply.cbData)) {
+				return false;
+			}
+			m_buffer_level += reply.cbData;
+		} else if (!receive_bytes(out, reply.cbData)) {
+			return false;
+		}
+		// A failed read-ahead received while waiting for another reply is requested again later
+		if (reply.status != c_status_ok && reply.id == id) {
+			m_error_log_oss << "The entropy server could not serve the request, status: " << reply.status << ". " << endl;
+			return false;
+		}
+		if (reply.id == id) {
+			return true;
+		}
+	}
+}
+
+/**
+ * @return false if the connection was lost, it is closed
+ */
+bool EntropyServerClient::send_bytes(const void *in, size_t size) {
+	const unsigned char *p = (const unsigned char*)in;
+	while (size > 0) {
+		ssize_t n = send(m_fd, p, size, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			m_error_log_oss << "Could not send a request to the entropy server, error code: " << errno << ". " << endl;
+			close_connection();
+			return false;
+		}
+		p += n;
+		size -= n;
+	}
+	return true;
+}
+
+/**
+ * @return false if the connection was lost, it is closed
+ */
+bool EntropyServerClient::receive_bytes(void *out, size_t size) {
+	unsigned char *p = (unsigned char*)out;
+	while (size > 0) {
+		ssize_t n = recv(m_fd, p, size, MSG_WAITALL);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			m_error_log_oss << "Could not receive a reply from the entropy server, error code: " << (n == 0 ? 0 : errno) << ". " << endl;
+			close_connection();
+			return false;
+		}
+		p += n;
+		size -= n;
+	}
+	return true;
+}
+
+void EntropyServerClient::clear_error_log() {
+	m_error_log_oss.str("");
+	m_error_log_oss.clear();
+}
+
+EntropyServerClient::~EntropyServerClient() {
+	close_connection();
+	OPENSSL_cleanse(m_buffer.data(), m_buffer.size());
+}
+
+} /* namespace alpharng */
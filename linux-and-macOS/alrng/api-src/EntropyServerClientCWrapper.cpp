@@ -0,0 +1,220 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a C wrapper around the C++ client of the entropy server running on Linux.
+
+ Most of C wrapper functions will return:
+	0 when invoked successfully;
+	-1 for invalid parameters;
+	-2 for other errors (invoke alrng_server_get_last_error() to retrieve the error message)
+ */
+
+/**
+ *    @file EntropyServerClientCWrapper.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.1
+ *
+ *    @brief Implements a C API wrapper around the C++ client of the entropy server.
+ */
+#include <EntropyServerClient.h>
+#include <EntropyServerClientCWrapper.h>
+#include <cstring>
+
+using namespace alpharng;
+
+extern "C" {
+
+/**
+ * Create a context for referencing an EntropyServerClient class instance.
+ *
+ * @param[in] socket_path Unix domain socket of the entropy server, nullptr for the default path
+ * @param[in] read_ahead_bytes size of the read-ahead buffer, 0 to disable it
+ *
+ * @return pointer to the new context or nullptr if failed
+ */
+alrng_server_context* alrng_server_create_ctxt(const char *socket_path, int read_ahead_bytes) {
+	if (read_ahead_bytes < 0) {
+		return nullptr;
+	}
+	std::string path = nullptr == socket_path ? EntropyServerClient::c_default_socket_path : socket_path;
+	return (alrng_server_context*) new (std::nothrow) EntropyServerClient(path, (size_t)read_ahead_bytes);
+}
+
+/**
+ * Connect to the entropy server
+ *
+ * @param[in] ctxt pointer to context structure, must not be nullptr
+ *
+ * @return 0 if connection was successful
+ */
+int alrng_server_connect(alrng_server_context* ctxt) {
+	if (nullptr == ctxt) {
+		return -1;
+	}
+	auto client = (EntropyServerClient*) ctxt;
+	return client->connect() ? 0 : -2;
+}
+
+/**
+ * Also trust an entropy server running as another user
+ *
+ * @param[in] ctxt pointer to context structure, must not be nullptr
+ * @param[in] server_uid user id of the entropy server
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_set_server_uid(alrng_server_context* ctxt, uint32_t server_uid) {
+	if (nullptr == ctxt) {
+		return -1;
+	}
+	auto client = (EntropyServerClient*) ctxt;
+	client->set_server_uid((uid_t)server_uid);
+	return 0;
+}
+
+/**
+ * Disconnect from the entropy server
+ *
+ * @param[in] ctxt pointer to context structure, must not be nullptr
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_disconnect(alrng_server_context* ctxt) {
+	if (nullptr == ctxt) {
+		return -1;
+	}
+	auto client = (EntropyServerClient*) ctxt;
+	client->disconnect();
+	return 0;
+}
+
+/**
+ * Close any active connection and destroy the context.
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_destroy_ctxt(alrng_server_context* ctxt) {
+	if (nullptr == ctxt) {
+		return -1;
+	}
+	delete (EntropyServerClient*) ctxt;
+	return 0;
+}
+
+/**
+ * Retrieve the message associated with the last error.
+ *
+ * @param[in] ctxt pointer to context structure, must not be nullptr
+ * @param[out] msg_buffer points to a location for storing a zero terminated error message
+ * @param[in] msg_buffer_size the memory allocated to msg_buffer in bytes
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_get_last_error(alrng_server_context* ctxt, char *msg_buffer, int msg_buffer_size) {
+	if (nullptr == ctxt || nullptr == msg_buffer || msg_buffer_size <= 2) {
+		return -1;
+	}
+	auto client = (EntropyServerClient*) ctxt;
+	std::string msg = client->get_last_error();
+	int size = (int)msg.size();
+	if (size >= msg_buffer_size) {
+		size = msg_buffer_size -1;
+	}
+	memcpy(msg_buffer, msg.c_str(), size);
+	msg_buffer[size] = '\0';
+	return 0;
+}
+
+/**
+ * Retrieve entropy bytes from the entropy server
+ *
+ * @param[in] ctxt pointer to context structure, must not be nullptr
+ * @param[out] out points to a byte array for storing the random bytes retrieved
+ * @param[in] out_length how many random bytes to retrieve
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_get_entropy(alrng_server_context* ctxt, unsigned char *out, int out_length) {
+	if (nullptr == ctxt || nullptr == out || out_length < 0) {
+		return -1;
+	}
+	auto client = (EntropyServerClient*) ctxt;
+	return client->get_entropy(out, (size_t)out_length) ? 0 : -2;
+}
+
+/**
+ * Retrieve entropy bytes extracted by the entropy server with SHA-256 method
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_extract_sha256_entropy(alrng_server_context* ctxt, unsigned char *out, int out_length) {
+	if (nullptr == ctxt || nullptr == out || out_length < 0) {
+		return -1;
+	}
+	auto client = (EntropyServerClient*) ctxt;
+	return client->extract_sha256_entropy(out, (size_t)out_length) ? 0 : -2;
+}
+
+/**
+ * Retrieve entropy bytes extracted by the entropy server with SHA-512 method
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_extract_sha512_entropy(alrng_server_context* ctxt, unsigned char *out, int out_length) {
+	if (nullptr == ctxt || nullptr == out || out_length < 0) {
+		return -1;
+	}
+	auto client = (EntropyServerClient*) ctxt;
+	return client->extract_sha512_entropy(out, (size_t)out_length) ? 0 : -2;
+}
+
+/**
+ * Retrieve concatenated raw random bytes of both noise sources
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_get_noise(alrng_server_context* ctxt, unsigned char *out, int out_length) {
+	if (nullptr == ctxt || nullptr == out || out_length < 0) {
+		return -1;
+	}
+	auto client = (EntropyServerClient*) ctxt;
+	return client->get_noise(out, (size_t)out_length) ? 0 : -2;
+}
+
+/**
+ * Retrieve test bytes
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_get_test_data(alrng_server_context* ctxt, unsigned char *out, int out_length) {
+	if (nullptr == ctxt || nullptr == out || out_length < 0) {
+		return -1;
+	}
+	auto client = (EntropyServerClient*) ctxt;
+	return client->get_test_data(out, (size_t)out_length) ? 0 : -2;
+}
+
+/**
+ * Retrieve the version of the entropy server
+ *
+ * @param[in] ctxt pointer to context structure, must not be nullptr
+ * @param[out] major_version points to location for major version number
+ * @param[out] minor_version points to location for minor version number
+ *
+ * @return 0 for successful operation
+ */
+int alrng_server_retrieve_version(alrng_server_context* ctxt, int *major_version, int *minor_version) {
+	if (nullptr == ctxt || nullptr == major_version || nullptr == minor_version) {
+		return -1;
+	}
+	auto client = (EntropyServerClient*) ctxt;
+	return client->get_server_major_version(*major_version) && client->get_server_minor_version(*minor_version) ? 0 : -2;
+}
+
+}
@@ -0,0 +1,471 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a stream writer that distributes one stream of bytes downloaded from an AlphaRNG device
+ to multiple output sinks such as files, named pipes (FIFO), standard output or file descriptors.
+
+ */
+
+/**
+ *    @file FanoutStreamWriter.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements a stream writer for distributing device data to multiple output sinks.
+ */
+
+#include <FanoutStreamWriter.h>
+
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <new>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace alpharng {
+
+/**
+ * @param[in] block_size_bytes the largest amount of bytes that can be acquired at once
+ */
+FanoutStreamWriter::FanoutStreamWriter(int block_size_bytes) : c_block_size_bytes(block_size_bytes) {
+}
+
+/**
+ * Add an output sink. Must be called before open().
+ *
+ * A sink specification is a destination optionally followed by a policy: 'destination[,block|,drop|,buffer=MB]'
+ * where destination is a file path name, a named pipe (FIFO) path name, '-' for the standard output
+ * or 'fd:N' for an already open file descriptor N.
+ *
+ * @param[in] sink_spec sink specification
+ *
+ * @return true for successful operation
+ */
+bool FanoutStreamWriter::add_sink(const string &sink_spec) {
+	if (m_is_open) {
+		m_error_log_oss << "Cannot add sink " << sink_spec << " after the writer is open. " << endl;
+		return false;
+	}
+	unique_ptr<Sink> sink(new Sink());
+	if (!parse_sink_spec(sink_spec, *sink)) {
+		return false;
+	}
+	m_sinks.push_back(move(sink));
+	return true;
+}
+
+bool FanoutStreamWriter::parse_sink_spec(const string &sink_spec, Sink &sink) {
+	string destination = sink_spec;
+	sink.e_policy = SinkPolicy::block;
+	size_t pos = sink_spec.find_last_of(',');
+	if (pos != string::npos) {
+		string policy = sink_spec.substr(pos + 1);
+		if (policy == "block") {
+			destination = sink_spec.substr(0, pos);
+		} else if (policy == "drop") {
+			sink.e_policy = SinkPolicy::drop;
+			destination = sink_spec.substr(0, pos);
+		} else if (policy.compare(0, 7, "buffer=") == 0) {
+			char *end = nullptr;
+			errno = 0;
+			long long mbytes = strtoll(policy.c_str() + 7, &end, 10);
+			if (errno != 0 || end == policy.c_str() + 7 || *end != '\0' || mbytes <= 0 || mbytes > 1000000) {
+				m_error_log_oss << "Invalid buffer size in sink specification: " << sink_spec << ". " << endl;
+				return false;
+			}
+			sink.e_policy = SinkPolicy::buffer;
+			sink.max_queued_bytes = mbytes * 1000000LL;
+			destination = sink_spec.substr(0, pos);
+		}
+	}
+
+	if (destination.empty()) {
+		m_error_log_oss << "Missing destination in sink specification: " << sink_spec << ". " << endl;
+		return false;
+	}
+
+	if (sink.e_policy == SinkPolicy::block) {
+		sink.max_queued_bytes = (int64_t)c_block_size_bytes * c_max_blocking_queue_blocks;
+	} else if (sink.e_policy == SinkPolicy::drop) {
+		sink.max_queued_bytes = c_block_size_bytes;
+	}
+
+	sink.name = destination;
+	if (destination == "-") {
+		sink.e_kind = SinkKind::standardOutput;
+		sink.fd = STDOUT_FILENO;
+	} else if (destination.compare(0, 3, "fd:") == 0) {
+		char *end = nullptr;
+		errno = 0;
+		long fd = strtol(destination.c_str() + 3, &end, 10);
+		if (errno != 0 || end == destination.c_str() + 3 || *end != '\0' || fd < 0 || fd > 65535) {
+			m_error_log_oss << "Invalid file descriptor in sink specification: " << sink_spec << ". " << endl;
+			return false;
+		}
+		if (fcntl((int)fd, F_GETFD) == -1) {
+			m_error_log_oss << "File descriptor " << fd << " is not open. " << endl;
+			return false;
+		}
+		sink.e_kind = SinkKind::fileDescriptor;
+		sink.fd = (int)fd;
+	} else {
+		struct stat st;
+		if (stat(destination.c_str(), &st) == 0 && S_ISFIFO(st.st_mode)) {
+			sink.e_kind = SinkKind::fifo;
+		} else {
+			sink.e_kind = SinkKind::file;
+		}
+	}
+	return true;
+}
+
+/**
+ * Open all file sinks and start one writer thread per sink.
+ * Named pipes are opened by their writer threads once a reader is connected.
+ *
+ * @return true for successful operation
+ */
+bool FanoutStreamWriter::open() {
+	if (m_is_open) {
+		return true;
+	}
+	if (m_sinks.empty()) {
+		m_error_log_oss << "No output sinks defined. " << endl;
+		return false;
+	}
+	for (auto &sink : m_sinks) {
+		if (sink->e_kind == SinkKind::file) {
+			sink->fd = ::open(sink->name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+			if (sink->fd == -1) {
+				m_error_log_oss << "Could not open file: " << sink->name << ". " << endl;
+				for (auto &s : m_sinks) {
+					if (s->owns_fd && s->fd != -1) {
+						close(s->fd);
+						s->fd = -1;
+						s->owns_fd = false;
+					}
+				}
+				return false;
+			}
+			sink->owns_fd = true;
+		}
+	}
+	for (auto &sink : m_sinks) {
+		sink->thread = thread(&FanoutStreamWriter::run_sink, this, sink.get());
+	}
+	m_is_open = true;
+	return true;
+}
+
+unsigned char* FanoutStreamWriter::acquire_buffer(int size) {
+	if (!m_is_open) {
+		m_error_log_oss << "Stream writer is not open. " << endl;
+		return nullptr;
+	}
+	if (size > c_block_size_bytes) {
+		m_error_log_oss << "Requested " << size << " bytes exceed the block size: " << c_block_size_bytes << ". " << endl;
+		return nullptr;
+	}
+	if (m_current_block == nullptr) {
+		lock_guard<mutex> lock(m_pool_mtx);
+		if (!m_free_blocks.empty()) {
+			m_current_block = m_free_blocks.back();
+			m_free_blocks.pop_back();
+		}
+	}
+	if (m_current_block == nullptr) {
+		Block *block = new (nothrow) Block();
+		if (block == nullptr) {
+			m_error_log_oss << "Could not allocate memory for a stream block. " << endl;
+			return nullptr;
+		}
+		block->data = new (nothrow) unsigned char[c_block_size_bytes];
+		if (block->data == nullptr) {
+			delete block;
+			m_error_log_oss << "Could not allocate memory for a stream block. " << endl;
+			return nullptr;
+		}
+		lock_guard<mutex> lock(m_pool_mtx);
+		m_all_blocks.push_back(block);
+		m_current_block = block;
+	}
+	return m_current_block->data;
+}
+
+bool FanoutStreamWriter::commit_buffer(int size) {
+	Block *block = m_current_block;
+	if (block == nullptr) {
+		m_error_log_oss << "No stream block acquired. " << endl;
+		return false;
+	}
+	m_current_block = nullptr;
+	block->size = size;
+	// The producer holds one reference while dispatching the block
+	block->ref_count.store(1);
+	for (auto &sink : m_sinks) {
+		dispatch_block(*sink, block);
+	}
+	release_block(block);
+
+	bool is_all_failed = true;
+	for (auto &sink : m_sinks) {
+		if (sink->is_failed.load()) {
+			if (sink->e_policy == SinkPolicy::block) {
+				lock_guard<mutex> lock(sink->mtx);
+				m_error_log_oss << "Sink " << sink->name << " failed: " << sink->error << endl;
+				return false;
+			}
+		} else {
+			is_all_failed = false;
+		}
+	}
+	if (is_all_failed) {
+		m_error_log_oss << "All output sinks failed. " << endl;
+		return false;
+	}
+	return true;
+}
+
+void FanoutStreamWriter::dispatch_block(Sink &sink, Block *block) {
+	unique_lock<mutex> lock(sink.mtx);
+	if (sink.e_policy == SinkPolicy::block) {
+		sink.cv_not_full.wait(lock, [&sink, block] {
+			return sink.is_failed.load() || sink.queued_bytes == 0
+					|| sink.queued_bytes + block->size <= sink.max_queued_bytes;
+		});
+	}
+	if (sink.is_failed.load()
+			|| (sink.queued_bytes > 0 && sink.queued_bytes + block->size > sink.max_queued_bytes)) {
+		// Detached or lagging non blocking sink
+		sink.bytes_dropped += block->size;
+		return;
+	}
+	block->ref_count.fetch_add(1);
+	sink.queue.push_back(block);
+	sink.queued_bytes += block->size;
+	sink.cv_not_empty.notify_one();
+}
+
+void FanoutStreamWriter::release_block(Block *block) {
+	if (block->ref_count.fetch_sub(1) == 1) {
+		lock_guard<mutex> lock(m_pool_mtx);
+		m_free_blocks.push_back(block);
+	}
+}
+
+/**
+ * Writer thread of a sink. Writes queued blocks until the stream is finished and the queue is empty.
+ */
+void FanoutStreamWriter::run_sink(Sink *sink) {
+	if (sink->e_kind == SinkKind::fifo && !open_fifo(*sink)) {
+		return;
+	}
+	while (true) {
+		unique_lock<mutex> lock(sink->mtx);
+		sink->cv_not_empty.wait(lock, [sink] {return !sink->queue.empty() || sink->is_closing;});
+		if (sink->queue.empty()) {
+			break;
+		}
+		Block *block = sink->queue.front();
+		sink->queue.pop_front();
+		lock.unlock();
+
+		bool is_written = write_block(*sink, block);
+		if (is_written) {
+			sink->bytes_written += block->size;
+		} else {
+			sink->bytes_dropped += block->size;
+		}
+		int size = block->size;
+		release_block(block);
+
+		lock.lock();
+		sink->queued_bytes -= size;
+		sink->cv_not_full.notify_one();
+		if (sink->is_failed.load()) {
+			break;
+		}
+	}
+}
+
+bool FanoutStreamWriter::open_fifo(Sink &sink) {
+	// Opening a FIFO without a reader fails with ENXIO in non-blocking mode,
+	// keep retrying so that the stream can be finished while no reader is connected
+	while (true) {
+		sink.fd = ::open(sink.name.c_str(), O_WRONLY | O_NONBLOCK);
+		if (sink.fd != -1) {
+			sink.owns_fd = true;
+			return true;
+		}
+		if (errno != ENXIO && errno != EINTR) {
+			fail_sink(sink, string("Could not open named pipe: ") + sink.name + ", " + strerror(errno) + ". ");
+			return false;
+		}
+		{
+			unique_lock<mutex> lock(sink.mtx);
+			if (sink.is_closing) {
+				// Nobody is listening, nothing to deliver
+				lock.unlock();
+				fail_sink(sink, string("No reader connected to named pipe: ") + sink.name + ". ");
+				return false;
+			}
+			sink.cv_not_empty.wait_for(lock, chrono::milliseconds(c_poll_interval_mlsecs));
+		}
+	}
+}
+
+bool FanoutStreamWriter::write_block(Sink &sink, const Block *block) {
+	const unsigned char *p = block->data;
+	int remaining = block->size;
+	int stalled_mlsecs = 0;
+	while (remaining > 0) {
+		ssize_t written = write(sink.fd, p, remaining);
+		if (written > 0) {
+			p += written;
+			remaining -= (int)written;
+			stalled_mlsecs = 0;
+			continue;
+		}
+		if (written == -1 && errno == EINTR) {
+			continue;
+		}
+		if (written == -1 && errno == EAGAIN) {
+			// Only FIFO sinks are opened in non-blocking mode
+			struct pollfd pfd;
+			pfd.fd = sink.fd;
+			pfd.events = POLLOUT;
+			pfd.revents = 0;
+			int rc = poll(&pfd, 1, c_poll_interval_mlsecs);
+			if (rc == 0) {
+				bool is_closing;
+				{
+					lock_guard<mutex> lock(sink.mtx);
+					is_closing = sink.is_closing;
+				}
+				if (is_closing && sink.e_policy != SinkPolicy::block) {
+					stalled_mlsecs += c_poll_interval_mlsecs;
+					if (stalled_mlsecs >= c_drain_timeout_mlsecs) {
+						fail_sink(sink, "Timed out waiting for the reader to consume data. ");
+						return false;
+					}
+				}
+			}
+			continue;
+		}
+		fail_sink(sink, string("Could not write to ") + sink.name + ", "
+				+ (written == -1 ? strerror(errno) : "no bytes written") + ". ");
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Mark the sink as failed and release all blocks still queued for it.
+ */
+void FanoutStreamWriter::fail_sink(Sink &sink, const string &error) {
+	deque<Block*> pending;
+	{
+		lock_guard<mutex> lock(sink.mtx);
+		sink.error = error;
+		sink.is_failed.store(true);
+		pending.swap(sink.queue);
+		for (Block *block : pending) {
+			sink.bytes_dropped += block->size;
+			sink.queued_bytes -= block->size;
+		}
+		sink.cv_not_full.notify_all();
+	}
+	for (Block *block : pending) {
+		release_block(block);
+	}
+}
+
+void FanoutStreamWriter::stop_sinks() {
+	for (auto &sink : m_sinks) {
+		lock_guard<mutex> lock(sink->mtx);
+		sink->is_closing = true;
+		sink->cv_not_empty.notify_all();
+	}
+	for (auto &sink : m_sinks) {
+		if (sink->thread.joinable()) {
+			sink->thread.join();
+		}
+	}
+}
+
+/**
+ * Wait until all queued blocks are written and close the sinks.
+ *
+ * @return true if every sink with the 'block' policy received the whole stream
+ */
+bool FanoutStreamWriter::finish() {
+	if (!m_is_open) {
+		return true;
+	}
+	stop_sinks();
+	m_is_open = false;
+	bool status = true;
+	for (auto &sink : m_sinks) {
+		if (sink->owns_fd && sink->fd != -1) {
+			if (close(sink->fd) == -1 && !sink->is_failed.load()) {
+				sink->is_failed.store(true);
+				sink->error = string("Could not close ") + sink->name + ". ";
+			}
+			sink->fd = -1;
+			sink->owns_fd = false;
+		}
+		if (sink->is_failed.load() && sink->e_policy == SinkPolicy::block) {
+			m_error_log_oss << "Sink " << sink->name << " failed: " << sink->error << endl;
+			status = false;
+		}
+	}
+	return status;
+}
+
+/**
+ * Retrieve the amount of bytes written to and dropped for a sink
+ *
+ * @param[in] sink_idx sink index, in the order the sinks were added
+ *
+ * @return sink statistics
+ */
+SinkStatistics FanoutStreamWriter::get_sink_statistics(int sink_idx) const {
+	const Sink &sink = *m_sinks.at(sink_idx);
+	SinkStatistics stats;
+	stats.name = sink.name;
+	stats.e_kind = sink.e_kind;
+	stats.e_policy = sink.e_policy;
+	stats.bytes_written = sink.bytes_written.load();
+	stats.bytes_dropped = sink.bytes_dropped.load();
+	stats.is_failed = sink.is_failed.load();
+	return stats;
+}
+
+FanoutStreamWriter::~FanoutStreamWriter() {
+	if (m_is_open) {
+		stop_sinks();
+	}
+	for (auto &sink : m_sinks) {
+		if (sink->owns_fd && sink->fd != -1) {
+			close(sink->fd);
+		}
+	}
+	for (Block *block : m_all_blocks) {
+		delete [] block->data;
+		delete block;
+	}
+}
+
+} /* namespace alpharng */
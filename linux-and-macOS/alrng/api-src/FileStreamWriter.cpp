@@ -0,0 +1,90 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a stream writer that stores bytes downloaded from an AlphaRNG device into a single file.
+
+ */
+
+/**
+ *    @file FileStreamWriter.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements a stream writer for storing device data into a file.
+ */
+
+#include <FileStreamWriter.h>
+
+using namespace std;
+
+namespace alpharng {
+
+/**
+ * @param[in] buffer_size_bytes the largest amount of bytes that can be acquired at once
+ */
+FileStreamWriter::FileStreamWriter(int buffer_size_bytes) : c_buffer_size_bytes(buffer_size_bytes) {
+}
+
+/**
+ * Create (or truncate) the output file
+ *
+ * @param[in] file_path_name file path name for storing the device data
+ *
+ * @return true for successful operation
+ */
+bool FileStreamWriter::open(const string &file_path_name) {
+	m_file_path_name = file_path_name;
+	if (m_buffer == nullptr) {
+		m_buffer = new (nothrow) unsigned char[c_buffer_size_bytes];
+		if (m_buffer == nullptr) {
+			m_error_log_oss << "Could not allocate memory for the file buffer" << ". " << endl;
+			return false;
+		}
+	}
+	m_os_file.open(file_path_name.c_str(), ios::out | ios::binary);
+	if (!m_os_file.good()) {
+		m_error_log_oss << "Could not open file: " << file_path_name << ". " << endl;
+		return false;
+	}
+	return true;
+}
+
+unsigned char* FileStreamWriter::acquire_buffer(int size) {
+	if (size > c_buffer_size_bytes) {
+		m_error_log_oss << "Requested " << size << " bytes exceed the file buffer size: " << c_buffer_size_bytes << ". " << endl;
+		return nullptr;
+	}
+	return m_buffer;
+}
+
+bool FileStreamWriter::commit_buffer(int size) {
+	m_os_file.write((const char*)m_buffer, size);
+	if (!m_os_file.good()) {
+		m_error_log_oss << "Could not write " << size << " bytes to file: " << m_file_path_name << ". " << endl;
+		return false;
+	}
+	return true;
+}
+
+bool FileStreamWriter::finish() {
+	m_os_file.close();
+	if (!m_os_file.good()) {
+		m_error_log_oss << "Could not close file: " << m_file_path_name << ". " << endl;
+		return false;
+	}
+	return true;
+}
+
+FileStreamWriter::~FileStreamWriter() {
+	if (m_buffer) {
+		delete [] m_buffer;
+	}
+}
+
+} /* namespace alpharng */
@@ -0,0 +1,272 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for interacting with the hardware random data generator device AlphaRNG for the purpose of
+ feeding the Linux kernel entropy pool with true random bytes.
+
+ It uses OpenSSL library.
+
+ */
+
+/**
+ *    @file KernelEntropyFeeder.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Feeds the Linux kernel entropy pool with entropy bytes generated by an AlphaRNG device
+ */
+
+#include <KernelEntropyFeeder.h>
+
+#include <algorithm>
+#include <vector>
+#include <fstream>
+#include <iomanip>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/signalfd.h>
+#include <linux/random.h>
+#include <openssl/crypto.h>
+
+using namespace std;
+
+namespace alpharng {
+
+/**
+ * Constructor
+ *
+ * @param[in] rng connected AlphaRNG API used for retrieving entropy bytes
+ * @param[in] cmd command with the entropy credit, the device number and the report interval
+ */
+KernelEntropyFeeder::KernelEntropyFeeder(AlphaRngApi *rng, Cmd *cmd) : m_rng(rng), m_cmd(cmd) {
+}
+
+/**
+ * Feed the kernel entropy pool whenever it wants entropy, until SIGINT or SIGTERM is received
+ *
+ * @return true when run successfully
+ */
+bool KernelEntropyFeeder::run() {
+	if (!open_pool()) {
+		return false;
+	}
+
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGINT);
+	sigaddset(&mask, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+	m_signal_fd = signalfd(-1, &mask, SFD_CLOEXEC);
+	if (m_signal_fd < 0) {
+		m_error_log_oss << "Could not create the signal descriptor, error code: " << errno << ". " << endl;
+		return false;
+	}
+
+	cout << "Feeding the kernel entropy pool of " << m_stats.pool_size_bits << " bits, write wake up threshold: "
+			<< m_wakeup_threshold_bits << " bits, credit: " << m_cmd->entropy_credit_bits << " bits per byte" << endl;
+
+	m_start_time = chrono::steady_clock::now();
+	chrono::steady_clock::time_point next_report_time = m_start_time + chrono::seconds(m_cmd->progress_interval_secs);
+	// Stop watching /dev/random for a while when feeding did not satisfy the kernel
+	bool is_watching_pool = true;
+	while (true) {
+		int timeout_mlsecs = c_check_interval_mlsecs;
+		if (m_cmd->progress_interval_secs > 0) {
+			int64_t report_mlsecs = chrono::duration_cast<chrono::milliseconds>(next_report_time - chrono::steady_clock::now()).count();
+			timeout_mlsecs = (int)max((int64_t)0, min((int64_t)timeout_mlsecs, report_mlsecs));
+		}
+		pollfd fds[2] = {{m_random_fd, (short)(is_watching_pool ? POLLOUT : 0), 0}, {m_signal_fd, POLLIN, 0}};
+		int count = poll(fds, 2, timeout_mlsecs);
+		if (count < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			m_error_log_oss << "poll failed with " << errno << " error code. " << endl;
+			return false;
+		}
+		if ((fds[1].revents & POLLIN) != 0) {
+			break;
+		}
+
+		int entropy_avail_bits;
+		if (!get_entropy_avail(&entropy_avail_bits)) {
+			return false;
+		}
+		m_stats.entropy_avail_bits = entropy_avail_bits;
+		is_watching_pool = true;
+		if ((fds[0].revents & POLLOUT) != 0 || entropy_avail_bits < m_wakeup_threshold_bits) {
+			m_stats.wakeup_count++;
+			if (!feed(entropy_avail_bits)) {
+				return false;
+			}
+			is_watching_pool = m_stats.entropy_avail_bits > entropy_avail_bits;
+		}
+
+		if (m_cmd->progress_interval_secs > 0 && chrono::steady_clock::now() >= next_report_time) {
+			report(false);
+			next_report_time += chrono::seconds(m_cmd->progress_interval_secs);
+		}
+	}
+	report(true);
+	return true;
+}
+
+/**
+ * Open /dev/random and read the pool size and the write wake up threshold
+ *
+ * @return true when successful
+ */
+bool KernelEntropyFeeder::open_pool() {
+	m_random_fd = open("/dev/random", O_RDWR | O_CLOEXEC);
+	if (m_random_fd < 0) {
+		m_error_log_oss << "Could not open /dev/random, error code: " << errno << ". " << endl;
+		return false;
+	}
+	if (!read_pool_setting("/proc/sys/kernel/random/poolsize", &m_stats.pool_size_bits)
+			|| !read_pool_setting("/proc/sys/kernel/random/write_wakeup_threshold", &m_wakeup_threshold_bits)) {
+		return false;
+	}
+	// Recent kernels keep a smaller pool and ignore the threshold, it may be larger than the pool
+	m_wakeup_threshold_bits = min(m_wakeup_threshold_bits, m_stats.pool_size_bits);
+	return get_entropy_avail(&m_stats.entropy_avail_bits);
+}
+
+/**
+ * @param[in] path /proc file with the setting
+ * @param[out] value setting value
+ *
+ * @return true when successful
+ */
+bool KernelEntropyFeeder::read_pool_setting(const char *path, int *value) {
+	ifstream setting(path);
+	if (!(setting >> *value) || *value <= 0) {
+		m_error_log_oss << "Could not read " << path << ". " << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @param[out] bits amount of entropy bits in the kernel input pool
+ *
+ * @return true when successful
+ */
+bool KernelEntropyFeeder::get_entropy_avail(int *bits) {
+	if (ioctl(m_random_fd, RNDGETENTCNT, bits) < 0) {
+		m_error_log_oss << "Could not retrieve the kernel entropy count, error code: " << errno << ". " << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Add entropy bytes until the kernel pool is full, in blocks sized by the missing amount of entropy bits
+ *
+ * @param[in] entropy_avail_bits current amount of entropy bits in the kernel input pool
+ *
+ * @return true when successful
+ */
+bool KernelEntropyFeeder::feed(int entropy_avail_bits) {
+	const int credit = m_cmd->entropy_credit_bits;
+	unsigned char buffer[c_max_feed_bytes];
+	bool status = true;
+	for (int i = 0; status && i < c_max_feeds_per_wakeup && entropy_avail_bits < m_stats.pool_size_bits; i++) {
+		int num_bytes = (m_stats.pool_size_bits - entropy_avail_bits + credit - 1) / credit;
+		num_bytes = max(c_min_feed_bytes, min(c_max_feed_bytes, num_bytes));
+		status = retrieve_entropy(buffer, num_bytes) && add_entropy(buffer, num_bytes)
+				&& get_entropy_avail(&entropy_avail_bits);
+	}
+	OPENSSL_cleanse(buffer, sizeof(buffer));
+	m_stats.entropy_avail_bits = entropy_avail_bits;
+	return status;
+}
+
+/**
+ * Retrieve entropy bytes from the device, reconnect to the device once if needed
+ *
+ * @param[out] out location for the entropy bytes
+ * @param[in] num_bytes amount of entropy bytes
+ *
+ * @return true when successful
+ */
+bool KernelEntropyFeeder::retrieve_entropy(unsigned char *out, int num_bytes) {
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	bool status = m_rng->get_entropy(out, num_bytes);
+	if (!status) {
+		m_rng->disconnect();
+		status = m_rng->connect(m_cmd->device_number) && m_rng->get_entropy(out, num_bytes);
+	}
+	m_stats.device_secs += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	if (!status) {
+		m_error_log_oss << m_rng->get_last_error();
+	}
+	return status;
+}
+
+/**
+ * @param[in] in entropy bytes
+ * @param[in] num_bytes amount of entropy bytes, up to c_max_feed_bytes
+ *
+ * @return true when successful
+ */
+bool KernelEntropyFeeder::add_entropy(const unsigned char *in, int num_bytes) {
+	const int credit_bits = num_bytes * m_cmd->entropy_credit_bits;
+	vector<unsigned char> request(sizeof(rand_pool_info) + num_bytes);
+	rand_pool_info *info = (rand_pool_info*)request.data();
+	info->entropy_count = credit_bits;
+	info->buf_size = num_bytes;
+	memcpy(info->buf, in, num_bytes);
+	int result = ioctl(m_random_fd, RNDADDENTROPY, info);
+	OPENSSL_cleanse(request.data(), request.size());
+	if (result < 0) {
+		m_error_log_oss << "Could not add entropy to the kernel pool, error code: " << errno << ". " << endl;
+		return false;
+	}
+	m_stats.bytes_contributed += num_bytes;
+	m_stats.bits_credited += credit_bits;
+	return true;
+}
+
+/**
+ * @return amount of bytes contributed and the device duty cycle since the start
+ */
+FeederStatistics KernelEntropyFeeder::get_statistics() const {
+	FeederStatistics stats = m_stats;
+	stats.elapsed_secs = chrono::duration<double>(chrono::steady_clock::now() - m_start_time).count();
+	return stats;
+}
+
+/**
+ * Report the kernel pool level, the contributed amount of bytes and the device duty cycle on standard output
+ *
+ * @param[in] is_final true for the report when the feeder stops
+ */
+void KernelEntropyFeeder::report(bool is_final) {
+	FeederStatistics stats = get_statistics();
+	double duty_cycle = stats.elapsed_secs > 0 ? stats.device_secs / stats.elapsed_secs * 100 : 0;
+	cout << (is_final ? "Total: " : "") << "kernel entropy " << stats.entropy_avail_bits << "/" << stats.pool_size_bits
+			<< " bits, contributed " << stats.bytes_contributed << " bytes (" << stats.bits_credited << " bits credited) in "
+			<< stats.wakeup_count << " wake ups, device duty cycle: " << std::fixed << std::setprecision(3) << duty_cycle
+			<< "%" << endl;
+}
+
+KernelEntropyFeeder::~KernelEntropyFeeder() {
+	if (m_signal_fd >= 0) {
+		close(m_signal_fd);
+	}
+	if (m_random_fd >= 0) {
+		close(m_random_fd);
+	}
+}
+
+} /* namespace alpharng */
@@ -0,0 +1,346 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for serving the run time metrics of a server distributing true random bytes
+ generated by an AlphaRNG device over HTTP in Prometheus text format.
+
+ */
+
+/**
+ *    @file MetricsEndpoint.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.1
+ *
+ *    @brief A loopback HTTP endpoint serving server metrics in Prometheus text format
+ */
+
+#include <MetricsEndpoint.h>
+
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+using namespace std;
+
+namespace alpharng {
+
+/**
+ * Constructor
+ *
+ * @param[in] metrics the counters of the server, written first by each scrape
+ */
+MetricsEndpoint::MetricsEndpoint(const ServerMetrics &metrics) : m_metrics(metrics) {
+}
+
+/**
+ * Listen on a loopback TCP port
+ *
+ * @param[in] port TCP port
+ * @param[in] source provides the server state for each scrape
+ *
+ * @return true when successful
+ */
+bool MetricsEndpoint::open(int port, StateSource *source) {
+	clear_error_log();
+	m_source = source;
+	m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (m_epoll_fd < 0) {
+		m_error_log_oss << "Could not create metrics epoll instance, error code: " << errno << endl;
+		return false;
+	}
+	m_listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (m_listen_fd < 0) {
+		m_error_log_oss << "Could not create metrics socket, error code: " << errno << endl;
+		return false;
+	}
+	int reuse = 1;
+	setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+	sockaddr_in addr {};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = htons((uint16_t)port);
+	if (::bind(m_listen_fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(m_listen_fd, c_max_clients) < 0) {
+		m_error_log_oss << "Could not listen on metrics port " << port << ", error code: " << errno << endl;
+		return false;
+	}
+
+	epoll_event ev {};
+	ev.events = EPOLLIN;
+	ev.data.fd = m_listen_fd;
+	if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_listen_fd, &ev) < 0) {
+		m_error_log_oss << "Could not watch the metrics socket, error code: " << errno << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Accept new scrape connections and serve the ready ones, never blocks
+ */
+void MetricsEndpoint::handle_events() {
+	epoll_event events[c_max_epoll_events];
+	int count = epoll_wait(m_epoll_fd, events, c_max_epoll_events, 0);
+	for (int i = 0; i < count; i++) {
+		const int fd = events[i].data.fd;
+		if (fd == m_listen_fd) {
+			accept_clients();
+			continue;
+		}
+		auto it = m_clients.find(fd);
+		if (it == m_clients.end()) {
+			// Closed while handling an earlier event of the same epoll_wait() call
+			continue;
+		}
+		if ((events[i].events & (EPOLLERR | EPOLLHUP)) != 0 || !serve_client(fd, &it->second)) {
+			close_client(fd);
+		}
+	}
+}
+
+/**
+ * Accept all pending scrape connections, the ones above c_max_clients are closed at once
+ */
+void MetricsEndpoint::accept_clients() {
+	while (true) {
+		int fd = accept4(m_listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) {
+				continue;
+			}
+			return;
+		}
+		if ((int)m_clients.size() >= c_max_clients) {
+			close(fd);
+			continue;
+		}
+		epoll_event ev {};
+		ev.events = EPOLLIN;
+		ev.data.fd = fd;
+		if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+			close(fd);
+			continue;
+		}
+		m_clients[fd] = Scrape();
+	}
+}
+
+/**
+ * Receive an HTTP request and reply with the metrics in Prometheus text format
+ *
+ * @param[in] fd scrape connection
+ * @param[in] scrape state of the connection
+ *
+ * @return false if the connection should be closed, which is the case after the reply is sent
+ */
+bool MetricsEndpoint::serve_client(int fd, Scrape *scrape) {
+	while (scrape->output.empty()) {
+		char buffer[c_max_request_bytes];
+		ssize_t n = recv(fd, buffer, c_max_request_bytes - scrape->input.size(), 0);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			return true;
+		}
+		if (n <= 0) {
+			return false;
+		}
+		scrape->input.append(buffer, n);
+		if (scrape->input.find("\r\n\r\n") == string::npos && scrape->input.size() < (size_t)c_max_request_bytes) {
+			continue;
+		}
+
+		string status = "200 OK";
+		ostringstream body;
+		if (scrape->input.compare(0, 4, "GET ") == 0) {
+			write(body);
+		} else {
+			status = "405 Method Not Allowed";
+		}
+		const string content = body.str();
+		scrape->output = "HTTP/1.1 " + status + "\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+				+ to_string(content.size()) + "\r\nConnection: close\r\n\r\n" + content;
+		scrape->output_bytes_written = 0;
+	}
+	if (!write_output(fd, scrape)) {
+		return false;
+	}
+	if (scrape->output_bytes_written == scrape->output.size()) {
+		return false;
+	}
+	// Wait until the socket becomes writable while the reply is not sent
+	epoll_event ev {};
+	ev.events = EPOLLOUT;
+	ev.data.fd = fd;
+	return epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+/**
+ * Send as much of the reply as the socket takes
+ *
+ * @param[in] fd scrape connection
+ * @param[in] scrape state of the connection
+ *
+ * @return false if the connection failed
+ */
+bool MetricsEndpoint::write_output(int fd, Scrape *scrape) {
+	while (scrape->output_bytes_written < scrape->output.size()) {
+		ssize_t n = send(fd, scrape->output.data() + scrape->output_bytes_written,
+				scrape->output.size() - scrape->output_bytes_written, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			return true;
+		}
+		if (n < 0) {
+			return false;
+		}
+		scrape->output_bytes_written += n;
+	}
+	return true;
+}
+
+/**
+ * @param[in] fd scrape connection
+ */
+void MetricsEndpoint::close_client(int fd) {
+	m_clients.erase(fd);
+	close(fd);
+}
+
+/**
+ * Write the server metrics and the server state in Prometheus text format
+ *
+ * @param[in] os output stream
+ */
+void MetricsEndpoint::write(ostream &os) const {
+	m_metrics.write(os);
+	ServerState state {};
+	m_source->get_server_state(&state);
+	write_state(os, state);
+}
+
+/**
+ * Write the device statistics, the cache levels and the per-client statistics in Prometheus text format
+ *
+ * @param[in] os output stream
+ * @param[in] state server state
+ */
+void MetricsEndpoint::write_state(ostream &os, const ServerState &state) {
+	os << "# HELP alpharng_device_in_rotation 1 if the device serves clients, 0 while it is taken out of rotation\n"
+			<< "# TYPE alpharng_device_in_rotation gauge\n";
+	for (const DeviceState &device : state.devices) {
+		os << "alpharng_device_in_rotation{device=\"" << device.device_number << "\"} " << (device.is_in_rotation ? 1 : 0) << "\n";
+	}
+	os << "# HELP alpharng_device_chunks_total Prefetch chunks added to the cache per device\n"
+			<< "# TYPE alpharng_device_chunks_total counter\n";
+	for (const DeviceState &device : state.devices) {
+		os << "alpharng_device_chunks_total{device=\"" << device.device_number << "\"} " << device.chunk_count << "\n";
+	}
+	os << "# HELP alpharng_device_chunk_latency_seconds Smoothed time to read one prefetch chunk per device\n"
+			<< "# TYPE alpharng_device_chunk_latency_seconds gauge\n";
+	for (const DeviceState &device : state.devices) {
+		os << "alpharng_device_chunk_latency_seconds{device=\"" << device.device_number << "\"} " << device.latency_usecs / 1e6 << "\n";
+	}
+	os << "# HELP alpharng_device_queued_requests Device requests waiting per device\n"
+			<< "# TYPE alpharng_device_queued_requests gauge\n";
+	for (const DeviceState &device : state.devices) {
+		os << "alpharng_device_queued_requests{device=\"" << device.device_number << "\"} " << device.queued_requests << "\n";
+	}
+	os << "# HELP alpharng_device_rotation_exits_total Times the device was taken out of rotation\n"
+			<< "# TYPE alpharng_device_rotation_exits_total counter\n";
+	for (const DeviceState &device : state.devices) {
+		os << "alpharng_device_rotation_exits_total{device=\"" << device.device_number << "\"} " << device.rotation_exit_count << "\n";
+	}
+	os << "# HELP alpharng_cache_bytes Entropy cache fill level and watermarks\n# TYPE alpharng_cache_bytes gauge\n"
+			<< "alpharng_cache_bytes{level=\"current\"} " << state.cache_level_bytes << "\n"
+			<< "alpharng_cache_bytes{level=\"low_watermark\"} " << state.cache_low_watermark_bytes << "\n"
+			<< "alpharng_cache_bytes{level=\"high_watermark\"} " << state.cache_high_watermark_bytes << "\n"
+			<< "alpharng_cache_bytes{level=\"seed\"} " << state.seed_level_bytes << "\n";
+	os << "# HELP alpharng_seed_bytes_served_total Bytes generated from the seed file and served before device entropy\n"
+			<< "# TYPE alpharng_seed_bytes_served_total counter\n"
+			<< "alpharng_seed_bytes_served_total " << state.seed_bytes_served << "\n";
+	os << "# HELP alpharng_cache_refills_total Cache refill cycles started below the low watermark\n"
+			<< "# TYPE alpharng_cache_refills_total counter\n"
+			<< "alpharng_cache_refills_total " << state.refill_count << "\n";
+	os << "# HELP alpharng_cache_requests_total Entropy requests served from the cache on arrival or after waiting\n"
+			<< "# TYPE alpharng_cache_requests_total counter\n"
+			<< "alpharng_cache_requests_total{result=\"hit\"} " << state.cache_hit_count << "\n"
+			<< "alpharng_cache_requests_total{result=\"miss\"} " << state.cache_miss_count << "\n";
+	os << "# HELP alpharng_direct_send_bytes_total Reply bytes sent straight from the cache or the request buffer\n"
+			<< "# TYPE alpharng_direct_send_bytes_total counter\n"
+			<< "alpharng_direct_send_bytes_total " << state.direct_send_bytes << "\n";
+	os << "# HELP alpharng_waiting_requests Entropy requests waiting for the scheduler\n"
+			<< "# TYPE alpharng_waiting_requests gauge\n"
+			<< "alpharng_waiting_requests " << state.waiting_requests << "\n";
+	if (state.has_ring) {
+		os << "# HELP alpharng_ring_bytes Entropy bytes available in the shared memory ring\n"
+				<< "# TYPE alpharng_ring_bytes gauge\n"
+				<< "alpharng_ring_bytes " << state.ring_level_bytes << "\n";
+		os << "# HELP alpharng_ring_claimed_bytes_total Entropy bytes claimed by shared memory ring readers\n"
+				<< "# TYPE alpharng_ring_claimed_bytes_total counter\n"
+				<< "alpharng_ring_claimed_bytes_total " << state.ring_claimed_bytes << "\n";
+		os << "# HELP alpharng_ring_readers Processes reading from the shared memory ring\n"
+				<< "# TYPE alpharng_ring_readers gauge\n"
+				<< "alpharng_ring_readers " << state.ring_reader_count << "\n";
+	}
+
+	static const char * const transports[] = {"unix", "tcp", "cuse"};
+	os << "# HELP alpharng_clients Connected clients by transport\n# TYPE alpharng_clients gauge\n";
+	for (const char *transport : transports) {
+		size_t client_count = 0;
+		for (const ClientState &client : state.clients) {
+			if (string(client.transport) == transport) {
+				client_count++;
+			}
+		}
+		os << "alpharng_clients{transport=\"" << transport << "\"} " << client_count << "\n";
+	}
+
+	vector<string> labels;
+	for (const ClientState &client : state.clients) {
+		labels.push_back("client=\"" + client.id + "\",pid=\"" + to_string(client.pid) + "\",priority=\"" + client.priority + "\"");
+	}
+	os << "# HELP alpharng_client_bytes_total Entropy bytes served per connected client\n"
+			<< "# TYPE alpharng_client_bytes_total counter\n";
+	for (size_t i = 0; i < state.clients.size(); i++) {
+		os << "alpharng_client_bytes_total{" << labels[i] << "} " << state.clients[i].byte_count << "\n";
+	}
+	os << "# HELP alpharng_client_request_latency_seconds Entropy request latency per connected client\n"
+			<< "# TYPE alpharng_client_request_latency_seconds summary\n";
+	for (size_t i = 0; i < state.clients.size(); i++) {
+		const ClientState &client = state.clients[i];
+		os << "alpharng_client_request_latency_seconds{" << labels[i] << ",quantile=\"0.5\"} " << client.latency_p50_usecs / 1e6 << "\n"
+				<< "alpharng_client_request_latency_seconds{" << labels[i] << ",quantile=\"0.99\"} " << client.latency_p99_usecs / 1e6 << "\n"
+				<< "alpharng_client_request_latency_seconds_count{" << labels[i] << "} " << client.latency_count << "\n";
+	}
+}
+
+void MetricsEndpoint::clear_error_log() {
+	m_error_log_oss.str("");
+	m_error_log_oss.clear();
+}
+
+MetricsEndpoint::~MetricsEndpoint() {
+	for (auto &entry : m_clients) {
+		close(entry.first);
+	}
+	if (m_listen_fd >= 0) {
+		close(m_listen_fd);
+	}
+	if (m_epoll_fd >= 0) {
+		close(m_epoll_fd);
+	}
+}
+
+} /* namespace alpharng */
@@ -0,0 +1,196 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements periodic progress reporting for long running downloads from an AlphaRNG device.
+
+ */
+
+/**
+ *    @file ProgressReporter.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements periodic throughput and latency reporting for device downloads.
+ */
+
+#include <ProgressReporter.h>
+
+#include <cstring>
+#include <iomanip>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace alpharng {
+
+void LatencyHistogram::clear() {
+	memset(m_buckets, 0, sizeof(m_buckets));
+	m_count = 0;
+	m_max_usecs = 0;
+}
+
+void LatencyHistogram::record(int64_t latency_usecs) {
+	if (latency_usecs < 0) {
+		latency_usecs = 0;
+	}
+	m_buckets[get_bucket(latency_usecs)]++;
+	m_count++;
+	if (latency_usecs > m_max_usecs) {
+		m_max_usecs = latency_usecs;
+	}
+}
+
+/**
+ * @param[in] percentile a value between 0 and 100
+ *
+ * @return latency in microseconds below which the given percentage of recorded latencies fall
+ */
+int64_t LatencyHistogram::get_percentile(double percentile) const {
+	if (m_count == 0) {
+		return 0;
+	}
+	int64_t rank = (int64_t)(percentile / 100.0 * (double)m_count + 0.5);
+	if (rank < 1) {
+		rank = 1;
+	}
+	int64_t seen = 0;
+	for (int i = 0; i < c_bucket_count; i++) {
+		seen += m_buckets[i];
+		if (seen >= rank) {
+			int64_t value = get_bucket_value(i);
+			return value < m_max_usecs ? value : m_max_usecs;
+		}
+	}
+	return m_max_usecs;
+}
+
+int LatencyHistogram::get_bucket(int64_t latency_usecs) {
+	if (latency_usecs < c_sub_buckets) {
+		return (int)latency_usecs;
+	}
+	int exponent = 63 - __builtin_clzll((unsigned long long)latency_usecs);
+	if (exponent > c_max_exponent) {
+		return c_bucket_count - 1;
+	}
+	int shift = exponent - c_sub_bucket_bits;
+	int sub_bucket = (int)(latency_usecs >> shift) - c_sub_buckets;
+	return c_sub_buckets + shift * c_sub_buckets + sub_bucket;
+}
+
+int64_t LatencyHistogram::get_bucket_value(int bucket) {
+	if (bucket < c_sub_buckets) {
+		return bucket;
+	}
+	int shift = (bucket - c_sub_buckets) / c_sub_buckets;
+	int sub_bucket = (bucket - c_sub_buckets) % c_sub_buckets;
+	// Middle of the bucket range
+	return ((int64_t)(c_sub_buckets + sub_bucket) << shift) + (((int64_t)1 << shift) >> 1);
+}
+
+/**
+ * @param[in] os output stream for progress lines
+ * @param[in] interval_secs how often to report progress, in seconds
+ * @param[in] e_format human readable text or JSON lines
+ */
+ProgressReporter::ProgressReporter(ostream &os, int interval_secs, ProgressFormat e_format) :
+		m_os(os), m_interval(seconds(interval_secs)), m_e_format(e_format) {
+	start();
+}
+
+/**
+ * Restart the time measurement and clear all counters
+ */
+void ProgressReporter::start() {
+	m_start_time = steady_clock::now();
+	m_interval_start_time = m_start_time;
+	m_total_bytes = 0;
+	m_interval_bytes = 0;
+	m_interval_latency.clear();
+	m_total_latency.clear();
+}
+
+/**
+ * Account a block of bytes retrieved from the device and report progress when the interval elapsed
+ *
+ * @param[in] num_bytes amount of bytes in the block
+ * @param[in] latency time it took to retrieve the block from the device
+ * @param[in] counters current device counters
+ */
+void ProgressReporter::record_block(int num_bytes, steady_clock::duration latency, const StreamCounters &counters) {
+	int64_t latency_usecs = duration_cast<microseconds>(latency).count();
+	m_interval_latency.record(latency_usecs);
+	m_total_latency.record(latency_usecs);
+	m_total_bytes += num_bytes;
+	m_interval_bytes += num_bytes;
+
+	steady_clock::time_point now = steady_clock::now();
+	if (now - m_interval_start_time >= m_interval) {
+		report(now, counters, false);
+		m_interval_start_time = now;
+		m_interval_bytes = 0;
+		m_interval_latency.clear();
+	}
+}
+
+/**
+ * Report the totals for the whole download
+ *
+ * @param[in] counters final device counters
+ */
+void ProgressReporter::finish(const StreamCounters &counters) {
+	report(steady_clock::now(), counters, true);
+}
+
+void ProgressReporter::report(steady_clock::time_point now, const StreamCounters &counters, bool is_final) {
+	double elapsed_secs = duration<double>(now - m_start_time).count();
+	double interval_secs = duration<double>(now - m_interval_start_time).count();
+	double average_kbsec = elapsed_secs > 0 ? (double)m_total_bytes / 1024.0 / elapsed_secs : 0;
+	double current_kbsec = interval_secs > 0 ? (double)m_interval_bytes / 1024.0 / interval_secs : 0;
+	if (is_final) {
+		current_kbsec = average_kbsec;
+	}
+	// The final report shows latencies for the whole download
+	const LatencyHistogram &latency = is_final ? m_total_latency : m_interval_latency;
+	double p50 = (double)latency.get_percentile(50) / 1000.0;
+	double p90 = (double)latency.get_percentile(90) / 1000.0;
+	double p99 = (double)latency.get_percentile(99) / 1000.0;
+	double max = (double)latency.get_max() / 1000.0;
+
+	ios_base::fmtflags flags = m_os.flags();
+	streamsize precision = m_os.precision();
+	m_os << fixed;
+	if (m_e_format == ProgressFormat::json) {
+		m_os << "{\"elapsed_secs\":" << setprecision(3) << elapsed_secs
+				<< ",\"bytes\":" << m_total_bytes
+				<< ",\"current_kbsec\":" << setprecision(1) << current_kbsec
+				<< ",\"average_kbsec\":" << average_kbsec
+				<< ",\"blocks\":" << latency.get_count()
+				<< ",\"latency_ms\":{\"p50\":" << setprecision(3) << p50 << ",\"p90\":" << p90
+				<< ",\"p99\":" << p99 << ",\"max\":" << max << "}"
+				<< ",\"retries\":" << counters.retry_count
+				<< ",\"sessions\":" << counters.session_count
+				<< ",\"max_rct_events\":" << counters.max_rct_failures
+				<< ",\"max_apt_events\":" << counters.max_apt_failures
+				<< ",\"final\":" << (is_final ? "true" : "false") << "}" << endl;
+	} else {
+		int64_t total_secs = (int64_t)elapsed_secs;
+		m_os << (is_final ? "Total " : "") << setfill('0') << setw(2) << total_secs / 3600 << ":"
+				<< setw(2) << (total_secs / 60) % 60 << ":" << setw(2) << total_secs % 60 << setfill(' ')
+				<< " " << m_total_bytes << " bytes"
+				<< ", current: " << setprecision(1) << current_kbsec << " KB/sec"
+				<< ", average: " << average_kbsec << " KB/sec"
+				<< ", block latency p50/p90/p99/max: " << setprecision(3) << p50 << "/" << p90 << "/" << p99 << "/" << max << " ms"
+				<< ", retries: " << counters.retry_count << ", sessions: " << counters.session_count
+				<< ", max RCT/APT block events: " << counters.max_rct_failures << "/" << counters.max_apt_failures << endl;
+	}
+	m_os.flags(flags);
+	m_os.precision(precision);
+}
+
+} /* namespace alpharng */
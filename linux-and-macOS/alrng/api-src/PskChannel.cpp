@@ -0,0 +1,220 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for protecting the connection between an entropy server and its clients
+ over TCP with a pre-shared key.
+
+ It uses OpenSSL library.
+
+ */
+
+/**
+ *    @file PskChannel.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Pre-shared key authenticated AES-GCM framing for entropy server connections
+ */
+
+#include <PskChannel.h>
+
+#include <fstream>
+#include <cctype>
+#include <openssl/crypto.h>
+
+using namespace std;
+
+namespace alpharng {
+
+/**
+ * Constructor
+ *
+ * @param[in] psk points to c_psk_size_bytes bytes of the pre-shared key
+ * @param[in] is_server true for the accepting side of the connection
+ */
+PskChannel::PskChannel(const unsigned char *psk, bool is_server) : m_is_server(is_server) {
+	memcpy(m_psk, psk, sizeof(m_psk));
+	m_is_initialized = m_tx_cryptor.is_initialized() && m_rx_cryptor.is_initialized()
+			&& RAND_bytes(m_nonce, sizeof(m_nonce)) == 1;
+}
+
+/**
+ * @param[out] out location for c_hello_size_bytes bytes sent to the peer before any frame
+ *
+ * @return true when successful
+ */
+bool PskChannel::create_hello(unsigned char *out) {
+	if (!m_is_initialized) {
+		m_error_log_oss << "Channel is not initialized. " << endl;
+		return false;
+	}
+	memcpy(out, &c_magic, sizeof(c_magic));
+	memcpy(out + 4, &c_version, sizeof(c_version));
+	memcpy(out + 8, m_nonce, sizeof(m_nonce));
+	return true;
+}
+
+/**
+ * Derive the keys of both directions from the pre-shared key and the nonces of both peers
+ *
+ * @param[in] in c_hello_size_bytes bytes received from the peer
+ *
+ * @return true when the hello is valid
+ */
+bool PskChannel::accept_hello(const unsigned char *in) {
+	uint32_t magic;
+	uint32_t version;
+	memcpy(&magic, in, sizeof(magic));
+	memcpy(&version, in + 4, sizeof(version));
+	if (!m_is_initialized || m_is_established || magic != c_magic || version != c_version) {
+		m_error_log_oss << "Unexpected hello received. " << endl;
+		return false;
+	}
+	const unsigned char *client_nonce = m_is_server ? in + 8 : m_nonce;
+	const unsigned char *server_nonce = m_is_server ? m_nonce : in + 8;
+	if (!derive_key(m_is_server ? "S2C" : "C2S", client_nonce, server_nonce, m_tx_cryptor)
+			|| !derive_key(m_is_server ? "C2S" : "S2C", client_nonce, server_nonce, m_rx_cryptor)) {
+		m_error_log_oss << "Could not derive the channel keys. " << endl;
+		return false;
+	}
+	m_is_established = true;
+	return true;
+}
+
+/**
+ * @param[in] label direction label
+ * @param[in] client_nonce nonce of the connecting peer
+ * @param[in] server_nonce nonce of the accepting peer
+ * @param[out] cryptor receives the derived key
+ *
+ * @return true when successful
+ */
+bool PskChannel::derive_key(const char *label, const unsigned char *client_nonce, const unsigned char *server_nonce,
+		AesCryptor &cryptor) {
+	unsigned char input[4 + 2 * c_nonce_size_bytes];
+	memcpy(input, label, 4);
+	memcpy(input + 4, client_nonce, c_nonce_size_bytes);
+	memcpy(input + 4 + c_nonce_size_bytes, server_nonce, c_nonce_size_bytes);
+	HmacSha256 kdf;
+	unsigned char key[32];
+	bool status = kdf.is_initialized() && kdf.set_key(m_psk, sizeof(m_psk)) && kdf.hmac(input, sizeof(input), key)
+			&& cryptor.set_key(key, sizeof(key));
+	OPENSSL_cleanse(key, sizeof(key));
+	return status;
+}
+
+/**
+ * Set the IV and the AAD of the next frame of one direction
+ *
+ * @param[in] cryptor cryptor of the direction
+ * @param[in,out] counter frame counter of the direction
+ * @param[in] size payload size, authenticated with the frame
+ *
+ * @return true when successful
+ */
+bool PskChannel::prepare_frame(AesCryptor &cryptor, uint64_t *counter, uint32_t size) {
+	unsigned char iv[12] {};
+	memcpy(iv + 4, counter, sizeof(*counter));
+	(*counter)++;
+	unsigned char aad[16] {};
+	memcpy(aad, &size, sizeof(size));
+	return cryptor.set_iv(iv) && cryptor.set_aad(aad);
+}
+
+/**
+ * Encrypt a payload into a frame
+ *
+ * @param[in] in payload bytes
+ * @param[in] size amount of payload bytes, between 1 and c_max_payload_bytes
+ * @param[out] out location for size + c_frame_overhead_bytes bytes of the frame
+ *
+ * @return true when successful
+ */
+bool PskChannel::seal(const unsigned char *in, uint32_t size, unsigned char *out) {
+	if (!m_is_established || size == 0 || size > c_max_payload_bytes) {
+		m_error_log_oss << "Could not seal a frame of " << size << " bytes. " << endl;
+		return false;
+	}
+	memcpy(out, &size, sizeof(size));
+	int out_size = 0;
+	if (!prepare_frame(m_tx_cryptor, &m_tx_counter, size)
+			|| !m_tx_cryptor.encrypt(in, (int)size, out + c_header_size_bytes, &out_size, out + c_header_size_bytes + size)) {
+		m_error_log_oss << "Could not encrypt a frame. " << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Decrypt and authenticate a complete frame
+ *
+ * @param[in] frame get_payload_size() + c_frame_overhead_bytes bytes of the frame
+ * @param[out] out location for the payload bytes
+ *
+ * @return false if the frame is not authentic
+ */
+bool PskChannel::open(const unsigned char *frame, unsigned char *out) {
+	const uint32_t size = get_payload_size(frame);
+	int out_size = 0;
+	if (!m_is_established || size == 0 || !prepare_frame(m_rx_cryptor, &m_rx_counter, size)
+			|| !m_rx_cryptor.decrypt(frame + c_header_size_bytes, (int)size, out, &out_size,
+					(unsigned char*)frame + c_header_size_bytes + size)) {
+		m_error_log_oss << "Frame authentication failed. " << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @param[in] frame at least c_header_size_bytes bytes of a frame
+ *
+ * @return amount of payload bytes, 0 if the frame header is invalid
+ */
+uint32_t PskChannel::get_payload_size(const unsigned char *frame) {
+	uint32_t size;
+	memcpy(&size, frame, sizeof(size));
+	return size <= c_max_payload_bytes ? size : 0;
+}
+
+/**
+ * Read a pre-shared key stored as 64 hexadecimal digits, for example created with 'openssl rand -hex 32'
+ *
+ * @param[in] file_name path of the key file
+ * @param[out] out location for c_psk_size_bytes bytes of the key
+ * @param[out] error reason of the failure
+ *
+ * @return true when successful
+ */
+bool PskChannel::read_psk_file(const string &file_name, unsigned char *out, string *error) {
+	ifstream file(file_name);
+	string hex;
+	if (!(file >> hex)) {
+		*error = "Could not read the pre-shared key file " + file_name;
+		return false;
+	}
+	if (hex.size() != 2 * c_psk_size_bytes) {
+		*error = "The pre-shared key file " + file_name + " must contain " + to_string(2 * c_psk_size_bytes) + " hexadecimal digits";
+		return false;
+	}
+	for (int i = 0; i < c_psk_size_bytes; i++) {
+		if (!isxdigit((unsigned char)hex[2 * i]) || !isxdigit((unsigned char)hex[2 * i + 1])) {
+			*error = "The pre-shared key file " + file_name + " contains an invalid digit";
+			return false;
+		}
+		out[i] = (unsigned char)stoi(hex.substr(2 * i, 2), nullptr, 16);
+	}
+	OPENSSL_cleanse(&hex[0], hex.size());
+	return true;
+}
+
+PskChannel::~PskChannel() {
+	OPENSSL_cleanse(m_psk, sizeof(m_psk));
+}
+
+} /* namespace alpharng */
@@ -0,0 +1,207 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a keyed pseudorandom permutation of a range of integers for generating sequences
+ without duplicates in constant memory.
+
+ */
+
+/**
+ *    @file RandomRangePermutation.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements a class for streaming up to 4294967295 unique integers within [-2147483647,2147483647] range in constant memory.
+ */
+
+#include <RandomRangePermutation.h>
+
+namespace tl_algorithm {
+
+/**
+ * Validate minimum and maximum limits and size the Feistel halves for the range.
+ *
+ * @param int32_t min_limit - the smallest number in the range
+ * @param int32_t max_limit - the largest number in the range
+ */
+RandomRangePermutation::RandomRangePermutation(const int32_t min_limit, const int32_t max_limit)
+		: c_min_limit(min_limit), c_max_limit(max_limit) {
+	if (min_limit < c_min_range_value) {
+		m_error_log_oss << "The smallest number in the range cannot be smaller than " << c_min_range_value << std::endl;
+		return;
+	}
+
+	if (max_limit > c_max_range_value) {
+		m_error_log_oss << "The largest number in the range cannot be bigger than " << c_max_range_value << std::endl;
+		return;
+	}
+
+	if (min_limit > max_limit) {
+		m_error_log_oss << "The largest number in the range cannot be smaller than the smallest number" << std::endl;
+		return;
+	}
+
+	c_actual_range = (uint32_t)((int64_t)max_limit - (int64_t)min_limit + 1);
+
+	int range_bits = 0;
+	for (uint32_t b = c_actual_range - 1; b != 0; b >>= 1) {
+		range_bits++;
+	}
+	m_left_bits = range_bits / 2;
+	m_right_bits = range_bits - m_left_bits;
+
+	m_is_error = false;
+}
+
+RandomRangePermutation::~RandomRangePermutation() {
+}
+
+/**
+ * Retrieve a new key from the entropy source, which selects a new permutation of the range
+ *
+ * @return bool - true when successful
+ */
+bool RandomRangePermutation::generate_key() {
+	if (m_is_error) {
+		// Unsuccessful object initialization
+		return false;
+	}
+	clear_error_log();
+
+	int32_t words[4];
+	if (false == get_entropy(words, 4)) {
+		m_error_log_oss << "Could not retrieve entropy for the permutation key" << std::endl;
+		return false;
+	}
+	m_key[0] = (uint64_t)(uint32_t)words[0] << 32 | (uint32_t)words[1];
+	m_key[1] = (uint64_t)(uint32_t)words[2] << 32 | (uint32_t)words[3];
+	volatile int32_t *volatile_words = words;
+	for (int i = 0; i < 4; i++) {
+		volatile_words[i] = 0;
+	}
+	m_is_keyed = true;
+	return true;
+}
+
+/**
+ * Generate a chunk of the sequence selected by the last key
+ *
+ * @param int32_t *dest - destination memory
+ * @param uint32_t size - how many numbers to generate
+ * @param uint64_t start_index - position of the first number in the sequence
+ * @return bool - true when successful
+ */
+bool RandomRangePermutation::generate_sequence(int32_t *dest, uint32_t size, uint64_t start_index) {
+	if (m_is_error) {
+		// Unsuccessful object initialization
+		return false;
+	}
+	clear_error_log();
+
+	if (!m_is_keyed) {
+		m_error_log_oss << "A key must be generated before generating a sequence" << std::endl;
+		return false;
+	}
+
+	if (start_index + size > c_actual_range) {
+		m_error_log_oss << "Amount of integers requested " << start_index + size << " cannot exceed " << c_actual_range << std::endl;
+		return false;
+	}
+
+	for (uint32_t i = 0; i < size; i++) {
+		dest[i] = get_number(start_index + i);
+	}
+	return true;
+}
+
+/**
+ * Map a position of the sequence to a position of the range
+ *
+ * @param uint32_t index - position in the sequence, below the range size
+ * @return uint32_t - position in the range
+ */
+uint32_t RandomRangePermutation::permute(uint32_t index) const {
+	uint32_t value = index;
+	do {
+		value = encrypt(value);
+	} while (value >= c_actual_range);
+	return value;
+}
+
+/**
+ * Apply the Feistel network to a value of m_left_bits + m_right_bits bits. Each round adds the round
+ * function of one half to the other half and swaps them, the halves alternate in size as in FF1.
+ *
+ * @param uint32_t value - the value to encrypt
+ * @return uint32_t - the encrypted value
+ */
+uint32_t RandomRangePermutation::encrypt(uint32_t value) const {
+	const uint64_t left_mask = ((uint64_t)1 << m_left_bits) - 1;
+	const uint64_t right_mask = ((uint64_t)1 << m_right_bits) - 1;
+	uint32_t a = (uint32_t)(((uint64_t)value >> m_right_bits) & left_mask);
+	uint32_t b = (uint32_t)(value & right_mask);
+	for (uint32_t round = 0; round < c_feistel_rounds; round++) {
+		const uint64_t mask = (round & 1) == 0 ? left_mask : right_mask;
+		const uint32_t c = (uint32_t)((a + (uint64_t)round_function(round, b)) & mask);
+		a = b;
+		b = c;
+	}
+	return (uint32_t)((uint64_t)a << m_right_bits | b);
+}
+
+static inline uint64_t rotate_left(uint64_t x, int b) {
+	return (x << b) | (x >> (64 - b));
+}
+
+static inline void sip_round(uint64_t &v0, uint64_t &v1, uint64_t &v2, uint64_t &v3) {
+	v0 += v1; v1 = rotate_left(v1, 13); v1 ^= v0; v0 = rotate_left(v0, 32);
+	v2 += v3; v3 = rotate_left(v3, 16); v3 ^= v2;
+	v0 += v3; v3 = rotate_left(v3, 21); v3 ^= v0;
+	v2 += v1; v1 = rotate_left(v1, 17); v1 ^= v2; v2 = rotate_left(v2, 32);
+}
+
+/**
+ * SipHash-2-4 of an 8 byte message made of the round number and the value
+ *
+ * @param uint32_t round - the Feistel round
+ * @param uint32_t value - half of the Feistel state
+ * @return uint32_t - 32 bits of the keyed hash
+ */
+uint32_t RandomRangePermutation::round_function(uint32_t round, uint32_t value) const {
+	const uint64_t m = (uint64_t)round << 32 | value;
+	const uint64_t b = (uint64_t)8 << 56;
+	uint64_t v0 = m_key[0] ^ 0x736f6d6570736575ULL;
+	uint64_t v1 = m_key[1] ^ 0x646f72616e646f6dULL;
+	uint64_t v2 = m_key[0] ^ 0x6c7967656e657261ULL;
+	uint64_t v3 = m_key[1] ^ 0x7465646279746573ULL;
+
+	v3 ^= m;
+	sip_round(v0, v1, v2, v3);
+	sip_round(v0, v1, v2, v3);
+	v0 ^= m;
+
+	v3 ^= b;
+	sip_round(v0, v1, v2, v3);
+	sip_round(v0, v1, v2, v3);
+	v0 ^= b;
+
+	v2 ^= 0xff;
+	sip_round(v0, v1, v2, v3);
+	sip_round(v0, v1, v2, v3);
+	sip_round(v0, v1, v2, v3);
+	sip_round(v0, v1, v2, v3);
+	return (uint32_t)(v0 ^ v1 ^ v2 ^ v3);
+}
+
+void RandomRangePermutation::clear_error_log() {
+	m_error_log_oss.str("");
+	m_error_log_oss.clear();
+}
+
+} /* namespace tl_algorithm */
@@ -12,14 +12,15 @@
 
 /**
  *    @file RandomRangeSequence.cpp
- *    @date 11/2/2024
+ *    @date 10/17/2026
  *    @Author: Andrian Belinski
- *    @version 1.0
+ *    @version 1.1
  *
  *    @brief Implements a class with an algorithm for generating up to 4294967295 unique sequence of integers within [-2147483647,2147483647] range.
  */
 
 #include <RandomRangeSequence.h>
+#include <algorithm>
 
 namespace tl_algorithm {
 
@@ -52,21 +53,15 @@ RandomRangeSequence::RandomRangeSequence(const int32_t min_limit, const int32_t
 		return;
 	}
 
-	m_number_buffer_1 = new (std::nothrow) int32_t[c_actual_range];
-	if (m_number_buffer_1 == nullptr) {
-		m_error_log_oss << "Cannot allocate memory for buffer 1" << std::endl;
+	m_number_buffer = new (std::nothrow) uint32_t[c_actual_range];
+	if (m_number_buffer == nullptr) {
+		m_error_log_oss << "Cannot allocate memory for number buffer" << std::endl;
 		return;
 	}
 
-	m_number_buffer_2 = new (std::nothrow) int32_t[c_actual_range];
-	if (m_number_buffer_2 == nullptr) {
-		m_error_log_oss << "Cannot allocate memory for buffer 2" << std::endl;
-		return;
-	}
-
-	mn_random_buffer = new (std::nothrow) int32_t[c_actual_range + 1];
-	if (mn_random_buffer == nullptr) {
-		m_error_log_oss << "Cannot allocate memory for random buffer" << std::endl;
+	m_entropy_buffer = new (std::nothrow) uint32_t[c_entropy_buffer_words];
+	if (m_entropy_buffer == nullptr) {
+		m_error_log_oss << "Cannot allocate memory for entropy buffer" << std::endl;
 		return;
 	}
 
@@ -74,67 +69,112 @@ RandomRangeSequence::RandomRangeSequence(const int32_t min_limit, const int32_t
 }
 
 RandomRangeSequence::~RandomRangeSequence() {
-	if (mn_random_buffer != nullptr) {
-		delete [] mn_random_buffer;
+	if (m_entropy_buffer != nullptr) {
+		delete [] m_entropy_buffer;
 	}
 
-	if (m_number_buffer_2 != nullptr) {
-		delete [] m_number_buffer_2;
+	if (m_number_buffer != nullptr) {
+		delete [] m_number_buffer;
 	}
+}
 
-	if (m_number_buffer_1 != nullptr) {
-		delete [] m_number_buffer_1;
+/**
+ * Retrieve entropy words, no more than the current sequence is expected to use
+ *
+ * @return bool - true when entropy successfully retrieved
+ */
+bool RandomRangeSequence::refill_entropy() {
+	uint64_t words = m_expected_bits / 32 + 1;
+	if (words < c_min_entropy_refill_words) {
+		words = c_min_entropy_refill_words;
 	}
+	if (words > c_entropy_buffer_words) {
+		words = c_entropy_buffer_words;
+	}
+	if (false == get_entropy((int32_t*)m_entropy_buffer, (uint32_t)words)) {
+		m_error_log_oss << "Could not retrieve entropy" << std::endl;
+		return false;
+	}
+	m_entropy_buffer_size = (uint32_t)words;
+	m_entropy_idx = 0;
+	m_entropy_words_used += words;
+	return true;
 }
 
 /**
+ * Take random bits from the bit pool
  *
- * Remove selected integers (marked as -1) from the buffer
- * and leave only those that have not been pulled out.
- *
+ * @param int num_bits - how many bits to take, 1 to 32
+ * @param uint32_t *value - location for the bits
+ * @return bool - true when successful
  */
-void RandomRangeSequence::defragment() {
-	uint32_t new_cur_num_buffer_size = 0;
-	for (uint32_t i = 0; i < m_current_number_buffer_size; i++) {
-		if (m_current_number_buffer[i] != -1) {
-			m_other_current_number_buffer[new_cur_num_buffer_size++] = m_current_number_buffer[i];
+bool RandomRangeSequence::draw_bits(int num_bits, uint32_t *value) {
+	if (m_bit_pool_size < num_bits) {
+		if (m_entropy_idx == m_entropy_buffer_size && false == refill_entropy()) {
+			return false;
 		}
+		m_bit_pool |= (uint64_t)m_entropy_buffer[m_entropy_idx++] << m_bit_pool_size;
+		m_bit_pool_size += 32;
 	}
-	m_current_number_buffer_size = new_cur_num_buffer_size;
-	int32_t *swap = m_current_number_buffer;
-	m_current_number_buffer = m_other_current_number_buffer;
-	m_other_current_number_buffer = swap;
+	*value = (uint32_t)(m_bit_pool & ((1ULL << num_bits) - 1));
+	m_bit_pool >>= num_bits;
+	m_bit_pool_size -= num_bits;
+	m_expected_bits = m_expected_bits > (uint64_t)num_bits ? m_expected_bits - num_bits : 0;
+	return true;
 }
 
 /**
- * Generate relative random integers and mark positions for those that have been extracted with -1 to
- * prevent duplicates.
+ * Draw a uniformly distributed integer below a bound with Lemire's method:
+ * the top bits of a random L bit number multiplied by the bound are uniform
+ * once the rare products with a biased low part are rejected.
  *
- * @param uint32_t *dest - destination buffer
- * @param uint32_t size - how many integers to generate within the range
+ * @param uint32_t bound - the exclusive upper limit, at least 2
+ * @param int bound_bits - amount of bits needed for bound - 1
+ * @param uint32_t *value - location for the integer
+ * @return bool - true when successful
  */
-void RandomRangeSequence::iterate(uint32_t *dest, const uint32_t size) {
-	for (uint32_t i = 0; i < size && m_dest_idx < size; i++) {
-		uint32_t idx = mn_random_buffer[i] % m_current_number_buffer_size;
-		if (m_current_number_buffer[idx] != -1) {
-			dest[m_dest_idx++] = m_current_number_buffer[idx];
-			m_current_number_buffer[idx] = -1;
+bool RandomRangeSequence::draw_below(uint32_t bound, int bound_bits, uint32_t *value) {
+	const int num_bits = std::min(bound_bits + c_extra_draw_bits, 32);
+	const uint64_t mask = ((uint64_t)1 << num_bits) - 1;
+	uint32_t x;
+	if (false == draw_bits(num_bits, &x)) {
+		return false;
+	}
+	uint64_t m = (uint64_t)x * bound;
+	uint64_t low = m & mask;
+	if (low < bound) {
+		const uint64_t threshold = (mask + 1 - bound) % bound;
+		while (low < threshold) {
+			if (false == draw_bits(num_bits, &x)) {
+				return false;
+			}
+			m = (uint64_t)x * bound;
+			low = m & mask;
 		}
 	}
+	*value = (uint32_t)(m >> num_bits);
+	return true;
 }
 
 /**
- * Initialize buffers and variables
+ * Count the entropy bits drawn for a sequence when no draw is rejected
  *
+ * @param uint32_t size - how many integers to generate within the range
+ * @return uint64_t - amount of bits
  */
-void RandomRangeSequence::init() {
-	m_current_number_buffer = m_number_buffer_1;
-	m_other_current_number_buffer = m_number_buffer_2;
-	for (uint32_t i = 0; i < c_actual_range; i++) {
-		m_current_number_buffer[i] = i + 1;
+uint64_t RandomRangeSequence::get_expected_bits(uint32_t size) const {
+	// Bounds from c_actual_range - size + 1 to c_actual_range, a bound in [2^(w-1) + 1, 2^w] takes w bits
+	const uint64_t lowest_bound = (uint64_t)c_actual_range - size + 1;
+	const uint64_t highest_bound = c_actual_range;
+	uint64_t bits = 0;
+	for (int w = 1; w <= 32; w++) {
+		uint64_t from = std::max(lowest_bound, ((uint64_t)1 << (w - 1)) + 1);
+		uint64_t to = std::min(highest_bound, (uint64_t)1 << w);
+		if (from <= to) {
+			bits += (to - from + 1) * (uint64_t)std::min(w + c_extra_draw_bits, 32);
+		}
 	}
-	m_current_number_buffer_size = c_actual_range;
-	m_dest_idx = 0;
+	return bits;
 }
 
 void RandomRangeSequence::clear_error_log() {
@@ -161,18 +201,35 @@ bool RandomRangeSequence::generate_sequence(int32_t *dest, uint32_t size) {
 		return false;
 	}
 
-	init();
-	while(m_current_number_buffer_size > 0 && m_dest_idx < size) {
-		if (false == get_entropy(mn_random_buffer, size)) {
-			return false;
-		}
-		iterate((uint32_t*)dest, size);
-		defragment();
+	for (uint32_t i = 0; i < c_actual_range; i++) {
+		m_number_buffer[i] = i;
 	}
+	m_entropy_words_used = 0;
+	m_expected_bits = get_expected_bits(size);
 
-	// Transform relative sequence numbers into absolute values
+	int bound_bits = 0;
+	for (uint32_t b = c_actual_range - 1; b != 0; b >>= 1) {
+		bound_bits++;
+	}
+
+	// Partial Fisher-Yates shuffle, position i receives a number drawn from the ones not used yet
 	for (uint32_t i = 0; i < size; i++) {
-		dest[i] = dest[i] - 1 + c_min_limit;
+		const uint32_t bound = c_actual_range - i;
+		uint32_t j = i;
+		if (bound > 1) {
+			if ((bound - 1) >> (bound_bits - 1) == 0) {
+				bound_bits--;
+			}
+			uint32_t offset;
+			if (false == draw_below(bound, bound_bits, &offset)) {
+				return false;
+			}
+			j += offset;
+		}
+		uint32_t number = m_number_buffer[j];
+		m_number_buffer[j] = m_number_buffer[i];
+		m_number_buffer[i] = number;
+		dest[i] = (int32_t)((int64_t)number + c_min_limit);
 	}
 
 	return true;
@@ -0,0 +1,283 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for keeping a seed of true random bytes generated by an AlphaRNG device across restarts,
+ so random bytes are available before a device connection is established.
+
+ It uses OpenSSL library.
+
+ */
+
+/**
+ *    @file SeedFile.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief A protected, consume once seed file for generating random bytes at startup.
+ */
+
+#include <SeedFile.h>
+#include <Sha256.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/random.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+
+using namespace std;
+
+namespace alpharng {
+
+const char SeedFile::c_magic[c_magic_size_bytes + 1] = "ALRNGSD1";
+
+/**
+ * Constructor
+ *
+ * @param[in] file_name path of the seed file
+ */
+SeedFile::SeedFile(const string &file_name) : m_file_name(file_name) {
+}
+
+/**
+ * Replace the seed file with a new seed
+ *
+ * @param[in] seed points to c_seed_size_bytes of device entropy that is not used for anything else
+ *
+ * @return true when the new seed file is durably stored
+ */
+bool SeedFile::save(const unsigned char *seed) {
+	clear_error_log();
+	unsigned char file_data[c_file_size_bytes];
+	memcpy(file_data, c_magic, c_magic_size_bytes);
+	memcpy(file_data + c_magic_size_bytes, seed, c_seed_size_bytes);
+	Sha256 sha;
+	if (!sha.hash(file_data, c_magic_size_bytes + c_seed_size_bytes, file_data + c_magic_size_bytes + c_seed_size_bytes)) {
+		OPENSSL_cleanse(file_data, sizeof(file_data));
+		m_error_log_oss << "Could not compute the seed checksum. " << endl;
+		return false;
+	}
+
+	const string tmp_file_name = m_file_name + ".tmp";
+	unlink(tmp_file_name.c_str());
+	int fd = open(tmp_file_name.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, S_IRUSR | S_IWUSR);
+	if (fd < 0) {
+		OPENSSL_cleanse(file_data, sizeof(file_data));
+		m_error_log_oss << "Could not create seed file " << tmp_file_name << ", error: " << strerror(errno) << endl;
+		return false;
+	}
+	size_t written = 0;
+	while (written < sizeof(file_data)) {
+		ssize_t count = write(fd, file_data + written, sizeof(file_data) - written);
+		if (count < 0 && errno == EINTR) {
+			continue;
+		}
+		if (count <= 0) {
+			break;
+		}
+		written += (size_t)count;
+	}
+	OPENSSL_cleanse(file_data, sizeof(file_data));
+	const bool is_written = written == sizeof(file_data) && fsync(fd) == 0;
+	const int error = errno;
+	close(fd);
+	if (!is_written) {
+		unlink(tmp_file_name.c_str());
+		m_error_log_oss << "Could not write seed file " << tmp_file_name << ", error: " << strerror(error) << endl;
+		return false;
+	}
+	if (rename(tmp_file_name.c_str(), m_file_name.c_str()) != 0) {
+		m_error_log_oss << "Could not rename " << tmp_file_name << " to " << m_file_name << ", error: " << strerror(errno) << endl;
+		unlink(tmp_file_name.c_str());
+		return false;
+	}
+	return sync_directory();
+}
+
+/**
+ * Remove the seed file and generate random bytes from its seed
+ *
+ * @param[out] out location for the random bytes
+ * @param[in] size amount of random bytes, up to c_max_output_bytes
+ *
+ * @return true when successful, the seed file no longer exists
+ */
+bool SeedFile::consume(unsigned char *out, size_t size) {
+	clear_error_log();
+	if (size > c_max_output_bytes) {
+		m_error_log_oss << "Too many bytes requested from a seed: " << size << endl;
+		return false;
+	}
+	unsigned char file_data[c_file_size_bytes];
+	if (!read_seed(file_data)) {
+		return false;
+	}
+	if (!remove_file()) {
+		OPENSSL_cleanse(file_data, sizeof(file_data));
+		return false;
+	}
+
+	unsigned char checksum[c_checksum_size_bytes];
+	Sha256 sha;
+	bool is_valid = memcmp(file_data, c_magic, c_magic_size_bytes) == 0
+			&& sha.hash(file_data, c_magic_size_bytes + c_seed_size_bytes, checksum)
+			&& CRYPTO_memcmp(checksum, file_data + c_magic_size_bytes + c_seed_size_bytes, sizeof(checksum)) == 0;
+	if (!is_valid) {
+		m_error_log_oss << "Seed file " << m_file_name << " is corrupted" << endl;
+	}
+	is_valid = is_valid && generate(file_data + c_magic_size_bytes, out, size);
+	OPENSSL_cleanse(file_data, sizeof(file_data));
+	return is_valid;
+}
+
+/**
+ * Read the seed file after checking that only the current user can access it
+ *
+ * @param[out] file_data location for c_file_size_bytes bytes
+ *
+ * @return true when successful
+ */
+bool SeedFile::read_seed(unsigned char *file_data) {
+	int fd = open(m_file_name.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+	if (fd < 0) {
+		m_error_log_oss << "Could not open seed file " << m_file_name << ", error: " << strerror(errno) << endl;
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_uid != geteuid() || (st.st_mode & (S_IRWXG | S_IRWXO)) != 0) {
+		close(fd);
+		m_error_log_oss << "Seed file " << m_file_name << " must be a regular file owned by the current user"
+				<< " and accessible only by that user" << endl;
+		return false;
+	}
+	if (st.st_size != (off_t)c_file_size_bytes) {
+		close(fd);
+		m_error_log_oss << "Seed file " << m_file_name << " has an unexpected size of " << st.st_size << " bytes" << endl;
+		return false;
+	}
+	size_t level = 0;
+	while (level < c_file_size_bytes) {
+		ssize_t count = read(fd, file_data + level, c_file_size_bytes - level);
+		if (count < 0 && errno == EINTR) {
+			continue;
+		}
+		if (count <= 0) {
+			break;
+		}
+		level += (size_t)count;
+	}
+	close(fd);
+	if (level != c_file_size_bytes) {
+		OPENSSL_cleanse(file_data, level);
+		m_error_log_oss << "Could not read seed file " << m_file_name << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Remove the seed file so it cannot be consumed again
+ *
+ * @return true when the removal is durably stored
+ */
+bool SeedFile::remove_file() {
+	if (unlink(m_file_name.c_str()) != 0) {
+		m_error_log_oss << "Could not remove seed file " << m_file_name << ", error: " << strerror(errno) << endl;
+		return false;
+	}
+	return sync_directory();
+}
+
+/**
+ * Flush the directory entry of the seed file
+ *
+ * @return true when successful
+ */
+bool SeedFile::sync_directory() {
+	const size_t separator = m_file_name.rfind('/');
+	const string dir_name = separator == string::npos ? "." : separator == 0 ? "/" : m_file_name.substr(0, separator);
+	int fd = open(dir_name.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd < 0) {
+		m_error_log_oss << "Could not open directory " << dir_name << ", error: " << strerror(errno) << endl;
+		return false;
+	}
+	const bool is_synced = fsync(fd) == 0;
+	const int error = errno;
+	close(fd);
+	if (!is_synced) {
+		m_error_log_oss << "Could not sync directory " << dir_name << ", error: " << strerror(error) << endl;
+	}
+	return is_synced;
+}
+
+/**
+ * Generate the AES-256-CTR key stream of a key derived from the seed
+ *
+ * @param[in] seed points to c_seed_size_bytes of the seed
+ * @param[out] out location for the random bytes
+ * @param[in] size amount of random bytes
+ *
+ * @return true when successful
+ */
+bool SeedFile::generate(const unsigned char *seed, unsigned char *out, size_t size) {
+	// A copied seed file still results in different bytes when the operating system has entropy to add
+	struct {
+		unsigned char seed[c_seed_size_bytes];
+		unsigned char os_bytes[32];
+		struct timespec time;
+		pid_t pid;
+	} input;
+	memset(&input, 0, sizeof(input));
+	memcpy(input.seed, seed, c_seed_size_bytes);
+#ifdef __linux__
+	if (getrandom(input.os_bytes, sizeof(input.os_bytes), GRND_NONBLOCK) != (ssize_t)sizeof(input.os_bytes)) {
+		memset(input.os_bytes, 0, sizeof(input.os_bytes));
+	}
+#else
+	getentropy(input.os_bytes, sizeof(input.os_bytes));
+#endif
+	clock_gettime(CLOCK_REALTIME, &input.time);
+	input.pid = getpid();
+
+	unsigned char key[c_checksum_size_bytes];
+	unsigned char iv[16] {};
+	Sha256 sha;
+	bool status = sha.hash((const unsigned char*)&input, (int)sizeof(input), key);
+	OPENSSL_cleanse(&input, sizeof(input));
+
+	EVP_CIPHER_CTX *ctx = status ? EVP_CIPHER_CTX_new() : nullptr;
+	status = ctx != nullptr && EVP_EncryptInit_ex(ctx, EVP_aes_256_ctr(), nullptr, key, iv) == 1;
+	OPENSSL_cleanse(key, sizeof(key));
+	memset(out, 0, size);
+	size_t offset = 0;
+	while (status && offset < size) {
+		const int chunk = (int)min(size - offset, (size_t)65536);
+		int out_size = 0;
+		status = EVP_EncryptUpdate(ctx, out + offset, &out_size, out + offset, chunk) == 1 && out_size == chunk;
+		offset += (size_t)chunk;
+	}
+	EVP_CIPHER_CTX_free(ctx);
+	if (!status) {
+		OPENSSL_cleanse(out, size);
+		m_error_log_oss << "Could not generate random bytes from the seed. " << endl;
+	}
+	return status;
+}
+
+void SeedFile::clear_error_log() {
+	m_error_log_oss.str("");
+	m_error_log_oss.clear();
+}
+
+} /* namespace alpharng */
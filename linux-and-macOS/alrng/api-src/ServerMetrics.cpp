@@ -0,0 +1,180 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class is used for collecting the run time metrics of a server distributing true random bytes
+ generated by an AlphaRNG device and for exposing them in Prometheus text format.
+
+ */
+
+/**
+ *    @file ServerMetrics.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Lock-free server metrics exposed in Prometheus text format
+ */
+
+#include <ServerMetrics.h>
+
+using namespace std;
+
+namespace alpharng {
+
+const int64_t MetricsHistogram::c_bucket_bounds_usecs[c_bucket_count] = {
+	10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000
+};
+
+const char * const ServerMetrics::c_stream_type_names[c_stream_type_count] = {
+	"entropy", "sha256", "sha512", "noise", "noise_source_1", "noise_source_2", "test"
+};
+
+MetricsHistogram::MetricsHistogram() {
+	for (atomic<uint64_t> &bucket : m_buckets) {
+		bucket.store(0);
+	}
+	m_sum_usecs.store(0);
+	m_count.store(0);
+}
+
+/**
+ * @param[in] latency_usecs latency in microseconds
+ */
+void MetricsHistogram::record(int64_t latency_usecs) {
+	if (latency_usecs < 0) {
+		latency_usecs = 0;
+	}
+	int bucket = 0;
+	while (bucket < c_bucket_count && latency_usecs > c_bucket_bounds_usecs[bucket]) {
+		bucket++;
+	}
+	m_buckets[bucket].fetch_add(1, memory_order_relaxed);
+	m_sum_usecs.fetch_add((uint64_t)latency_usecs, memory_order_relaxed);
+	m_count.fetch_add(1, memory_order_relaxed);
+}
+
+/**
+ * Write the histogram with cumulative buckets in seconds
+ *
+ * @param[in] os output stream
+ * @param[in] name metric name
+ * @param[in] help metric description
+ */
+void MetricsHistogram::write(ostream &os, const string &name, const string &help) const {
+	os << "# HELP " << name << " " << help << "\n# TYPE " << name << " histogram\n";
+	uint64_t cumulative = 0;
+	for (int i = 0; i < c_bucket_count; i++) {
+		cumulative += m_buckets[i].load(memory_order_relaxed);
+		os << name << "_bucket{le=\"" << c_bucket_bounds_usecs[i] / 1e6 << "\"} " << cumulative << "\n";
+	}
+	cumulative += m_buckets[c_bucket_count].load(memory_order_relaxed);
+	// Counters are sampled one by one, the total is never below the last bucket
+	os << name << "_bucket{le=\"+Inf\"} " << cumulative << "\n";
+	os << name << "_sum " << m_sum_usecs.load(memory_order_relaxed) / 1e6 << "\n";
+	os << name << "_count " << cumulative << "\n";
+}
+
+ServerMetrics::ServerMetrics() {
+	for (atomic<uint64_t> &bytes : m_bytes_served) {
+		bytes.store(0);
+	}
+	m_request_count.store(0);
+	m_invalid_request_count.store(0);
+	m_failed_request_count.store(0);
+	m_device_bytes.store(0);
+	m_device_failure_count.store(0);
+	m_retry_count.store(0);
+	m_session_count.store(0);
+	m_max_rct_failures.store(0);
+	m_max_apt_failures.store(0);
+	m_is_device_connected.store(0);
+	m_rng_status.store(-1);
+}
+
+/**
+ * @param[in] e_type type of the bytes served
+ * @param[in] num_bytes amount of bytes served
+ */
+void ServerMetrics::add_bytes_served(StreamType e_type, uint64_t num_bytes) {
+	m_bytes_served[(int)e_type].fetch_add(num_bytes, memory_order_relaxed);
+}
+
+/**
+ * @param[in] latency_usecs how long the device took to deliver the bytes, in microseconds
+ * @param[in] num_bytes amount of bytes retrieved from the device
+ */
+void ServerMetrics::record_device_read(int64_t latency_usecs, uint64_t num_bytes) {
+	m_device_latency.record(latency_usecs);
+	m_device_bytes.fetch_add(num_bytes, memory_order_relaxed);
+}
+
+/**
+ * @param[in] counters retry, session and health test counters of the device API
+ * @param[in] is_connected true if the device is connected
+ */
+void ServerMetrics::set_device_counters(const StreamCounters &counters, bool is_connected) {
+	m_retry_count.store(counters.retry_count, memory_order_relaxed);
+	m_session_count.store(counters.session_count, memory_order_relaxed);
+	m_max_rct_failures.store(counters.max_rct_failures, memory_order_relaxed);
+	m_max_apt_failures.store(counters.max_apt_failures, memory_order_relaxed);
+	m_is_device_connected.store(is_connected ? 1 : 0, memory_order_relaxed);
+}
+
+/**
+ * @param[in] status device status returned by AlphaRngApi::retrieve_rng_status(), 0 when healthy
+ */
+void ServerMetrics::set_rng_status(unsigned char status) {
+	m_rng_status.store(status, memory_order_relaxed);
+}
+
+/**
+ * Write all metrics in Prometheus text format
+ *
+ * @param[in] os output stream
+ */
+void ServerMetrics::write(ostream &os) const {
+	os << "# HELP alpharng_bytes_served_total Bytes served to clients by stream type\n"
+			<< "# TYPE alpharng_bytes_served_total counter\n";
+	for (int i = 0; i < c_stream_type_count; i++) {
+		os << "alpharng_bytes_served_total{stream=\"" << c_stream_type_names[i] << "\"} "
+				<< m_bytes_served[i].load(memory_order_relaxed) << "\n";
+	}
+	os << "# HELP alpharng_requests_total Client requests received\n# TYPE alpharng_requests_total counter\n"
+			<< "alpharng_requests_total " << m_request_count.load(memory_order_relaxed) << "\n";
+	os << "# HELP alpharng_request_errors_total Client requests not served\n# TYPE alpharng_request_errors_total counter\n"
+			<< "alpharng_request_errors_total{reason=\"invalid\"} " << m_invalid_request_count.load(memory_order_relaxed) << "\n"
+			<< "alpharng_request_errors_total{reason=\"device\"} " << m_failed_request_count.load(memory_order_relaxed) << "\n";
+	m_request_latency.write(os, "alpharng_request_latency_seconds", "Time from receiving an entropy request to its reply");
+
+	os << "# HELP alpharng_device_bytes_total Entropy bytes retrieved from the device\n# TYPE alpharng_device_bytes_total counter\n"
+			<< "alpharng_device_bytes_total " << m_device_bytes.load(memory_order_relaxed) << "\n";
+	os << "# HELP alpharng_device_failures_total Failed device reads after a reconnect attempt\n"
+			<< "# TYPE alpharng_device_failures_total counter\n"
+			<< "alpharng_device_failures_total " << m_device_failure_count.load(memory_order_relaxed) << "\n";
+	m_device_latency.write(os, "alpharng_device_read_latency_seconds", "Time to retrieve one chunk of entropy bytes from the device");
+	os << "# HELP alpharng_device_connected 1 if the device is connected\n# TYPE alpharng_device_connected gauge\n"
+			<< "alpharng_device_connected " << m_is_device_connected.load(memory_order_relaxed) << "\n";
+	os << "# HELP alpharng_device_operation_retries Device operations retried in the current connection\n"
+			<< "# TYPE alpharng_device_operation_retries gauge\n"
+			<< "alpharng_device_operation_retries " << m_retry_count.load(memory_order_relaxed) << "\n";
+	os << "# HELP alpharng_device_sessions Device sessions created in the current connection\n"
+			<< "# TYPE alpharng_device_sessions gauge\n"
+			<< "alpharng_device_sessions " << m_session_count.load(memory_order_relaxed) << "\n";
+	os << "# HELP alpharng_health_test_max_failures Largest amount of health test failures per block\n"
+			<< "# TYPE alpharng_health_test_max_failures gauge\n"
+			<< "alpharng_health_test_max_failures{test=\"rct\"} " << m_max_rct_failures.load(memory_order_relaxed) << "\n"
+			<< "alpharng_health_test_max_failures{test=\"apt\"} " << m_max_apt_failures.load(memory_order_relaxed) << "\n";
+	int rng_status = m_rng_status.load(memory_order_relaxed);
+	if (rng_status >= 0) {
+		os << "# HELP alpharng_device_status Device status, 0 when healthy, a bit mask of test failures otherwise\n"
+				<< "# TYPE alpharng_device_status gauge\n"
+				<< "alpharng_device_status " << rng_status << "\n";
+	}
+}
+
+} /* namespace alpharng */
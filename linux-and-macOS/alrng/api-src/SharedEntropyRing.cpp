@@ -0,0 +1,492 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a single producer, multiple consumer ring buffer in POSIX shared memory
+ for distributing random bytes to local processes on Linux.
+
+ */
+
+/**
+ *    @file SharedEntropyRing.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.2
+ *
+ *    @brief A shared memory ring for distributing random bytes to local processes without system calls.
+ */
+
+#include <SharedEntropyRing.h>
+
+#include <chrono>
+#include <climits>
+#include <cerrno>
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
+#include <grp.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+using namespace std;
+
+namespace alpharng {
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+		"Atomic operations in shared memory must be lock free");
+
+/**
+ * Block while the futex word holds the expected value
+ */
+static void futex_wait(atomic<uint32_t> *word, uint32_t expected, int timeout_mlsecs) {
+	timespec ts;
+	ts.tv_sec = timeout_mlsecs / 1000;
+	ts.tv_nsec = (long)(timeout_mlsecs % 1000) * 1000000L;
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+static void futex_wake(atomic<uint32_t> *word, int count) {
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, count, nullptr, nullptr, 0);
+}
+
+/**
+ * Create the shared memory ring as the producer. A ring left by a previous producer is replaced.
+ *
+ * @param[in] name shared memory object name, such as '/alpharng'
+ * @param[in] capacity_bytes ring size, a power of two between 64 KB and 1 GB
+ * @param[in] reader_group group allowed to read the ring, empty for the user of the producer only
+ *
+ * @return true when successful
+ */
+bool SharedEntropyRing::create(const string &name, size_t capacity_bytes, const string &reader_group) {
+	detach();
+	if (capacity_bytes < 65536 || capacity_bytes > 1073741824 || (capacity_bytes & (capacity_bytes - 1)) != 0) {
+		m_error_log_oss << "Invalid ring capacity: " << capacity_bytes << ", must be a power of two between 64 KB and 1 GB. " << endl;
+		return false;
+	}
+	gid_t gid = (gid_t)-1;
+	if (!reader_group.empty()) {
+		const group *gr = getgrnam(reader_group.c_str());
+		if (gr == nullptr) {
+			m_error_log_oss << "Unknown ring reader group: " << reader_group << ". " << endl;
+			return false;
+		}
+		gid = gr->gr_gid;
+	}
+	m_name = name.compare(0, 1, "/") == 0 ? name : "/" + name;
+	const string control_name = get_control_name(m_name);
+	shm_unlink(m_name.c_str());
+	shm_unlink(control_name.c_str());
+	const bool is_group = gid != (gid_t)-1;
+	int fd = create_object(m_name, get_header_size() + capacity_bytes, is_group ? 0640 : 0600, gid);
+	if (fd < 0) {
+		return false;
+	}
+	int control_fd = create_object(control_name, sizeof(Control), is_group ? 0660 : 0600, gid);
+	if (control_fd < 0) {
+		close(fd);
+		shm_unlink(m_name.c_str());
+		return false;
+	}
+	m_is_producer = true;
+	bool status = map(fd, control_fd, capacity_bytes);
+	close(fd);
+	close(control_fd);
+	if (!status) {
+		shm_unlink(m_name.c_str());
+		shm_unlink(control_name.c_str());
+		m_is_producer = false;
+	}
+	return status;
+}
+
+/**
+ * Attach to a ring created by a producer as a reader
+ *
+ * @param[in] name shared memory object name used by the producer
+ * @param[in] producer_uid user allowed to own the ring besides root and the user of the reader
+ *
+ * @return true when successful
+ */
+bool SharedEntropyRing::attach(const string &name, uid_t producer_uid) {
+	detach();
+	m_name = name.compare(0, 1, "/") == 0 ? name : "/" + name;
+	int fd = open_object(m_name, O_RDONLY, producer_uid);
+	if (fd < 0) {
+		return false;
+	}
+	int control_fd = open_object(get_control_name(m_name), O_RDWR, producer_uid);
+	if (control_fd < 0) {
+		close(fd);
+		return false;
+	}
+	struct stat st;
+	struct stat control_st;
+	if (fstat(fd, &st) < 0 || (size_t)st.st_size <= get_header_size() || fstat(control_fd, &control_st) < 0
+			|| (size_t)control_st.st_size != sizeof(Control) || control_st.st_uid != st.st_uid) {
+		m_error_log_oss << "Shared memory " << m_name << " is not a ring. " << endl;
+		close(fd);
+		close(control_fd);
+		return false;
+	}
+	bool status = map(fd, control_fd, st.st_size - get_header_size());
+	close(fd);
+	close(control_fd);
+	if (!status) {
+		return false;
+	}
+	const uint64_t capacity = m_header->capacity;
+	if (m_header->magic != c_magic || m_header->version != c_version || capacity != m_mapped_bytes - get_header_size()
+			|| (capacity & (capacity - 1)) != 0) {
+		m_error_log_oss << "Shared memory " << m_name << " is not a compatible ring. " << endl;
+		detach();
+		return false;
+	}
+	if (!register_reader()) {
+		detach();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Create a shared memory object, removed again when it cannot be set up
+ *
+ * @param[in] name shared memory object name
+ * @param[in] size_bytes object size
+ * @param[in] mode access permissions, set regardless of the umask
+ * @param[in] gid group of the object or (gid_t)-1 to keep the group of the producer
+ *
+ * @return descriptor of the object or -1 on error
+ */
+int SharedEntropyRing::create_object(const string &name, size_t size_bytes, mode_t mode, gid_t gid) {
+	int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+	if (fd < 0) {
+		m_error_log_oss << "Could not create shared memory " << name << ", error code: " << errno << ". " << endl;
+		return -1;
+	}
+	if ((gid != (gid_t)-1 && fchown(fd, (uid_t)-1, gid) < 0) || fchmod(fd, mode) < 0) {
+		m_error_log_oss << "Could not set the permissions of shared memory " << name << ", error code: " << errno << ". " << endl;
+		close(fd);
+		shm_unlink(name.c_str());
+		return -1;
+	}
+	if (ftruncate(fd, size_bytes) < 0) {
+		m_error_log_oss << "Could not size shared memory " << name << ", error code: " << errno << ". " << endl;
+		close(fd);
+		shm_unlink(name.c_str());
+		return -1;
+	}
+	return fd;
+}
+
+/**
+ * Open a shared memory object of the ring as a reader. The object must be owned by root, by the
+ * user of the reader or by producer_uid. Only the owner may write the ring bytes.
+ *
+ * @param[in] name shared memory object name
+ * @param[in] flags O_RDONLY for the ring bytes, O_RDWR for the control object
+ * @param[in] producer_uid user allowed to own the object besides root and the user of the reader
+ *
+ * @return descriptor of the object or -1 on error
+ */
+int SharedEntropyRing::open_object(const string &name, int flags, uid_t producer_uid) {
+	int fd = shm_open(name.c_str(), flags | O_CLOEXEC, 0);
+	if (fd < 0) {
+		m_error_log_oss << "Could not open shared memory " << name << ", error code: " << errno << ". " << endl;
+		return -1;
+	}
+	struct stat st;
+	if (fstat(fd, &st) < 0 || (st.st_uid != 0 && st.st_uid != geteuid() && st.st_uid != producer_uid)
+			|| (flags == O_RDONLY && (st.st_mode & (S_IWGRP | S_IWOTH)) != 0)) {
+		m_error_log_oss << "Shared memory " << name << " is not owned by a trusted user or is writable by other users. " << endl;
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+/**
+ * Map both shared memory objects, the producer also initializes them
+ *
+ * @param[in] fd descriptor of the ring bytes
+ * @param[in] control_fd descriptor of the control object
+ * @param[in] capacity_bytes ring size
+ *
+ * @return true when successful
+ */
+bool SharedEntropyRing::map(int fd, int control_fd, size_t capacity_bytes) {
+	size_t size = get_header_size() + capacity_bytes;
+	// Readers cannot change the published bytes
+	void *p = mmap(nullptr, size, m_is_producer ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	if (p == MAP_FAILED) {
+		m_error_log_oss << "Could not map shared memory " << m_name << ", error code: " << errno << ". " << endl;
+		return false;
+	}
+	void *control = mmap(nullptr, sizeof(Control), PROT_READ | PROT_WRITE, MAP_SHARED, control_fd, 0);
+	if (control == MAP_FAILED) {
+		m_error_log_oss << "Could not map shared memory " << get_control_name(m_name) << ", error code: " << errno << ". " << endl;
+		munmap(p, size);
+		return false;
+	}
+	m_mapped_bytes = size;
+	m_header = static_cast<Header*>(p);
+	m_data = static_cast<unsigned char*>(p) + get_header_size();
+	m_control = static_cast<Control*>(control);
+	if (m_is_producer) {
+		// The memory is zero filled, only the fields with other initial values are set
+		for (ReaderSlot &slot : m_control->slots) {
+			slot.busy_pos.store(c_idle_pos);
+		}
+		m_header->capacity = capacity_bytes;
+		m_header->producer_pid.store(getpid());
+		m_header->version = c_version;
+		atomic_thread_fence(memory_order_seq_cst);
+		m_header->magic = c_magic;
+	}
+	return true;
+}
+
+bool SharedEntropyRing::register_reader() {
+	const int32_t pid = getpid();
+	for (int pass = 0; pass < 2; pass++) {
+		for (ReaderSlot &slot : m_control->slots) {
+			int32_t owner = slot.pid.load();
+			// The second pass takes over slots of readers that exited without detaching
+			if ((owner == 0 || (pass == 1 && !is_process_alive(owner))) && slot.pid.compare_exchange_strong(owner, pid)) {
+				slot.busy_pos.store(c_idle_pos);
+				slot.bytes_claimed.store(0);
+				m_slot = &slot;
+				return true;
+			}
+		}
+	}
+	m_error_log_oss << "All " << c_max_readers << " reader slots of " << m_name << " are in use. " << endl;
+	return false;
+}
+
+/**
+ * Release the ring. A producer marks the ring closed and removes the shared memory name.
+ * A forked child only unmaps the ring, the reader slot and the ring stay owned by the parent.
+ */
+void SharedEntropyRing::detach() {
+	if (m_header == nullptr) {
+		return;
+	}
+	const int32_t pid = getpid();
+	if (m_slot != nullptr && m_slot->pid.load() == pid) {
+		m_slot->busy_pos.store(c_idle_pos);
+		m_slot->pid.store(0);
+	}
+	m_slot = nullptr;
+	if (m_is_producer && m_header->producer_pid.load() == pid) {
+		m_header->is_closed.store(1);
+		m_control->data_seq.fetch_add(1);
+		futex_wake(&m_control->data_seq, INT_MAX);
+		shm_unlink(m_name.c_str());
+		shm_unlink(get_control_name(m_name).c_str());
+	}
+	m_is_producer = false;
+	munmap(m_header, m_mapped_bytes);
+	munmap(m_control, sizeof(Control));
+	m_header = nullptr;
+	m_data = nullptr;
+	m_mapped_bytes = 0;
+	m_control = nullptr;
+}
+
+/**
+ * Wait until the ring has room for new bytes
+ *
+ * @param[in] num_bytes amount of bytes to be published
+ * @param[in] timeout_mlsecs how long to wait
+ *
+ * @return true if there is room for num_bytes bytes
+ */
+bool SharedEntropyRing::wait_for_space(size_t num_bytes, int timeout_mlsecs) {
+	const uint64_t capacity = m_header->capacity;
+	chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::milliseconds(timeout_mlsecs);
+	while (true) {
+		if (get_release_pos() + capacity - m_header->write_pos.load() >= num_bytes) {
+			return true;
+		}
+		m_control->is_producer_waiting.store(1);
+		uint32_t seq = m_control->space_seq.load();
+		if (get_release_pos() + capacity - m_header->write_pos.load() >= num_bytes) {
+			m_control->is_producer_waiting.store(0);
+			return true;
+		}
+		int remaining_mlsecs = (int)chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now()).count();
+		if (remaining_mlsecs <= 0) {
+			m_control->is_producer_waiting.store(0);
+			return false;
+		}
+		futex_wait(&m_control->space_seq, seq, remaining_mlsecs < c_wait_timeout_mlsecs ? remaining_mlsecs : c_wait_timeout_mlsecs);
+		m_control->is_producer_waiting.store(0);
+		release_dead_readers();
+	}
+}
+
+/**
+ * Publish bytes to the readers, the caller waits for room with wait_for_space() first
+ *
+ * @param[in] in bytes to publish
+ * @param[in] num_bytes amount of bytes
+ *
+ * @return true when successful
+ */
+bool SharedEntropyRing::publish(const unsigned char *in, size_t num_bytes) {
+	const uint64_t capacity = m_header->capacity;
+	const uint64_t write_pos = m_header->write_pos.load(memory_order_relaxed);
+	if (get_release_pos() + capacity - write_pos < num_bytes) {
+		m_error_log_oss << "No room in ring " << m_name << " for " << num_bytes << " bytes. " << endl;
+		return false;
+	}
+	size_t offset = write_pos & (capacity - 1);
+	size_t first = num_bytes < capacity - offset ? num_bytes : capacity - offset;
+	memcpy(m_data + offset, in, first);
+	memcpy(m_data, in + first, num_bytes - first);
+	m_header->write_pos.store(write_pos + num_bytes);
+	if (m_control->reader_waiters.load() > 0) {
+		m_control->data_seq.fetch_add(1);
+		futex_wake(&m_control->data_seq, INT_MAX);
+	}
+	return true;
+}
+
+/**
+ * Claim and copy bytes from the ring, block while the ring is drained
+ *
+ * @param[out] out location for the bytes
+ * @param[in] num_bytes amount of bytes
+ *
+ * @return true when successful, false if the producer is gone
+ */
+bool SharedEntropyRing::read(unsigned char *out, size_t num_bytes) {
+	if (m_slot == nullptr) {
+		m_error_log_oss << "Ring is not attached as a reader. " << endl;
+		return false;
+	}
+	const size_t max_claim_bytes = m_header->capacity / 4;
+	while (num_bytes > 0) {
+		size_t claim_bytes = num_bytes < max_claim_bytes ? num_bytes : max_claim_bytes;
+		// Announce a position not after the claimed one, so the producer cannot overwrite the range
+		uint64_t announced_pos = m_control->claim_pos.load();
+		m_slot->busy_pos.store(announced_pos);
+		uint64_t pos = m_control->claim_pos.fetch_add(claim_bytes);
+		if (pos != announced_pos) {
+			m_slot->busy_pos.store(pos);
+		}
+		if (m_header->write_pos.load(memory_order_acquire) < pos + claim_bytes && !wait_for_data(pos + claim_bytes)) {
+			m_slot->busy_pos.store(c_idle_pos);
+			return false;
+		}
+		copy_out(pos, out, claim_bytes);
+		m_slot->busy_pos.store(c_idle_pos, memory_order_release);
+		m_slot->bytes_claimed.store(m_slot->bytes_claimed.load(memory_order_relaxed) + claim_bytes, memory_order_relaxed);
+		if (m_control->is_producer_waiting.load()) {
+			m_control->space_seq.fetch_add(1);
+			futex_wake(&m_control->space_seq, 1);
+		}
+		out += claim_bytes;
+		num_bytes -= claim_bytes;
+	}
+	return true;
+}
+
+bool SharedEntropyRing::wait_for_data(uint64_t end_pos) {
+	while (true) {
+		m_control->reader_waiters.fetch_add(1);
+		uint32_t seq = m_control->data_seq.load();
+		if (m_header->write_pos.load() >= end_pos) {
+			m_control->reader_waiters.fetch_sub(1);
+			return true;
+		}
+		if (m_header->is_closed.load() || !is_process_alive(m_header->producer_pid.load())) {
+			m_control->reader_waiters.fetch_sub(1);
+			m_error_log_oss << "Producer of ring " << m_name << " is gone. " << endl;
+			return false;
+		}
+		futex_wait(&m_control->data_seq, seq, c_wait_timeout_mlsecs);
+		m_control->reader_waiters.fetch_sub(1);
+	}
+}
+
+/**
+ * @return position of the first byte that may still be copied by a reader
+ */
+uint64_t SharedEntropyRing::get_release_pos() {
+	uint64_t release_pos = m_control->claim_pos.load();
+	for (const ReaderSlot &slot : m_control->slots) {
+		uint64_t busy_pos = slot.busy_pos.load();
+		if (busy_pos < release_pos) {
+			release_pos = busy_pos;
+		}
+	}
+	return release_pos;
+}
+
+void SharedEntropyRing::release_dead_readers() {
+	for (ReaderSlot &slot : m_control->slots) {
+		int32_t pid = slot.pid.load();
+		if (pid != 0 && !is_process_alive(pid)) {
+			slot.busy_pos.store(c_idle_pos);
+			slot.pid.compare_exchange_strong(pid, 0);
+		}
+	}
+}
+
+void SharedEntropyRing::copy_out(uint64_t pos, unsigned char *out, size_t num_bytes) const {
+	const uint64_t capacity = m_header->capacity;
+	size_t offset = pos & (capacity - 1);
+	size_t first = num_bytes < capacity - offset ? num_bytes : capacity - offset;
+	memcpy(out, m_data + offset, first);
+	memcpy(out + first, m_data, num_bytes - first);
+}
+
+/**
+ * @return amount of published and claimed bytes, bytes waiting in the ring and registered readers
+ */
+RingStatistics SharedEntropyRing::get_statistics() const {
+	RingStatistics stats {};
+	if (m_header == nullptr) {
+		return stats;
+	}
+	stats.bytes_published = m_header->write_pos.load();
+	stats.bytes_claimed = m_control->claim_pos.load();
+	stats.level_bytes = stats.bytes_claimed < stats.bytes_published ? stats.bytes_published - stats.bytes_claimed : 0;
+	for (const ReaderSlot &slot : m_control->slots) {
+		if (slot.pid.load() != 0) {
+			stats.reader_count++;
+		}
+	}
+	return stats;
+}
+
+bool SharedEntropyRing::is_process_alive(int32_t pid) {
+	return kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+size_t SharedEntropyRing::get_header_size() {
+	return (sizeof(Header) + 4095) & ~(size_t)4095;
+}
+
+/**
+ * @return name of the shared memory object with the reader slots of ring name
+ */
+string SharedEntropyRing::get_control_name(const string &name) {
+	return name + ".ctl";
+}
+
+SharedEntropyRing::~SharedEntropyRing() {
+	detach();
+}
+
+} /* namespace alpharng */
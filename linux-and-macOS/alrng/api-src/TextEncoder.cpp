@@ -0,0 +1,434 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements hex, base64, base64url and base32 text encoders for random bytes.
+ SSSE3 and AVX2 implementations are selected at run time when supported by the CPU.
+
+ */
+
+/**
+ *    @file TextEncoder.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements vectorized text encoders for random bytes.
+ */
+
+#include <TextEncoder.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ALPHARNG_X86_SIMD
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace alpharng {
+
+static const char c_hex_digits[] = "0123456789abcdef";
+static const char c_base64_digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char c_base64url_digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+static const char c_base32_digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+
+/*
+ * Scalar encoders, process whole groups only
+ */
+
+static void encode_hex_scalar(const unsigned char *in, int in_length, char *out) {
+	for (int i = 0; i < in_length; i++) {
+		out[2 * i] = c_hex_digits[in[i] >> 4];
+		out[2 * i + 1] = c_hex_digits[in[i] & 0x0f];
+	}
+}
+
+static void encode_base64_scalar(const unsigned char *in, int in_length, char *out, const char *digits) {
+	for (int i = 0; i + 3 <= in_length; i += 3, out += 4) {
+		uint32_t v = ((uint32_t)in[i] << 16) | ((uint32_t)in[i + 1] << 8) | in[i + 2];
+		out[0] = digits[(v >> 18) & 0x3f];
+		out[1] = digits[(v >> 12) & 0x3f];
+		out[2] = digits[(v >> 6) & 0x3f];
+		out[3] = digits[v & 0x3f];
+	}
+}
+
+static void encode_base32_scalar(const unsigned char *in, int in_length, char *out) {
+	for (int i = 0; i + 5 <= in_length; i += 5, out += 8) {
+		uint64_t v = ((uint64_t)in[i] << 32) | ((uint64_t)in[i + 1] << 24) | ((uint64_t)in[i + 2] << 16)
+				| ((uint64_t)in[i + 3] << 8) | in[i + 4];
+		for (int k = 0; k < 8; k++) {
+			out[k] = c_base32_digits[(v >> (35 - 5 * k)) & 0x1f];
+		}
+	}
+}
+
+#ifdef ALPHARNG_X86_SIMD
+
+/*
+ * SIMD encoders, each returns the amount of input bytes processed, always a multiple of the group size.
+ * The remaining input is processed by the scalar encoders.
+ */
+
+__attribute__((target("ssse3")))
+static int encode_hex_ssse3(const unsigned char *in, int in_length, char *out) {
+	const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+	const __m128i nibble_mask = _mm_set1_epi8(0x0f);
+	int i = 0;
+	for (; i + 16 <= in_length; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+		__m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), nibble_mask));
+		__m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, nibble_mask));
+		_mm_storeu_si128((__m128i*)(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i*)(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+	return i;
+}
+
+__attribute__((target("avx2")))
+static int encode_hex_avx2(const unsigned char *in, int in_length, char *out) {
+	const __m256i lut = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+			'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+	const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+	int i = 0;
+	for (; i + 32 <= in_length; i += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i*)(in + i));
+		__m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble_mask));
+		__m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, nibble_mask));
+		// Unpack works within 128-bit lanes, restore the byte order across lanes
+		__m256i first = _mm256_unpacklo_epi8(hi, lo);
+		__m256i second = _mm256_unpackhi_epi8(hi, lo);
+		_mm256_storeu_si256((__m256i*)(out + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+		_mm256_storeu_si256((__m256i*)(out + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+	}
+	return i;
+}
+
+/*
+ * Base64 encoding as described by W. Mula and D. Lemire, "Faster Base64 Encoding and Decoding Using AVX2 Instructions".
+ * Each 32-bit word receives 3 input bytes, the four 6-bit fields are moved into separate bytes with multiplications
+ * and translated to ASCII with a 16 entry lookup table.
+ */
+
+__attribute__((target("ssse3")))
+static __m128i base64_translate_ssse3(__m128i indices, bool is_url) {
+	const __m128i lut = is_url
+			? _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -17, 32, 0, 0)
+			: _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+	__m128i lut_idx = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+	lut_idx = _mm_sub_epi8(lut_idx, _mm_cmpgt_epi8(indices, _mm_set1_epi8(25)));
+	return _mm_add_epi8(indices, _mm_shuffle_epi8(lut, lut_idx));
+}
+
+__attribute__((target("ssse3")))
+static int encode_base64_ssse3(const unsigned char *in, int in_length, char *out, bool is_url) {
+	const __m128i shuffle = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+	int i = 0;
+	int o = 0;
+	// Loads 16 bytes, encodes 12 of those
+	for (; i + 16 <= in_length; i += 12, o += 16) {
+		__m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(in + i)), shuffle);
+		__m128i t0 = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+		__m128i t1 = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+		_mm_storeu_si128((__m128i*)(out + o), base64_translate_ssse3(_mm_or_si128(t0, t1), is_url));
+	}
+	return i;
+}
+
+__attribute__((target("avx2")))
+static int encode_base64_avx2(const unsigned char *in, int in_length, char *out, bool is_url) {
+	const __m256i shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+			1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+	const __m256i lut = is_url
+			? _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -17, 32, 0, 0,
+					65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -17, 32, 0, 0)
+			: _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+					65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+	int i = 0;
+	int o = 0;
+	// Each 128-bit lane encodes 12 bytes, the second lane reads up to 28 bytes ahead
+	for (; i + 28 <= in_length; i += 24, o += 32) {
+		__m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(in + i))),
+				_mm_loadu_si128((const __m128i*)(in + i + 12)), 1);
+		v = _mm256_shuffle_epi8(v, shuffle);
+		__m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+		__m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+		__m256i indices = _mm256_or_si256(t0, t1);
+		__m256i lut_idx = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+		lut_idx = _mm256_sub_epi8(lut_idx, _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)));
+		_mm256_storeu_si256((__m256i*)(out + o), _mm256_add_epi8(indices, _mm256_shuffle_epi8(lut, lut_idx)));
+	}
+	return i;
+}
+
+/*
+ * Base32 encoding: each of the eight 5-bit fields of a 5 byte group is loaded into a 16-bit word
+ * together with the following byte, shifted into place with an unsigned multiplication
+ * and translated to ASCII.
+ */
+
+__attribute__((target("ssse3")))
+static int encode_base32_ssse3(const unsigned char *in, int in_length, char *out) {
+	const __m128i shuffle_first = _mm_setr_epi8(1, 0, 1, 0, 2, 1, 2, 1, 3, 2, 4, 3, 4, 3, 5, 4);
+	const __m128i shuffle_second = _mm_setr_epi8(6, 5, 6, 5, 7, 6, 7, 6, 8, 7, 9, 8, 9, 8, 10, 9);
+	// Multiplying by 2^(16 - n) and keeping the high word shifts right by n bits
+	const __m128i shifts = _mm_setr_epi16(1 << 5, 1 << 10, 1 << 7, 1 << 12, 1 << 9, 1 << 6, 1 << 11, 1 << 8);
+	const __m128i field_mask = _mm_set1_epi16(0x1f);
+	int i = 0;
+	int o = 0;
+	// Loads 16 bytes, encodes 10 of those
+	for (; i + 16 <= in_length; i += 10, o += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+		__m128i first = _mm_and_si128(_mm_mulhi_epu16(_mm_shuffle_epi8(v, shuffle_first), shifts), field_mask);
+		__m128i second = _mm_and_si128(_mm_mulhi_epu16(_mm_shuffle_epi8(v, shuffle_second), shifts), field_mask);
+		__m128i indices = _mm_packus_epi16(first, second);
+		__m128i digits = _mm_add_epi8(indices, _mm_set1_epi8('A'));
+		// '2' follows 'Z' in the base32 alphabet
+		digits = _mm_sub_epi8(digits, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(25)), _mm_set1_epi8('A' + 26 - '2')));
+		_mm_storeu_si128((__m128i*)(out + o), digits);
+	}
+	return i;
+}
+
+__attribute__((target("avx2")))
+static int encode_base32_avx2(const unsigned char *in, int in_length, char *out) {
+	const __m256i shuffle_first = _mm256_setr_epi8(1, 0, 1, 0, 2, 1, 2, 1, 3, 2, 4, 3, 4, 3, 5, 4,
+			1, 0, 1, 0, 2, 1, 2, 1, 3, 2, 4, 3, 4, 3, 5, 4);
+	const __m256i shuffle_second = _mm256_setr_epi8(6, 5, 6, 5, 7, 6, 7, 6, 8, 7, 9, 8, 9, 8, 10, 9,
+			6, 5, 6, 5, 7, 6, 7, 6, 8, 7, 9, 8, 9, 8, 10, 9);
+	const __m256i shifts = _mm256_setr_epi16(1 << 5, 1 << 10, 1 << 7, 1 << 12, 1 << 9, 1 << 6, 1 << 11, 1 << 8,
+			1 << 5, 1 << 10, 1 << 7, 1 << 12, 1 << 9, 1 << 6, 1 << 11, 1 << 8);
+	const __m256i field_mask = _mm256_set1_epi16(0x1f);
+	int i = 0;
+	int o = 0;
+	// Each 128-bit lane encodes 10 bytes, the second lane reads up to 26 bytes ahead
+	for (; i + 26 <= in_length; i += 20, o += 32) {
+		__m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(in + i))),
+				_mm_loadu_si128((const __m128i*)(in + i + 10)), 1);
+		__m256i first = _mm256_and_si256(_mm256_mulhi_epu16(_mm256_shuffle_epi8(v, shuffle_first), shifts), field_mask);
+		__m256i second = _mm256_and_si256(_mm256_mulhi_epu16(_mm256_shuffle_epi8(v, shuffle_second), shifts), field_mask);
+		__m256i indices = _mm256_packus_epi16(first, second);
+		__m256i digits = _mm256_add_epi8(indices, _mm256_set1_epi8('A'));
+		digits = _mm256_sub_epi8(digits, _mm256_and_si256(_mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)),
+				_mm256_set1_epi8('A' + 26 - '2')));
+		_mm256_storeu_si256((__m256i*)(out + o), digits);
+	}
+	return i;
+}
+
+#endif /* ALPHARNG_X86_SIMD */
+
+/**
+ * @param[in] e_encoding output encoding
+ * @param[in] is_simd_enabled false to always use the scalar implementation
+ */
+TextEncoder::TextEncoder(OutputEncoding e_encoding, bool is_simd_enabled) : m_e_encoding(e_encoding) {
+	switch (m_e_encoding) {
+	case OutputEncoding::hex:
+		m_in_group_bytes = 1;
+		m_out_group_bytes = 2;
+		break;
+	case OutputEncoding::base64:
+	case OutputEncoding::base64url:
+		m_in_group_bytes = 3;
+		m_out_group_bytes = 4;
+		break;
+	case OutputEncoding::base32:
+		m_in_group_bytes = 5;
+		m_out_group_bytes = 8;
+		break;
+	default:
+		m_in_group_bytes = 1;
+		m_out_group_bytes = 1;
+		break;
+	}
+	m_e_simd_level = is_simd_enabled ? detect_simd_level() : SimdLevel::scalar;
+}
+
+TextEncoder::SimdLevel TextEncoder::detect_simd_level() {
+#ifdef ALPHARNG_X86_SIMD
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return SimdLevel::avx2;
+	}
+	if (__builtin_cpu_supports("ssse3")) {
+		return SimdLevel::ssse3;
+	}
+#endif
+	return SimdLevel::scalar;
+}
+
+/**
+ * @return name of the implementation in use: avx2, ssse3 or scalar
+ */
+const char* TextEncoder::get_implementation_name() const {
+	switch (m_e_simd_level) {
+	case SimdLevel::avx2:
+		return "avx2";
+	case SimdLevel::ssse3:
+		return "ssse3";
+	default:
+		return "scalar";
+	}
+}
+
+/**
+ * Convert an encoding name to an encoding type
+ *
+ * @param[in] name hex, base64, base64url, base32 or none
+ * @param[out] e_encoding encoding type
+ *
+ * @return true if the name is valid
+ */
+bool TextEncoder::parse_encoding(const string &name, OutputEncoding &e_encoding) {
+	if (name == "hex") {
+		e_encoding = OutputEncoding::hex;
+	} else if (name == "base64") {
+		e_encoding = OutputEncoding::base64;
+	} else if (name == "base64url") {
+		e_encoding = OutputEncoding::base64url;
+	} else if (name == "base32") {
+		e_encoding = OutputEncoding::base32;
+	} else if (name == "none") {
+		e_encoding = OutputEncoding::none;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Calculate the encoded size. Base64 and base32 output is padded with '=' at the end of the stream,
+ * base64url output is not padded.
+ *
+ * @param[in] num_bytes amount of bytes to encode
+ * @param[in] is_final true if these are the last bytes of the stream
+ *
+ * @return amount of encoded characters
+ */
+int64_t TextEncoder::get_encoded_size(int64_t num_bytes, bool is_final) const {
+	int64_t groups = num_bytes / m_in_group_bytes;
+	int64_t remainder = num_bytes % m_in_group_bytes;
+	int64_t size = groups * m_out_group_bytes;
+	if (is_final && remainder > 0) {
+		if (m_e_encoding == OutputEncoding::base64url) {
+			size += remainder + 1;
+		} else {
+			size += m_out_group_bytes;
+		}
+	}
+	return size;
+}
+
+/**
+ * Encode bytes into text. Unless is_final is set, in_length must be a multiple of the input group size.
+ *
+ * @param[in] in bytes to encode
+ * @param[in] in_length amount of bytes to encode
+ * @param[out] out destination for get_encoded_size(in_length, is_final) characters, not null terminated
+ * @param[in] is_final true if these are the last bytes of the stream
+ *
+ * @return amount of characters written
+ */
+int TextEncoder::encode(const unsigned char *in, int in_length, char *out, bool is_final) const {
+	int whole_bytes = in_length - in_length % m_in_group_bytes;
+	int out_length = encode_groups(in, whole_bytes, out);
+	if (is_final && whole_bytes < in_length) {
+		out_length += encode_tail(in + whole_bytes, in_length - whole_bytes, out + out_length);
+	}
+	return out_length;
+}
+
+int TextEncoder::encode_groups(const unsigned char *in, int in_length, char *out) const {
+	int done = 0;
+#ifdef ALPHARNG_X86_SIMD
+	const bool is_url = m_e_encoding == OutputEncoding::base64url;
+	if (m_e_simd_level == SimdLevel::avx2) {
+		switch (m_e_encoding) {
+		case OutputEncoding::hex:
+			done = encode_hex_avx2(in, in_length, out);
+			break;
+		case OutputEncoding::base64:
+		case OutputEncoding::base64url:
+			done = encode_base64_avx2(in, in_length, out, is_url);
+			break;
+		case OutputEncoding::base32:
+			done = encode_base32_avx2(in, in_length, out);
+			break;
+		default:
+			break;
+		}
+	}
+	if (m_e_simd_level != SimdLevel::scalar) {
+		// SSSE3 also handles the input left over by AVX2
+		char *ssse3_out = out + done / m_in_group_bytes * m_out_group_bytes;
+		switch (m_e_encoding) {
+		case OutputEncoding::hex:
+			done += encode_hex_ssse3(in + done, in_length - done, ssse3_out);
+			break;
+		case OutputEncoding::base64:
+		case OutputEncoding::base64url:
+			done += encode_base64_ssse3(in + done, in_length - done, ssse3_out, is_url);
+			break;
+		case OutputEncoding::base32:
+			done += encode_base32_ssse3(in + done, in_length - done, ssse3_out);
+			break;
+		default:
+			break;
+		}
+	}
+#endif
+	char *scalar_out = out + done / m_in_group_bytes * m_out_group_bytes;
+	switch (m_e_encoding) {
+	case OutputEncoding::hex:
+		encode_hex_scalar(in + done, in_length - done, scalar_out);
+		break;
+	case OutputEncoding::base64:
+		encode_base64_scalar(in + done, in_length - done, scalar_out, c_base64_digits);
+		break;
+	case OutputEncoding::base64url:
+		encode_base64_scalar(in + done, in_length - done, scalar_out, c_base64url_digits);
+		break;
+	case OutputEncoding::base32:
+		encode_base32_scalar(in + done, in_length - done, scalar_out);
+		break;
+	default:
+		for (int i = done; i < in_length; i++) {
+			scalar_out[i - done] = (char)in[i];
+		}
+		break;
+	}
+	return in_length / m_in_group_bytes * m_out_group_bytes;
+}
+
+int TextEncoder::encode_tail(const unsigned char *in, int in_length, char *out) const {
+	unsigned char group[5] = {0, 0, 0, 0, 0};
+	for (int i = 0; i < in_length; i++) {
+		group[i] = in[i];
+	}
+	char encoded[8];
+	int digits;
+	if (m_e_encoding == OutputEncoding::base32) {
+		encode_base32_scalar(group, 5, encoded);
+		// 8 bits per byte, 5 bits per digit
+		digits = (in_length * 8 + 4) / 5;
+	} else {
+		encode_base64_scalar(group, 3, encoded,
+				m_e_encoding == OutputEncoding::base64url ? c_base64url_digits : c_base64_digits);
+		digits = in_length + 1;
+	}
+	int out_length = digits;
+	if (m_e_encoding != OutputEncoding::base64url) {
+		out_length = m_out_group_bytes;
+	}
+	for (int i = 0; i < out_length; i++) {
+		out[i] = i < digits ? encoded[i] : '=';
+	}
+	return out_length;
+}
+
+} /* namespace alpharng */
@@ -0,0 +1,147 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a token bucket used for pacing device requests to a steady rate.
+
+ */
+
+/**
+ *    @file TokenBucket.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.1
+ *
+ *    @brief Implements a token bucket for pacing device requests.
+ */
+
+#include <TokenBucket.h>
+
+#include <thread>
+#include <cmath>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace alpharng {
+
+/**
+ * Set the pacing rate
+ *
+ * @param[in] rate_bytes_per_sec amount of bytes per second, 0 - disable pacing
+ * @param[in] capacity_bytes largest amount of bytes that can be acquired without waiting (burst size)
+ */
+void TokenBucket::configure(int64_t rate_bytes_per_sec, int64_t capacity_bytes) {
+	m_rate_bytes_per_sec = rate_bytes_per_sec;
+	m_capacity_bytes = capacity_bytes;
+	reset();
+}
+
+/**
+ * Fill the bucket and restart the statistics
+ */
+void TokenBucket::reset() {
+	m_tokens = (double)m_capacity_bytes;
+	m_start_time = steady_clock::now();
+	m_last_refill_time = m_start_time;
+	m_last_request_time = m_start_time;
+	m_last_request_bytes = 0;
+	m_total_bytes = 0;
+	m_request_count = 0;
+	m_total_jitter_mlsecs = 0;
+	m_max_jitter_mlsecs = 0;
+}
+
+void TokenBucket::refill(steady_clock::time_point now) {
+	double elapsed_secs = duration<double>(now - m_last_refill_time).count();
+	m_tokens += elapsed_secs * (double)m_rate_bytes_per_sec;
+	if (m_tokens > (double)m_capacity_bytes) {
+		m_tokens = (double)m_capacity_bytes;
+	}
+	m_last_refill_time = now;
+}
+
+/**
+ * Wait until the requested amount of bytes can be retrieved at the configured rate.
+ * Returns immediately when pacing is disabled.
+ *
+ * @param[in] num_bytes amount of bytes about to be retrieved
+ */
+void TokenBucket::acquire(int64_t num_bytes) {
+	if (!is_enabled()) {
+		return;
+	}
+	steady_clock::time_point now = steady_clock::now();
+	refill(now);
+	if (m_tokens < (double)num_bytes) {
+		double wait_secs = ((double)num_bytes - m_tokens) / (double)m_rate_bytes_per_sec;
+		this_thread::sleep_until(now + duration_cast<steady_clock::duration>(duration<double>(wait_secs)));
+		now = steady_clock::now();
+		refill(now);
+	}
+	// A request larger than the bucket capacity is allowed once enough time has passed
+	m_tokens -= (double)num_bytes;
+
+	if (m_request_count > 0) {
+		double interval_mlsecs = duration<double, milli>(now - m_last_request_time).count();
+		double nominal_mlsecs = (double)m_last_request_bytes * 1000.0 / (double)m_rate_bytes_per_sec;
+		double jitter_mlsecs = fabs(interval_mlsecs - nominal_mlsecs);
+		m_total_jitter_mlsecs += jitter_mlsecs;
+		if (jitter_mlsecs > m_max_jitter_mlsecs) {
+			m_max_jitter_mlsecs = jitter_mlsecs;
+		}
+	}
+	m_last_request_time = now;
+	m_last_request_bytes = num_bytes;
+	m_total_bytes += num_bytes;
+	m_request_count++;
+}
+
+/**
+ * Acquire as many of the requested bytes as available without waiting, used by event loops.
+ * Returns the requested amount when pacing is disabled.
+ *
+ * @param[in] num_bytes amount of bytes about to be retrieved
+ * @param[out] wait_secs time until more bytes become available when none were acquired
+ *
+ * @return amount of bytes acquired
+ */
+int64_t TokenBucket::try_acquire(int64_t num_bytes, double *wait_secs) {
+	*wait_secs = 0;
+	if (!is_enabled()) {
+		return num_bytes;
+	}
+	refill(steady_clock::now());
+	int64_t available = (int64_t)m_tokens;
+	if (available <= 0) {
+		// Wait for a reasonable amount of bytes instead of a single one
+		int64_t wanted = num_bytes < m_capacity_bytes ? num_bytes : m_capacity_bytes;
+		*wait_secs = ((double)wanted - m_tokens) / (double)m_rate_bytes_per_sec;
+		return 0;
+	}
+	int64_t acquired = num_bytes < available ? num_bytes : available;
+	m_tokens -= (double)acquired;
+	m_total_bytes += acquired;
+	m_request_count++;
+	return acquired;
+}
+
+/**
+ * @return achieved rate and jitter since the last reset
+ */
+PacingStatistics TokenBucket::get_statistics() const {
+	PacingStatistics stats;
+	stats.total_bytes = m_total_bytes;
+	stats.request_count = m_request_count;
+	stats.elapsed_secs = duration<double>(steady_clock::now() - m_start_time).count();
+	stats.achieved_rate_bytes_sec = stats.elapsed_secs > 0 ? (double)m_total_bytes / stats.elapsed_secs : 0;
+	stats.mean_jitter_mlsecs = m_request_count > 1 ? m_total_jitter_mlsecs / (double)(m_request_count - 1) : 0;
+	stats.max_jitter_mlsecs = m_max_jitter_mlsecs;
+	return stats;
+}
+
+} /* namespace alpharng */
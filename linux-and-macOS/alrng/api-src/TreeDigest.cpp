@@ -0,0 +1,302 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This class may only be used in conjunction with TectroLabs devices.
+
+ This class implements a SHA-256 Merkle tree digest used for verifying the integrity of files
+ with bytes downloaded from an AlphaRNG device.
+
+ */
+
+/**
+ *    @file TreeDigest.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 1.0
+ *
+ *    @brief Implements a SHA-256 Merkle tree digest with a sidecar file and parallel verification.
+ */
+
+#include <TreeDigest.h>
+#include <Sha256.h>
+
+#include <fstream>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+using namespace std;
+
+namespace alpharng {
+
+const char * const TreeDigest::c_sidecar_suffix = ".sha256tree";
+
+/**
+ * Hash one leaf
+ *
+ * @param[in,out] prefixed_leaf leaf bytes preceded by one spare byte that receives the leaf prefix
+ * @param[in] leaf_bytes amount of leaf bytes, not counting the prefix
+ * @param[out] out leaf hash
+ *
+ * @return true for successful operation
+ */
+bool TreeDigest::hash_leaf(unsigned char *prefixed_leaf, int leaf_bytes, DigestValue &out) {
+	Sha256 sha;
+	prefixed_leaf[0] = 0x00;
+	return sha.hash(prefixed_leaf, leaf_bytes + 1, out.data());
+}
+
+/**
+ * Compute the Merkle root out of the leaf hashes
+ *
+ * @param[in] leaves leaf hashes in stream order
+ * @param[out] root root hash
+ *
+ * @return true for successful operation
+ */
+bool TreeDigest::compute_root(const vector<DigestValue> &leaves, DigestValue &root) {
+	if (leaves.empty()) {
+		return false;
+	}
+	Sha256 sha;
+	unsigned char node[1 + 2 * sizeof(DigestValue)];
+	node[0] = 0x01;
+	vector<DigestValue> level = leaves;
+	while (level.size() > 1) {
+		vector<DigestValue> next;
+		next.reserve((level.size() + 1) / 2);
+		for (size_t i = 0; i < level.size(); i += 2) {
+			if (i + 1 == level.size()) {
+				next.push_back(level[i]);
+				break;
+			}
+			memcpy(node + 1, level[i].data(), level[i].size());
+			memcpy(node + 1 + level[i].size(), level[i + 1].data(), level[i + 1].size());
+			DigestValue parent;
+			if (!sha.hash(node, sizeof(node), parent.data())) {
+				return false;
+			}
+			next.push_back(parent);
+		}
+		level.swap(next);
+	}
+	root = level[0];
+	return true;
+}
+
+string TreeDigest::to_hex(const DigestValue &value) {
+	static const char digits[] = "0123456789abcdef";
+	string hex;
+	hex.reserve(value.size() * 2);
+	for (unsigned char c : value) {
+		hex.push_back(digits[c >> 4]);
+		hex.push_back(digits[c & 0x0f]);
+	}
+	return hex;
+}
+
+bool TreeDigest::from_hex(const string &hex, DigestValue &value) {
+	if (hex.size() != value.size() * 2) {
+		return false;
+	}
+	for (size_t i = 0; i < value.size(); i++) {
+		int v = 0;
+		for (int k = 0; k < 2; k++) {
+			char c = hex[2 * i + k];
+			v <<= 4;
+			if (c >= '0' && c <= '9') {
+				v |= c - '0';
+			} else if (c >= 'a' && c <= 'f') {
+				v |= c - 'a' + 10;
+			} else {
+				return false;
+			}
+		}
+		value[i] = (unsigned char)v;
+	}
+	return true;
+}
+
+/**
+ * @return amount of hashing threads to use, up to 4
+ */
+int TreeDigest::get_default_thread_count() {
+	int count = (int)thread::hardware_concurrency();
+	if (count < 1) {
+		count = 1;
+	}
+	return count > 4 ? 4 : count;
+}
+
+/**
+ * Store the tree digest into a text sidecar file
+ *
+ * @return true for successful operation
+ */
+bool TreeDigest::write_sidecar(const string &sidecar_path, int64_t total_bytes, const vector<DigestValue> &leaves,
+		const DigestValue &root) {
+	ofstream os(sidecar_path.c_str(), ios::out | ios::trunc);
+	if (!os.good()) {
+		m_error_log_oss << "Could not open digest file: " << sidecar_path << ". " << endl;
+		return false;
+	}
+	os << "algorithm: sha256-merkle" << endl;
+	os << "leaf-size: " << c_leaf_size_bytes << endl;
+	os << "size: " << total_bytes << endl;
+	os << "leaves: " << leaves.size() << endl;
+	os << "root: " << to_hex(root) << endl;
+	for (size_t i = 0; i < leaves.size(); i++) {
+		os << "leaf: " << to_hex(leaves[i]) << endl;
+	}
+	os.close();
+	if (!os.good()) {
+		m_error_log_oss << "Could not write digest file: " << sidecar_path << ". " << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Load the tree digest from a sidecar file
+ *
+ * @return true for successful operation
+ */
+bool TreeDigest::read_sidecar(const string &sidecar_path, int64_t &total_bytes, vector<DigestValue> &leaves,
+		DigestValue &root) {
+	ifstream is(sidecar_path.c_str());
+	if (!is.good()) {
+		m_error_log_oss << "Could not open digest file: " << sidecar_path << ". " << endl;
+		return false;
+	}
+	leaves.clear();
+	total_bytes = -1;
+	int64_t leaf_count = -1;
+	bool is_root_found = false;
+	string line;
+	while (getline(is, line)) {
+		size_t pos = line.find(": ");
+		if (pos == string::npos) {
+			continue;
+		}
+		string key = line.substr(0, pos);
+		string value = line.substr(pos + 2);
+		if (key == "algorithm" && value != "sha256-merkle") {
+			m_error_log_oss << "Unsupported digest algorithm: " << value << ". " << endl;
+			return false;
+		} else if (key == "leaf-size" && atoll(value.c_str()) != c_leaf_size_bytes) {
+			m_error_log_oss << "Unsupported leaf size: " << value << ". " << endl;
+			return false;
+		} else if (key == "size") {
+			total_bytes = atoll(value.c_str());
+		} else if (key == "leaves") {
+			leaf_count = atoll(value.c_str());
+		} else if (key == "root") {
+			is_root_found = from_hex(value, root);
+		} else if (key == "leaf") {
+			DigestValue leaf;
+			if (!from_hex(value, leaf)) {
+				m_error_log_oss << "Invalid leaf hash in digest file: " << sidecar_path << ". " << endl;
+				return false;
+			}
+			leaves.push_back(leaf);
+		}
+	}
+	if (total_bytes < 0 || !is_root_found || leaf_count != (int64_t)leaves.size()) {
+		m_error_log_oss << "Incomplete digest file: " << sidecar_path << ". " << endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Verify a file against its sidecar digest file, hashing leaves in parallel
+ *
+ * @param[in] file_path_name file to verify, the digest is read from file_path_name + c_sidecar_suffix
+ * @param[in] num_threads amount of hashing threads
+ *
+ * @return true if the file matches the digest
+ */
+bool TreeDigest::verify_file(const string &file_path_name, int num_threads) {
+	int64_t total_bytes;
+	vector<DigestValue> expected_leaves;
+	DigestValue expected_root;
+	if (!read_sidecar(file_path_name + c_sidecar_suffix, total_bytes, expected_leaves, expected_root)) {
+		return false;
+	}
+	ifstream is(file_path_name.c_str(), ios::in | ios::binary | ios::ate);
+	if (!is.good()) {
+		m_error_log_oss << "Could not open file: " << file_path_name << ". " << endl;
+		return false;
+	}
+	int64_t file_bytes = (int64_t)is.tellg();
+	is.close();
+	if (file_bytes != total_bytes) {
+		m_error_log_oss << "File size " << file_bytes << " does not match the digest size " << total_bytes << ". " << endl;
+		return false;
+	}
+	int64_t leaf_count = total_bytes == 0 ? 1 : (total_bytes + c_leaf_size_bytes - 1) / c_leaf_size_bytes;
+	if (leaf_count != (int64_t)expected_leaves.size()) {
+		m_error_log_oss << "Leaf count " << expected_leaves.size() << " does not match the file size. " << endl;
+		return false;
+	}
+
+	if (num_threads < 1) {
+		num_threads = 1;
+	}
+	vector<DigestValue> leaves((size_t)leaf_count);
+	vector<thread> workers;
+	unique_ptr<bool[]> errors(new bool[num_threads]());
+	for (int t = 0; t < num_threads; t++) {
+		workers.push_back(thread(verify_leaves, file_path_name, total_bytes, t, num_threads, &leaves, &errors[t]));
+	}
+	for (auto &worker : workers) {
+		worker.join();
+	}
+	for (int t = 0; t < num_threads; t++) {
+		if (errors[t]) {
+			m_error_log_oss << "Could not read or hash file: " << file_path_name << ". " << endl;
+			return false;
+		}
+	}
+
+	for (size_t i = 0; i < leaves.size(); i++) {
+		if (leaves[i] != expected_leaves[i]) {
+			m_error_log_oss << "Digest mismatch in leaf " << i << ", bytes " << (int64_t)i * c_leaf_size_bytes
+					<< " to " << ((int64_t)i + 1) * c_leaf_size_bytes - 1 << ". " << endl;
+			return false;
+		}
+	}
+	DigestValue root;
+	if (!compute_root(leaves, root) || root != expected_root) {
+		m_error_log_oss << "Root digest mismatch. " << endl;
+		return false;
+	}
+	return true;
+}
+
+void TreeDigest::verify_leaves(const string &file_path_name, int64_t total_bytes, int first_leaf, int leaf_step,
+		vector<DigestValue> *leaves, bool *is_error) {
+	unique_ptr<unsigned char[]> buffer(new (nothrow) unsigned char[c_leaf_size_bytes + 1]);
+	ifstream is(file_path_name.c_str(), ios::in | ios::binary);
+	if (!buffer || !is.good()) {
+		*is_error = true;
+		return;
+	}
+	for (size_t i = (size_t)first_leaf; i < leaves->size(); i += (size_t)leaf_step) {
+		int64_t offset = (int64_t)i * c_leaf_size_bytes;
+		int64_t leaf_bytes = total_bytes - offset < c_leaf_size_bytes ? total_bytes - offset : c_leaf_size_bytes;
+		is.seekg(offset);
+		is.read((char*)buffer.get() + 1, leaf_bytes);
+		if (is.gcount() != leaf_bytes || !hash_leaf(buffer.get(), (int)leaf_bytes, (*leaves)[i])) {
+			*is_error = true;
+			return;
+		}
+	}
+}
+
+} /* namespace alpharng */
@@ -0,0 +1,565 @@
+/**
+ Copyright (C) 2014-2026 TectroLabs L.L.C. https://tectrolabs.com
+
+ THIS SOFTWARE IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESSED OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+
+ This program may only be used in conjunction with TectroLabs devices.
+
+ This program is used for interacting with the hardware random data generator device AlphaRNG for the purpose of
+ downloading and distributing true random bytes using a Unix domain socket on Linux.
+
+ It uses OpenSSL library.
+
+ */
+
+/**
+ *    @file entropy-server.cpp
+ *    @date 10/17/2026
+ *    @Author: Andrian Belinski
+ *    @version 2.1
+ *
+ *    @brief A Unix domain socket service for distributing true random bytes generated by an AlphaRNG device
+ */
+
+#include <AlphaRngApi.h>
+#include <AppArguments.h>
+#include <EntropyServer.h>
+#include <iomanip>
+#include <memory>
+
+using namespace std;
+using namespace alpharng;
+
+/**
+* Valid command line arguments
+*/
+AppArguments appArgs({
+	{"-d", ArgDef::requireArgument},
+	{"-e", ArgDef::noArgument},
+	{"-h", ArgDef::noArgument},
+	{"-m", ArgDef::requireArgument},
+	{"-k", ArgDef::requireArgument},
+	{"-c", ArgDef::requireArgument},
+	{"-p", ArgDef::requireArgument},
+	{"-i", ArgDef::requireArgument},
+	{"-E", ArgDef::requireArgument},
+	{"-S", ArgDef::requireArgument},
+	{"-Sg", ArgDef::requireArgument},
+	{"-C", ArgDef::requireArgument},
+	{"-rate", ArgDef::requireArgument},
+	{"-hw", ArgDef::requireArgument},
+	{"-lw", ArgDef::requireArgument},
+	{"-metrics", ArgDef::requireArgument},
+	{"-tcp", ArgDef::requireArgument},
+	{"-psk", ArgDef::requireArgument},
+	{"-seed", ArgDef::requireArgument},
+	{"-dt", ArgDef::noArgument},
+	{"-th", ArgDef::requireArgument},
+	{"-le", ArgDef::noArgument},
+	{"-ttl", ArgDef::requireArgument}
+});
+
+/**
+* Current version of this application
+*/
+static double const version = 2.1;
+
+static bool extract_command(Cmd &cmd, RngConfig &cfg, const int argc, const char **argv);
+static bool validate_comand(const Cmd &cmd);
+static void display_help();
+
+/**
+ * Application entry point
+ * @param[in] argc number of arguments provided in command line
+ * @param[in] argv points to the location with command line parameters
+ *
+ * @return 0 if command and options extracted successfully
+ */
+int main(const int argc, const char **argv) {
+
+	RngConfig cfg;
+	Cmd cmd;
+	if (!extract_command(cmd, cfg, argc, argv)) {
+		return -1;
+	}
+
+	if (!validate_comand(cmd)) {
+		return -1;
+	}
+
+	if (cfg.key_file.size() > 0) {
+		RsaCryptor rsa(cfg.key_file, true);
+		if (!rsa.is_initialized()) {
+			cerr << "Could not load the RSA public key file: " << cfg.key_file << endl;
+			return -1;
+		}
+	}
+
+	if (cmd.cmd_type == CmdOpt::getHelp) {
+		display_help();
+		return 0;
+	}
+
+	AlphaRngApi rng (AlphaRngConfig{cfg.e_mac_type, cfg.e_rsa_key_size, cfg.e_aes_key_size, cfg.key_file});
+
+	if (!rng.set_session_ttl(cmd.ttl_minutes)) {
+		cerr << rng.get_last_error() << endl;
+		return -1;
+	}
+
+	if (cmd.disable_stat_tests == true) {
+		rng.disable_stat_tests();
+	}
+	rng.set_num_failures_threshold(cmd.num_failures_threshold);
+
+	unique_ptr<EntropyServer> server {new EntropyServer(&rng, &cmd)};
+
+	if (!server->run()) {
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Parse and extract command and options from the command line
+ *
+ * @param[out] cmd resulting command
+ * @param[out] cfg configuration
+ * @param[in] argc number of arguments provided in command line
+ * @param[in] argv points to the location with command line parameters
+ *
+ * @return true if command and options extracted successfully
+ */
+static bool extract_command(Cmd &cmd, RngConfig &cfg, const int argc, const char **argv) {
+	appArgs.load_arguments(argc, argv);
+	if (appArgs.is_error()) {
+		cerr << appArgs.get_last_error();
+		return false;
+	}
+
+	cmd.device_number = 0;
+	cmd.is_all_devices = false;
+	cmd.op_count = 0;
+	cmd.cmd_type = CmdOpt::none;
+	cmd.pipe_name = "";
+	cmd.shm_ring_name = "";
+	cmd.shm_ring_group = "";
+	cmd.cuse_device_name = "";
+	cmd.pipe_instances = EntropyServer::c_default_clients;
+	cmd.disable_stat_tests = false;
+	cmd.num_failures_threshold = HealthTests::s_min_num_failures_threshold;
+	cmd.err_log_enabled = false;
+	cmd.ttl_minutes = 0;
+	cmd.rate_kbsec = 0;
+	cmd.cache_high_kb = 0;
+	cmd.cache_low_kb = 0;
+	cmd.metrics_port = 0;
+	cmd.tcp_address = "127.0.0.1";
+	cmd.tcp_port = 0;
+	cmd.psk_file_name = "";
+	cmd.seed_file_name = "";
+
+	cfg.e_mac_type = MacType::None;
+	cfg.e_aes_key_size = KeySize::k256;
+	cfg.e_rsa_key_size = RsaKeySize::rsa2048;
+
+	map<string, string> arg_map = appArgs.get_argument_map();
+	for (auto const& map : arg_map) {
+		string option = map.first;
+		string value = map.second;
+
+		if (option.length() <= 1) {
+			cerr << "Invalid option: " << option << endl;
+			return false;
+		}
+
+		char c = option.at(1);
+
+		switch (c) {
+		case 'E':
+			cmd.pipe_name = value;
+			break;
+		case 'S':
+			if (option.compare("-Sg") == 0) {
+				cmd.shm_ring_group = value;
+			} else {
+				cmd.shm_ring_name = value;
+			}
+			break;
+		case 'C':
+#ifdef ALPHARNG_EXPERIMENTAL_CUSE
+			cmd.cuse_device_name = value;
+			break;
+#else
+			cerr << "Option -C is experimental and not included in this build, use 'make EXPERIMENTAL_CUSE=1' to enable it" << endl;
+			return false;
+#endif
+		case 's':
+			if (option.compare("-seed") == 0) {
+				cmd.seed_file_name = value;
+			} else {
+				cerr << "unexpected option " << option << endl;
+				return false;
+			}
+			break;
+		case 'h':
+			if (option.compare("-hw") == 0) {
+				cmd.cache_high_kb = atoll(value.c_str());
+				if (cmd.cache_high_kb < EntropyServer::c_min_cache_size_kb || cmd.cache_high_kb > EntropyServer::c_max_cache_size_kb) {
+					cerr << "unexpected high watermark " << value << ", must be between " << EntropyServer::c_min_cache_size_kb
+							<< " and " << EntropyServer::c_max_cache_size_kb << " KB" << endl;
+					return false;
+				}
+				break;
+			}
+			cmd.cmd_type = CmdOpt::getHelp;
+			cmd.op_count++;
+			break;
+		case 'e':
+			cmd.cmd_type = CmdOpt::getEntropy;
+			cmd.op_count++;
+			break;
+		case 'l':
+			if (option.compare("-lw") == 0) {
+				cmd.cache_low_kb = atoll(value.c_str());
+				if (cmd.cache_low_kb < 1) {
+					cerr << "unexpected low watermark " << value << ", must be a positive number in KB" << endl;
+					return false;
+				}
+				break;
+			}
+			cmd.err_log_enabled = true;
+			break;
+		case 'k':
+			cfg.key_file = value;
+			break;
+		case 'm':
+			if (option.compare("-metrics") == 0) {
+				cmd.metrics_port = atoi(value.c_str());
+				if (cmd.metrics_port < 1 || cmd.metrics_port > 65535) {
+					cerr << "unexpected metrics port " << value << ", must be between 1 and 65535" << endl;
+					return false;
+				}
+				break;
+			}
+			if (value.compare("hmacSha160") == 0) {
+				cfg.e_mac_type = MacType::hmacSha160;
+				break;
+			}
+			if (value.compare("hmacMD5") == 0) {
+				cfg.e_mac_type = MacType::hmacMD5;
+				break;
+			}
+			if (value.compare("hmacSha256") == 0) {
+				cfg.e_mac_type = MacType::hmacSha256;
+				break;
+			}
+			if (value.compare("none") == 0) {
+				cfg.e_mac_type = MacType::None;
+				break;
+			}
+			cerr << "unexpected mac option specified, must be hmacMD5, hmacSha160, hmacSha256 or none" << endl;
+			return false;
+			break;
+		case 'c':
+			if (value.compare("aes256") == 0) {
+				cfg.e_aes_key_size = KeySize::k256;
+				break;
+			}
+			if (value.compare("aes128") == 0) {
+				cfg.e_aes_key_size = KeySize::k128;
+				break;
+			}
+			if (value.compare("none") == 0) {
+				cfg.e_aes_key_size = KeySize::None;
+				break;
+			}
+			cerr << "unexpected cipher option specified, must be aes256, aes128 or none" << endl;
+			return false;
+			break;
+		case 'p':
+			if (option.compare("-psk") == 0) {
+				cmd.psk_file_name = value;
+				break;
+			}
+			if (value.compare("RSA1024") == 0) {
+				cfg.e_rsa_key_size = RsaKeySize::rsa1024;
+				break;
+			}
+			if (value.compare("RSA2048") == 0) {
+				cfg.e_rsa_key_size = RsaKeySize::rsa2048;
+				break;
+			}
+			cerr << "unexpected RSA option specified, must be RSA1024, RSA2048 or RSA4096" << endl;
+			return false;
+			break;
+		case 'd':
+			if (option.length() == 3 && option.at(2) == 't') {
+				cmd.disable_stat_tests = true;
+			} else if (value.compare("all") == 0) {
+				cmd.is_all_devices = true;
+			} else {
+				cmd.device_number = atoi(value.c_str());
+			}
+			break;
+		case 'i':
+			cmd.pipe_instances = atoi(value.c_str());
+			break;
+		case 'r':
+			if (option.compare("-rate") == 0) {
+				cmd.rate_kbsec = atoll(value.c_str());
+				if (cmd.rate_kbsec < 1 || cmd.rate_kbsec > 1000000) {
+					cerr << "unexpected rate " << value << ", must be between 1 and 1000000 KB/sec" << endl;
+					return false;
+				}
+			} else {
+				cerr << "unexpected option " << option << endl;
+				return false;
+			}
+			break;
+		case 't':
+			if (option.compare("-tcp") == 0) {
+				const size_t separator = value.rfind(':');
+				if (separator != string::npos) {
+					cmd.tcp_address = value.substr(0, separator);
+				}
+				cmd.tcp_port = atoi(value.substr(separator == string::npos ? 0 : separator + 1).c_str());
+				if (cmd.tcp_port < 1 || cmd.tcp_port > 65535) {
+					cerr << "unexpected TCP port in " << value << ", must be between 1 and 65535" << endl;
+					return false;
+				}
+				break;
+			}
+			if (option.length() == 4 && option.at(2) == 't' && option.at(3) == 'l') {
+				int val = atoi(value.c_str());
+				if (val < 1) {
+					cerr << "unexpected ttl " << val << " value, must be a positive number in minutes" << endl;
+					return false;
+				}
+				cmd.ttl_minutes = val;
+				break;
+			} else if (option.length() == 3 && option.at(2) == 'h') {
+				int val = atoi(value.c_str());
+				if (val < 6 || val > 255) {
+					cerr << "unexpected threshold for number of failures, must be between 6 and 255" << endl;
+					return false;
+				}
+				cmd.num_failures_threshold = val;
+				break;
+			} else {
+				cerr << "unexpected option " << option << endl;
+				return false;
+			}
+			break;
+		default:
+			cerr << "Unexpected option: " << c << endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Validate command
+ *
+ * @param[in] cmd command to be validated
+ *
+ * @return true if command is valid
+ */
+static bool validate_comand(const Cmd &cmd) {
+	if (cmd.op_count > 1) {
+		cerr << "Too many operation modes specified, choose only one" << endl;
+		return false;
+	}
+
+	if (cmd.op_count == 0) {
+		cerr << "No operation mode specified. Use -h for help" << endl;
+		return false;
+	}
+
+	if (cmd.device_number < 0 || cmd.device_number > 25) {
+		cerr << "Invalid device number specified: " << cmd.device_number << endl;
+		return false;
+	}
+
+	if (cmd.pipe_instances < 1 || cmd.pipe_instances > EntropyServer::c_max_clients) {
+		cerr << "Invalid amount of clients specified: " << cmd.pipe_instances << endl;
+		return false;
+	}
+	if (!cmd.shm_ring_group.empty() && cmd.shm_ring_name.empty()) {
+		cerr << "Option -Sg requires -S" << endl;
+		return false;
+	}
+	if ((cmd.tcp_port > 0) != !cmd.psk_file_name.empty()) {
+		cerr << "Options -tcp and -psk must be used together" << endl;
+		return false;
+	}
+
+	const int64_t cache_high_kb = cmd.cache_high_kb > 0 ? cmd.cache_high_kb : EntropyServer::c_default_cache_size_kb;
+	if (cmd.cache_low_kb >= cache_high_kb) {
+		cerr << "Low watermark " << cmd.cache_low_kb << " KB must be below the high watermark " << cache_high_kb << " KB" << endl;
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Display usage
+ */
+static void display_help() {
+	cout << "*********************************************************************************" << endl;
+	cout << "                       AlphaRNG entropy-server Ver ";
+	cout << std::fixed << std::setw(2) << std::setprecision(1) << version << endl;
+	cout << "*********************************************************************************" << endl;
+	cout << "NAME" << endl;
+	cout << "     entropy-server - An application server for distributing random bytes" << endl;
+	cout << "                      downloaded from AlphaRNG device" << endl;
+	cout << "SYNOPSIS" << endl;
+	cout << "     entropy-server <operation mode> [options]" << endl;
+	cout << endl;
+	cout << "DESCRIPTION" << endl;
+	cout << "     entropy-server downloads random bytes from Hardware (True) " << endl;
+	cout << "     Random Number Generator AlphaRNG device and distributes them to" << endl;
+	cout << "     consumer applications using a Unix domain socket. It uses the same" << endl;
+	cout << "     request protocol as the Windows entropy server named pipe." << endl;
+	cout << "     Clients are served in deficit round robin order within three priority" << endl;
+	cout << "     classes, so a client requesting large amounts of bytes does not delay" << endl;
+	cout << "     the small requests of other clients." << endl;
+	cout << "     Requests are served from an entropy cache that the device refills in the" << endl;
+	cout << "     background between a low and a high watermark." << endl;
+	cout << "     The server stops on SIGINT or SIGTERM. Per client latency and cache statistics" << endl;
+	cout << "     are logged on SIGUSR1 and when the server stops." << endl;
+	cout << endl;
+	cout << "FUNCTION LETTERS" << endl;
+	cout << "     Main operation mode:" << endl;
+	cout << endl;
+	cout << "     -e" << endl;
+	cout << "           start the entropy server for retrieving/extracting and distributing" << endl;
+	cout << "           entropy bytes from an AlhaRNG device using a Unix domain socket." << endl;
+	cout << endl;
+	cout << "OPTIONS" << endl;
+	cout << endl;
+	cout << "     -d NUMBER" << endl;
+	cout << "           USB device NUMBER, if more than one. Skip this option if only" << endl;
+	cout << "           one AlphaRNG device is connected. Use 'all' to serve clients from all" << endl;
+	cout << "           connected devices: each device has its own worker, the cache is refilled by" << endl;
+	cout << "           all of them and a failing device is taken out of rotation until it recovers." << endl;
+	cout << endl;
+	cout << "     -m MAC" << endl;
+	cout << "           MAC type: hmacMD5, hmacSha160, hmacSha256 or none - skip this option for none." << endl;
+	cout << endl;
+	cout << "     -p KEYTYPE" << endl;
+	cout << "           Public KEYTYPE: RSA1024 or RSA2048 - skip this option for RSA2048." << endl;
+	cout << endl;
+	cout << "     -c CIPHER" << endl;
+	cout << "           CIPHER type: aes256, aes128 or none - skip this option for aes256." << endl;
+	cout << endl;
+	cout << "     -k FILE" << endl;
+	cout << "           FILE pathname with an alternative RSA 2048 public key, supplied by the manufacturer." << endl;
+	cout << endl;
+	cout << "     -E ENDPOINT" << endl;
+	cout << "           ENDPOINT: a custom Unix domain socket path (default: " << EntropyServer::c_default_socket_path << ")." << endl;
+	cout << "           Place it in a directory only the server user can write, such as /run, so no other" << endl;
+	cout << "           local user can bind the path first and pose as the server." << endl;
+	cout << endl;
+	cout << "     -S NAME" << endl;
+	cout << "           Also publish entropy bytes into a POSIX shared memory ring NAME (for example /alpharng)" << endl;
+	cout << "           of " << SharedEntropyRing::c_default_capacity_bytes / 1048576 << " MB for up to " << SharedEntropyRing::c_max_readers << " local reader processes." << endl;
+	cout << "           Readers claim bytes with an atomic operation and block only when the ring is drained." << endl;
+	cout << "           The bytes are kept in NAME, which only the server can write, the reader slots in NAME.ctl." << endl;
+	cout << "           Both are readable only by the server user unless -Sg is given. Readers map NAME read only" << endl;
+	cout << "           and attach only to a ring owned by root or by their own user. Any reader can see the bytes" << endl;
+	cout << "           handed to other readers and can stall the ring, so grant access only to trusted users." << endl;
+	cout << endl;
+	cout << "     -Sg GROUP" << endl;
+	cout << "           Allow members of GROUP to attach to the ring of -S as readers." << endl;
+	cout << endl;
+#ifdef ALPHARNG_EXPERIMENTAL_CUSE
+	cout << "     -C NAME" << endl;
+	cout << "           Also serve entropy bytes through character device /dev/NAME (for example alpharng)" << endl;
+	cout << "           registered with CUSE. Requires access to /dev/cuse (cuse kernel module)." << endl;
+	cout << "           Each open file of the device is scheduled as a separate client. Access to the device" << endl;
+	cout << "           file is granted with a udev rule, for example: KERNEL==\"alpharng\", MODE=\"0444\"" << endl;
+	cout << "           EXPERIMENTAL: not yet verified with the cuse kernel module." << endl;
+	cout << endl;
+#endif
+	cout << "     -i NUMBER" << endl;
+	cout << "          How many clients may be connected at once (default: " << EntropyServer::c_default_clients << ")" << endl;
+	cout << "          Valid values are integers from 1 to " << EntropyServer::c_max_clients << endl;
+	cout << endl;
+	cout << "     -rate KBSEC" << endl;
+	cout << "          Limit the entropy bytes served to each client to KBSEC kilobytes per second," << endl;
+	cout << "          between 1 and 1000000. Skip this option for no per client limit." << endl;
+	cout << endl;
+	cout << "     -hw KB" << endl;
+	cout << "          High watermark: size of the entropy cache in kilobytes, between " << EntropyServer::c_min_cache_size_kb << " and " << EntropyServer::c_max_cache_size_kb << "." << endl;
+	cout << "          Client requests are served from the cache (default: " << EntropyServer::c_default_cache_size_kb << " KB)." << endl;
+	cout << endl;
+	cout << "     -lw KB" << endl;
+	cout << "          Low watermark: the device refills the cache up to the high watermark once it drops" << endl;
+	cout << "          below KB kilobytes (default: three quarters of the high watermark)." << endl;
+	cout << endl;
+	cout << "     -metrics PORT" << endl;
+	cout << "          Expose server, device and per client metrics in Prometheus text format" << endl;
+	cout << "          at http://127.0.0.1:PORT/metrics. Only local connections are accepted." << endl;
+	cout << endl;
+	cout << "     -tcp [ADDRESS:]PORT" << endl;
+	cout << "          Also serve clients connecting over TCP to IPv4 ADDRESS:PORT (default address: 127.0.0.1," << endl;
+	cout << "          use 0.0.0.0 for all interfaces). Requires -psk. Requests and replies are carried" << endl;
+	cout << "          in AES-256-GCM frames with keys derived from the pre-shared key for each connection." << endl;
+	cout << endl;
+	cout << "     -psk FILE" << endl;
+	cout << "          FILE with the pre-shared key of TCP clients, 64 hexadecimal digits." << endl;
+	cout << "          Keep it readable only by the server user and by authorized clients." << endl;
+	cout << endl;
+	cout << "     -seed FILE" << endl;
+	cout << "          Keep a seed of device entropy in FILE, written with 0600 permissions every " << EntropyServer::c_seed_save_interval_secs / 60 << endl;
+	cout << "          minutes and when the server stops. At startup the seed is consumed: FILE is removed" << endl;
+	cout << "          and the cache is filled with " << EntropyServer::c_seeded_cache_bytes / 1024 << " KB generated from the seed, so clients are" << endl;
+	cout << "          served at once while the device connection is established in the background." << endl;
+	cout << endl;
+	cout << "     -dt" << endl;
+	cout << "           Disable APT and RCT statistical tests." << endl;
+	cout << endl;
+	cout << "     -th NUMBER" << endl;
+	cout << "           Set threshold for number of failures per APT and RCT test blocks. Must be between 6 and 255" << endl;
+	cout << endl;
+	cout << "     -le" << endl;
+	cout << "           Log all errors on standard error stream. Use this option with caution as it may result" << endl;
+	cout << "           in flooding the standard error stream with many error messages." << endl;
+	cout << endl;
+	cout << "     -ttl MINUTES" << endl;
+	cout << "           Set session time to live in minutes. A new session will be created every specified " << endl;
+	cout << "           amount of minutes within a connection. MINUTES must be a positive number." << endl;
+	cout << "           Skip this option if session should never expire for a connection." << endl;
+	cout << endl;
+	cout << "EXAMPLES:" << endl;
+	cout << "     To start the server using AlphaRNG device with default security settings:" << endl;
+	cout << "           entropy-server -e " << endl;
+	cout << "     To start the server using first AlphaRNG device and custom socket path:" << endl;
+	cout << "           entropy-server -e -E /run/alpharng/entropy.sock" << endl;
+	cout << "     To start the server and also publish entropy bytes into '/alpharng' shared memory ring:" << endl;
+	cout << "           entropy-server -e -S /alpharng" << endl;
+	cout << "     To also let the members of group 'alpharng' read the ring:" << endl;
+	cout << "           entropy-server -e -S /alpharng -Sg alpharng" << endl;
+#ifdef ALPHARNG_EXPERIMENTAL_CUSE
+	cout << "     To start the server and also serve entropy bytes through /dev/alpharng:" << endl;
+	cout << "           entropy-server -e -C alpharng" << endl;
+#endif
+	cout << "     To start the server limiting each client to 512 KB per second:" << endl;
+	cout << "           entropy-server -e -rate 512" << endl;
+	cout << "     To start the server with a 4 MB entropy cache refilled when it is half empty:" << endl;
+	cout << "           entropy-server -e -hw 4096 -lw 2048" << endl;
+	cout << "     To start the server and expose metrics for Prometheus on port 9464:" << endl;
+	cout << "           entropy-server -e -metrics 9464" << endl;
+	cout << "     To create a pre-shared key and serve the hosts of the local network on port 9465:" << endl;
+	cout << "           openssl rand -hex 32 > alpharng.psk && chmod 600 alpharng.psk" << endl;
+	cout << "           entropy-server -e -tcp 0.0.0.0:9465 -psk alpharng.psk" << endl;
+	cout << "     To start the server using all connected AlphaRNG devices:" << endl;
+	cout << "           entropy-server -e -d all" << endl;
+	cout << "     To start the server with entropy available right after a reboot:" << endl;
+	cout << "           entropy-server -e -seed /var/lib/alpharng/seed" << endl;
+	cout << endl;
+}
@@ -1,7 +1,7 @@
 /**
  *    @file sample_c.c
- *    @date 07/20/2024
- *    @version 1.5
+ *    @date 10/17/2026
+ *    @version 1.6
  *
  *    @brief A C example that utilizes a C wrapper around the C++ API for communicating with the AlphaRNG device.
  */
@@ -24,8 +24,16 @@ struct rng_data {
 	uint16_t freq_table_1[256];
 	uint16_t freq_table_2[256];
 	char device_path[128];
+	unsigned char async_entropy_buffer[32];
+	int async_status;
 };
 
+/* Invoked from alrng_async_poll() when an asynchronous request is reported */
+static void on_async_entropy(alrng_async *async, int64_t request_id, int status, unsigned char *out, int out_length, void *user_data) {
+	(void)async; (void)request_id; (void)out; (void)out_length;
+	((struct rng_data*)user_data)->async_status = status;
+}
+
 /*
   *** MAIN ***
 */
@@ -35,6 +43,7 @@ int main() {
 	int call_ret_value;
 	int ret_val;
 	int i;
+	alrng_async *async;
 
 	/* Create a connection context using RSA-2048, HMAC-SHA-160 and AES-256-GCM security attributes */
 	struct alrng_context *ctxt = alrng_create_ctxt(rsa_2048_key, hmac_sha_160, aes_256_gcm, "");
@@ -175,6 +184,26 @@ int main() {
 		goto error;
 	}
 
+	/* Retrieve entropy bytes asynchronously, an event loop would wait for alrng_async_get_fd() to become readable */
+	async = alrng_async_create(ctxt, 0);
+	if (NULL == async) {
+		call_ret_value = -2;
+		goto error;
+	}
+	rand_data.async_status = alrng_async_queued;
+	if (alrng_async_submit(async, alrng_op_get_entropy, rand_data.async_entropy_buffer,
+			sizeof(rand_data.async_entropy_buffer), on_async_entropy, &rand_data) < 0) {
+		rand_data.async_status = alrng_async_failed;
+	}
+	while (rand_data.async_status == alrng_async_queued) {
+		alrng_async_poll(async, -1);
+	}
+	if (rand_data.async_status != alrng_async_completed) {
+		alrng_async_get_last_error(async, rand_data.device_error_message, sizeof(rand_data.device_error_message));
+		printf("%s\n", rand_data.device_error_message);
+	}
+	alrng_async_destroy(async);
+
 
 	/* Print retrieved data */
 	printf("========================================\n");
@@ -200,6 +229,12 @@ int main() {
 		printf("%d ", rand_data.entropy_buffer[i]);
 	}
 	printf("\n");
+	printf("asynchronous entropy bytes: ");
+
+	for (i = 0; i < (int)sizeof(rand_data.async_entropy_buffer); i++) {
+		printf("%d ", rand_data.async_entropy_buffer[i]);
+	}
+	printf("\n");
 	goto close_and_exit;
 
 error: